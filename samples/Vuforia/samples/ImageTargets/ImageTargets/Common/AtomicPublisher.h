@@ -0,0 +1,53 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace SampleCommon
+{
+    // Publishes immutable objects from one thread to others without locks
+    // held across their work (read-copy-update).
+    //
+    // A writer builds a complete new object and publishes it; readers take a
+    // reference to the current object and use it for as long as they need,
+    // even after a newer one is published. An object is freed when the last
+    // reader holding it drops its reference, so there is no grace period to
+    // wait for and no reader ever blocks on a writer's work.
+    template <typename T>
+    class AtomicPublisher
+    {
+    public:
+        AtomicPublisher() :
+            m_version(0)
+        {
+        }
+
+        // Makes value the current object, or clears it with nullptr
+        void Publish(std::shared_ptr<const T> value)
+        {
+            std::atomic_store_explicit(&m_current, std::move(value), std::memory_order_release);
+            m_version.fetch_add(1, std::memory_order_release);
+        }
+
+        // The current object, or nullptr before the first one
+        std::shared_ptr<const T> Acquire() const
+        {
+            return std::atomic_load_explicit(&m_current, std::memory_order_acquire);
+        }
+
+        // Number of objects published so far, for readers caching derived data
+        uint32_t GetVersion() const { return m_version.load(std::memory_order_acquire); }
+
+    private:
+        // Only accessed through the atomic shared_ptr functions
+        std::shared_ptr<const T> m_current;
+        std::atomic<uint32_t> m_version;
+    };
+} // namespace SampleCommon
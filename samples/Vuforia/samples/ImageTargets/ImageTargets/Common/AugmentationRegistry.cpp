@@ -0,0 +1,312 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "AugmentationRegistry.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace SampleCommon;
+
+namespace
+{
+    const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    const size_t MAX_TOKENS = 9;
+
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Splits a line at whitespace, returns the number of tokens or
+    // MAX_TOKENS + 1 if there are too many
+    size_t Tokenize(const char *line, std::string tokens[MAX_TOKENS])
+    {
+        size_t count = 0;
+        while (*line != '\0')
+        {
+            while (IsSpace(*line))
+            {
+                line++;
+            }
+            if (*line == '\0')
+            {
+                break;
+            }
+
+            const char *start = line;
+            while (*line != '\0' && !IsSpace(*line))
+            {
+                line++;
+            }
+
+            if (count == MAX_TOKENS)
+            {
+                return MAX_TOKENS + 1;
+            }
+            tokens[count++].assign(start, line - start);
+        }
+        return count;
+    }
+
+    bool ParseFloat(const std::string &token, float &value)
+    {
+        char *end = nullptr;
+        value = strtof(token.c_str(), &end);
+        return end != token.c_str() && *end == '\0';
+    }
+
+    uint32_t FindName(const std::string &name, const char *const *names, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (name == names[i])
+            {
+                return i;
+            }
+        }
+        return AugmentationRegistry::INVALID_ENTRY;
+    }
+}
+
+const uint32_t AugmentationRegistry::INVALID_ENTRY;
+const uint32_t AugmentationRegistry::UNRESOLVED_ENTRY;
+
+AugmentationRegistry::AugmentationRegistry()
+{
+    Clear();
+}
+
+void AugmentationRegistry::Clear()
+{
+    m_entries.clear();
+    m_names.clear();
+    m_modes.clear();
+    m_slots.clear();
+    m_trackableCache.clear();
+    for (int mode = 0; mode < AUGMENTATION_MODE_COUNT; mode++)
+    {
+        m_fallbackEntries[mode] = INVALID_ENTRY;
+    }
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+bool AugmentationRegistry::Load(
+    const char *text,
+    size_t length,
+    const char *const *meshNames,
+    uint32_t meshCount,
+    const char *const *textureNames,
+    uint32_t textureCount)
+{
+    Clear();
+
+    std::string line;
+    size_t position = 0;
+    while (position < length)
+    {
+        size_t end = position;
+        while (end < length && text[end] != '\n')
+        {
+            end++;
+        }
+
+        line.assign(text + position, end - position);
+        if (!ParseLine(line.c_str(), meshNames, meshCount, textureNames, textureCount))
+        {
+            m_stats.rejectedLines++;
+        }
+        position = end + 1;
+    }
+
+    BuildTable();
+    m_stats.entryCount = static_cast<uint32_t>(m_entries.size());
+    return !m_entries.empty();
+}
+
+bool AugmentationRegistry::ParseLine(
+    const char *line,
+    const char *const *meshNames,
+    uint32_t meshCount,
+    const char *const *textureNames,
+    uint32_t textureCount)
+{
+    std::string tokens[MAX_TOKENS];
+    size_t count = Tokenize(line, tokens);
+    if (count == 0 || tokens[0][0] == '#')
+    {
+        return true;
+    }
+
+    // mode, target, mesh and texture, then optionally the scale, the
+    // translation and the rotation, each complete
+    if (count != 4 && count != 5 && count != 8 && count != 9)
+    {
+        return false;
+    }
+
+    AugmentationMode mode;
+    if (tokens[0] == "standard")
+    {
+        mode = AUGMENTATION_MODE_STANDARD;
+    }
+    else if (tokens[0] == "extended")
+    {
+        mode = AUGMENTATION_MODE_EXTENDED;
+    }
+    else
+    {
+        return false;
+    }
+
+    AugmentationEntry entry;
+    entry.mesh = FindName(tokens[2], meshNames, meshCount);
+    entry.texture = FindName(tokens[3], textureNames, textureCount);
+    if (entry.mesh == INVALID_ENTRY || entry.texture == INVALID_ENTRY)
+    {
+        return false;
+    }
+
+    entry.scale = 1.0f;
+    entry.rotation = 0.0f;
+    entry.translation[0] = entry.translation[1] = entry.translation[2] = 0.0f;
+
+    if ((count > 4 && !ParseFloat(tokens[4], entry.scale)) ||
+        (count > 5 && !(ParseFloat(tokens[5], entry.translation[0]) &&
+                        ParseFloat(tokens[6], entry.translation[1]) &&
+                        ParseFloat(tokens[7], entry.translation[2]))) ||
+        (count > 8 && !ParseFloat(tokens[8], entry.rotation)))
+    {
+        return false;
+    }
+
+    AddEntry(tokens[1], mode, entry);
+    return true;
+}
+
+void AugmentationRegistry::AddEntry(const std::string &name, AugmentationMode mode, const AugmentationEntry &entry)
+{
+    uint32_t index = static_cast<uint32_t>(m_entries.size());
+    m_entries.push_back(entry);
+    m_names.push_back(name);
+    m_modes.push_back(static_cast<uint8_t>(mode));
+
+    if (name == "*")
+    {
+        m_fallbackEntries[mode] = index;
+    }
+}
+
+void AugmentationRegistry::BuildTable()
+{
+    size_t capacity = 16;
+    while (capacity < m_entries.size() * 2)
+    {
+        capacity *= 2;
+    }
+
+    Slot empty = { 0, INVALID_ENTRY };
+    m_slots.assign(capacity, empty);
+
+    for (uint32_t i = 0; i < m_entries.size(); i++)
+    {
+        if (m_names[i] == "*")
+        {
+            continue;
+        }
+
+        uint64_t hash = HashName(m_names[i].c_str(), m_names[i].size(), static_cast<AugmentationMode>(m_modes[i]));
+        size_t slot = static_cast<size_t>(hash) & (capacity - 1);
+        uint32_t probeLength = 1;
+        while (m_slots[slot].entry != INVALID_ENTRY)
+        {
+            // A later line for the same target replaces the earlier one
+            uint32_t other = m_slots[slot].entry;
+            if (m_slots[slot].hash == hash && m_modes[other] == m_modes[i] && m_names[other] == m_names[i])
+            {
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+            probeLength++;
+        }
+
+        m_slots[slot].hash = hash;
+        m_slots[slot].entry = i;
+        m_stats.maxProbeLength = (probeLength > m_stats.maxProbeLength) ? probeLength : m_stats.maxProbeLength;
+    }
+}
+
+uint64_t AugmentationRegistry::HashName(const char *name, size_t length, AugmentationMode mode)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= static_cast<uint8_t>(name[i]);
+        hash *= FNV_PRIME;
+    }
+
+    hash ^= static_cast<uint64_t>(mode);
+    hash *= FNV_PRIME;
+    return hash;
+}
+
+uint32_t AugmentationRegistry::FindExact(const char *name, size_t length, AugmentationMode mode) const
+{
+    if (m_slots.empty())
+    {
+        return INVALID_ENTRY;
+    }
+
+    size_t mask = m_slots.size() - 1;
+    uint64_t hash = HashName(name, length, mode);
+    for (size_t slot = static_cast<size_t>(hash) & mask; m_slots[slot].entry != INVALID_ENTRY; slot = (slot + 1) & mask)
+    {
+        // Compare the names only when the full hashes match
+        const Slot &candidate = m_slots[slot];
+        if (candidate.hash == hash &&
+            m_names[candidate.entry].size() == length &&
+            memcmp(m_names[candidate.entry].data(), name, length) == 0)
+        {
+            return candidate.entry;
+        }
+    }
+    return INVALID_ENTRY;
+}
+
+uint32_t AugmentationRegistry::Find(const char *targetName, AugmentationMode mode) const
+{
+    uint32_t entry = FindExact(targetName, strlen(targetName), mode);
+    return (entry != INVALID_ENTRY) ? entry : m_fallbackEntries[mode];
+}
+
+uint32_t AugmentationRegistry::Resolve(int trackableId, const char *targetName, AugmentationMode mode)
+{
+    m_stats.lookups++;
+    if (trackableId < 0)
+    {
+        return Find(targetName, mode);
+    }
+
+    size_t index = static_cast<size_t>(trackableId) * AUGMENTATION_MODE_COUNT + mode;
+    if (index >= m_trackableCache.size())
+    {
+        m_trackableCache.resize(index + 1, UNRESOLVED_ENTRY);
+    }
+
+    uint32_t &cached = m_trackableCache[index];
+    if (cached != UNRESOLVED_ENTRY)
+    {
+        m_stats.cacheHits++;
+        return cached;
+    }
+
+    cached = Find(targetName, mode);
+    return cached;
+}
@@ -0,0 +1,133 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SampleCommon
+{
+    // Tracking modes an augmentation can be registered for
+    enum AugmentationMode
+    {
+        AUGMENTATION_MODE_STANDARD = 0,
+        AUGMENTATION_MODE_EXTENDED,
+        AUGMENTATION_MODE_COUNT
+    };
+
+    // How an augmentation is drawn over a trackable. mesh and texture index the
+    // name tables given to Load(). The transform applies on top of the mesh's
+    // own model matrix: scale first, then the rotation in degrees around the
+    // target normal, then the translation.
+    struct AugmentationEntry
+    {
+        uint32_t mesh;
+        uint32_t texture;
+        float scale;
+        float rotation;
+        float translation[3];
+    };
+
+    struct AugmentationRegistryStats
+    {
+        uint32_t entryCount;
+        uint32_t rejectedLines;
+
+        // Longest probe sequence of any entry in the hash table
+        uint32_t maxProbeLength;
+
+        // Resolve() calls, and those answered from the per-trackable cache
+        uint64_t lookups;
+        uint64_t cacheHits;
+    };
+
+    // Maps target names to augmentations, as read from a scene description.
+    // Names are looked up through an open addressing hash table built at load
+    // time, and Resolve() caches the result per trackable id so that the
+    // per-frame path does no string work once a trackable has been seen.
+    //
+    // The scene description has one augmentation per line:
+    //     <mode> <target> <mesh> <texture> [scale [x y z [rotation]]]
+    // where mode is "standard" or "extended" and the target "*" matches targets
+    // without a line of their own. Empty lines and lines starting with '#' are
+    // skipped.
+    class AugmentationRegistry
+    {
+    public:
+        static const uint32_t INVALID_ENTRY = 0xffffffff;
+
+        AugmentationRegistry();
+
+        // Replaces the registry with the augmentations of a scene description.
+        // Lines that don't parse, or name unknown meshes or textures, are
+        // counted in the stats and skipped. Returns false if no line was valid.
+        bool Load(
+            const char *text,
+            size_t length,
+            const char *const *meshNames,
+            uint32_t meshCount,
+            const char *const *textureNames,
+            uint32_t textureCount);
+
+        void Clear();
+
+        // Entry index of a target, falling back to the "*" entry of the mode.
+        // Returns INVALID_ENTRY if neither exists.
+        uint32_t Find(const char *targetName, AugmentationMode mode) const;
+
+        // Find(), cached per trackable id. Trackable ids are small and dense, so
+        // the cache is a plain array; negative ids are looked up every time.
+        uint32_t Resolve(int trackableId, const char *targetName, AugmentationMode mode);
+
+        const AugmentationEntry& GetEntry(uint32_t index) const { return m_entries[index]; }
+        size_t GetEntryCount() const { return m_entries.size(); }
+
+        const AugmentationRegistryStats& GetStats() const { return m_stats; }
+
+        // 64-bit FNV-1a of a target name, mixed with the mode
+        static uint64_t HashName(const char *name, size_t length, AugmentationMode mode);
+
+    private:
+        // Marks trackable ids whose entry hasn't been looked up yet
+        static const uint32_t UNRESOLVED_ENTRY = 0xfffffffe;
+
+        struct Slot
+        {
+            uint64_t hash;
+            uint32_t entry;
+        };
+
+        bool ParseLine(
+            const char *line,
+            const char *const *meshNames,
+            uint32_t meshCount,
+            const char *const *textureNames,
+            uint32_t textureCount);
+
+        void AddEntry(const std::string &name, AugmentationMode mode, const AugmentationEntry &entry);
+        void BuildTable();
+        uint32_t FindExact(const char *name, size_t length, AugmentationMode mode) const;
+
+        std::vector<AugmentationEntry> m_entries;
+        std::vector<std::string> m_names;
+        std::vector<uint8_t> m_modes;
+
+        // Hash table of the named entries, with a power of two size and at
+        // most half full, probed linearly
+        std::vector<Slot> m_slots;
+
+        // The "*" entry of each mode
+        uint32_t m_fallbackEntries[AUGMENTATION_MODE_COUNT];
+
+        // Resolved entries, indexed by trackable id * AUGMENTATION_MODE_COUNT + mode
+        std::vector<uint32_t> m_trackableCache;
+
+        AugmentationRegistryStats m_stats;
+    };
+} // namespace SampleCommon
@@ -0,0 +1,175 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "BoundingVolume.h"
+
+#include <cfloat>
+#include <cmath>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define BOUNDING_VOLUME_USE_SSE 1
+#endif
+
+using namespace SampleCommon;
+
+BoundingVolume BoundingVolumeUtil::ComputeBoundingVolume(const float *positions, size_t count, size_t stride)
+{
+    BoundingVolume volume;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        volume.boxMin[axis] = (count > 0) ? FLT_MAX : 0.0f;
+        volume.boxMax[axis] = (count > 0) ? -FLT_MAX : 0.0f;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float *p = positions + i * stride;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            volume.boxMin[axis] = (p[axis] < volume.boxMin[axis]) ? p[axis] : volume.boxMin[axis];
+            volume.boxMax[axis] = (p[axis] > volume.boxMax[axis]) ? p[axis] : volume.boxMax[axis];
+        }
+    }
+
+    // The sphere is centered on the box, with the farthest vertex on its surface
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        volume.sphereCenter[axis] = 0.5f * (volume.boxMin[axis] + volume.boxMax[axis]);
+    }
+
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float *p = positions + i * stride;
+        float dx = p[0] - volume.sphereCenter[0];
+        float dy = p[1] - volume.sphereCenter[1];
+        float dz = p[2] - volume.sphereCenter[2];
+        float distanceSquared = dx * dx + dy * dy + dz * dz;
+        radiusSquared = (distanceSquared > radiusSquared) ? distanceSquared : radiusSquared;
+    }
+    volume.sphereRadius = sqrtf(radiusSquared);
+
+    return volume;
+}
+
+FrustumPlanes BoundingVolumeUtil::ExtractFrustumPlanes(const float projection[16])
+{
+    const float *row0 = projection;
+    const float *row1 = projection + 4;
+    const float *row2 = projection + 8;
+    const float *row3 = projection + 12;
+
+    FrustumPlanes frustum;
+    for (int i = 0; i < 4; ++i)
+    {
+        frustum.planes[0][i] = row3[i] + row0[i]; // left
+        frustum.planes[1][i] = row3[i] - row0[i]; // right
+        frustum.planes[2][i] = row3[i] + row1[i]; // bottom
+        frustum.planes[3][i] = row3[i] - row1[i]; // top
+        frustum.planes[4][i] = row3[i] + row2[i]; // near
+        frustum.planes[5][i] = row3[i] - row2[i]; // far
+    }
+
+    // Normalize so that plane distances compare with sphere radii
+    for (int p = 0; p < 6; ++p)
+    {
+        float *plane = frustum.planes[p];
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                plane[i] /= length;
+            }
+        }
+    }
+
+    return frustum;
+}
+
+size_t BoundingVolumeUtil::CullSpheresScalar(
+    const FrustumPlanes &frustum,
+    const float *centerX,
+    const float *centerY,
+    const float *centerZ,
+    const float *radius,
+    size_t count,
+    uint8_t *visible)
+{
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; ++p)
+        {
+            const float *plane = frustum.planes[p];
+            float distance = plane[0] * centerX[i] + plane[1] * centerY[i] + plane[2] * centerZ[i] + plane[3];
+            inside = (distance >= -radius[i]);
+        }
+        visible[i] = inside ? 1 : 0;
+        visibleCount += visible[i];
+    }
+    return visibleCount;
+}
+
+size_t BoundingVolumeUtil::CullSpheres(
+    const FrustumPlanes &frustum,
+    const float *centerX,
+    const float *centerY,
+    const float *centerZ,
+    const float *radius,
+    size_t count,
+    uint8_t *visible)
+{
+#if defined(BOUNDING_VOLUME_USE_SSE)
+    // Four spheres at a time against each plane
+    __m128 planeA[6], planeB[6], planeC[6], planeD[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        planeA[p] = _mm_set1_ps(frustum.planes[p][0]);
+        planeB[p] = _mm_set1_ps(frustum.planes[p][1]);
+        planeC[p] = _mm_set1_ps(frustum.planes[p][2]);
+        planeD[p] = _mm_set1_ps(frustum.planes[p][3]);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    size_t visibleCount = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(centerX + i);
+        __m128 y = _mm_loadu_ps(centerY + i);
+        __m128 z = _mm_loadu_ps(centerZ + i);
+        __m128 negativeRadius = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < 6; ++p)
+        {
+            // Summed in the order of the scalar path, so that both agree
+            // on spheres just touching a plane
+            __m128 distance = _mm_add_ps(_mm_mul_ps(planeA[p], x), _mm_mul_ps(planeB[p], y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(planeC[p], z));
+            distance = _mm_add_ps(distance, planeD[p]);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; ++k)
+        {
+            visible[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+            visibleCount += visible[i + k];
+        }
+    }
+
+    return visibleCount + CullSpheresScalar(
+        frustum, centerX + i, centerY + i, centerZ + i, radius + i, count - i, visible + i);
+#else
+    return CullSpheresScalar(frustum, centerX, centerY, centerZ, radius, count, visible);
+#endif
+}
@@ -0,0 +1,74 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SampleCommon
+{
+    // Axis aligned bounding box and bounding sphere of a mesh, in model space.
+    struct BoundingVolume
+    {
+        float boxMin[3];
+        float boxMax[3];
+        float sphereCenter[3];
+        float sphereRadius;
+    };
+
+    // The six planes of a view frustum, as (a, b, c, d) with normalized
+    // (a, b, c) pointing inside: a point p is inside a plane when
+    // a * p.x + b * p.y + c * p.z + d >= 0.
+    struct FrustumPlanes
+    {
+        float planes[6][4];
+    };
+
+    // Per-frame culling statistics.
+    struct CullingStats
+    {
+        uint32_t testedCount;
+        uint32_t culledCount;
+        uint32_t drawnCount;
+    };
+
+    namespace BoundingVolumeUtil
+    {
+        // Computes the bounds of count positions, stride floats apart
+        BoundingVolume ComputeBoundingVolume(const float *positions, size_t count, size_t stride);
+
+        // Extracts the frustum planes of a projection matrix, stored row-major and
+        // applied to column vectors (clip = projection * p), so that the planes
+        // are in the space the projection is applied to.
+        // The clip volume is taken as -w <= z <= w, which also holds for 0 <= z <= w
+        // projections, only less tightly.
+        FrustumPlanes ExtractFrustumPlanes(const float projection[16]);
+
+        // Tests count spheres, stored as separate arrays, against the frustum.
+        // visible[i] is set to 1 for spheres that intersect the frustum and to 0
+        // otherwise. Returns the number of visible spheres.
+        // Uses SSE where available and falls back to CullSpheresScalar.
+        size_t CullSpheres(
+            const FrustumPlanes &frustum,
+            const float *centerX,
+            const float *centerY,
+            const float *centerZ,
+            const float *radius,
+            size_t count,
+            uint8_t *visible);
+
+        // Reference implementation of CullSpheres
+        size_t CullSpheresScalar(
+            const FrustumPlanes &frustum,
+            const float *centerX,
+            const float *centerY,
+            const float *centerZ,
+            const float *radius,
+            size_t count,
+            uint8_t *visible);
+    }
+} // namespace SampleCommon
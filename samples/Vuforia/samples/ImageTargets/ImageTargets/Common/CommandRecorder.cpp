@@ -0,0 +1,97 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "CommandRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace SampleCommon;
+
+ParallelCommandRecorder::ParallelCommandRecorder(ICommandRecordingBackend *backend, JobSystem *jobSystem) :
+    m_backend(backend),
+    m_jobSystem(jobSystem),
+    m_jobs(nullptr),
+    m_record(nullptr),
+    m_nextJob(0)
+{
+    m_stats.jobCount = 0;
+    m_stats.workerCount = backend->GetWorkerCount();
+    m_stats.recordMilliseconds = 0.0;
+    m_stats.executeMilliseconds = 0.0;
+}
+
+void ParallelCommandRecorder::SplitJobs(
+    uint32_t viewIndex,
+    uint32_t drawCount,
+    uint32_t drawsPerJob,
+    std::vector<RecordingJob> &jobs)
+{
+    drawsPerJob = (std::max)(drawsPerJob, 1u);
+    for (uint32_t first = 0; first < drawCount; first += drawsPerJob)
+    {
+        RecordingJob job = { viewIndex, first, (std::min)(drawsPerJob, drawCount - first) };
+        jobs.push_back(job);
+    }
+}
+
+void ParallelCommandRecorder::Record(const std::vector<RecordingJob> &jobs, const RecordFunction &record)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    m_stats.jobCount = static_cast<uint32_t>(jobs.size());
+    m_backend->PrepareJobs(m_stats.jobCount);
+
+    m_jobs = &jobs;
+    m_record = &record;
+    m_nextJob = 0;
+
+    // Each worker index owns a recording context, so a job system job is
+    // started per index rather than per recording job. Worker 0 is the
+    // thread calling Record(), and no more are started than there are jobs for.
+    uint32_t workerCount = (std::min)(m_stats.workerCount, m_stats.jobCount);
+    JobCounter workers;
+    for (uint32_t worker = 1; worker < workerCount; ++worker)
+    {
+        m_jobSystem->Run([this, worker]() { RunJobs(worker); }, &workers);
+    }
+
+    RunJobs(0);
+    m_jobSystem->Wait(workers);
+
+    m_jobs = nullptr;
+    m_record = nullptr;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.recordMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void ParallelCommandRecorder::Execute()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t job = 0; job < m_stats.jobCount; ++job)
+    {
+        m_backend->ExecuteJob(job);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.executeMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void ParallelCommandRecorder::RunJobs(uint32_t worker)
+{
+    // Jobs are handed out dynamically so that uneven jobs balance across workers
+    uint32_t job;
+    while ((job = m_nextJob.fetch_add(1)) < m_stats.jobCount)
+    {
+        m_backend->BeginJob(worker, job);
+        (*m_record)(worker, (*m_jobs)[job]);
+        m_backend->EndJob(worker, job);
+    }
+}
@@ -0,0 +1,96 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace SampleCommon
+{
+    // A unit of recording work: a range of draws within one view.
+    struct RecordingJob
+    {
+        uint32_t viewIndex;
+        uint32_t firstDraw;
+        uint32_t drawCount;
+    };
+
+    // Per-frame statistics of the command recorder.
+    struct CommandRecordingStats
+    {
+        uint32_t jobCount;
+        uint32_t workerCount;
+        double   recordMilliseconds;
+        double   executeMilliseconds;
+    };
+
+    // Graphics API side of the command recorder. Each worker owns a recording
+    // context; each job is recorded into its own command list so that the
+    // lists can be replayed in job order regardless of which worker recorded them.
+    class ICommandRecordingBackend
+    {
+    public:
+        virtual ~ICommandRecordingBackend() {}
+
+        // Number of workers that can record concurrently (at least 1)
+        virtual uint32_t GetWorkerCount() const = 0;
+
+        // Called on the submitting thread before recording starts
+        virtual void PrepareJobs(uint32_t jobCount) = 0;
+
+        // Called on the worker thread around the recording of a job
+        virtual void BeginJob(uint32_t worker, uint32_t job) = 0;
+        virtual void EndJob(uint32_t worker, uint32_t job) = 0;
+
+        // Called on the submitting thread, in job order
+        virtual void ExecuteJob(uint32_t job) = 0;
+    };
+
+    // Splits per-view draw ranges into jobs, records them on the workers of
+    // a job system and replays the result in order.
+    class ParallelCommandRecorder
+    {
+    public:
+        typedef std::function<void(uint32_t worker, const RecordingJob &job)> RecordFunction;
+
+        ParallelCommandRecorder(ICommandRecordingBackend *backend, JobSystem *jobSystem);
+
+        // Appends the jobs for one view, with at most drawsPerJob draws each
+        static void SplitJobs(
+            uint32_t viewIndex,
+            uint32_t drawCount,
+            uint32_t drawsPerJob,
+            std::vector<RecordingJob> &jobs);
+
+        // Records all jobs. The calling thread takes part as worker 0 and
+        // the call returns once every job has been recorded; while it waits,
+        // it may also run other jobs of the job system.
+        void Record(const std::vector<RecordingJob> &jobs, const RecordFunction &record);
+
+        // Replays the recorded jobs in submission order
+        void Execute();
+
+        const CommandRecordingStats& GetStats() const { return m_stats; }
+
+    private:
+        void RunJobs(uint32_t worker);
+
+        ICommandRecordingBackend *m_backend;
+        JobSystem *m_jobSystem;
+
+        // Work of the current Record() call
+        const std::vector<RecordingJob> *m_jobs;
+        const RecordFunction *m_record;
+        std::atomic<uint32_t> m_nextJob;
+
+        CommandRecordingStats m_stats;
+    };
+} // namespace SampleCommon
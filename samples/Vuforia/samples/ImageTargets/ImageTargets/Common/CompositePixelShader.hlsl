@@ -0,0 +1,56 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+cbuffer CompositeConstantBuffer : register(b0)
+{
+    // xy: scale from back buffer pixels to texture coordinates,
+    // zw: highest texture coordinates written at the current scale
+    float4 texcoordScaleAndMax;
+
+    // Viewport composited, in back buffer pixels: x, y, width, height
+    float4 viewport;
+
+    // Rows of the homography from the viewport's normalized device
+    // coordinates to those the target is sampled at
+    float4 homography[3];
+};
+
+struct PixelShaderInput
+{
+    float4 pos : SV_POSITION;
+    float2 ndc : TEXCOORD0;
+};
+
+Texture2D Texture : register(t0);
+sampler Sampler : register(s0);
+
+float4 main(PixelShaderInput input) : SV_TARGET
+{
+    // Interpolated from the corners, as feature level 9 can't read SV_POSITION
+    float2 ndc = input.ndc;
+
+    // Where the pixel was rendered, before reprojection
+    float3 source = float3(
+        dot(homography[0].xyz, float3(ndc, 1.0f)),
+        dot(homography[1].xyz, float3(ndc, 1.0f)),
+        dot(homography[2].xyz, float3(ndc, 1.0f)));
+    if (source.z <= 0.0f)
+    {
+        return float4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    // Nothing was rendered outside of the viewport, and in stereo that
+    // part of the target belongs to the other eye
+    float2 sourceNdc = source.xy / source.z;
+    if (any(abs(sourceNdc) > 1.0f))
+    {
+        return float4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    float2 sourcePos = viewport.xy + (sourceNdc * float2(0.5f, -0.5f) + 0.5f) * viewport.zw;
+    float2 texcoord = min(sourcePos * texcoordScaleAndMax.xy, texcoordScaleAndMax.zw);
+    return Texture.Sample(Sampler, texcoord);
+}
@@ -0,0 +1,28 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+struct VertexShaderInput
+{
+    float2 pos : POSITION;
+};
+
+struct PixelShaderInput
+{
+    float4 pos : SV_POSITION;
+    float2 ndc : TEXCOORD0;
+};
+
+// Passes on the corners of a triangle covering the whole viewport, given in
+// normalized device coordinates. Those are handed to the pixel shader as
+// well, as feature level 9 has neither SV_VertexID nor SV_POSITION input.
+PixelShaderInput main(VertexShaderInput input)
+{
+    PixelShaderInput output;
+    output.pos = float4(input.pos, 0.0f, 1.0f);
+    output.ndc = input.pos;
+
+    return output;
+}
@@ -0,0 +1,146 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "ConstantBufferRing.h"
+#include "DirectXHelper.h"
+
+using namespace SampleCommon;
+using namespace Microsoft::WRL;
+
+ConstantBufferRing::ConstantBufferRing(
+    const std::shared_ptr<DX::DeviceResources>& deviceResources,
+    uint32_t capacity) :
+    m_deviceResources(deviceResources),
+    m_ring((capacity + BYTES_ALIGNMENT - 1) / BYTES_ALIGNMENT * BYTES_ALIGNMENT, BYTES_ALIGNMENT),
+    m_discardOnNextMap(true),
+    m_nextFenceValue(1)
+{
+    auto device = m_deviceResources->GetD3DDevice();
+
+    // Binding at an offset and appending without a discard both need
+    // Direct3D 11.1 support from the driver
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    HRESULT hr = device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options));
+    if (FAILED(hr) || !options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer)
+    {
+        return;
+    }
+
+    CD3D11_BUFFER_DESC bufferDesc(
+        m_ring.GetCapacity(),
+        D3D11_BIND_CONSTANT_BUFFER,
+        D3D11_USAGE_DYNAMIC,
+        D3D11_CPU_ACCESS_WRITE);
+
+    DX::ThrowIfFailed(
+        device->CreateBuffer(&bufferDesc, nullptr, &m_buffer)
+        );
+}
+
+void ConstantBufferRing::ReleaseResources()
+{
+    m_pendingFences.clear();
+    m_freeQueries.clear();
+    m_buffer.Reset();
+    m_ring.Reset();
+    m_deviceResources.reset();
+}
+
+void ConstantBufferRing::BeginFrame()
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+
+    while (!m_pendingFences.empty())
+    {
+        FrameFence &fence = m_pendingFences.front();
+        if (context->GetData(fence.query.Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            break;
+        }
+
+        m_ring.Retire(fence.fenceValue);
+        m_freeQueries.push_back(fence.query);
+        m_pendingFences.pop_front();
+    }
+}
+
+void ConstantBufferRing::EndFrame()
+{
+    if (!IsSupported())
+    {
+        return;
+    }
+
+    FrameFence fence;
+    if (!m_freeQueries.empty())
+    {
+        fence.query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+    }
+    else
+    {
+        CD3D11_QUERY_DESC queryDesc(D3D11_QUERY_EVENT);
+        DX::ThrowIfFailed(
+            m_deviceResources->GetD3DDevice()->CreateQuery(&queryDesc, &fence.query)
+            );
+    }
+
+    fence.fenceValue = m_nextFenceValue++;
+    m_deviceResources->GetD3DDeviceContext()->End(fence.query.Get());
+    m_ring.EndFrame(fence.fenceValue);
+    m_pendingFences.push_back(fence);
+}
+
+void* ConstantBufferRing::Map(uint32_t size, ConstantBufferAllocation &allocation)
+{
+    uint32_t offset;
+    bool wrapped;
+    if (!m_ring.Allocate(size, offset, wrapped))
+    {
+        if (size > m_ring.GetCapacity())
+        {
+            return nullptr;
+        }
+
+        // The ring is full of frames still in flight. Discarding hands us
+        // fresh memory while the GPU keeps reading the old contents.
+        m_ring.Reset();
+        m_ring.Allocate(size, offset, wrapped);
+        wrapped = true;
+    }
+
+    D3D11_MAP mapType = (wrapped || m_discardOnNextMap) ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+    m_discardOnNextMap = false;
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    DX::ThrowIfFailed(
+        m_deviceResources->GetD3DDeviceContext()->Map(m_buffer.Get(), 0, mapType, 0, &mapped)
+        );
+
+    uint32_t alignedSize = (size + BYTES_ALIGNMENT - 1) / BYTES_ALIGNMENT * BYTES_ALIGNMENT;
+    allocation.buffer = m_buffer.Get();
+    allocation.firstConstant = offset / 16;
+    allocation.numConstants = alignedSize / 16;
+
+    return static_cast<uint8_t*>(mapped.pData) + offset;
+}
+
+void ConstantBufferRing::Unmap()
+{
+    m_deviceResources->GetD3DDeviceContext()->Unmap(m_buffer.Get(), 0);
+}
+
+ConstantBufferAllocation ConstantBufferRing::GetElement(const ConstantBufferAllocation &allocation, uint32_t index)
+{
+    ConstantBufferAllocation element = {
+        allocation.buffer,
+        allocation.firstConstant + index * CONSTANTS_ALIGNMENT,
+        CONSTANTS_ALIGNMENT
+    };
+    return element;
+}
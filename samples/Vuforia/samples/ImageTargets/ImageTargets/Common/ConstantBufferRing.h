@@ -0,0 +1,87 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "DeviceResources.h"
+#include "RingAllocator.h"
+
+#include <memory>
+#include <vector>
+#include <wrl.h>
+#include <d3d11_3.h>
+
+namespace SampleCommon
+{
+    // A range of the constant buffer ring, ready to be bound with
+    // VSSetConstantBuffers1.
+    struct ConstantBufferAllocation
+    {
+        ID3D11Buffer *buffer;
+        UINT firstConstant;
+        UINT numConstants;
+    };
+
+    // Sub-allocates constant data from one large dynamic constant buffer.
+    // Allocations are appended with MAP_WRITE_NO_OVERWRITE, the buffer is
+    // discarded when the ring wraps, and event queries tell when the GPU is
+    // done with a frame so that its range can be reused.
+    //
+    // Requires constant buffer offsetting (Direct3D 11.1); callers must
+    // check IsSupported() and fall back to UpdateSubresource1 otherwise.
+    class ConstantBufferRing
+    {
+    public:
+        // Bindings must start on and span multiples of 16 constants
+        static const UINT CONSTANTS_ALIGNMENT = 16;
+        static const UINT BYTES_ALIGNMENT = CONSTANTS_ALIGNMENT * 16;
+
+        ConstantBufferRing(const std::shared_ptr<DX::DeviceResources>& deviceResources, uint32_t capacity);
+
+        void ReleaseResources();
+
+        bool IsSupported() const { return m_buffer != nullptr; }
+
+        // Reclaims the ranges of frames the GPU has finished with
+        void BeginFrame();
+
+        // Closes the frame; its ranges are reused once the GPU is done with them
+        void EndFrame();
+
+        // Maps size bytes on the immediate context. The returned pointer is
+        // valid until Unmap(), which must be called before drawing. Bind the
+        // allocation before the next Map(), which may discard the buffer.
+        // Returns nullptr if size exceeds the capacity of the ring.
+        void* Map(uint32_t size, ConstantBufferAllocation &allocation);
+        void Unmap();
+
+        // Binding of the element at index in an allocation made of
+        // consecutive elements of BYTES_ALIGNMENT bytes each
+        static ConstantBufferAllocation GetElement(const ConstantBufferAllocation &allocation, uint32_t index);
+
+        const RingAllocatorStats& GetStats() const { return m_ring.GetStats(); }
+
+    private:
+        // Cached pointer to device resources.
+        std::shared_ptr<DX::DeviceResources> m_deviceResources;
+
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_buffer;
+        RingAllocator m_ring;
+
+        // The first map of the buffer has to discard
+        bool m_discardOnNextMap;
+
+        // Event queries of the frames in flight, with their fence values
+        struct FrameFence
+        {
+            Microsoft::WRL::ComPtr<ID3D11Query> query;
+            uint64_t fenceValue;
+        };
+        std::deque<FrameFence> m_pendingFences;
+        std::vector<Microsoft::WRL::ComPtr<ID3D11Query>> m_freeQueries;
+        uint64_t m_nextFenceValue;
+    };
+} // namespace SampleCommon
@@ -0,0 +1,90 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "D3D11CommandRecordingBackend.h"
+#include "DirectXHelper.h"
+
+using namespace SampleCommon;
+using namespace Microsoft::WRL;
+
+D3D11CommandRecordingBackend::D3D11CommandRecordingBackend(
+    const std::shared_ptr<DX::DeviceResources>& deviceResources,
+    uint32_t workerCount) :
+    m_deviceResources(deviceResources)
+{
+    m_viewport = m_deviceResources->GetScreenViewport();
+
+    workerCount = (workerCount > 0) ? workerCount : 1;
+    m_deferredContexts.resize(workerCount);
+
+    for (auto &context : m_deferredContexts)
+    {
+        DX::ThrowIfFailed(
+            m_deviceResources->GetD3DDevice()->CreateDeferredContext3(0, &context)
+            );
+    }
+}
+
+void D3D11CommandRecordingBackend::ReleaseResources()
+{
+    m_commandLists.clear();
+    m_deferredContexts.clear();
+    m_renderTargetView.Reset();
+    m_depthStencilView.Reset();
+    m_deviceResources.reset();
+}
+
+void D3D11CommandRecordingBackend::PrepareJobs(uint32_t jobCount)
+{
+    m_commandLists.clear();
+    m_commandLists.resize(jobCount);
+
+    // Jobs record into the viewport and targets the immediate context
+    // currently uses; the viewport spans both eyes when rendering stereo
+    // views, and the targets may be an offscreen pass
+    auto immediateContext = m_deviceResources->GetD3DDeviceContext();
+    UINT viewportCount = 1;
+    immediateContext->RSGetViewports(&viewportCount, &m_viewport);
+    if (viewportCount == 0)
+    {
+        m_viewport = m_deviceResources->GetScreenViewport();
+    }
+
+    immediateContext->OMGetRenderTargets(1, m_renderTargetView.ReleaseAndGetAddressOf(), m_depthStencilView.ReleaseAndGetAddressOf());
+    if (m_renderTargetView == nullptr)
+    {
+        m_renderTargetView = m_deviceResources->GetBackBufferRenderTargetView();
+        m_depthStencilView = m_deviceResources->GetDepthStencilView();
+    }
+}
+
+void D3D11CommandRecordingBackend::BeginJob(uint32_t worker, uint32_t job)
+{
+    // Deferred contexts start each command list from the default pipeline
+    // state, so the output merger and viewport have to be set up per job
+    auto context = m_deferredContexts[worker].Get();
+
+    context->RSSetViewports(1, &m_viewport);
+
+    ID3D11RenderTargetView *const targets[1] = { m_renderTargetView.Get() };
+    context->OMSetRenderTargets(1, targets, m_depthStencilView.Get());
+}
+
+void D3D11CommandRecordingBackend::EndJob(uint32_t worker, uint32_t job)
+{
+    DX::ThrowIfFailed(
+        m_deferredContexts[worker]->FinishCommandList(FALSE, &m_commandLists[job])
+        );
+}
+
+void D3D11CommandRecordingBackend::ExecuteJob(uint32_t job)
+{
+    // Keep the immediate context state, later passes may rely on it
+    m_deviceResources->GetD3DDeviceContext()->ExecuteCommandList(m_commandLists[job].Get(), TRUE);
+    m_commandLists[job].Reset();
+}
@@ -0,0 +1,50 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "DeviceResources.h"
+#include "CommandRecorder.h"
+
+#include <wrl.h>
+#include <d3d11_3.h>
+
+namespace SampleCommon
+{
+    // Records jobs on D3D11 deferred contexts, one per worker, and replays
+    // the resulting command lists on the immediate context.
+    class D3D11CommandRecordingBackend : public ICommandRecordingBackend
+    {
+    public:
+        D3D11CommandRecordingBackend(
+            const std::shared_ptr<DX::DeviceResources>& deviceResources,
+            uint32_t workerCount);
+
+        void ReleaseResources();
+
+        // The context a worker must record its draws on
+        ID3D11DeviceContext3* GetContext(uint32_t worker) const { return m_deferredContexts[worker].Get(); }
+
+        // ICommandRecordingBackend
+        virtual uint32_t GetWorkerCount() const override { return static_cast<uint32_t>(m_deferredContexts.size()); }
+        virtual void PrepareJobs(uint32_t jobCount) override;
+        virtual void BeginJob(uint32_t worker, uint32_t job) override;
+        virtual void EndJob(uint32_t worker, uint32_t job) override;
+        virtual void ExecuteJob(uint32_t job) override;
+
+    private:
+        // Cached pointer to device resources.
+        std::shared_ptr<DX::DeviceResources> m_deviceResources;
+
+        std::vector<Microsoft::WRL::ComPtr<ID3D11DeviceContext3>> m_deferredContexts;
+        std::vector<Microsoft::WRL::ComPtr<ID3D11CommandList>> m_commandLists;
+
+        // Viewport and targets of the jobs being recorded
+        D3D11_VIEWPORT m_viewport;
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_renderTargetView;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+    };
+} // namespace SampleCommon
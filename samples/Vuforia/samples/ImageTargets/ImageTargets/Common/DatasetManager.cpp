@@ -0,0 +1,413 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "DatasetManager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace SampleCommon;
+
+DatasetManager::DatasetManager(int datasetCount, size_t memoryBudgetBytes, int prefetchCount,
+    const DatasetLoadFunction &load, const DatasetUnloadFunction &unload) :
+    m_load(load),
+    m_unload(unload),
+    m_datasetCount(datasetCount),
+    m_memoryBudgetBytes(memoryBudgetBytes),
+    m_prefetchCount(prefetchCount),
+    m_active(-1),
+    m_reserved(-1),
+    m_useClock(0),
+    m_shutdown(false)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    Dataset dataset;
+    memset(&dataset, 0, sizeof(dataset));
+    dataset.state = DATASET_UNLOADED;
+    m_datasets.assign(datasetCount, dataset);
+    m_transitions.assign(datasetCount * datasetCount, 0);
+
+    // Predictions are made on the tracking thread, without allocating
+    m_predicted.reserve(prefetchCount + 1);
+
+    m_thread = std::thread(&DatasetManager::ThreadLoop, this);
+}
+
+DatasetManager::~DatasetManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_queueCondition.notify_all();
+    m_stateCondition.notify_all();
+    m_thread.join();
+}
+
+bool DatasetManager::Acquire(int dataset)
+{
+    Clock::time_point start = Clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Dataset &entry = m_datasets[dataset];
+    m_stats.acquires++;
+    m_reserved = dataset;
+
+    bool loading = (entry.state == DATASET_LOADING);
+    m_stateCondition.wait(lock, [this, dataset]() { return !IsBusy(dataset); });
+
+    bool acquired = true;
+    if (m_shutdown)
+    {
+        acquired = false;
+    }
+    else if (entry.state == DATASET_LOADED)
+    {
+        if (loading)
+        {
+            m_stats.inFlightHits++;
+        }
+        else
+        {
+            m_stats.hits++;
+        }
+        if (entry.prefetched)
+        {
+            m_stats.prefetchHits++;
+        }
+    }
+    else
+    {
+        // Loaded by the I/O thread, next, which keeps the loads serialized
+        // and within the budget
+        m_stats.misses++;
+        entry.demanded = true;
+        Enqueue(dataset, true);
+        m_queueCondition.notify_one();
+        m_stateCondition.wait(lock, [this, &entry]() { return m_shutdown || !entry.demanded; });
+        acquired = (entry.state == DATASET_LOADED);
+    }
+
+    entry.prefetched = false;
+    entry.lastUsed = ++m_useClock;
+
+    double milliseconds = Milliseconds(start, Clock::now());
+    m_stats.lastAcquireMilliseconds = milliseconds;
+    m_stats.maxAcquireMilliseconds = (std::max)(m_stats.maxAcquireMilliseconds, milliseconds);
+    return acquired;
+}
+
+void DatasetManager::OnActivated(int previous, int dataset, double activateMilliseconds)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active = dataset;
+        if (m_reserved == dataset)
+        {
+            m_reserved = -1;
+        }
+
+        // The one deactivated is the most likely to be kept
+        if (previous >= 0)
+        {
+            m_datasets[previous].lastUsed = ++m_useClock;
+            m_transitions[previous * m_datasetCount + dataset]++;
+        }
+
+        m_stats.lastActivateMilliseconds = activateMilliseconds;
+        m_stats.maxActivateMilliseconds = (std::max)(m_stats.maxActivateMilliseconds, activateMilliseconds);
+
+        Predict(dataset, m_predicted);
+        for (int next : m_predicted)
+        {
+            Enqueue(next, false);
+        }
+    }
+    m_queueCondition.notify_one();
+}
+
+void DatasetManager::Hint(int dataset)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Enqueue(dataset, true);
+    }
+    m_queueCondition.notify_one();
+}
+
+void DatasetManager::UnloadAll()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (int dataset : m_queue)
+    {
+        m_datasets[dataset].queued = false;
+        m_datasets[dataset].demanded = false;
+    }
+    m_queue.clear();
+    m_stateCondition.notify_all();
+    m_active = -1;
+    m_reserved = -1;
+
+    m_stateCondition.wait(lock, [this]()
+    {
+        for (int dataset = 0; dataset < m_datasetCount; dataset++)
+        {
+            if (IsBusy(dataset))
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    for (int dataset = 0; dataset < m_datasetCount; dataset++)
+    {
+        Dataset &entry = m_datasets[dataset];
+        if (entry.state != DATASET_LOADED)
+        {
+            continue;
+        }
+
+        entry.state = DATASET_UNLOADING;
+        m_stats.loadedCount--;
+        m_stats.loadedBytes -= entry.bytes;
+        lock.unlock();
+
+        m_unload(dataset);
+
+        lock.lock();
+        entry.state = DATASET_UNLOADED;
+        entry.prefetched = false;
+    }
+    m_stateCondition.notify_all();
+}
+
+DatasetManagerStats DatasetManager::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void DatasetManager::FormatReport(std::string &text)
+{
+    DatasetManagerStats stats = GetStats();
+    char buffer[160];
+
+    snprintf(buffer, sizeof(buffer), "datasets: %u loaded, %.1f of %.1f MB\n",
+        stats.loadedCount, stats.loadedBytes / (1024.0 * 1024.0), m_memoryBudgetBytes / (1024.0 * 1024.0));
+    text += buffer;
+    snprintf(buffer, sizeof(buffer), "  acquires: %u, %u loaded, %u loading, %u not loaded\n",
+        stats.acquires, stats.hits, stats.inFlightHits, stats.misses);
+    text += buffer;
+    snprintf(buffer, sizeof(buffer), "  prefetches: %u, %u used; evictions: %u; load failures: %u\n",
+        stats.prefetches, stats.prefetchHits, stats.evictions, stats.loadFailures);
+    text += buffer;
+    snprintf(buffer, sizeof(buffer), "  load: last %.1f ms, mean %.1f ms, max %.1f ms\n",
+        stats.lastLoadMilliseconds,
+        (stats.loads > 0) ? stats.totalLoadMilliseconds / stats.loads : 0.0,
+        stats.maxLoadMilliseconds);
+    text += buffer;
+    snprintf(buffer, sizeof(buffer), "  acquire: last %.1f ms, max %.1f ms; activate: last %.1f ms, max %.1f ms\n",
+        stats.lastAcquireMilliseconds, stats.maxAcquireMilliseconds,
+        stats.lastActivateMilliseconds, stats.maxActivateMilliseconds);
+    text += buffer;
+}
+
+void DatasetManager::ThreadLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_queueCondition.wait(lock, [this]() { return m_shutdown || !m_queue.empty(); });
+        if (m_shutdown)
+        {
+            break;
+        }
+
+        int dataset = m_queue.front();
+        m_queue.pop_front();
+        Dataset &entry = m_datasets[dataset];
+        entry.queued = false;
+        bool demanded = entry.demanded;
+        if (entry.state == DATASET_UNLOADED && (demanded || FitsWithPinned(dataset)))
+        {
+            if (!demanded)
+            {
+                m_stats.prefetches++;
+            }
+            Load(lock, dataset, !demanded);
+        }
+
+        if (demanded)
+        {
+            entry.demanded = false;
+            m_stateCondition.notify_all();
+        }
+    }
+}
+
+bool DatasetManager::Load(std::unique_lock<std::mutex> &lock, int dataset, bool prefetch)
+{
+    Dataset &entry = m_datasets[dataset];
+    entry.state = DATASET_LOADING;
+
+    // Room is made ahead for a dataset loaded before, whose size is known
+    EvictOverBudget(lock, entry.bytes);
+    lock.unlock();
+
+    size_t bytes = 0;
+    Clock::time_point start = Clock::now();
+    bool loaded = m_load(dataset, bytes);
+    double milliseconds = Milliseconds(start, Clock::now());
+
+    lock.lock();
+    if (loaded)
+    {
+        entry.state = DATASET_LOADED;
+        entry.bytes = bytes;
+        entry.lastUsed = ++m_useClock;
+        entry.prefetched = prefetch;
+
+        m_stats.loadedCount++;
+        m_stats.loadedBytes += bytes;
+        m_stats.loads++;
+        m_stats.lastLoadMilliseconds = milliseconds;
+        m_stats.maxLoadMilliseconds = (std::max)(m_stats.maxLoadMilliseconds, milliseconds);
+        m_stats.totalLoadMilliseconds += milliseconds;
+    }
+    else
+    {
+        entry.state = DATASET_UNLOADED;
+        m_stats.loadFailures++;
+    }
+    m_stateCondition.notify_all();
+
+    EvictOverBudget(lock, 0);
+    return loaded;
+}
+
+void DatasetManager::EvictOverBudget(std::unique_lock<std::mutex> &lock, size_t incomingBytes)
+{
+    while (m_stats.loadedBytes + incomingBytes > m_memoryBudgetBytes)
+    {
+        int victim = -1;
+        for (int dataset = 0; dataset < m_datasetCount; dataset++)
+        {
+            const Dataset &entry = m_datasets[dataset];
+            if (entry.state == DATASET_LOADED && !IsPinned(dataset) &&
+                (victim < 0 || entry.lastUsed < m_datasets[victim].lastUsed))
+            {
+                victim = dataset;
+            }
+        }
+        if (victim < 0)
+        {
+            // Only pinned datasets left, which are kept over budget
+            break;
+        }
+
+        Dataset &entry = m_datasets[victim];
+        entry.state = DATASET_UNLOADING;
+        m_stats.loadedCount--;
+        m_stats.loadedBytes -= entry.bytes;
+        m_stats.evictions++;
+        lock.unlock();
+
+        m_unload(victim);
+
+        lock.lock();
+        entry.state = DATASET_UNLOADED;
+        entry.prefetched = false;
+        m_stateCondition.notify_all();
+    }
+}
+
+void DatasetManager::Predict(int dataset, std::vector<int> &predicted) const
+{
+    predicted.clear();
+    const uint32_t *counts = &m_transitions[dataset * m_datasetCount];
+    for (int next = 0; next < m_datasetCount; next++)
+    {
+        if (next == dataset || counts[next] == 0)
+        {
+            continue;
+        }
+
+        // Kept sorted, most first, and cut to prefetchCount
+        auto position = std::find_if(predicted.begin(), predicted.end(),
+            [counts, next](int other) { return counts[other] < counts[next]; });
+        if (position - predicted.begin() < m_prefetchCount)
+        {
+            predicted.insert(position, next);
+            if (static_cast<int>(predicted.size()) > m_prefetchCount)
+            {
+                predicted.pop_back();
+            }
+        }
+    }
+}
+
+bool DatasetManager::FitsWithPinned(int dataset) const
+{
+    // Not prefetched if it is known not to fit along with the pinned ones
+    size_t pinnedBytes = 0;
+    for (int pinned = 0; pinned < m_datasetCount; pinned++)
+    {
+        if (IsPinned(pinned) && m_datasets[pinned].state != DATASET_UNLOADED)
+        {
+            pinnedBytes += m_datasets[pinned].bytes;
+        }
+    }
+    return m_datasets[dataset].bytes + pinnedBytes <= m_memoryBudgetBytes;
+}
+
+void DatasetManager::Enqueue(int dataset, bool front)
+{
+    Dataset &entry = m_datasets[dataset];
+    if (entry.state != DATASET_UNLOADED)
+    {
+        return;
+    }
+
+    if (entry.queued)
+    {
+        if (!front)
+        {
+            return;
+        }
+        m_queue.erase(std::find(m_queue.begin(), m_queue.end(), dataset));
+    }
+
+    entry.queued = true;
+    if (front)
+    {
+        auto position = m_queue.begin();
+        while (!entry.demanded && position != m_queue.end() && m_datasets[*position].demanded)
+        {
+            ++position;
+        }
+        m_queue.insert(position, dataset);
+    }
+    else
+    {
+        m_queue.push_back(dataset);
+    }
+}
+
+bool DatasetManager::IsBusy(int dataset) const
+{
+    DatasetState state = m_datasets[dataset].state;
+    return state == DATASET_LOADING || state == DATASET_UNLOADING;
+}
+
+double DatasetManager::Milliseconds(Clock::time_point from, Clock::time_point to)
+{
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
@@ -0,0 +1,170 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SampleCommon
+{
+    // Creates and loads a dataset; bytes is set to the memory it takes,
+    // e.g. the size of its .dat file. Returns false if it couldn't.
+    typedef std::function<bool(int dataset, size_t &bytes)> DatasetLoadFunction;
+
+    // Deactivates the dataset if it is active, and destroys it
+    typedef std::function<void(int dataset)> DatasetUnloadFunction;
+
+    struct DatasetManagerStats
+    {
+        // Acquire() calls: with the dataset loaded, loading on the I/O
+        // thread, or not loaded at all
+        uint32_t acquires;
+        uint32_t hits;
+        uint32_t inFlightHits;
+        uint32_t misses;
+
+        // Prefetches started, and how many were acquired before evicted
+        uint32_t prefetches;
+        uint32_t prefetchHits;
+
+        uint32_t evictions;
+        uint32_t loadFailures;
+
+        uint32_t loadedCount;
+        size_t loadedBytes;
+
+        double lastLoadMilliseconds;
+        double maxLoadMilliseconds;
+        double totalLoadMilliseconds;
+        uint32_t loads;
+
+        // Time Acquire() blocked its caller
+        double lastAcquireMilliseconds;
+        double maxAcquireMilliseconds;
+
+        double lastActivateMilliseconds;
+        double maxActivateMilliseconds;
+    };
+
+    // Keeps the datasets of a catalog loaded ahead of being activated.
+    //
+    // The active dataset, and the one acquired to be activated next, stay
+    // loaded; the other loaded datasets are kept, least recently used
+    // first out, while they fit in the memory budget. An I/O thread loads
+    // the datasets likely to be asked for next: those hinted at by the
+    // app, then those most often activated after the active one. The
+    // datasets acquired without being loaded are loaded on that thread
+    // too, so that two loads never run at once.
+    class DatasetManager
+    {
+    public:
+        // prefetchCount is how many of the datasets most often activated
+        // after the active one are prefetched
+        DatasetManager(int datasetCount, size_t memoryBudgetBytes, int prefetchCount,
+            const DatasetLoadFunction &load, const DatasetUnloadFunction &unload);
+
+        // Waits for a dataset being loaded; the datasets aren't unloaded
+        ~DatasetManager();
+
+        // Loads the dataset, if it isn't, before it is activated: the I/O
+        // thread loads it ahead of any prefetch while the caller waits. Waits
+        // for it if it is being prefetched. Returns false if it couldn't be.
+        bool Acquire(int dataset);
+
+        // Once the acquired dataset is active, previous is -1 if there was
+        // none; queues the prefetch of the datasets likely to be next
+        void OnActivated(int previous, int dataset, double activateMilliseconds);
+
+        // Queues the prefetch of a dataset the app expects to be asked for,
+        // ahead of those predicted
+        void Hint(int dataset);
+
+        // Drops the queued prefetches, fails the pending acquires and
+        // unloads every dataset, once none is being loaded; the usage
+        // history is kept
+        void UnloadAll();
+
+        DatasetManagerStats GetStats();
+        void FormatReport(std::string &text);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        enum DatasetState
+        {
+            DATASET_UNLOADED,
+            DATASET_LOADING,
+            DATASET_LOADED,
+            DATASET_UNLOADING
+        };
+
+        struct Dataset
+        {
+            DatasetState state;
+            size_t bytes;       // 0 until loaded once
+            uint64_t lastUsed;  // m_useClock when last acquired or deactivated
+            bool prefetched;    // loaded by a prefetch, not acquired since
+            bool queued;
+            bool demanded;      // queued for an Acquire() waiting for it
+        };
+
+        DatasetManager(const DatasetManager&) = delete;
+        DatasetManager& operator=(const DatasetManager&) = delete;
+
+        void ThreadLoop();
+
+        // Called with the lock held, which is released while loading or
+        // unloading. Evicts until incomingBytes more fit in the budget.
+        bool Load(std::unique_lock<std::mutex> &lock, int dataset, bool prefetch);
+        void EvictOverBudget(std::unique_lock<std::mutex> &lock, size_t incomingBytes);
+
+        // The datasets most often activated after this one, most first
+        void Predict(int dataset, std::vector<int> &predicted) const;
+
+        // Queued at the front, prefetches go behind the demanded datasets
+        void Enqueue(int dataset, bool front);
+        bool IsPinned(int dataset) const { return dataset == m_active || dataset == m_reserved; }
+        bool IsBusy(int dataset) const;
+        bool FitsWithPinned(int dataset) const;
+
+        static double Milliseconds(Clock::time_point from, Clock::time_point to);
+
+        DatasetLoadFunction m_load;
+        DatasetUnloadFunction m_unload;
+        const int m_datasetCount;
+        const size_t m_memoryBudgetBytes;
+        const int m_prefetchCount;
+
+        std::mutex m_mutex;
+        std::condition_variable m_queueCondition;
+        std::condition_variable m_stateCondition;
+
+        // Guarded by the mutex
+        std::vector<Dataset> m_datasets;
+        std::deque<int> m_queue;
+        int m_active;
+        int m_reserved;     // acquired and not yet activated, or -1
+        uint64_t m_useClock;
+        bool m_shutdown;
+        DatasetManagerStats m_stats;
+
+        // Times each dataset was activated after each other one, row by
+        // the one active before
+        std::vector<uint32_t> m_transitions;
+        std::vector<int> m_predicted;
+
+        std::thread m_thread;
+    };
+} // namespace SampleCommon
@@ -0,0 +1,218 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "DatasetSwitcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace SampleCommon;
+
+DatasetSwitcher::DatasetSwitcher(const DatasetPrepareFunction &prepare, const DatasetActivateFunction &activate) :
+    m_prepare(prepare),
+    m_activate(activate),
+    m_generation(0),
+    m_active(-1),
+    m_requested(-1),
+    m_prepared(-1),
+    m_preparing(false),
+    m_activating(-1),
+    m_shutdown(false),
+    m_swapReady(false),
+    m_swapFrame(-1)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_thread = std::thread(&DatasetSwitcher::ThreadLoop, this);
+}
+
+DatasetSwitcher::~DatasetSwitcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_requestCondition.notify_all();
+    m_thread.join();
+}
+
+void DatasetSwitcher::Reset(int activeDataset)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_generation++;
+    m_requested = -1;
+    m_prepared = -1;
+    m_swapReady = false;
+    m_idleCondition.wait(lock, [this]() { return !m_preparing && m_activating < 0; });
+    m_active = activeDataset;
+}
+
+void DatasetSwitcher::RequestSwitch(int dataset)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_active < 0)
+    {
+        return;
+    }
+
+    m_stats.requests++;
+    if (m_requested >= 0)
+    {
+        m_stats.coalesced++;
+    }
+
+    m_prepared = -1;
+    m_swapReady = false;
+    if (dataset == GetCurrentDataset())
+    {
+        // Back to the active dataset: nothing to switch
+        m_requested = -1;
+        return;
+    }
+
+    m_requested = dataset;
+    m_requestTime = Clock::now();
+    m_requestCondition.notify_one();
+}
+
+bool DatasetSwitcher::OnFrameBoundary(int64_t frameIndex)
+{
+    // Frames the tracking thread missed while it activated the last dataset
+    if (m_swapFrame >= 0)
+    {
+        int64_t gapFrames = (std::max)(frameIndex - m_swapFrame - 1, static_cast<int64_t>(0));
+        m_swapFrame = -1;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.lastGapFrames = gapFrames;
+        m_stats.maxGapFrames = (std::max)(m_stats.maxGapFrames, gapFrames);
+    }
+
+    if (!m_swapReady.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    int previous;
+    int dataset;
+    uint64_t generation;
+    Clock::time_point requestTime;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_prepared < 0)
+        {
+            return false;
+        }
+        previous = m_active;
+        dataset = m_prepared;
+        generation = m_generation;
+        requestTime = m_requestTime;
+        m_prepared = -1;
+        m_requested = -1;
+        m_swapReady = false;
+        m_activating = dataset;
+    }
+
+    Clock::time_point start = Clock::now();
+    bool activated = m_activate(previous, dataset);
+    Clock::time_point end = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activating = -1;
+        if (generation == m_generation && activated)
+        {
+            m_active = dataset;
+        }
+
+        double milliseconds = Milliseconds(start, end);
+        m_stats.lastActivateMilliseconds = milliseconds;
+        m_stats.maxActivateMilliseconds = (std::max)(m_stats.maxActivateMilliseconds, milliseconds);
+        m_stats.lastRequestToSwapMilliseconds = Milliseconds(requestTime, end);
+        if (activated)
+        {
+            m_stats.swaps++;
+        }
+        else
+        {
+            m_stats.failures++;
+        }
+    }
+    m_idleCondition.notify_all();
+
+    m_swapFrame = frameIndex;
+    return activated;
+}
+
+int DatasetSwitcher::GetTargetDataset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (m_requested >= 0) ? m_requested : GetCurrentDataset();
+}
+
+int DatasetSwitcher::GetActiveDataset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_active;
+}
+
+DatasetSwitchStats DatasetSwitcher::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void DatasetSwitcher::ThreadLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        // A requested dataset already prepared waits for its swap
+        m_requestCondition.wait(lock, [this]()
+        {
+            return m_shutdown || (m_requested >= 0 && m_prepared != m_requested);
+        });
+        if (m_shutdown)
+        {
+            break;
+        }
+
+        int dataset = m_requested;
+        uint64_t generation = m_generation;
+        m_preparing = true;
+        lock.unlock();
+
+        Clock::time_point start = Clock::now();
+        bool prepared = m_prepare(dataset);
+        double milliseconds = Milliseconds(start, Clock::now());
+
+        lock.lock();
+        m_preparing = false;
+        m_stats.lastPrepareMilliseconds = milliseconds;
+
+        // Dropped if it was reset or another dataset was asked for meanwhile
+        if (generation == m_generation && dataset == m_requested)
+        {
+            if (prepared)
+            {
+                m_prepared = dataset;
+                m_swapReady = true;
+            }
+            else
+            {
+                m_stats.failures++;
+                m_requested = -1;
+            }
+        }
+        m_idleCondition.notify_all();
+    }
+}
+
+double DatasetSwitcher::Milliseconds(Clock::time_point from, Clock::time_point to)
+{
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
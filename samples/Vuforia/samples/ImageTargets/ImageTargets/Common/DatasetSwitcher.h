@@ -0,0 +1,126 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace SampleCommon
+{
+    // Worker thread: gets a dataset ready to be activated, e.g. loads it.
+    // Returns false if it couldn't be.
+    typedef std::function<bool(int dataset)> DatasetPrepareFunction;
+
+    // Tracking thread: deactivates the dataset active before, if any, and
+    // activates the new one. Returns false if the new one isn't active.
+    typedef std::function<bool(int previous, int dataset)> DatasetActivateFunction;
+
+    struct DatasetSwitchStats
+    {
+        uint32_t requests;
+
+        // Requests replaced by a later one before their swap
+        uint32_t coalesced;
+        uint32_t swaps;
+        uint32_t failures;
+
+        double lastPrepareMilliseconds;
+
+        // Time the tracking thread spent in the swap
+        double lastActivateMilliseconds;
+        double maxActivateMilliseconds;
+
+        double lastRequestToSwapMilliseconds;
+
+        // Camera frames that went by without a tracking callback across
+        // the last swap, and the most across any swap
+        int64_t lastGapFrames;
+        int64_t maxGapFrames;
+    };
+
+    // Switches the active dataset without stalling the tracking thread for
+    // anything but the activation itself.
+    //
+    // Switches are asked for from any thread. A worker thread prepares the
+    // dataset asked for while the active one keeps tracking; once it is
+    // ready, the tracking thread activates it at its next frame boundary.
+    // Only the last dataset asked for is switched to: a request made while
+    // an earlier one is prepared replaces it.
+    class DatasetSwitcher
+    {
+    public:
+        DatasetSwitcher(const DatasetPrepareFunction &prepare, const DatasetActivateFunction &activate);
+
+        // Waits for a dataset being prepared
+        ~DatasetSwitcher();
+
+        // Sets the dataset active now, e.g. once the datasets are loaded,
+        // or -1 before they are unloaded. Pending switches are dropped, and
+        // a dataset being prepared or activated is waited for.
+        void Reset(int activeDataset);
+
+        // Ignored while no dataset is active
+        void RequestSwitch(int dataset);
+
+        // Tracking thread, once per camera frame, before the frame is used:
+        // activates a prepared dataset. Returns true if it did.
+        bool OnFrameBoundary(int64_t frameIndex);
+
+        // The dataset last asked for, or the active one if none is pending
+        int GetTargetDataset();
+        int GetActiveDataset();
+
+        DatasetSwitchStats GetStats();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        DatasetSwitcher(const DatasetSwitcher&) = delete;
+        DatasetSwitcher& operator=(const DatasetSwitcher&) = delete;
+
+        void ThreadLoop();
+
+        // The dataset being activated, or else the active one. Called with
+        // the mutex held.
+        int GetCurrentDataset() const { return (m_activating >= 0) ? m_activating : m_active; }
+
+        static double Milliseconds(Clock::time_point from, Clock::time_point to);
+
+        DatasetPrepareFunction m_prepare;
+        DatasetActivateFunction m_activate;
+
+        std::mutex m_mutex;
+        std::condition_variable m_requestCondition;
+        std::condition_variable m_idleCondition;
+
+        // Guarded by the mutex. A reset starts a new generation, the work
+        // of an earlier one is dropped.
+        uint64_t m_generation;
+        int m_active;
+        int m_requested;    // -1 if no switch is pending
+        int m_prepared;     // -1 until the requested dataset is ready
+        Clock::time_point m_requestTime;
+        bool m_preparing;
+        int m_activating;   // -1 unless the tracking thread activates a dataset
+        bool m_shutdown;
+        DatasetSwitchStats m_stats;
+
+        // Set while a prepared dataset waits, checked on every frame
+        // without taking the mutex
+        std::atomic<bool> m_swapReady;
+
+        // Tracking thread only: frame of the last swap, -1 once its gap is measured
+        int64_t m_swapFrame;
+
+        std::thread m_thread;
+    };
+} // namespace SampleCommon
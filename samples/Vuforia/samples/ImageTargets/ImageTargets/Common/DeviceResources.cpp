@@ -646,6 +646,10 @@ void DX::DeviceResources::RegisterDeviceNotify(DX::IDeviceNotify* deviceNotify)
 // is entering an idle state and that temporary buffers can be reclaimed for use by other apps.
 void DX::DeviceResources::Trim()
 {
+    // Only memory the context doesn't reference can be reclaimed; the
+    // resources themselves are kept, so resuming needs no reloading
+    m_d3dContext->ClearState();
+
     ComPtr<IDXGIDevice3> dxgiDevice;
     m_d3dDevice.As(&dxgiDevice);
 
@@ -0,0 +1,140 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace SampleCommon
+{
+    // Statistics of the frame pipeline: how prepared frames were handed from
+    // the tracking thread to the render thread, and how long each stage took.
+    struct FramePipelineStats
+    {
+        // Totals since the pipeline was created
+        uint32_t framesPrepared;
+        uint32_t framesRendered;
+        uint32_t framesDropped;   // replaced by a newer frame before being rendered
+        uint32_t framesRepeated;  // rendered again, no newer frame being ready
+
+        // Stage timings of the last rendered frame
+        double prepareMilliseconds;
+        double submitMilliseconds;
+        double presentMilliseconds;
+
+        // Time the stages of the last rendered frame waited for locks
+        double prepareLockWaitMilliseconds;
+        double renderLockWaitMilliseconds;
+
+        // Bytes of constant data the last rendered frame uploaded
+        uint32_t constantBufferBytes;
+    };
+
+    // Hands frames from one producer thread to one consumer thread without
+    // locks or waits.
+    //
+    // The producer fills the write buffer and publishes it; the consumer
+    // acquires the most recently published buffer and keeps it until its
+    // next Acquire(). A third buffer sits between them, so neither side ever
+    // touches the buffer the other is using. Frames the consumer did not
+    // take in time are dropped, and the consumer gets its current buffer
+    // again when nothing new was published.
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() :
+            m_writeIndex(0),
+            m_readIndex(2),
+            m_hasRead(false),
+            m_shared(1),
+            m_published(0),
+            m_dropped(0),
+            m_acquired(0),
+            m_repeated(0)
+        {
+        }
+
+        // Producer: the buffer to fill, left as it was the last time the
+        // producer used it so that its allocations can be reused
+        T& GetWriteBuffer() { return m_buffers[m_writeIndex]; }
+
+        // Producer: makes the write buffer the latest frame
+        void Publish()
+        {
+            uint32_t previous = m_shared.exchange(m_writeIndex | FRESH, std::memory_order_acq_rel);
+            m_writeIndex = previous & INDEX_MASK;
+            if ((previous & FRESH) != 0)
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_published.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Consumer: the latest published frame, or nullptr before the first
+        // one. The frame stays valid until the next call.
+        T* Acquire()
+        {
+            if ((m_shared.load(std::memory_order_relaxed) & FRESH) != 0)
+            {
+                uint32_t previous = m_shared.exchange(m_readIndex, std::memory_order_acq_rel);
+                m_readIndex = previous & INDEX_MASK;
+                m_hasRead = true;
+                m_acquired.fetch_add(1, std::memory_order_relaxed);
+            }
+            else if (m_hasRead)
+            {
+                m_repeated.fetch_add(1, std::memory_order_relaxed);
+            }
+            return m_hasRead ? &m_buffers[m_readIndex] : nullptr;
+        }
+
+        // Consumer: the latest published frame if it is newer than the one
+        // acquired last, otherwise nullptr, in which case that one stays
+        // valid. Unlike Acquire(), not finding a newer frame isn't counted
+        // as a repeat, so this can be used to check for a newer frame while
+        // rendering one.
+        T* AcquireNewer()
+        {
+            if ((m_shared.load(std::memory_order_relaxed) & FRESH) == 0)
+            {
+                return nullptr;
+            }
+
+            uint32_t previous = m_shared.exchange(m_readIndex, std::memory_order_acq_rel);
+            m_readIndex = previous & INDEX_MASK;
+            m_hasRead = true;
+            m_acquired.fetch_add(1, std::memory_order_relaxed);
+            return &m_buffers[m_readIndex];
+        }
+
+        uint32_t GetPublishedCount() const { return m_published.load(std::memory_order_relaxed); }
+        uint32_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+        uint32_t GetAcquiredCount() const { return m_acquired.load(std::memory_order_relaxed); }
+        uint32_t GetRepeatedCount() const { return m_repeated.load(std::memory_order_relaxed); }
+
+    private:
+        static const uint32_t INDEX_MASK = 0x3;
+        static const uint32_t FRESH = 0x4;
+
+        T m_buffers[3];
+
+        // Owned by the producer and by the consumer respectively
+        uint32_t m_writeIndex;
+        uint32_t m_readIndex;
+        bool m_hasRead;
+
+        // Index of the buffer in between, and whether it holds a frame
+        // the consumer has not seen yet
+        std::atomic<uint32_t> m_shared;
+
+        std::atomic<uint32_t> m_published;
+        std::atomic<uint32_t> m_dropped;
+        std::atomic<uint32_t> m_acquired;
+        std::atomic<uint32_t> m_repeated;
+    };
+} // namespace SampleCommon
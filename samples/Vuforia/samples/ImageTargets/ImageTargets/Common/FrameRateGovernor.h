@@ -0,0 +1,115 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace SampleCommon
+{
+    // Quality steps, from the best to the cheapest. Each step keeps the
+    // reductions of the steps before it.
+    enum QualityLevel
+    {
+        QUALITY_FULL,
+        QUALITY_REDUCED_TEXTURES,   // textures sampled from a smaller mip
+        QUALITY_HALF_RATE,          // every other camera frame rendered
+        QUALITY_FAST_CAMERA,        // camera switched to its speed optimized video mode
+        QUALITY_LEVEL_COUNT
+    };
+
+    struct FrameRateGovernorSettings
+    {
+        // Time a frame may take, usually the camera frame interval
+        double frameBudgetMilliseconds;
+
+        // Quality is lowered when overrunFrames of the last windowFrames
+        // rendered frames went over the budget
+        uint32_t windowFrames;
+        uint32_t overrunFrames;
+
+        // Quality is raised again after recoveryFrames rendered frames in a
+        // row took less than recoveryHeadroom of the budget
+        uint32_t recoveryFrames;
+        double recoveryHeadroom;
+
+        // After idleFrames camera frames without a tracked target, only one
+        // camera frame out of idleRenderInterval is rendered
+        uint32_t idleFrames;
+        uint32_t idleRenderInterval;
+
+        // The camera video mode needs a camera restart to change, so the
+        // last quality step can be left out
+        bool allowVideoModeChange;
+    };
+
+    // What the governor decided for a camera frame.
+    struct FrameRateDecision
+    {
+        bool render;
+        bool idle;
+        QualityLevel qualityLevel;
+
+        // Camera frames per rendered frame, the quality level and idling combined
+        uint32_t renderInterval;
+        float textureMipBias;
+        bool fastVideoMode;
+    };
+
+    struct FrameRateGovernorStats
+    {
+        uint32_t qualityStepsDown;
+        uint32_t qualityStepsUp;
+        uint32_t idlePeriods;
+        uint32_t framesSkipped;
+    };
+
+    // Decides, for each camera frame, whether it is rendered and at which
+    // quality. Nothing is rendered more often than needed while no target
+    // is tracked, and quality is stepped down while frames don't fit their
+    // budget. It has no clock or graphics state of its own, so that recorded
+    // traces of frame times can be replayed through it.
+    class FrameRateGovernor
+    {
+    public:
+        explicit FrameRateGovernor(const FrameRateGovernorSettings &settings);
+
+        // Suited to a 30 fps camera
+        static FrameRateGovernorSettings GetDefaultSettings();
+
+        // Called once per camera frame. tracking tells whether the frame has
+        // a tracked target; frameMilliseconds is the time taken by the last
+        // frame rendered since the previous call, or negative if there was none.
+        const FrameRateDecision& Update(bool tracking, double frameMilliseconds);
+
+        const FrameRateDecision& GetDecision() const { return m_decision; }
+        const FrameRateGovernorStats& GetStats() const { return m_stats; }
+
+    private:
+        void AddFrameTime(double frameMilliseconds);
+        void SetQualityLevel(QualityLevel level);
+        void UpdateDecision();
+
+        FrameRateGovernorSettings m_settings;
+        QualityLevel m_maxQualityLevel;
+
+        // Camera frames since the last tracked one, and since the last rendered one
+        uint32_t m_framesWithoutTracking;
+        uint32_t m_framesSinceRender;
+        bool m_wasTracking;
+
+        // Whether each of the last windowFrames rendered frames overran
+        std::vector<bool> m_overruns;
+        uint32_t m_nextOverrun;
+        uint32_t m_overrunCount;
+        uint32_t m_timedFrames;
+        uint32_t m_recoveredFrames;
+
+        FrameRateDecision m_decision;
+        FrameRateGovernorStats m_stats;
+    };
+} // namespace SampleCommon
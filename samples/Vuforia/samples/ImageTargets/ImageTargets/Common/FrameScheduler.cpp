@@ -0,0 +1,128 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "FrameScheduler.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace SampleCommon;
+
+const uint32_t FrameScheduler::WINDOW_SIZE;
+
+FrameScheduler::FrameScheduler() :
+    m_framesNotified(0),
+    m_framesTaken(0),
+    m_wakeRequested(false),
+    m_hasRendered(false),
+    m_waitMilliseconds(0.0),
+    m_sampleCount(0),
+    m_nextSample(0)
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void FrameScheduler::NotifyFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_framesNotified++;
+    }
+    m_condition.notify_one();
+}
+
+void FrameScheduler::Wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeRequested = true;
+    }
+    m_condition.notify_one();
+}
+
+FrameWakeReason FrameScheduler::WaitForFrame(uint32_t timeoutMilliseconds)
+{
+    FrameWakeReason reason = FRAME_WAKE_TIMEOUT;
+    auto start = Clock::now();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait_for(lock, std::chrono::milliseconds(timeoutMilliseconds), [this]() {
+            return m_framesNotified != m_framesTaken || m_wakeRequested;
+        });
+
+        if (m_framesNotified != m_framesTaken)
+        {
+            // Only the latest frame is rendered, the ones before it are skipped
+            m_stats.framesSkipped += m_framesNotified - m_framesTaken - 1;
+            m_framesTaken = m_framesNotified;
+            reason = FRAME_WAKE_NEW_FRAME;
+        }
+        else if (m_wakeRequested)
+        {
+            reason = FRAME_WAKE_REQUESTED;
+        }
+
+        // A new frame is redrawn anyway, so it also serves the wake
+        m_wakeRequested = false;
+        m_stats.framesNotified = m_framesNotified;
+    }
+
+    auto end = Clock::now();
+    m_waitMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+    return reason;
+}
+
+void FrameScheduler::FrameRendered(bool newFrame)
+{
+    auto now = Clock::now();
+
+    m_stats.framesRendered++;
+    if (!newFrame)
+    {
+        m_stats.framesDuplicated++;
+    }
+
+    // The first frame has no interval to measure
+    if (m_hasRendered)
+    {
+        Sample &sample = m_samples[m_nextSample];
+        sample.intervalMilliseconds = std::chrono::duration<double, std::milli>(now - m_lastRendered).count();
+        sample.waitMilliseconds = m_waitMilliseconds;
+        sample.duplicate = !newFrame;
+
+        m_nextSample = (m_nextSample + 1) % WINDOW_SIZE;
+        m_sampleCount = (m_sampleCount < WINDOW_SIZE) ? m_sampleCount + 1 : WINDOW_SIZE;
+
+        double intervalSum = 0.0;
+        double waitSum = 0.0;
+        uint32_t duplicates = 0;
+        for (uint32_t i = 0; i < m_sampleCount; ++i)
+        {
+            intervalSum += m_samples[i].intervalMilliseconds;
+            waitSum += m_samples[i].waitMilliseconds;
+            duplicates += m_samples[i].duplicate ? 1 : 0;
+        }
+
+        double mean = intervalSum / m_sampleCount;
+        double variance = 0.0;
+        for (uint32_t i = 0; i < m_sampleCount; ++i)
+        {
+            double deviation = m_samples[i].intervalMilliseconds - mean;
+            variance += deviation * deviation;
+        }
+
+        m_stats.duplicateFrameRate = static_cast<double>(duplicates) / m_sampleCount;
+        m_stats.frameIntervalMilliseconds = mean;
+        m_stats.frameIntervalJitterMilliseconds = std::sqrt(variance / m_sampleCount);
+        m_stats.dutyCycle = (intervalSum > 0.0) ? 1.0 - waitSum / intervalSum : 0.0;
+    }
+
+    m_hasRendered = true;
+    m_lastRendered = now;
+    m_waitMilliseconds = 0.0;
+}
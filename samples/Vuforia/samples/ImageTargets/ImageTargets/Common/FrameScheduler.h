@@ -0,0 +1,95 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace SampleCommon
+{
+    // Statistics of the frame scheduler.
+    struct FrameSchedulerStats
+    {
+        // Totals since the scheduler was created
+        uint64_t framesNotified;   // camera frames ready to be rendered
+        uint64_t framesRendered;
+        uint64_t framesDuplicated; // rendered without a new camera frame, e.g. after a resize
+        uint64_t framesSkipped;    // replaced by a newer camera frame before being rendered
+
+        // Over the last WINDOW_SIZE rendered frames
+        double duplicateFrameRate;          // share of the rendered frames that were duplicates
+        double frameIntervalMilliseconds;   // mean time between rendered frames
+        double frameIntervalJitterMilliseconds; // standard deviation of that time
+        double dutyCycle;                   // share of the time the render thread wasn't waiting
+    };
+
+    // What ended a wait for a frame.
+    enum FrameWakeReason
+    {
+        FRAME_WAKE_NEW_FRAME,
+        FRAME_WAKE_REQUESTED,
+        FRAME_WAKE_TIMEOUT
+    };
+
+    // Paces the render thread by the camera: it sleeps until the tracking
+    // thread has a new frame ready instead of redrawing the last one at the
+    // display rate.
+    class FrameScheduler
+    {
+    public:
+        static const uint32_t WINDOW_SIZE = 64;
+
+        FrameScheduler();
+
+        // Tracking thread: a new frame is ready to be rendered
+        void NotifyFrame();
+
+        // Wakes the render thread without a new frame, to redraw the last
+        // one after a change to the display or to let it stop
+        void Wake();
+
+        // Render thread: waits for a new frame or a wake, for at most timeoutMilliseconds
+        FrameWakeReason WaitForFrame(uint32_t timeoutMilliseconds);
+
+        // Render thread: the frame the last wait returned for has been presented
+        void FrameRendered(bool newFrame);
+
+        // Render thread only
+        const FrameSchedulerStats& GetStats() const { return m_stats; }
+
+    private:
+        typedef std::chrono::high_resolution_clock Clock;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+
+        // Guarded by the mutex
+        uint64_t m_framesNotified;
+        uint64_t m_framesTaken;
+        bool m_wakeRequested;
+
+        // Owned by the render thread
+        Clock::time_point m_lastRendered;
+        bool m_hasRendered;
+        double m_waitMilliseconds;
+
+        // Rolling window of the last rendered frames
+        struct Sample
+        {
+            double intervalMilliseconds;
+            double waitMilliseconds;
+            bool duplicate;
+        };
+        Sample m_samples[WINDOW_SIZE];
+        uint32_t m_sampleCount;
+        uint32_t m_nextSample;
+
+        FrameSchedulerStats m_stats;
+    };
+} // namespace SampleCommon
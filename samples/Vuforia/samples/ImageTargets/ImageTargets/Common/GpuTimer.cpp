@@ -0,0 +1,105 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "GpuTimer.h"
+#include "DirectXHelper.h"
+
+using namespace SampleCommon;
+
+GpuTimer::GpuTimer(const std::shared_ptr<DX::DeviceResources>& deviceResources, uint32_t latency) :
+    m_deviceResources(deviceResources),
+    m_next(0),
+    m_nextSequence(0)
+{
+    auto device = m_deviceResources->GetD3DDevice();
+
+    m_measurements.resize((latency > 0) ? latency : 1);
+    for (auto &measurement : m_measurements)
+    {
+        CD3D11_QUERY_DESC disjointDesc(D3D11_QUERY_TIMESTAMP_DISJOINT);
+        CD3D11_QUERY_DESC timestampDesc(D3D11_QUERY_TIMESTAMP);
+        DX::ThrowIfFailed(device->CreateQuery(&disjointDesc, &measurement.disjoint));
+        DX::ThrowIfFailed(device->CreateQuery(&timestampDesc, &measurement.begin));
+        DX::ThrowIfFailed(device->CreateQuery(&timestampDesc, &measurement.end));
+        measurement.sequence = 0;
+        measurement.pending = false;
+    }
+}
+
+void GpuTimer::ReleaseResources()
+{
+    m_measurements.clear();
+    m_deviceResources.reset();
+}
+
+void GpuTimer::Begin()
+{
+    // A measurement that still hasn't been read back is dropped
+    Measurement &measurement = m_measurements[m_next];
+    measurement.pending = false;
+
+    auto context = m_deviceResources->GetD3DDeviceContext();
+    context->Begin(measurement.disjoint.Get());
+    context->End(measurement.begin.Get());
+}
+
+void GpuTimer::End()
+{
+    Measurement &measurement = m_measurements[m_next];
+
+    auto context = m_deviceResources->GetD3DDeviceContext();
+    context->End(measurement.end.Get());
+    context->End(measurement.disjoint.Get());
+
+    measurement.sequence = m_nextSequence++;
+    measurement.pending = true;
+    m_next = (m_next + 1) % m_measurements.size();
+}
+
+bool GpuTimer::TryGetMilliseconds(double &milliseconds)
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+
+    while (true)
+    {
+        Measurement *oldest = nullptr;
+        for (auto &measurement : m_measurements)
+        {
+            if (measurement.pending && (oldest == nullptr || measurement.sequence < oldest->sequence))
+            {
+                oldest = &measurement;
+            }
+        }
+        if (oldest == nullptr)
+        {
+            return false;
+        }
+
+        // Never waits for the GPU; the queries of a pass finish together
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        if (context->GetData(oldest->disjoint.Get(), &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            return false;
+        }
+
+        UINT64 begin = 0;
+        UINT64 end = 0;
+        if (context->GetData(oldest->begin.Get(), &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(oldest->end.Get(), &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+        {
+            return false;
+        }
+        oldest->pending = false;
+
+        if (!disjoint.Disjoint && disjoint.Frequency > 0 && end >= begin)
+        {
+            milliseconds = static_cast<double>(end - begin) * 1000.0 / static_cast<double>(disjoint.Frequency);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "DeviceResources.h"
+
+#include <memory>
+#include <vector>
+#include <wrl.h>
+
+namespace SampleCommon
+{
+    // Measures the GPU time of a pass with timestamp queries. The results
+    // are read back a few frames later without stalling, so the time
+    // returned is always that of an earlier pass.
+    class GpuTimer
+    {
+    public:
+        // latency is the number of passes that can be in flight at once
+        GpuTimer(const std::shared_ptr<DX::DeviceResources>& deviceResources, uint32_t latency);
+
+        void ReleaseResources();
+
+        // Bracket the pass on the immediate context
+        void Begin();
+        void End();
+
+        // Returns true and the time of the oldest finished pass, if any.
+        // Passes measured while the GPU clock was unreliable are skipped.
+        bool TryGetMilliseconds(double &milliseconds);
+
+    private:
+        // Cached pointer to device resources.
+        std::shared_ptr<DX::DeviceResources> m_deviceResources;
+
+        struct Measurement
+        {
+            Microsoft::WRL::ComPtr<ID3D11Query> disjoint;
+            Microsoft::WRL::ComPtr<ID3D11Query> begin;
+            Microsoft::WRL::ComPtr<ID3D11Query> end;
+            uint64_t sequence;
+            bool pending;
+        };
+        std::vector<Measurement> m_measurements;
+
+        // The measurement the next pass is written to
+        uint32_t m_next;
+        uint64_t m_nextSequence;
+    };
+} // namespace SampleCommon
@@ -0,0 +1,295 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+using namespace SampleCommon;
+
+namespace
+{
+    // Job system and worker index of the calling thread, if it is a worker
+    thread_local const JobSystem *t_jobSystem = nullptr;
+    thread_local uint32_t t_worker = 0;
+}
+
+JobSystem::JobSystem(uint32_t workerCount) :
+    m_queuedJobs(0),
+    m_sleepingWorkers(0),
+    m_workerSleeps(0),
+    m_shutdown(false),
+    m_mainThreadJobsExecuted(0)
+{
+    workerCount = (std::max)(workerCount, 1u);
+    for (uint32_t queue = 0; queue <= workerCount; ++queue)
+    {
+        m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+    }
+
+    for (uint32_t worker = 0; worker < workerCount; ++worker)
+    {
+        m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this, worker));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_shutdown = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::GetDefaultWorkerCount()
+{
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    return (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+}
+
+void JobSystem::Run(const JobFunction &function, JobCounter *counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job = { function, counter };
+    Push(std::move(job));
+}
+
+void JobSystem::RunAfter(JobCounter &dependency, const JobFunction &function, JobCounter *counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job = { function, counter };
+    {
+        // The dependency only reaches zero under its lock, so the job is
+        // either kept here and released by Finish(), or queued right away
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_pending.load(std::memory_order_acquire) != 0)
+        {
+            dependency.m_continuations.push_back(std::move(job));
+            return;
+        }
+    }
+    Push(std::move(job));
+}
+
+void JobSystem::Wait(JobCounter &counter)
+{
+    uint32_t queue = GetCurrentQueue();
+    while (counter.m_pending.load(std::memory_order_acquire) != 0)
+    {
+        Job job;
+        if (TryPop(queue, job))
+        {
+            Execute(queue, job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // The job finishing the counter may still be releasing its lock, which
+    // must be done before the caller is free to destroy the counter
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::RunOnMainThread(const JobFunction &function, JobCounter *counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job job = { function, counter };
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadJobs.push_back(std::move(job));
+}
+
+uint32_t JobSystem::RunMainThreadJobs()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_runningMainThreadJobs.swap(m_mainThreadJobs);
+    }
+
+    // Jobs queued by these jobs run on the next call
+    uint32_t count = static_cast<uint32_t>(m_runningMainThreadJobs.size());
+    for (auto &job : m_runningMainThreadJobs)
+    {
+        job.function();
+        Finish(job.counter);
+    }
+    m_runningMainThreadJobs.clear();
+
+    m_mainThreadJobsExecuted.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
+
+bool JobSystem::HasMainThreadJobs()
+{
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    return !m_mainThreadJobs.empty();
+}
+
+JobSystemStats JobSystem::GetStats() const
+{
+    JobSystemStats stats = {};
+    for (auto &queue : m_queues)
+    {
+        stats.jobsExecuted += queue->jobsExecuted.load(std::memory_order_relaxed);
+        stats.jobsStolen += queue->jobsStolen.load(std::memory_order_relaxed);
+    }
+    stats.mainThreadJobs = m_mainThreadJobsExecuted.load(std::memory_order_relaxed);
+    stats.workerSleeps = m_workerSleeps.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void JobSystem::WorkerLoop(uint32_t worker)
+{
+    t_jobSystem = this;
+    t_worker = worker;
+
+    while (true)
+    {
+        Job job;
+        if (TryPop(worker, job))
+        {
+            Execute(worker, job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        if (m_queuedJobs.load() > 0)
+        {
+            continue;
+        }
+        if (m_shutdown)
+        {
+            return;
+        }
+
+        // Push() reads the sleeping count after adding its job, so either
+        // it sees this worker and wakes it, or the wait sees its job
+        m_sleepingWorkers.fetch_add(1);
+        m_workerSleeps.fetch_add(1, std::memory_order_relaxed);
+        m_wakeCondition.wait(lock, [this]() { return m_shutdown || m_queuedJobs.load() > 0; });
+        m_sleepingWorkers.fetch_sub(1);
+    }
+}
+
+uint32_t JobSystem::GetCurrentQueue() const
+{
+    return (t_jobSystem == this) ? t_worker : static_cast<uint32_t>(m_workers.size());
+}
+
+void JobSystem::Push(Job &&job)
+{
+    WorkQueue &queue = *m_queues[GetCurrentQueue()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    m_queuedJobs.fetch_add(1);
+    if (m_sleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.notify_one();
+    }
+}
+
+bool JobSystem::TryPop(uint32_t queue, Job &job)
+{
+    uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+
+    // Workers take their newest job first; the shared queue and the jobs
+    // stolen from other workers are taken oldest first
+    for (uint32_t i = 0; i < queueCount; ++i)
+    {
+        uint32_t source = (queue + i) % queueCount;
+        WorkQueue &sourceQueue = *m_queues[source];
+
+        std::lock_guard<std::mutex> lock(sourceQueue.mutex);
+        if (sourceQueue.jobs.empty())
+        {
+            continue;
+        }
+
+        bool own = (i == 0) && (source < m_workers.size());
+        if (own)
+        {
+            job = std::move(sourceQueue.jobs.back());
+            sourceQueue.jobs.pop_back();
+        }
+        else
+        {
+            job = std::move(sourceQueue.jobs.front());
+            sourceQueue.jobs.pop_front();
+        }
+        m_queuedJobs.fetch_sub(1);
+
+        if (!own && source < m_workers.size())
+        {
+            m_queues[queue]->jobsStolen.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::Execute(uint32_t queue, Job &job)
+{
+    job.function();
+    m_queues[queue]->jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    Finish(job.counter);
+}
+
+void JobSystem::Finish(JobCounter *counter)
+{
+    if (counter == nullptr)
+    {
+        return;
+    }
+
+    // Counters that don't reach zero are decremented without the lock
+    uint32_t pending = counter->m_pending.load(std::memory_order_relaxed);
+    while (pending > 1)
+    {
+        if (counter->m_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel))
+        {
+            return;
+        }
+    }
+
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            continuations.swap(counter->m_continuations);
+        }
+    }
+
+    for (auto &continuation : continuations)
+    {
+        Push(std::move(continuation));
+    }
+}
@@ -0,0 +1,154 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SampleCommon
+{
+    class JobCounter;
+
+    typedef std::function<void()> JobFunction;
+
+    // A function to run, and the counter it decrements once it has run.
+    struct Job
+    {
+        JobFunction function;
+        JobCounter *counter;
+    };
+
+    // Counts the jobs started with it that haven't finished yet. Other jobs
+    // can wait for it to reach zero, see JobSystem::RunAfter().
+    // A counter must outlive the jobs started with it.
+    class JobCounter
+    {
+    public:
+        JobCounter() : m_pending(0) {}
+
+        bool IsDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+        uint32_t GetPending() const { return m_pending.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        std::atomic<uint32_t> m_pending;
+
+        // Only reaches zero under the lock, which also guards the jobs
+        // waiting for it to do so
+        std::mutex m_mutex;
+        std::vector<Job> m_continuations;
+    };
+
+    // Statistics of a job system since it was created.
+    struct JobSystemStats
+    {
+        uint64_t jobsExecuted;
+        uint64_t jobsStolen;       // taken from another worker's queue
+        uint64_t mainThreadJobs;
+        uint64_t workerSleeps;
+    };
+
+    // Runs jobs on a fixed set of worker threads.
+    //
+    // Each worker has its own queue: it pushes and pops its own jobs at the
+    // back, so that nested work stays hot in its cache, and steals from the
+    // front of the other queues when it runs out. Jobs started from threads
+    // outside the system go to a shared queue. Threads waiting for a counter
+    // run jobs while they wait instead of blocking.
+    //
+    // Main thread jobs are only run when the thread owning that role, e.g.
+    // the render thread, calls RunMainThreadJobs() at a point of its choosing.
+    class JobSystem
+    {
+    public:
+        explicit JobSystem(uint32_t workerCount);
+
+        // Finishes the queued jobs, then stops the workers
+        ~JobSystem();
+
+        // One worker per hardware thread, leaving one to the thread creating the jobs
+        static uint32_t GetDefaultWorkerCount();
+
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        // Queues a job. If counter is set, it is incremented now and
+        // decremented once the job has run.
+        void Run(const JobFunction &function, JobCounter *counter = nullptr);
+
+        // Queues a job once dependency reaches zero; counter counts it from now
+        void RunAfter(JobCounter &dependency, const JobFunction &function, JobCounter *counter = nullptr);
+
+        // Runs jobs until counter reaches zero. Never runs main thread jobs,
+        // so the main thread must not wait for one of its own.
+        void Wait(JobCounter &counter);
+
+        // Queues a job for the main thread
+        void RunOnMainThread(const JobFunction &function, JobCounter *counter = nullptr);
+
+        // Main thread: runs the jobs queued for it so far and returns their number
+        uint32_t RunMainThreadJobs();
+
+        bool HasMainThreadJobs();
+
+        JobSystemStats GetStats() const;
+
+    private:
+        // Padded so that the queues of different workers don't share a cache line
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+            std::atomic<uint64_t> jobsExecuted;
+            std::atomic<uint64_t> jobsStolen;
+            char padding[64];
+
+            WorkQueue() : jobsExecuted(0), jobsStolen(0) {}
+        };
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void WorkerLoop(uint32_t worker);
+
+        // Queue of the calling thread, the shared queue for outside threads
+        uint32_t GetCurrentQueue() const;
+
+        void Push(Job &&job);
+        bool TryPop(uint32_t queue, Job &job);
+        void Execute(uint32_t queue, Job &job);
+        void Finish(JobCounter *counter);
+
+        std::vector<std::thread> m_workers;
+
+        // One queue per worker, then the shared queue
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+        // Jobs in all queues, and workers sleeping until there are some
+        std::atomic<int32_t> m_queuedJobs;
+        std::atomic<uint32_t> m_sleepingWorkers;
+        std::atomic<uint64_t> m_workerSleeps;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeCondition;
+        bool m_shutdown;
+
+        std::mutex m_mainThreadMutex;
+        std::vector<Job> m_mainThreadJobs;
+        std::vector<Job> m_runningMainThreadJobs;
+        std::atomic<uint64_t> m_mainThreadJobsExecuted;
+    };
+} // namespace SampleCommon
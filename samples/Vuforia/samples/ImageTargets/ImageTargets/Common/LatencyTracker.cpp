@@ -0,0 +1,239 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "LatencyTracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace SampleCommon;
+
+namespace
+{
+    // Camera timestamps further from the callback time than this, or after
+    // it, are taken to be on another clock
+    const double MAX_CAPTURE_TO_CALLBACK_SECONDS = 1.0;
+
+    const char *const INTERVAL_NAMES[LATENCY_INTERVAL_COUNT] = {
+        "capture to callback",
+        "callback to render",
+        "render to submit",
+        "submit to present",
+        "capture to present"
+    };
+
+    // The stages each interval spans
+    const LatencyStage INTERVAL_STAGES[LATENCY_INTERVAL_COUNT][2] = {
+        { LATENCY_STAGE_CAPTURE, LATENCY_STAGE_CALLBACK },
+        { LATENCY_STAGE_CALLBACK, LATENCY_STAGE_RENDER_BEGIN },
+        { LATENCY_STAGE_RENDER_BEGIN, LATENCY_STAGE_SUBMITTED },
+        { LATENCY_STAGE_SUBMITTED, LATENCY_STAGE_PRESENTED },
+        { LATENCY_STAGE_CAPTURE, LATENCY_STAGE_PRESENTED }
+    };
+}
+
+const uint32_t LatencyHistogram::BIN_COUNT;
+constexpr double LatencyHistogram::BIN_MILLISECONDS;
+
+LatencyHistogram::LatencyHistogram()
+{
+    Reset();
+}
+
+void LatencyHistogram::Add(double milliseconds)
+{
+    milliseconds = (std::max)(milliseconds, 0.0);
+    size_t bin = (std::min)(static_cast<size_t>(milliseconds / BIN_MILLISECONDS), static_cast<size_t>(BIN_COUNT - 1));
+    m_bins[bin]++;
+    m_count++;
+    m_max = (std::max)(m_max, milliseconds);
+}
+
+void LatencyHistogram::Reset()
+{
+    memset(m_bins, 0, sizeof(m_bins));
+    m_count = 0;
+    m_max = 0.0;
+}
+
+double LatencyHistogram::GetPercentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return 0.0;
+    }
+
+    double rank = percentile / 100.0 * m_count;
+    uint64_t below = 0;
+    for (uint32_t bin = 0; bin < BIN_COUNT; bin++)
+    {
+        if (m_bins[bin] == 0 || below + m_bins[bin] < rank)
+        {
+            below += m_bins[bin];
+            continue;
+        }
+
+        // The overflow bin has no upper edge, its samples are at most the maximum
+        if (bin == BIN_COUNT - 1)
+        {
+            return m_max;
+        }
+
+        double fraction = (rank - below) / m_bins[bin];
+        return (std::min)((bin + fraction) * BIN_MILLISECONDS, m_max);
+    }
+    return m_max;
+}
+
+LatencyPercentiles LatencyHistogram::GetPercentiles() const
+{
+    LatencyPercentiles percentiles;
+    percentiles.count = m_count;
+    percentiles.p50 = GetPercentile(50.0);
+    percentiles.p95 = GetPercentile(95.0);
+    percentiles.p99 = GetPercentile(99.0);
+    percentiles.max = m_max;
+    return percentiles;
+}
+
+LatencyTracker::LatencyTracker(size_t traceCapacity) :
+    m_trace((std::max)(traceCapacity, static_cast<size_t>(1)))
+{
+    Reset();
+}
+
+double LatencyTracker::Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyTracker::AddFrame(const FrameLatencyRecord &record)
+{
+    FrameLatencyRecord adjusted = record;
+    adjusted.repeated = m_hasFrame && record.frameId == m_lastFrameId;
+    m_lastFrameId = record.frameId;
+    m_hasFrame = true;
+
+    m_stats.framesPresented++;
+    if (adjusted.repeated)
+    {
+        m_stats.framesRepeated++;
+    }
+
+    bool complete = true;
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        complete = complete && record.times[stage] != 0.0;
+    }
+
+    // Decided once, from the first complete frame
+    if (complete && !m_cameraClockKnown)
+    {
+        double captureToCallback = record.times[LATENCY_STAGE_CALLBACK] - record.times[LATENCY_STAGE_CAPTURE];
+        m_stats.cameraClockEstimated = captureToCallback < 0.0 || captureToCallback > MAX_CAPTURE_TO_CALLBACK_SECONDS;
+        m_cameraClockOffset = m_stats.cameraClockEstimated ? captureToCallback : 0.0;
+        m_cameraClockKnown = true;
+    }
+    if (complete && m_stats.cameraClockEstimated)
+    {
+        double captureToCallback = record.times[LATENCY_STAGE_CALLBACK] - record.times[LATENCY_STAGE_CAPTURE];
+        m_cameraClockOffset = (std::min)(m_cameraClockOffset, captureToCallback);
+    }
+    adjusted.times[LATENCY_STAGE_CAPTURE] += m_cameraClockOffset;
+
+    m_trace[m_traceNext] = adjusted;
+    m_traceNext = (m_traceNext + 1) % m_trace.size();
+    m_traceCount = (std::min)(m_traceCount + 1, m_trace.size());
+
+    if (!complete)
+    {
+        m_stats.incompleteFrames++;
+        return;
+    }
+    if (adjusted.repeated)
+    {
+        return;
+    }
+
+    for (int interval = 0; interval < LATENCY_INTERVAL_COUNT; interval++)
+    {
+        double seconds =
+            adjusted.times[INTERVAL_STAGES[interval][1]] -
+            adjusted.times[INTERVAL_STAGES[interval][0]];
+        m_histograms[interval].Add(seconds * 1000.0);
+    }
+}
+
+void LatencyTracker::Reset()
+{
+    for (auto &histogram : m_histograms)
+    {
+        histogram.Reset();
+    }
+    m_traceNext = 0;
+    m_traceCount = 0;
+    m_lastFrameId = 0;
+    m_hasFrame = false;
+    m_cameraClockOffset = 0.0;
+    m_cameraClockKnown = false;
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void LatencyTracker::GetTrace(std::vector<FrameLatencyRecord> &trace) const
+{
+    trace.clear();
+    size_t first = (m_traceNext + m_trace.size() - m_traceCount) % m_trace.size();
+    for (size_t i = 0; i < m_traceCount; i++)
+    {
+        trace.push_back(m_trace[(first + i) % m_trace.size()]);
+    }
+}
+
+void LatencyTracker::FormatTrace(std::string &text) const
+{
+    text += "frame,repeated,callback_ms,render_ms,submit_ms,present_ms\n";
+
+    char buffer[160];
+    size_t first = (m_traceNext + m_trace.size() - m_traceCount) % m_trace.size();
+    for (size_t i = 0; i < m_traceCount; i++)
+    {
+        const FrameLatencyRecord &record = m_trace[(first + i) % m_trace.size()];
+        double capture = record.times[LATENCY_STAGE_CAPTURE];
+        snprintf(buffer, sizeof(buffer), "%lld,%d,%.3f,%.3f,%.3f,%.3f\n",
+            static_cast<long long>(record.frameId),
+            record.repeated ? 1 : 0,
+            (record.times[LATENCY_STAGE_CALLBACK] - capture) * 1000.0,
+            (record.times[LATENCY_STAGE_RENDER_BEGIN] - capture) * 1000.0,
+            (record.times[LATENCY_STAGE_SUBMITTED] - capture) * 1000.0,
+            (record.times[LATENCY_STAGE_PRESENTED] - capture) * 1000.0);
+        text += buffer;
+    }
+}
+
+void LatencyTracker::FormatSummary(std::string &text) const
+{
+    char buffer[160];
+    for (int interval = 0; interval < LATENCY_INTERVAL_COUNT; interval++)
+    {
+        LatencyPercentiles percentiles = m_histograms[interval].GetPercentiles();
+        snprintf(buffer, sizeof(buffer), "%s: n=%u p50=%.2f p95=%.2f p99=%.2f max=%.2f ms\n",
+            INTERVAL_NAMES[interval],
+            percentiles.count,
+            percentiles.p50,
+            percentiles.p95,
+            percentiles.p99,
+            percentiles.max);
+        text += buffer;
+    }
+    if (m_stats.cameraClockEstimated)
+    {
+        text += "camera clock estimated, capture intervals are lower bounds\n";
+    }
+}
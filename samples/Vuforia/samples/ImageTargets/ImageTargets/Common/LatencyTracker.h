@@ -0,0 +1,153 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SampleCommon
+{
+    // Points a camera frame passes on its way to the display, in order
+    enum LatencyStage
+    {
+        LATENCY_STAGE_CAPTURE = 0,      // camera frame timestamp
+        LATENCY_STAGE_CALLBACK,         // Vuforia's update callback received the frame
+        LATENCY_STAGE_RENDER_BEGIN,     // rendering of the frame began
+        LATENCY_STAGE_SUBMITTED,        // all its rendering was submitted
+        LATENCY_STAGE_PRESENTED,        // presenting it returned
+        LATENCY_STAGE_COUNT
+    };
+
+    // Intervals between the stages, and motion-to-photon over all of them
+    enum LatencyInterval
+    {
+        LATENCY_INTERVAL_CAPTURE_TO_CALLBACK = 0,
+        LATENCY_INTERVAL_CALLBACK_TO_RENDER,
+        LATENCY_INTERVAL_RENDER_TO_SUBMIT,
+        LATENCY_INTERVAL_SUBMIT_TO_PRESENT,
+        LATENCY_INTERVAL_CAPTURE_TO_PRESENT,
+        LATENCY_INTERVAL_COUNT
+    };
+
+    // Times of one presented frame, in seconds of LatencyTracker::Now(), or 0
+    // for stages that weren't recorded. The capture time may be on another clock.
+    struct FrameLatencyRecord
+    {
+        int64_t frameId;
+        double times[LATENCY_STAGE_COUNT];
+
+        // The frame had been presented before, no newer one being ready
+        bool repeated;
+    };
+
+    struct LatencyPercentiles
+    {
+        uint32_t count;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    // Histogram of latencies in milliseconds with fixed bins, so that adding
+    // a sample never allocates. Latencies beyond the last bin are counted in
+    // it and reported as the maximum seen.
+    class LatencyHistogram
+    {
+    public:
+        static const uint32_t BIN_COUNT = 2000;
+        static constexpr double BIN_MILLISECONDS = 0.1;
+
+        LatencyHistogram();
+
+        void Add(double milliseconds);
+        void Reset();
+
+        // Interpolated within the bin the percentile falls into
+        double GetPercentile(double percentile) const;
+        LatencyPercentiles GetPercentiles() const;
+
+        uint32_t GetCount() const { return m_count; }
+
+    private:
+        uint32_t m_bins[BIN_COUNT];
+        uint32_t m_count;
+        double m_max;
+    };
+
+    struct LatencyTrackerStats
+    {
+        uint64_t framesPresented;
+        uint64_t framesRepeated;
+
+        // Records missing a stage, which are traced but not histogrammed
+        uint64_t incompleteFrames;
+
+        // The camera timestamps aren't on the tracker's clock, so the capture
+        // intervals are measured from the lowest one seen (see AddFrame())
+        bool cameraClockEstimated;
+    };
+
+    // Measures how old camera frames are when they reach the display, stage
+    // by stage, as histograms and as a trace of the last frames.
+    //
+    // Repeated presentations of a frame are traced, but only the first one
+    // goes into the histograms, so that each camera frame is counted once.
+    // The tracker is used from one thread; the stage times are gathered by
+    // whichever threads the frame passes through and handed over with it.
+    class LatencyTracker
+    {
+    public:
+        explicit LatencyTracker(size_t traceCapacity);
+
+        // The clock stage times are taken with, in seconds. It is monotonic
+        // and on Windows based on the performance counter.
+        static double Now();
+
+        // Adds the times of a presented frame. Camera timestamps from another
+        // clock are detected by their distance to the callback time; the
+        // offset between the clocks is then taken as the shortest capture to
+        // callback interval seen, which makes that interval a lower bound.
+        void AddFrame(const FrameLatencyRecord &record);
+
+        void Reset();
+
+        const LatencyHistogram& GetHistogram(LatencyInterval interval) const { return m_histograms[interval]; }
+        LatencyPercentiles GetPercentiles(LatencyInterval interval) const { return m_histograms[interval].GetPercentiles(); }
+
+        // The last frames, oldest first, with the capture time moved onto the
+        // tracker's clock
+        void GetTrace(std::vector<FrameLatencyRecord> &trace) const;
+
+        // The trace as CSV, one line per frame with the time of each stage
+        // in milliseconds after the capture
+        void FormatTrace(std::string &text) const;
+
+        // One line per interval with its percentiles
+        void FormatSummary(std::string &text) const;
+
+        const LatencyTrackerStats& GetStats() const { return m_stats; }
+
+    private:
+        LatencyHistogram m_histograms[LATENCY_INTERVAL_COUNT];
+
+        std::vector<FrameLatencyRecord> m_trace;
+        size_t m_traceNext;
+        size_t m_traceCount;
+
+        int64_t m_lastFrameId;
+        bool m_hasFrame;
+
+        // Added to camera timestamps to bring them onto the tracker's clock
+        double m_cameraClockOffset;
+        bool m_cameraClockKnown;
+
+        LatencyTrackerStats m_stats;
+    };
+} // namespace SampleCommon
@@ -0,0 +1,105 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "PoseBatch.h"
+#include "SampleMath.h"
+
+#include <cstring>
+
+using namespace SampleCommon;
+
+const uint32_t PoseBatch::MAX_VIEWS;
+
+PoseBatch::PoseBatch() :
+    m_count(0)
+{
+}
+
+void PoseBatch::Clear()
+{
+    m_count = 0;
+}
+
+uint32_t PoseBatch::Add(const float pose[12], const float model[16], const float point[3])
+{
+    if (m_count == m_instances.size())
+    {
+        size_t capacity = m_instances.size() + 1;
+        m_instances.resize(capacity);
+        m_modelViews.resize(capacity * 16);
+        for (auto &modelViewProjections : m_modelViewProjections)
+        {
+            modelViewProjections.resize(capacity * 16);
+        }
+        for (auto &coordinates : m_points)
+        {
+            coordinates.resize(capacity);
+        }
+    }
+
+    Instance &instance = m_instances[m_count];
+    memcpy(instance.pose, pose, sizeof(instance.pose));
+    memcpy(instance.model, model, sizeof(instance.model));
+    memcpy(instance.point, point, sizeof(instance.point));
+    return static_cast<uint32_t>(m_count++);
+}
+
+void PoseBatch::Compute(const float (*projections)[16], uint32_t viewCount)
+{
+    viewCount = (viewCount < MAX_VIEWS) ? viewCount : MAX_VIEWS;
+
+    // A 4x4 product already fills the SIMD lanes one row at a time, so the
+    // matrices stay interleaved per instance rather than being transposed
+    // across instances
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        const Instance &instance = m_instances[i];
+        float *modelView = &m_modelViews[i * 16];
+
+        SampleMath::MultiplyMatrix34(instance.pose, instance.model, modelView);
+        for (uint32_t view = 0; view < viewCount; ++view)
+        {
+            SampleMath::Multiply(projections[view], modelView, &m_modelViewProjections[view][i * 16]);
+        }
+
+        for (int row = 0; row < 3; ++row)
+        {
+            m_points[row][i] =
+                instance.pose[row * 4 + 0] * instance.point[0] +
+                instance.pose[row * 4 + 1] * instance.point[1] +
+                instance.pose[row * 4 + 2] * instance.point[2] +
+                instance.pose[row * 4 + 3];
+        }
+    }
+}
+
+void PoseBatch::ComputeScalar(const float (*projections)[16], uint32_t viewCount)
+{
+    viewCount = (viewCount < MAX_VIEWS) ? viewCount : MAX_VIEWS;
+
+    for (size_t i = 0; i < m_count; ++i)
+    {
+        const Instance &instance = m_instances[i];
+        float *modelView = &m_modelViews[i * 16];
+
+        SampleMath::MultiplyMatrix34Scalar(instance.pose, instance.model, modelView);
+        for (uint32_t view = 0; view < viewCount; ++view)
+        {
+            SampleMath::MultiplyScalar(projections[view], modelView, &m_modelViewProjections[view][i * 16]);
+        }
+
+        for (int row = 0; row < 3; ++row)
+        {
+            m_points[row][i] =
+                instance.pose[row * 4 + 0] * instance.point[0] +
+                instance.pose[row * 4 + 1] * instance.point[1] +
+                instance.pose[row * 4 + 2] * instance.point[2] +
+                instance.pose[row * 4 + 3];
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SampleCommon
+{
+    // Transforms the poses of all trackable results of a frame in one pass.
+    //
+    // Each instance is a Vuforia pose (row-major 3x4), a model matrix and a
+    // point in pose space, typically the center of the instance's bounding
+    // sphere. Compute() produces, for every instance, the model-view matrix,
+    // the model-view-projection matrix of every view and the point in camera
+    // space. The matrices are kept in contiguous arrays that draw submission
+    // reads directly; the points are kept one array per coordinate for the
+    // culling kernel.
+    //
+    // Matrices use the SampleMath layout: row-major, applied to column vectors.
+    class PoseBatch
+    {
+    public:
+        static const uint32_t MAX_VIEWS = 2;
+
+        PoseBatch();
+
+        void Clear();
+
+        // Adds an instance and returns its index
+        uint32_t Add(const float pose[12], const float model[16], const float point[3]);
+
+        size_t Size() const { return m_count; }
+
+        // Computes the outputs of all instances for viewCount projections,
+        // which must not exceed MAX_VIEWS
+        void Compute(const float (*projections)[16], uint32_t viewCount);
+
+        // Reference implementation of Compute
+        void ComputeScalar(const float (*projections)[16], uint32_t viewCount);
+
+        const float* GetModelView(uint32_t instance) const { return &m_modelViews[instance * 16]; }
+        const float* GetModelViewProjection(uint32_t view, uint32_t instance) const { return &m_modelViewProjections[view][instance * 16]; }
+
+        // The points in camera space, one array per coordinate
+        const float* GetPointsX() const { return m_points[0].data(); }
+        const float* GetPointsY() const { return m_points[1].data(); }
+        const float* GetPointsZ() const { return m_points[2].data(); }
+
+    private:
+        struct Instance
+        {
+            float pose[12];
+            float model[16];
+            float point[3];
+        };
+
+        size_t m_count;
+
+        // The buffers are reused every frame, so they only grow
+        std::vector<Instance> m_instances;
+        std::vector<float> m_modelViews;
+        std::vector<float> m_modelViewProjections[MAX_VIEWS];
+        std::vector<float> m_points[3];
+    };
+} // namespace SampleCommon
@@ -0,0 +1,208 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "PosePredictionEvaluator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+using namespace SampleCommon;
+
+namespace
+{
+    const double RADIANS_TO_DEGREES = 57.29577951308232;
+
+    bool IsBlank(const char *line)
+    {
+        while (*line == ' ' || *line == '\t' || *line == '\r')
+        {
+            line++;
+        }
+        return *line == '\0' || *line == '#';
+    }
+
+    bool ParseLine(const char *line, RecordedPose &pose)
+    {
+        char *end = nullptr;
+        pose.timestamp = strtod(line, &end);
+        if (end == line)
+        {
+            return false;
+        }
+
+        line = end;
+        pose.trackableId = static_cast<int>(strtol(line, &end, 10));
+        if (end == line)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < 12; i++)
+        {
+            line = end;
+            pose.pose[i] = strtof(line, &end);
+            if (end == line)
+            {
+                return false;
+            }
+        }
+        return IsBlank(end);
+    }
+
+    // Recorded pose of a trackable at a time, interpolated between the poses
+    // of its sequence around it. poses are those of the trackable, in time order.
+    bool Interpolate(
+        const std::vector<const RecordedPose*> &poses,
+        double timestamp,
+        double maxGap,
+        float result[12])
+    {
+        auto later = std::lower_bound(poses.begin(), poses.end(), timestamp,
+            [](const RecordedPose *pose, double t) { return pose->timestamp < t; });
+        if (later == poses.end())
+        {
+            return false;
+        }
+        if ((*later)->timestamp == timestamp)
+        {
+            memcpy(result, (*later)->pose, sizeof((*later)->pose));
+            return true;
+        }
+        if (later == poses.begin())
+        {
+            return false;
+        }
+
+        const RecordedPose *from = *(later - 1);
+        const RecordedPose *to = *later;
+        double span = to->timestamp - from->timestamp;
+        if (span > maxGap)
+        {
+            return false;
+        }
+
+        double twist[6];
+        PoseMath::RelativeTwist(from->pose, to->pose, twist);
+        PoseMath::ApplyTwist(twist, (timestamp - from->timestamp) / span, from->pose, result);
+        return true;
+    }
+}
+
+uint32_t PosePredictionEvaluator::ParseSequence(const char *text, size_t length, std::vector<RecordedPose> &sequence)
+{
+    uint32_t rejected = 0;
+    std::string line;
+    size_t position = 0;
+    while (position < length)
+    {
+        const char *start = text + position;
+        const char *newline = static_cast<const char*>(memchr(start, '\n', length - position));
+        size_t lineLength = (newline != nullptr) ? newline - start : length - position;
+        line.assign(start, lineLength);
+        position += lineLength + 1;
+
+        if (IsBlank(line.c_str()))
+        {
+            continue;
+        }
+
+        RecordedPose pose;
+        if (ParseLine(line.c_str(), pose))
+        {
+            sequence.push_back(pose);
+        }
+        else
+        {
+            rejected++;
+        }
+    }
+    return rejected;
+}
+
+void PosePredictionEvaluator::FormatPose(const RecordedPose &pose, std::string &text)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.6f %d", pose.timestamp, pose.trackableId);
+    text += buffer;
+    for (int i = 0; i < 12; i++)
+    {
+        snprintf(buffer, sizeof(buffer), " %.9g", pose.pose[i]);
+        text += buffer;
+    }
+    text += '\n';
+}
+
+void PosePredictionEvaluator::Evaluate(
+    const std::vector<RecordedPose> &sequence,
+    const PosePredictorSettings &settings,
+    const double *horizons,
+    size_t horizonCount,
+    std::vector<PredictionError> &errors)
+{
+    errors.assign(horizonCount, PredictionError());
+    for (size_t h = 0; h < horizonCount; h++)
+    {
+        memset(&errors[h], 0, sizeof(PredictionError));
+        errors[h].horizon = horizons[h];
+    }
+
+    // The recorded poses of each trackable, in time order, for the ground truth
+    std::map<int, std::vector<const RecordedPose*>> tracks;
+    for (const auto &pose : sequence)
+    {
+        tracks[pose.trackableId].push_back(&pose);
+    }
+    for (auto &track : tracks)
+    {
+        std::stable_sort(track.second.begin(), track.second.end(),
+            [](const RecordedPose *a, const RecordedPose *b) { return a->timestamp < b->timestamp; });
+    }
+
+    PosePredictor predictor(settings);
+    for (const auto &pose : sequence)
+    {
+        predictor.AddPose(pose.trackableId, pose.timestamp, pose.pose);
+
+        for (size_t h = 0; h < horizonCount; h++)
+        {
+            float actual[12];
+            if (!Interpolate(tracks[pose.trackableId], pose.timestamp + horizons[h], settings.maxGap, actual))
+            {
+                continue;
+            }
+
+            float predicted[12];
+            predictor.Predict(pose.trackableId, pose.timestamp + horizons[h], predicted);
+
+            PredictionError &error = errors[h];
+            double translation = PoseMath::TranslationDistance(predicted, actual);
+            double rotation = PoseMath::RotationAngle(predicted, actual) * RADIANS_TO_DEGREES;
+            error.count++;
+            error.meanTranslation += translation;
+            error.maxTranslation = (std::max)(error.maxTranslation, translation);
+            error.meanRotationDegrees += rotation;
+            error.maxRotationDegrees = (std::max)(error.maxRotationDegrees, rotation);
+            error.meanTranslationHeld += PoseMath::TranslationDistance(pose.pose, actual);
+            error.meanRotationDegreesHeld += PoseMath::RotationAngle(pose.pose, actual) * RADIANS_TO_DEGREES;
+        }
+    }
+
+    for (auto &error : errors)
+    {
+        if (error.count > 0)
+        {
+            error.meanTranslation /= error.count;
+            error.meanRotationDegrees /= error.count;
+            error.meanTranslationHeld /= error.count;
+            error.meanRotationDegreesHeld /= error.count;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "PosePredictor.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SampleCommon
+{
+    // A tracked pose of a recorded sequence
+    struct RecordedPose
+    {
+        double timestamp;
+        int trackableId;
+        float pose[12];
+    };
+
+    // Prediction error over a sequence for one horizon. The errors of
+    // holding the latest pose, as when prediction is disabled, are given
+    // for comparison.
+    struct PredictionError
+    {
+        double horizon;
+        uint32_t count;
+
+        double meanTranslation;
+        double maxTranslation;
+        double meanRotationDegrees;
+        double maxRotationDegrees;
+
+        double meanTranslationHeld;
+        double meanRotationDegreesHeld;
+    };
+
+    // Replays recorded pose sequences through a PosePredictor, offline. It
+    // isn't part of the app: tests/PosePredictionEvaluator.cpp runs it.
+    //
+    // A sequence is text with one pose per line:
+    //     <timestamp> <trackable id> <12 pose values, row by row>
+    // Empty lines and lines starting with '#' are skipped.
+    namespace PosePredictionEvaluator
+    {
+        // Appends the poses of the text to sequence, in the order of the
+        // text. Returns the number of lines that could not be parsed.
+        uint32_t ParseSequence(const char *text, size_t length, std::vector<RecordedPose> &sequence);
+
+        // Appends a pose to text as a line of a sequence
+        void FormatPose(const RecordedPose &pose, std::string &text);
+
+        // For every pose of the sequence, predicts the pose of its trackable
+        // horizon seconds later and compares it with the recorded pose of
+        // that time, interpolated between the two poses around it. Poses
+        // past the end of their trackable's tracking aren't compared.
+        void Evaluate(
+            const std::vector<RecordedPose> &sequence,
+            const PosePredictorSettings &settings,
+            const double *horizons,
+            size_t horizonCount,
+            std::vector<PredictionError> &errors);
+    }
+} // namespace SampleCommon
@@ -0,0 +1,389 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "PosePredictor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace SampleCommon;
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+
+    // Below this angle the series expansions of the coefficients are used
+    const double SMALL_ANGLE = 1e-4;
+
+    void GetRotation(const float pose[12], double rotation[9])
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                rotation[r * 3 + c] = pose[r * 4 + c];
+            }
+        }
+    }
+
+    void Multiply3(const double a[9], const double b[9], double result[9])
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                result[r * 3 + c] = a[r * 3] * b[c] + a[r * 3 + 1] * b[3 + c] + a[r * 3 + 2] * b[6 + c];
+            }
+        }
+    }
+
+    // result = a * transpose(b)
+    void MultiplyTransposed3(const double a[9], const double b[9], double result[9])
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                result[r * 3 + c] = a[r * 3] * b[c * 3] + a[r * 3 + 1] * b[c * 3 + 1] + a[r * 3 + 2] * b[c * 3 + 2];
+            }
+        }
+    }
+
+    // Coefficients of exp(w) = I + a [w]x + b [w]x^2 and of the left
+    // Jacobian V = I + b [w]x + c [w]x^2, for the angle theta = |w|
+    void GetCoefficients(double theta, double &a, double &b, double &c)
+    {
+        double theta2 = theta * theta;
+        if (theta < SMALL_ANGLE)
+        {
+            a = 1.0 - theta2 / 6.0;
+            b = 0.5 - theta2 / 24.0;
+            c = 1.0 / 6.0 - theta2 / 120.0;
+        }
+        else
+        {
+            a = sin(theta) / theta;
+            b = (1.0 - cos(theta)) / theta2;
+            c = (theta - sin(theta)) / (theta2 * theta);
+        }
+    }
+
+    // result = (I + s [w]x + t [w]x^2) * v
+    void ApplySkewPolynomial(const double w[3], double s, double t, const double v[3], double result[3])
+    {
+        double wv[3] = {
+            w[1] * v[2] - w[2] * v[1],
+            w[2] * v[0] - w[0] * v[2],
+            w[0] * v[1] - w[1] * v[0]
+        };
+        double wwv[3] = {
+            w[1] * wv[2] - w[2] * wv[1],
+            w[2] * wv[0] - w[0] * wv[2],
+            w[0] * wv[1] - w[1] * wv[0]
+        };
+        for (int i = 0; i < 3; i++)
+        {
+            result[i] = v[i] + s * wv[i] + t * wwv[i];
+        }
+    }
+
+    void RotationExp(const double w[3], double rotation[9])
+    {
+        double theta = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+        double a, b, c;
+        GetCoefficients(theta, a, b, c);
+
+        // I + a K + b K^2, where K^2 = w w^T - theta^2 I
+        rotation[0] = 1.0 + b * (w[0] * w[0] - theta * theta);
+        rotation[1] = -a * w[2] + b * w[0] * w[1];
+        rotation[2] = a * w[1] + b * w[0] * w[2];
+        rotation[3] = a * w[2] + b * w[1] * w[0];
+        rotation[4] = 1.0 + b * (w[1] * w[1] - theta * theta);
+        rotation[5] = -a * w[0] + b * w[1] * w[2];
+        rotation[6] = -a * w[1] + b * w[2] * w[0];
+        rotation[7] = a * w[0] + b * w[2] * w[1];
+        rotation[8] = 1.0 + b * (w[2] * w[2] - theta * theta);
+    }
+
+    // Rotation vector of a rotation of less than PI
+    void RotationLog(const double rotation[9], double w[3])
+    {
+        double cosTheta = 0.5 * (rotation[0] + rotation[4] + rotation[8] - 1.0);
+        cosTheta = (std::min)((std::max)(cosTheta, -1.0), 1.0);
+        double theta = acos(cosTheta);
+
+        double v[3] = {
+            rotation[7] - rotation[5],
+            rotation[2] - rotation[6],
+            rotation[3] - rotation[1]
+        };
+
+        // Near PI the axis is lost in the antisymmetric part, but
+        // consecutive camera frames never rotate that far
+        double factor = (theta < SMALL_ANGLE) ? 0.5 + theta * theta / 12.0 : theta / (2.0 * sin((std::min)(theta, PI - SMALL_ANGLE)));
+        for (int i = 0; i < 3; i++)
+        {
+            w[i] = factor * v[i];
+        }
+    }
+
+    double Length3(const double v[3])
+    {
+        return sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    }
+
+    // Smoothing factor of an exponential low-pass for a time step
+    double LowPassAlpha(double cutoff, double dt)
+    {
+        double tau = 1.0 / (2.0 * PI * cutoff);
+        return 1.0 / (1.0 + tau / dt);
+    }
+}
+
+void PoseMath::RelativeTwist(const float from[12], const float to[12], double twist[6])
+{
+    double rotationFrom[9], rotationTo[9], rotation[9];
+    GetRotation(from, rotationFrom);
+    GetRotation(to, rotationTo);
+
+    // to = [R | t] * from, so R = Rto Rfrom^T and t = tto - R tfrom
+    MultiplyTransposed3(rotationTo, rotationFrom, rotation);
+    RotationLog(rotation, twist);
+
+    double translationFrom[3] = { from[3], from[7], from[11] };
+    double rotated[3];
+    for (int i = 0; i < 3; i++)
+    {
+        rotated[i] = rotation[i * 3] * translationFrom[0] + rotation[i * 3 + 1] * translationFrom[1] + rotation[i * 3 + 2] * translationFrom[2];
+    }
+    double translation[3] = {
+        to[3] - rotated[0],
+        to[7] - rotated[1],
+        to[11] - rotated[2]
+    };
+
+    // The translation part of the twist is V^-1 t, with
+    // V^-1 = I - 1/2 [w]x + (1 - a / (2 b)) / theta^2 [w]x^2
+    double theta = Length3(twist);
+    double a, b, c;
+    GetCoefficients(theta, a, b, c);
+    double t = (theta < SMALL_ANGLE) ? 1.0 / 12.0 + theta * theta / 720.0 : (1.0 - a / (2.0 * b)) / (theta * theta);
+    ApplySkewPolynomial(twist, -0.5, t, translation, twist + 3);
+}
+
+void PoseMath::ApplyTwist(const double twist[6], double scale, const float pose[12], float result[12])
+{
+    double w[3] = { twist[0] * scale, twist[1] * scale, twist[2] * scale };
+    double u[3] = { twist[3] * scale, twist[4] * scale, twist[5] * scale };
+
+    double rotation[9];
+    RotationExp(w, rotation);
+
+    double a, b, c;
+    GetCoefficients(Length3(w), a, b, c);
+    double translation[3];
+    ApplySkewPolynomial(w, b, c, u, translation);
+
+    double rotationPose[9], rotationResult[9];
+    GetRotation(pose, rotationPose);
+    Multiply3(rotation, rotationPose, rotationResult);
+
+    double translationPose[3] = { pose[3], pose[7], pose[11] };
+    for (int r = 0; r < 3; r++)
+    {
+        double t = translation[r] +
+            rotation[r * 3] * translationPose[0] +
+            rotation[r * 3 + 1] * translationPose[1] +
+            rotation[r * 3 + 2] * translationPose[2];
+        for (int col = 0; col < 3; col++)
+        {
+            result[r * 4 + col] = static_cast<float>(rotationResult[r * 3 + col]);
+        }
+        result[r * 4 + 3] = static_cast<float>(t);
+    }
+}
+
+double PoseMath::RotationAngle(const float a[12], const float b[12])
+{
+    double rotationA[9], rotationB[9], rotation[9];
+    GetRotation(a, rotationA);
+    GetRotation(b, rotationB);
+    MultiplyTransposed3(rotationA, rotationB, rotation);
+
+    double cosTheta = 0.5 * (rotation[0] + rotation[4] + rotation[8] - 1.0);
+    return acos((std::min)((std::max)(cosTheta, -1.0), 1.0));
+}
+
+double PoseMath::TranslationDistance(const float a[12], const float b[12])
+{
+    double d[3] = { a[3] - b[3], a[7] - b[7], a[11] - b[11] };
+    return Length3(d);
+}
+
+const uint32_t PosePredictor::HISTORY_SIZE;
+
+PosePredictor::PosePredictor(const PosePredictorSettings &settings) :
+    m_settings(settings)
+{
+    m_settings.minCutoff = (std::max)(m_settings.minCutoff, 1e-3);
+    Reset();
+}
+
+PosePredictorSettings PosePredictor::GetDefaultSettings()
+{
+    PosePredictorSettings settings;
+    settings.maxHorizon = 0.1;
+    settings.maxGap = 0.2;
+    settings.velocityWindow = 0.05;
+    settings.minCutoff = 2.0;
+    settings.rotationBeta = 5.0;
+    settings.translationBeta = 0.02;
+    return settings;
+}
+
+void PosePredictor::AddPose(int trackableId, double timestamp, const float pose[12])
+{
+    m_stats.samples++;
+
+    Track *track = FindTrack(trackableId);
+    if (track == nullptr)
+    {
+        m_tracks.push_back(Track());
+        track = &m_tracks.back();
+        track->trackableId = trackableId;
+        track->count = 0;
+        m_stats.trackCount = static_cast<uint32_t>(m_tracks.size());
+    }
+
+    if (track->count > 0)
+    {
+        double previous = track->history[track->head].timestamp;
+        if (timestamp <= previous)
+        {
+            // The same camera frame again, or out of order
+            return;
+        }
+        if (timestamp - previous > m_settings.maxGap)
+        {
+            track->count = 0;
+            m_stats.restarts++;
+        }
+    }
+
+    if (track->count == 0)
+    {
+        track->head = 0;
+        track->hasVelocity = false;
+    }
+    else
+    {
+        track->head = (track->head + 1) % HISTORY_SIZE;
+    }
+    track->count = (std::min)(track->count + 1, HISTORY_SIZE);
+
+    Sample &sample = track->history[track->head];
+    sample.timestamp = timestamp;
+    memcpy(sample.pose, pose, sizeof(sample.pose));
+
+    if (track->count < 2)
+    {
+        return;
+    }
+
+    // Measure from the oldest pose within the window, or the previous pose
+    // if even that one is older
+    uint32_t back = 1;
+    while (back + 1 < track->count)
+    {
+        const Sample &older = track->history[(track->head + HISTORY_SIZE - back - 1) % HISTORY_SIZE];
+        if (timestamp - older.timestamp > m_settings.velocityWindow)
+        {
+            break;
+        }
+        back++;
+    }
+    const Sample &from = track->history[(track->head + HISTORY_SIZE - back) % HISTORY_SIZE];
+    double span = timestamp - from.timestamp;
+
+    double twist[6];
+    PoseMath::RelativeTwist(from.pose, sample.pose, twist);
+    for (int i = 0; i < 6; i++)
+    {
+        twist[i] /= span;
+    }
+
+    if (!track->hasVelocity)
+    {
+        memcpy(track->twist, twist, sizeof(twist));
+        track->hasVelocity = true;
+        return;
+    }
+
+    // The cutoff follows the smoothed speed, so that a single noisy pose
+    // doesn't open the filter
+    double dt = timestamp - track->history[(track->head + HISTORY_SIZE - 1) % HISTORY_SIZE].timestamp;
+    double rotationCutoff = m_settings.minCutoff + m_settings.rotationBeta * Length3(track->twist);
+    double translationCutoff = m_settings.minCutoff + m_settings.translationBeta * Length3(track->twist + 3);
+    double rotationAlpha = LowPassAlpha(rotationCutoff, dt);
+    double translationAlpha = LowPassAlpha(translationCutoff, dt);
+    for (int i = 0; i < 3; i++)
+    {
+        track->twist[i] += rotationAlpha * (twist[i] - track->twist[i]);
+        track->twist[i + 3] += translationAlpha * (twist[i + 3] - track->twist[i + 3]);
+    }
+}
+
+bool PosePredictor::Predict(int trackableId, double timestamp, float predicted[12])
+{
+    Track *track = FindTrack(trackableId);
+    if (track == nullptr || track->count == 0)
+    {
+        return false;
+    }
+
+    const Sample &latest = track->history[track->head];
+    if (!track->hasVelocity)
+    {
+        memcpy(predicted, latest.pose, sizeof(latest.pose));
+        m_stats.fallbacks++;
+        return false;
+    }
+
+    double horizon = (std::min)((std::max)(timestamp - latest.timestamp, 0.0), m_settings.maxHorizon);
+    PoseMath::ApplyTwist(track->twist, horizon, latest.pose, predicted);
+    m_stats.predictions++;
+    return true;
+}
+
+void PosePredictor::Prune(double timestamp)
+{
+    auto stale = [this, timestamp](const Track &track) {
+        return track.count == 0 || timestamp - track.history[track.head].timestamp > m_settings.maxGap;
+    };
+    m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(), stale), m_tracks.end());
+    m_stats.trackCount = static_cast<uint32_t>(m_tracks.size());
+}
+
+void PosePredictor::Reset()
+{
+    m_tracks.clear();
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+PosePredictor::Track* PosePredictor::FindTrack(int trackableId)
+{
+    for (auto &track : m_tracks)
+    {
+        if (track.trackableId == trackableId)
+        {
+            return &track;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,136 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace SampleCommon
+{
+    struct PosePredictorSettings
+    {
+        // Predictions further ahead than this are clamped to it, in seconds
+        double maxHorizon;
+
+        // A trackable not seen for longer starts a new history, in seconds
+        double maxGap;
+
+        // The velocity is measured over the poses of the last velocityWindow
+        // seconds, rather than over the last two, to reduce tracking noise
+        double velocityWindow;
+
+        // The measured velocity is low-pass filtered with a cutoff frequency
+        // of minCutoff Hz, raised by beta times the speed (in radians and in
+        // pose units per second), as in the one euro filter. Slow motion is
+        // smoothed to keep still augmentations from jittering, fast motion
+        // is followed with little lag.
+        double minCutoff;
+        double rotationBeta;
+        double translationBeta;
+    };
+
+    struct PosePredictorStats
+    {
+        uint64_t samples;
+        uint64_t predictions;
+
+        // Predict() calls that returned the latest pose unchanged, because
+        // the trackable had no velocity yet
+        uint64_t fallbacks;
+
+        // Histories restarted after a gap in tracking
+        uint64_t restarts;
+
+        uint32_t trackCount;
+    };
+
+    // Rigid motion helpers on Vuforia's row-major 3x4 [R|t] poses. A twist
+    // is a rotation vector (axis times angle in radians) followed by a
+    // translation, describing a motion on SE(3).
+    namespace PoseMath
+    {
+        // The twist moving from to to: exp(twist) * from = to
+        void RelativeTwist(const float from[12], const float to[12], double twist[6]);
+
+        // result = exp(scale * twist) * pose. result may alias pose.
+        void ApplyTwist(const double twist[6], double scale, const float pose[12], float result[12]);
+
+        // Angle of the rotation between the rotations of two poses, in radians
+        double RotationAngle(const float a[12], const float b[12]);
+
+        // Distance between the translations of two poses
+        double TranslationDistance(const float a[12], const float b[12]);
+    }
+
+    // Extrapolates the poses of trackables to the time they are displayed.
+    //
+    // Each trackable keeps a short history of its poses with the timestamps
+    // of their camera frames. Its motion is modeled as a constant velocity
+    // twist on SE(3), that is a rotation and a translation moving together
+    // like a screw, measured from the history and smoothed. A prediction
+    // applies that motion for the time between the latest pose and the time
+    // it is predicted for.
+    //
+    // Poses are Vuforia's row-major 3x4 [R|t] matrices. The predictor has no
+    // clock or Vuforia state, so recorded sequences can be replayed through it.
+    class PosePredictor
+    {
+    public:
+        static const uint32_t HISTORY_SIZE = 8;
+
+        explicit PosePredictor(const PosePredictorSettings &settings);
+
+        // For image targets at camera frame rates, in scene units of millimeters
+        static PosePredictorSettings GetDefaultSettings();
+
+        // Adds the pose of a trackable in the camera frame taken at timestamp,
+        // in seconds. Timestamps of a trackable must increase.
+        void AddPose(int trackableId, double timestamp, const float pose[12]);
+
+        // Writes the pose of the trackable extrapolated to timestamp. Writes
+        // its latest pose and returns false if it has no velocity yet, and
+        // returns false without writing anything if it has no pose at all.
+        bool Predict(int trackableId, double timestamp, float predicted[12]);
+
+        // Forgets the trackables not seen for maxGap before timestamp
+        void Prune(double timestamp);
+
+        void Reset();
+
+        const PosePredictorStats& GetStats() const { return m_stats; }
+
+    private:
+        struct Sample
+        {
+            double timestamp;
+            float pose[12];
+        };
+
+        struct Track
+        {
+            int trackableId;
+            Sample history[HISTORY_SIZE];
+            uint32_t head;
+            uint32_t count;
+
+            // Smoothed twist, the angular velocity first, in radians and
+            // pose units per second
+            double twist[6];
+            bool hasVelocity;
+        };
+
+        Track* FindTrack(int trackableId);
+
+        PosePredictorSettings m_settings;
+
+        // Few trackables are tracked at once, so they are searched linearly.
+        // The vector keeps its allocation when trackables come and go.
+        std::vector<Track> m_tracks;
+
+        PosePredictorStats m_stats;
+    };
+} // namespace SampleCommon
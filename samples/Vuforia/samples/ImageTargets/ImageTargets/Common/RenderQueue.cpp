@@ -0,0 +1,147 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace SampleCommon;
+
+// Below this size an insertion sort beats the radix sort histogram passes,
+// as measured by tests/RenderQueueBenchmark
+static const size_t INSERTION_SORT_THRESHOLD = 64;
+
+RenderQueue::RenderQueue()
+{
+    m_stats.packetCount = 0;
+    m_stats.stateChanges = 0;
+    m_stats.sortMilliseconds = 0.0;
+}
+
+uint64_t RenderQueue::MakeSortKey(
+    RenderPass pass,
+    uint32_t blendMode,
+    uint32_t shader,
+    uint32_t texture,
+    uint32_t mesh,
+    float normalizedDepth)
+{
+    // Quantize the depth to 32 bits
+    float depth = (std::min)((std::max)(normalizedDepth, 0.0f), 1.0f);
+    uint64_t depthBits = static_cast<uint64_t>(depth * 4294967295.0);
+
+    uint64_t key = (static_cast<uint64_t>(pass) & 0x3) << 62;
+    key |= (static_cast<uint64_t>(blendMode) & 0x3) << 60;
+
+    uint64_t stateBits =
+        ((static_cast<uint64_t>(shader) & 0xFF) << 20) |
+        ((static_cast<uint64_t>(texture) & 0xFFF) << 8) |
+        (static_cast<uint64_t>(mesh) & 0xFF);
+
+    if (pass == RENDER_PASS_TRANSLUCENT)
+    {
+        // Back-to-front: farthest draws get the smallest keys
+        key |= (0xFFFFFFFFull - depthBits) << 28;
+        key |= stateBits;
+    }
+    else
+    {
+        // Group by state, then front-to-back to make the most of early depth rejection
+        key |= stateBits << 32;
+        key |= depthBits;
+    }
+    return key;
+}
+
+void RenderQueue::Clear()
+{
+    m_packets.clear();
+    m_stats.packetCount = 0;
+    m_stats.stateChanges = 0;
+    m_stats.sortMilliseconds = 0.0;
+}
+
+void RenderQueue::Submit(uint64_t sortKey, uint32_t drawIndex)
+{
+    DrawPacket packet = { sortKey, drawIndex };
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::Sort()
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if (m_packets.size() <= INSERTION_SORT_THRESHOLD)
+    {
+        for (size_t i = 1; i < m_packets.size(); ++i)
+        {
+            DrawPacket packet = m_packets[i];
+            size_t j = i;
+            while (j > 0 && m_packets[j - 1].sortKey > packet.sortKey)
+            {
+                m_packets[j] = m_packets[j - 1];
+                --j;
+            }
+            m_packets[j] = packet;
+        }
+    }
+    else
+    {
+        RadixSort();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_stats.packetCount = static_cast<uint32_t>(m_packets.size());
+    m_stats.sortMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// LSD radix sort on 8-bit digits. Digits that are the same for every packet
+// (typically pass, blend mode and shader) are skipped.
+void RenderQueue::RadixSort()
+{
+    const size_t count = m_packets.size();
+    m_scratch.resize(count);
+
+    DrawPacket *src = m_packets.data();
+    DrawPacket *dst = m_scratch.data();
+
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        uint32_t histogram[256] = { 0 };
+        for (size_t i = 0; i < count; ++i)
+        {
+            histogram[(src[i].sortKey >> shift) & 0xFF]++;
+        }
+
+        if (histogram[(src[0].sortKey >> shift) & 0xFF] == count)
+        {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (int b = 0; b < 256; ++b)
+        {
+            uint32_t bucketSize = histogram[b];
+            histogram[b] = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].sortKey >> shift) & 0xFF]++] = src[i];
+        }
+
+        std::swap(src, dst);
+    }
+
+    if (src != m_packets.data())
+    {
+        std::copy(src, src + count, m_packets.data());
+    }
+}
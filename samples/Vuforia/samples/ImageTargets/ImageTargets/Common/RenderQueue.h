@@ -0,0 +1,87 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SampleCommon
+{
+    // Render passes, in execution order.
+    enum RenderPass
+    {
+        RENDER_PASS_OPAQUE = 0,
+        RENDER_PASS_TRANSLUCENT = 1,
+        RENDER_PASS_OVERLAY = 2
+    };
+
+    // A draw submitted to the render queue. The payload is an index into
+    // renderer-owned draw data, so packets stay small and cheap to sort.
+    struct DrawPacket
+    {
+        uint64_t sortKey;
+        uint32_t drawIndex;
+    };
+
+    // Per-frame statistics of the render queue.
+    struct RenderQueueStats
+    {
+        uint32_t packetCount;
+        uint32_t stateChanges;
+        double   sortMilliseconds;
+    };
+
+    // Collects draw packets for one frame, sorts them by a 64-bit key
+    // and hands them back in execution order.
+    //
+    // Key layout (most significant bits first):
+    //   opaque:      pass(2) | blend(2) | shader(8) | texture(12) | mesh(8) | depth(32)
+    //   translucent: pass(2) | blend(2) | inverted depth(32) | shader(8) | texture(12) | mesh(8)
+    // Opaque draws are grouped by state and then sorted front-to-back,
+    // translucent draws are sorted back-to-front.
+    class RenderQueue
+    {
+    public:
+        RenderQueue();
+
+        static uint64_t MakeSortKey(
+            RenderPass pass,
+            uint32_t blendMode,
+            uint32_t shader,
+            uint32_t texture,
+            uint32_t mesh,
+            float normalizedDepth);
+
+        static RenderPass GetPass(uint64_t sortKey) { return static_cast<RenderPass>(sortKey >> 62); }
+
+        void Clear();
+        void Submit(uint64_t sortKey, uint32_t drawIndex);
+        void Sort();
+
+        // Counts pipeline state changes made while executing the queue
+        void AddStateChanges(uint32_t count) { m_stats.stateChanges += count; }
+
+        const RenderQueueStats& GetStats() const { return m_stats; }
+        size_t Size() const { return m_packets.size(); }
+        const DrawPacket& operator[](size_t index) const { return m_packets[index]; }
+
+        std::vector<DrawPacket>::const_iterator begin() const { return m_packets.begin(); }
+        std::vector<DrawPacket>::const_iterator end() const { return m_packets.end(); }
+
+    private:
+        void RadixSort();
+
+        std::vector<DrawPacket> m_packets;
+
+        // Scratch storage for the radix sort, kept across frames to avoid
+        // per-frame allocations.
+        std::vector<DrawPacket> m_scratch;
+
+        RenderQueueStats m_stats;
+    };
+} // namespace SampleCommon
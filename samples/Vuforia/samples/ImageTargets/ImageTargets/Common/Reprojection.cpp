@@ -0,0 +1,203 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "Reprojection.h"
+
+#include <cmath>
+
+using namespace SampleCommon;
+
+namespace
+{
+    // Clip space rows giving x, y and w
+    const int CLIP_ROWS[3] = { 0, 1, 3 };
+
+    bool InvertDouble(const double m[9], double result[9])
+    {
+        double c0 = m[4] * m[8] - m[5] * m[7];
+        double c1 = m[5] * m[6] - m[3] * m[8];
+        double c2 = m[3] * m[7] - m[4] * m[6];
+        double determinant = m[0] * c0 + m[1] * c1 + m[2] * c2;
+
+        // Relative to the size of the entries, which vary with the scene units
+        double scale = 0.0;
+        for (int i = 0; i < 9; i++)
+        {
+            scale = fmax(scale, fabs(m[i]));
+        }
+        if (scale == 0.0 || fabs(determinant) <= 1e-9 * scale * scale * scale)
+        {
+            return false;
+        }
+
+        double inverse = 1.0 / determinant;
+        result[0] = c0 * inverse;
+        result[1] = (m[2] * m[7] - m[1] * m[8]) * inverse;
+        result[2] = (m[1] * m[5] - m[2] * m[4]) * inverse;
+        result[3] = c1 * inverse;
+        result[4] = (m[0] * m[8] - m[2] * m[6]) * inverse;
+        result[5] = (m[2] * m[3] - m[0] * m[5]) * inverse;
+        result[6] = c2 * inverse;
+        result[7] = (m[1] * m[6] - m[0] * m[7]) * inverse;
+        result[8] = (m[0] * m[4] - m[1] * m[3]) * inverse;
+        return true;
+    }
+
+    void MultiplyDouble(const double a[9], const double b[9], double result[9])
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                result[r * 3 + c] = a[r * 3] * b[c] + a[r * 3 + 1] * b[3 + c] + a[r * 3 + 2] * b[6 + c];
+            }
+        }
+    }
+
+    // Maps the target plane point (x, y, 1) to clip space (x, y, w)
+    void GetPlaneToClip(const float projection[16], const float pose[12], double result[9])
+    {
+        // Columns 0, 1 and 3 of projection * [pose; 0 0 0 1]
+        const int poseColumns[3] = { 0, 1, 3 };
+        for (int r = 0; r < 3; r++)
+        {
+            const float *row = projection + CLIP_ROWS[r] * 4;
+            for (int c = 0; c < 3; c++)
+            {
+                int column = poseColumns[c];
+                double value = (column == 3) ? row[3] : 0.0;
+                for (int k = 0; k < 3; k++)
+                {
+                    value += static_cast<double>(row[k]) * pose[k * 4 + column];
+                }
+                result[r * 3 + c] = value;
+            }
+        }
+    }
+
+    // Homographies are only defined up to scale, so they are scaled for
+    // their largest entry to be one, keeping the sign of w
+    void Normalize(const double homography[9], float result[9])
+    {
+        double scale = 0.0;
+        for (int i = 0; i < 9; i++)
+        {
+            scale = fmax(scale, fabs(homography[i]));
+        }
+        for (int i = 0; i < 9; i++)
+        {
+            result[i] = static_cast<float>(homography[i] / scale);
+        }
+    }
+}
+
+void Reprojection::Identity(float homography[9])
+{
+    for (int i = 0; i < 9; i++)
+    {
+        homography[i] = (i % 4 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+bool Reprojection::ComputePlanarHomography(
+    const float projection[16],
+    const float renderedPose[12],
+    const float displayedPose[12],
+    float homography[9])
+{
+    // Displayed image to plane, then plane to rendered layer
+    double rendered[9], displayed[9], displayedInverse[9], result[9];
+    GetPlaneToClip(projection, renderedPose, rendered);
+    GetPlaneToClip(projection, displayedPose, displayed);
+    if (!InvertDouble(displayed, displayedInverse))
+    {
+        return false;
+    }
+
+    // The plane must not be edge on in the rendered pose either
+    double renderedInverse[9];
+    if (!InvertDouble(rendered, renderedInverse))
+    {
+        return false;
+    }
+
+    MultiplyDouble(rendered, displayedInverse, result);
+    Normalize(result, homography);
+    return true;
+}
+
+bool Reprojection::ComputeRotationalHomography(
+    const float projection[16],
+    const float renderedPose[12],
+    const float displayedPose[12],
+    float homography[9])
+{
+    // Directions only: the projection without its translation column
+    double k[9], kInverse[9];
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            k[r * 3 + c] = projection[CLIP_ROWS[r] * 4 + c];
+        }
+    }
+    if (!InvertDouble(k, kInverse))
+    {
+        return false;
+    }
+
+    // A direction of the displayed camera in the rendered camera:
+    // Rrendered * transpose(Rdisplayed)
+    double rotation[9];
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            rotation[r * 3 + c] =
+                static_cast<double>(renderedPose[r * 4]) * displayedPose[c * 4] +
+                static_cast<double>(renderedPose[r * 4 + 1]) * displayedPose[c * 4 + 1] +
+                static_cast<double>(renderedPose[r * 4 + 2]) * displayedPose[c * 4 + 2];
+        }
+    }
+
+    double temp[9], result[9];
+    MultiplyDouble(k, rotation, temp);
+    MultiplyDouble(temp, kInverse, result);
+    Normalize(result, homography);
+    return true;
+}
+
+bool Reprojection::Invert(const float matrix[9], float result[9])
+{
+    double m[9], inverse[9];
+    for (int i = 0; i < 9; i++)
+    {
+        m[i] = matrix[i];
+    }
+    if (!InvertDouble(m, inverse))
+    {
+        return false;
+    }
+    for (int i = 0; i < 9; i++)
+    {
+        result[i] = static_cast<float>(inverse[i]);
+    }
+    return true;
+}
+
+bool Reprojection::TransformPoint(const float homography[9], float x, float y, float &resultX, float &resultY)
+{
+    float w = homography[6] * x + homography[7] * y + homography[8];
+    if (w <= 1e-6f)
+    {
+        return false;
+    }
+    resultX = (homography[0] * x + homography[1] * y + homography[2]) / w;
+    resultY = (homography[3] * x + homography[4] * y + homography[5]) / w;
+    return true;
+}
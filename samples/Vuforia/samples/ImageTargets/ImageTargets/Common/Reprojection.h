@@ -0,0 +1,76 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstdint>
+
+namespace SampleCommon
+{
+    // How a layer rendered with one pose is warped to a newer pose
+    enum ReprojectionMode
+    {
+        // The layer is composited as rendered
+        REPROJECTION_OFF = 0,
+
+        // Only the rotation between the poses is corrected, which is exact
+        // for distant content and ignores parallax
+        REPROJECTION_ROTATIONAL,
+
+        // The motion of the target plane is corrected, which is exact for
+        // content on the plane and close for content near it
+        REPROJECTION_PLANAR
+    };
+
+    struct ReprojectionStats
+    {
+        // Frames composited with a newer pose than they were rendered with
+        uint32_t reprojectedFrames;
+
+        // Frames composited as rendered, no newer pose being available
+        uint32_t currentFrames;
+
+        // Frames that had a newer pose but could not be warped to it, e.g.
+        // because no target was tracked in both
+        uint32_t fallbackFrames;
+    };
+
+    // Homographies warping a layer rendered with the pose of a target to a
+    // newer pose of it, in normalized device coordinates.
+    //
+    // Homographies are row-major 3x3 matrices applied to column vectors
+    // (x, y, 1). They map a point of the displayed image to the point of the
+    // rendered layer to sample, so compositing needs no inversion. Poses are
+    // Vuforia's row-major 3x4 [R|t] target to camera matrices; projections
+    // use the SampleMath layout and may include an eye adjustment.
+    namespace Reprojection
+    {
+        void Identity(float homography[9]);
+
+        // The homography induced by the target plane (z = 0 in target space).
+        // Returns false if the plane is seen edge on in either pose.
+        bool ComputePlanarHomography(
+            const float projection[16],
+            const float renderedPose[12],
+            const float displayedPose[12],
+            float homography[9]);
+
+        // The homography of the camera rotation between the poses, as seen
+        // through the projection. Returns false if the projection is singular.
+        bool ComputeRotationalHomography(
+            const float projection[16],
+            const float renderedPose[12],
+            const float displayedPose[12],
+            float homography[9]);
+
+        // result = inverse(matrix). Returns false if matrix is singular.
+        bool Invert(const float matrix[9], float result[9]);
+
+        // Applies a homography to a point; returns false if the point maps
+        // to infinity or behind the camera
+        bool TransformPoint(const float homography[9], float x, float y, float &resultX, float &resultY);
+    }
+} // namespace SampleCommon
@@ -0,0 +1,115 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "ResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace SampleCommon;
+
+ResolutionController::ResolutionController(const ResolutionControllerSettings &settings) :
+    m_settings(settings)
+{
+    m_settings.minScale = (std::max)(m_settings.minScale, 0.05f);
+    m_settings.maxScale = (std::max)(m_settings.maxScale, m_settings.minScale);
+    m_settings.scaleStep = (std::max)(m_settings.scaleStep, 0.001f);
+    Reset();
+}
+
+ResolutionControllerSettings ResolutionController::GetDefaultSettings()
+{
+    ResolutionControllerSettings settings;
+    settings.targetMilliseconds = 8.0;
+    settings.minScale = 0.5f;
+    settings.maxScale = 1.0f;
+    settings.proportionalGain = 0.1;
+    settings.integralGain = 0.05;
+    settings.derivativeGain = 0.02;
+    settings.scaleStep = 0.05f;
+    settings.settleUpdates = 3;
+    settings.deadband = 0.1;
+    return settings;
+}
+
+float ResolutionController::Update(double passMilliseconds)
+{
+    m_recentMilliseconds[m_recentCount % 3] = passMilliseconds;
+    m_recentCount++;
+
+    double measured = passMilliseconds;
+    if (m_recentCount >= 3)
+    {
+        double a = m_recentMilliseconds[0];
+        double b = m_recentMilliseconds[1];
+        double c = m_recentMilliseconds[2];
+        measured = (std::max)((std::min)(a, b), (std::min)((std::max)(a, b), c));
+    }
+
+    // Positive while the pass has time to spare
+    double error = (m_settings.targetMilliseconds - measured) / m_settings.targetMilliseconds;
+    if (std::fabs(error) < m_settings.deadband)
+    {
+        error = 0.0;
+    }
+
+    m_rawScale +=
+        m_settings.proportionalGain * (error - m_previousError) +
+        m_settings.integralGain * error +
+        m_settings.derivativeGain * (error - 2.0 * m_previousError + m_previousError2);
+    m_rawScale = (std::min)((std::max)(m_rawScale, static_cast<double>(m_settings.minScale)),
+        static_cast<double>(m_settings.maxScale));
+
+    m_previousError2 = m_previousError;
+    m_previousError = error;
+
+    // The scale only moves once the controller has stayed a whole step away
+    // from it, so that a single slow pass doesn't change the resolution.
+    // The tolerance keeps float steps from rounding down at the range ends.
+    const double tolerance = 1e-4;
+    double step = m_settings.scaleStep;
+    float scale = m_scale;
+    bool unsettled = std::fabs(m_rawScale - m_scale) >= step - tolerance;
+    m_unsettledUpdates = unsettled ? m_unsettledUpdates + 1 : 0;
+    if (m_unsettledUpdates >= m_settings.settleUpdates)
+    {
+        if (m_rawScale > m_scale)
+        {
+            scale = static_cast<float>(std::floor(m_rawScale / step + tolerance) * step);
+        }
+        else
+        {
+            scale = static_cast<float>(std::ceil(m_rawScale / step - tolerance) * step);
+        }
+        scale = (std::min)((std::max)(scale, m_settings.minScale), m_settings.maxScale);
+        m_unsettledUpdates = 0;
+    }
+
+    if (scale != m_scale)
+    {
+        m_scale = scale;
+        m_stats.scaleChanges++;
+    }
+
+    m_stats.updates++;
+    m_stats.lastMilliseconds = passMilliseconds;
+    m_stats.lastError = error;
+    return m_scale;
+}
+
+void ResolutionController::Reset()
+{
+    m_rawScale = m_settings.maxScale;
+    m_scale = m_settings.maxScale;
+    m_previousError = 0.0;
+    m_previousError2 = 0.0;
+    m_unsettledUpdates = 0;
+    m_recentCount = 0;
+    memset(&m_stats, 0, sizeof(m_stats));
+}
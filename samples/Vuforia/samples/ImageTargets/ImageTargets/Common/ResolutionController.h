@@ -0,0 +1,92 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstdint>
+
+namespace SampleCommon
+{
+    struct ResolutionControllerSettings
+    {
+        // Time the controlled pass should take
+        double targetMilliseconds;
+
+        // Range of the resolution scale, applied to both dimensions
+        float minScale;
+        float maxScale;
+
+        // Gains of the controller, on the error relative to the target
+        double proportionalGain;
+        double integralGain;
+        double derivativeGain;
+
+        // The scale only changes in steps of scaleStep, once the controller
+        // has been a whole step away from it for settleUpdates updates in a
+        // row, and not at all while the time is within deadband of the target
+        // (relative to it)
+        float scaleStep;
+        uint32_t settleUpdates;
+        double deadband;
+    };
+
+    struct ResolutionControllerStats
+    {
+        uint32_t updates;
+        uint32_t scaleChanges;
+        double lastMilliseconds;
+        double lastError;
+    };
+
+    // Chooses the resolution scale of a render pass from its measured time,
+    // so that the pass keeps within its time budget.
+    //
+    // The time of each pass is taken as the median of the last three, which
+    // rejects single slow passes. A PID controller in velocity form moves an
+    // unquantized scale, which is kept from winding up by clamping it to its
+    // range. The scale that is used only follows it in whole steps, so that
+    // small variations of the pass time don't make the resolution flicker.
+    // The controller has no clock or graphics state, so that synthetic
+    // timing traces can be replayed through it.
+    class ResolutionController
+    {
+    public:
+        explicit ResolutionController(const ResolutionControllerSettings &settings);
+
+        // For a pass sharing a 60 Hz frame with the rest of the rendering
+        static ResolutionControllerSettings GetDefaultSettings();
+
+        // Feeds the time a pass took at the current scale; returns the scale
+        // to render the next pass at
+        float Update(double passMilliseconds);
+
+        // Back to the maximum scale, e.g. after the display size changed
+        void Reset();
+
+        float GetScale() const { return m_scale; }
+        const ResolutionControllerStats& GetStats() const { return m_stats; }
+
+    private:
+        ResolutionControllerSettings m_settings;
+
+        // Unquantized scale, and the one in use
+        double m_rawScale;
+        float m_scale;
+
+        // Times of the last passes, for the median
+        double m_recentMilliseconds[3];
+        uint32_t m_recentCount;
+
+        // Errors of the two previous updates
+        double m_previousError;
+        double m_previousError2;
+
+        // Updates the controller has been a whole step away from the scale
+        uint32_t m_unsettledUpdates;
+
+        ResolutionControllerStats m_stats;
+    };
+} // namespace SampleCommon
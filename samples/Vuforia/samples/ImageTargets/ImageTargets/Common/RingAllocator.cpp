@@ -0,0 +1,121 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "RingAllocator.h"
+
+using namespace SampleCommon;
+
+RingAllocator::RingAllocator(uint32_t capacity, uint32_t alignment) :
+    m_capacity(capacity),
+    m_alignment(alignment > 0 ? alignment : 1)
+{
+    Reset();
+
+    m_stats.allocations = 0;
+    m_stats.allocatedBytes = 0;
+    m_stats.wraps = 0;
+    m_stats.failedAllocations = 0;
+}
+
+bool RingAllocator::Allocate(uint32_t size, uint32_t &offset, bool &wrapped)
+{
+    wrapped = false;
+
+    uint64_t alignedSize = (static_cast<uint64_t>(size) + m_alignment - 1) / m_alignment * m_alignment;
+    if (alignedSize == 0 || alignedSize > m_capacity - m_used)
+    {
+        m_stats.failedAllocations++;
+        return false;
+    }
+    uint32_t allocationSize = static_cast<uint32_t>(alignedSize);
+
+    if (m_head >= m_tail)
+    {
+        // The free space is [head, capacity) followed by [0, tail)
+        if (m_capacity - m_head >= allocationSize)
+        {
+            offset = m_head;
+        }
+        else if (m_tail >= allocationSize)
+        {
+            // Skip the end of the ring, the padding belongs to the current frame
+            uint32_t padding = m_capacity - m_head;
+            m_used += padding;
+            m_frameSize += padding;
+            m_head = 0;
+
+            offset = 0;
+            wrapped = true;
+            m_stats.wraps++;
+        }
+        else
+        {
+            m_stats.failedAllocations++;
+            return false;
+        }
+    }
+    else
+    {
+        // The free space is [head, tail)
+        if (m_tail - m_head >= allocationSize)
+        {
+            offset = m_head;
+        }
+        else
+        {
+            m_stats.failedAllocations++;
+            return false;
+        }
+    }
+
+    m_head = offset + allocationSize;
+    m_used += allocationSize;
+    m_frameSize += allocationSize;
+
+    m_stats.allocations++;
+    m_stats.allocatedBytes += allocationSize;
+    return true;
+}
+
+void RingAllocator::EndFrame(uint64_t fenceValue)
+{
+    if (m_frameSize == 0)
+    {
+        return;
+    }
+
+    Frame frame = { fenceValue, m_head, m_frameSize };
+    m_frames.push_back(frame);
+    m_frameSize = 0;
+}
+
+void RingAllocator::Retire(uint64_t completedFenceValue)
+{
+    while (!m_frames.empty() && m_frames.front().fenceValue <= completedFenceValue)
+    {
+        m_tail = m_frames.front().endOffset;
+        m_used -= m_frames.front().size;
+        m_frames.pop_front();
+    }
+
+    if (m_used == 0)
+    {
+        // Nothing is in flight, restart from the beginning without wrapping
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+void RingAllocator::Reset()
+{
+    m_head = 0;
+    m_tail = 0;
+    m_used = 0;
+    m_frameSize = 0;
+    m_frames.clear();
+}
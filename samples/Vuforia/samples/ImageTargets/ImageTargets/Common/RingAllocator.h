@@ -0,0 +1,74 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace SampleCommon
+{
+    // Statistics of a ring allocator since it was created.
+    struct RingAllocatorStats
+    {
+        uint64_t allocations;
+        uint64_t allocatedBytes;
+        uint64_t wraps;
+        uint64_t failedAllocations;
+    };
+
+    // Bookkeeping of a linear ring allocator over a fixed size buffer.
+    // Allocations are grouped into frames; a frame is closed with a fence
+    // value and its memory is reclaimed once that fence is retired.
+    // The allocator never touches memory itself, the owner maps the offsets
+    // it hands out onto the actual buffer.
+    class RingAllocator
+    {
+    public:
+        RingAllocator(uint32_t capacity, uint32_t alignment);
+
+        // Allocates size bytes, rounded up to the alignment. Returns false if
+        // the ring has no room left before the oldest unretired frame.
+        // wrapped is set when the allocation restarted at the beginning of the ring.
+        bool Allocate(uint32_t size, uint32_t &offset, bool &wrapped);
+
+        // Closes the current frame; its memory is reclaimed by Retire(fenceValue)
+        void EndFrame(uint64_t fenceValue);
+
+        // Reclaims the memory of all frames with a fence value up to completedFenceValue
+        void Retire(uint64_t completedFenceValue);
+
+        // Forgets all allocations, e.g. once the whole buffer has been discarded
+        void Reset();
+
+        uint32_t GetCapacity() const { return m_capacity; }
+        uint32_t GetAlignment() const { return m_alignment; }
+        uint32_t GetUsedBytes() const { return m_used; }
+        const RingAllocatorStats& GetStats() const { return m_stats; }
+
+    private:
+        struct Frame
+        {
+            uint64_t fenceValue;
+            uint32_t endOffset;
+            uint32_t size;
+        };
+
+        uint32_t m_capacity;
+        uint32_t m_alignment;
+
+        // Allocations are made at the head and reclaimed at the tail
+        uint32_t m_head;
+        uint32_t m_tail;
+        uint32_t m_used;
+
+        // Bytes used by the current frame, padding at a wrap included
+        uint32_t m_frameSize;
+        std::deque<Frame> m_frames;
+
+        RingAllocatorStats m_stats;
+    };
+} // namespace SampleCommon
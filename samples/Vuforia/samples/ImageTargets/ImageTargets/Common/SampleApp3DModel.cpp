@@ -23,8 +23,12 @@ using namespace std;
 SampleApp3DModel::SampleApp3DModel(
     const std::shared_ptr<DX::DeviceResources>& deviceResources,
     const char *filename)
-    : m_filename((char*)filename), m_deviceResources(deviceResources), m_vertexCount(0)
+    : m_filename((char*)filename),
+    m_vertices(nullptr), m_normals(nullptr), m_texCoords(nullptr), m_meshVertices(nullptr),
+    m_deviceResources(deviceResources), m_vertexCount(0)
 {
+    memset(&m_boundingVolume, 0, sizeof(m_boundingVolume));
+
     if (!LoadMeshFromFile()) {
         throw ref new Platform::Exception(E_FAIL, "Failed to load 3D model.");
     }
@@ -51,12 +55,22 @@ void SampleApp3DModel::ReleaseResources()
         free(m_texCoords);
         m_texCoords = nullptr;
     }
+
+    if (m_meshVertices != nullptr) {
+        delete[] m_meshVertices;
+        m_meshVertices = nullptr;
+    }
     
-    m_vertexBuffer.Reset();
+    ReleaseDeviceResources();
     m_vertexCount = 0;
     m_deviceResources.reset();
 }
 
+void SampleApp3DModel::ReleaseDeviceResources()
+{
+    m_vertexBuffer.Reset();
+}
+
 bool SampleApp3DModel::LoadMeshFromFile()
 {
     char buffer[132];
@@ -123,16 +137,22 @@ bool SampleApp3DModel::LoadMeshFromFile()
 
 void SampleApp3DModel::InitMesh()
 {
-    m_meshVertices = new TexturedVertex[m_vertexCount];
-    for (uint32 i = 0; i < m_vertexCount; ++i)
+    // Built once, kept for when the device resources are created again
+    if (m_meshVertices == nullptr)
     {
-        m_meshVertices[i].pos = DirectX::XMFLOAT3(
-            m_vertices[3 * i],
-            m_vertices[3 * i + 1],
-            m_vertices[3 * i + 2]);
-        m_meshVertices[i].texcoord = DirectX::XMFLOAT2(
-            m_texCoords[2 * i],
-            m_texCoords[2 * i + 1]);
+        m_meshVertices = new TexturedVertex[m_vertexCount];
+        for (uint32 i = 0; i < m_vertexCount; ++i)
+        {
+            m_meshVertices[i].pos = DirectX::XMFLOAT3(
+                m_vertices[3 * i],
+                m_vertices[3 * i + 1],
+                m_vertices[3 * i + 2]);
+            m_meshVertices[i].texcoord = DirectX::XMFLOAT2(
+                m_texCoords[2 * i],
+                m_texCoords[2 * i + 1]);
+        }
+
+        m_boundingVolume = BoundingVolumeUtil::ComputeBoundingVolume(m_vertices, m_vertexCount, 3);
     }
 
     D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
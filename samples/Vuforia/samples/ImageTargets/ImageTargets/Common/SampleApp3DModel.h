@@ -8,6 +8,7 @@ countries.
 
 #include "DeviceResources.h"
 #include "ShaderStructures.h"
+#include "BoundingVolume.h"
 
 #include <wrl.h>
 #include <d3d11.h>
@@ -25,8 +26,13 @@ namespace SampleCommon
         void InitMesh();
         void ReleaseResources();
 
+        // Releases the vertex buffer only; the parsed model is kept, and
+        // InitMesh() creates the buffer again without parsing the file
+        void ReleaseDeviceResources();
+
         Microsoft::WRL::ComPtr<ID3D11Buffer> & GetVertexBuffer() { return m_vertexBuffer; }
         uint32_t GetVertexCount() const { return m_vertexCount; }
+        const BoundingVolume& GetBoundingVolume() const { return m_boundingVolume; }
 
     private:
         bool LoadMeshFromFile();
@@ -46,6 +52,9 @@ namespace SampleCommon
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
         uint32    m_vertexCount;
 
+        // Model space bounds, computed when the mesh is created
+        BoundingVolume m_boundingVolume;
+
     };
 
 }// namespace SampleCommon
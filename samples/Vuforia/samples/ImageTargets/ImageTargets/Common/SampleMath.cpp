@@ -0,0 +1,196 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "SampleMath.h"
+
+#if defined(SAMPLE_MATH_SSE2)
+#include <emmintrin.h>
+#elif defined(SAMPLE_MATH_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace SampleCommon;
+
+namespace
+{
+#if defined(SAMPLE_MATH_SSE2)
+    // row * b, with b given as its four rows
+    inline __m128 MultiplyRow(__m128 row, const __m128 b[4])
+    {
+        __m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b[0]);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b[1]));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b[2]));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b[3]));
+        return result;
+    }
+
+    inline void LoadRows(const float *matrix, __m128 rows[4])
+    {
+        rows[0] = _mm_loadu_ps(matrix);
+        rows[1] = _mm_loadu_ps(matrix + 4);
+        rows[2] = _mm_loadu_ps(matrix + 8);
+        rows[3] = _mm_loadu_ps(matrix + 12);
+    }
+#elif defined(SAMPLE_MATH_NEON)
+    inline float32x4_t MultiplyRow(float32x4_t row, const float32x4_t b[4])
+    {
+        float32x4_t result = vmulq_n_f32(b[0], vgetq_lane_f32(row, 0));
+        result = vmlaq_n_f32(result, b[1], vgetq_lane_f32(row, 1));
+        result = vmlaq_n_f32(result, b[2], vgetq_lane_f32(row, 2));
+        result = vmlaq_n_f32(result, b[3], vgetq_lane_f32(row, 3));
+        return result;
+    }
+
+    inline void LoadRows(const float *matrix, float32x4_t rows[4])
+    {
+        rows[0] = vld1q_f32(matrix);
+        rows[1] = vld1q_f32(matrix + 4);
+        rows[2] = vld1q_f32(matrix + 8);
+        rows[3] = vld1q_f32(matrix + 12);
+    }
+#endif
+}
+
+void SampleMath::FromMatrix34(const float matrix34[12], float result[16])
+{
+    for (int i = 0; i < 12; ++i)
+    {
+        result[i] = matrix34[i];
+    }
+    result[12] = 0.0f;
+    result[13] = 0.0f;
+    result[14] = 0.0f;
+    result[15] = 1.0f;
+}
+
+void SampleMath::FromGLMatrix(const float glMatrix[16], float result[16])
+{
+    Transpose(glMatrix, result);
+}
+
+void SampleMath::Transpose(const float matrix[16], float result[16])
+{
+#if defined(SAMPLE_MATH_SSE2)
+    __m128 rows[4];
+    LoadRows(matrix, rows);
+    _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+    _mm_storeu_ps(result, rows[0]);
+    _mm_storeu_ps(result + 4, rows[1]);
+    _mm_storeu_ps(result + 8, rows[2]);
+    _mm_storeu_ps(result + 12, rows[3]);
+#else
+    float copy[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        copy[i] = matrix[i];
+    }
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            result[row * 4 + column] = copy[column * 4 + row];
+        }
+    }
+#endif
+}
+
+void SampleMath::Multiply(const float a[16], const float b[16], float result[16])
+{
+#if defined(SAMPLE_MATH_SSE2)
+    __m128 rowsA[4], rowsB[4];
+    LoadRows(a, rowsA);
+    LoadRows(b, rowsB);
+    for (int i = 0; i < 4; ++i)
+    {
+        rowsA[i] = MultiplyRow(rowsA[i], rowsB);
+    }
+    _mm_storeu_ps(result, rowsA[0]);
+    _mm_storeu_ps(result + 4, rowsA[1]);
+    _mm_storeu_ps(result + 8, rowsA[2]);
+    _mm_storeu_ps(result + 12, rowsA[3]);
+#elif defined(SAMPLE_MATH_NEON)
+    float32x4_t rowsA[4], rowsB[4];
+    LoadRows(a, rowsA);
+    LoadRows(b, rowsB);
+    for (int i = 0; i < 4; ++i)
+    {
+        rowsA[i] = MultiplyRow(rowsA[i], rowsB);
+    }
+    vst1q_f32(result, rowsA[0]);
+    vst1q_f32(result + 4, rowsA[1]);
+    vst1q_f32(result + 8, rowsA[2]);
+    vst1q_f32(result + 12, rowsA[3]);
+#else
+    MultiplyScalar(a, b, result);
+#endif
+}
+
+void SampleMath::MultiplyMatrix34(const float matrix34[12], const float b[16], float result[16])
+{
+#if defined(SAMPLE_MATH_SSE2)
+    __m128 rowsB[4];
+    LoadRows(b, rowsB);
+    __m128 row0 = MultiplyRow(_mm_loadu_ps(matrix34), rowsB);
+    __m128 row1 = MultiplyRow(_mm_loadu_ps(matrix34 + 4), rowsB);
+    __m128 row2 = MultiplyRow(_mm_loadu_ps(matrix34 + 8), rowsB);
+    _mm_storeu_ps(result, row0);
+    _mm_storeu_ps(result + 4, row1);
+    _mm_storeu_ps(result + 8, row2);
+    _mm_storeu_ps(result + 12, rowsB[3]);
+#elif defined(SAMPLE_MATH_NEON)
+    float32x4_t rowsB[4];
+    LoadRows(b, rowsB);
+    float32x4_t row0 = MultiplyRow(vld1q_f32(matrix34), rowsB);
+    float32x4_t row1 = MultiplyRow(vld1q_f32(matrix34 + 4), rowsB);
+    float32x4_t row2 = MultiplyRow(vld1q_f32(matrix34 + 8), rowsB);
+    vst1q_f32(result, row0);
+    vst1q_f32(result + 4, row1);
+    vst1q_f32(result + 8, row2);
+    vst1q_f32(result + 12, rowsB[3]);
+#else
+    MultiplyMatrix34Scalar(matrix34, b, result);
+#endif
+}
+
+void SampleMath::MultiplyScalar(const float a[16], const float b[16], float result[16])
+{
+    float product[16];
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            product[row * 4 + column] =
+                a[row * 4 + 0] * b[column] +
+                a[row * 4 + 1] * b[4 + column] +
+                a[row * 4 + 2] * b[8 + column] +
+                a[row * 4 + 3] * b[12 + column];
+        }
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        result[i] = product[i];
+    }
+}
+
+void SampleMath::MultiplyMatrix34Scalar(const float matrix34[12], const float b[16], float result[16])
+{
+    float matrix[16];
+    FromMatrix34(matrix34, matrix);
+    MultiplyScalar(matrix, b, result);
+}
+
+const char* SampleMath::GetBackendName()
+{
+#if defined(SAMPLE_MATH_SSE2)
+    return "SSE2";
+#elif defined(SAMPLE_MATH_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
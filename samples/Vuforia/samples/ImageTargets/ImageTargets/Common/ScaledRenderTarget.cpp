@@ -0,0 +1,265 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "ScaledRenderTarget.h"
+#include "DirectXHelper.h"
+#include "RenderUtil.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace SampleCommon;
+using namespace DirectX;
+
+ScaledRenderTarget::ScaledRenderTarget(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
+    m_deviceResources(deviceResources),
+    m_width(0),
+    m_height(0),
+    m_scale(1.0f)
+{
+    ZeroMemory(&m_viewport, sizeof(m_viewport));
+}
+
+void ScaledRenderTarget::InitVertexShader(const void *shaderByteCode, SIZE_T byteCodeLength)
+{
+    auto device = m_deviceResources->GetD3DDevice();
+    DX::ThrowIfFailed(
+        device->CreateVertexShader(shaderByteCode, byteCodeLength, nullptr, &m_vertexShader)
+        );
+
+    static const D3D11_INPUT_ELEMENT_DESC vertexDesc[] =
+    {
+        { "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+    };
+    DX::ThrowIfFailed(
+        device->CreateInputLayout(vertexDesc, ARRAYSIZE(vertexDesc), shaderByteCode, byteCodeLength, &m_inputLayout)
+        );
+
+    // A triangle covering the whole viewport, in normalized device
+    // coordinates. It comes from a vertex buffer rather than from the
+    // vertex ids, which feature level 9 doesn't have.
+    static const XMFLOAT2 vertices[] =
+    {
+        XMFLOAT2(-1.0f, 1.0f),
+        XMFLOAT2(3.0f, 1.0f),
+        XMFLOAT2(-1.0f, -3.0f),
+    };
+    D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
+    vertexBufferData.pSysMem = vertices;
+    CD3D11_BUFFER_DESC vertexBufferDesc(sizeof(vertices), D3D11_BIND_VERTEX_BUFFER, D3D11_USAGE_IMMUTABLE);
+    DX::ThrowIfFailed(
+        device->CreateBuffer(&vertexBufferDesc, &vertexBufferData, &m_vertexBuffer)
+        );
+}
+
+void ScaledRenderTarget::InitPixelShader(const void *shaderByteCode, SIZE_T byteCodeLength)
+{
+    DX::ThrowIfFailed(
+        m_deviceResources->GetD3DDevice()->CreatePixelShader(
+            shaderByteCode, byteCodeLength, nullptr, &m_pixelShader)
+        );
+
+    CD3D11_BUFFER_DESC constantBufferDesc(sizeof(CompositeConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
+    DX::ThrowIfFailed(
+        m_deviceResources->GetD3DDevice()->CreateBuffer(&constantBufferDesc, nullptr, &m_constantBuffer)
+        );
+}
+
+void ScaledRenderTarget::InitRenderState()
+{
+    auto device = m_deviceResources->GetD3DDevice();
+
+    // Upscaling filters bilinearly, and never reads past the rendered part
+    D3D11_SAMPLER_DESC samplerDesc;
+    ZeroMemory(&samplerDesc, sizeof(D3D11_SAMPLER_DESC));
+    samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.MaxAnisotropy = 1;
+    samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    DX::ThrowIfFailed(device->CreateSamplerState(&samplerDesc, &m_samplerState));
+
+    // The target holds premultiplied colors
+    D3D11_BLEND_DESC blendDesc = RenderUtil::CreateBlendDesc(true);
+    blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+    blendDesc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+    DX::ThrowIfFailed(device->CreateBlendState(&blendDesc, &m_blendState));
+
+    D3D11_DEPTH_STENCIL_DESC depthStencilDesc = RenderUtil::CreateDepthStencilDesc(
+        false,
+        D3D11_DEPTH_WRITE_MASK_ZERO,
+        D3D11_COMPARISON_ALWAYS
+        );
+    DX::ThrowIfFailed(device->CreateDepthStencilState(&depthStencilDesc, &m_depthStencilState));
+
+    D3D11_RASTERIZER_DESC rasterDesc = RenderUtil::CreateRasterizerDesc(
+        D3D11_FILL_SOLID,
+        D3D11_CULL_NONE,
+        false,
+        false
+        );
+    DX::ThrowIfFailed(device->CreateRasterizerState(&rasterDesc, &m_rasterState));
+}
+
+void ScaledRenderTarget::ReleaseResources()
+{
+    m_colorTexture.Reset();
+    m_colorTargetView.Reset();
+    m_colorResourceView.Reset();
+    m_depthTexture.Reset();
+    m_depthStencilView.Reset();
+    m_width = 0;
+    m_height = 0;
+
+    m_vertexShader.Reset();
+    m_inputLayout.Reset();
+    m_vertexBuffer.Reset();
+    m_pixelShader.Reset();
+    m_constantBuffer.Reset();
+    m_samplerState.Reset();
+    m_blendState.Reset();
+    m_depthStencilState.Reset();
+    m_rasterState.Reset();
+}
+
+void ScaledRenderTarget::Begin(float scale)
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+
+    // Follow the size of the back buffer; only the part in use is rendered
+    // to, so that changing the scale never reallocates the target
+    D3D11_VIEWPORT screenViewport = m_deviceResources->GetScreenViewport();
+    Resize(static_cast<UINT>(screenViewport.Width), static_cast<UINT>(screenViewport.Height));
+
+    m_scale = scale;
+
+    UINT viewportCount = 1;
+    context->RSGetViewports(&viewportCount, &m_viewport);
+    if (viewportCount == 0)
+    {
+        m_viewport = screenViewport;
+    }
+
+    SetViewport(m_viewport);
+
+    ID3D11RenderTargetView *const targets[1] = { m_colorTargetView.Get() };
+    context->OMSetRenderTargets(1, targets, m_depthStencilView.Get());
+
+    // Only the part that is rendered to and composited needs clearing
+    const float transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    D3D11_RECT scaledRect = {
+        0,
+        0,
+        static_cast<LONG>(std::ceil(m_width * scale)),
+        static_cast<LONG>(std::ceil(m_height * scale))
+    };
+    context->ClearView(m_colorTargetView.Get(), transparent, &scaledRect, 1);
+    context->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+}
+
+void ScaledRenderTarget::SetViewport(const D3D11_VIEWPORT &viewport)
+{
+    // Every viewport is scaled around the origin, so that a back buffer
+    // pixel always maps to the same target pixel scaled by the same factor
+    CD3D11_VIEWPORT scaledViewport(
+        viewport.TopLeftX * m_scale,
+        viewport.TopLeftY * m_scale,
+        viewport.Width * m_scale,
+        viewport.Height * m_scale);
+    m_deviceResources->GetD3DDeviceContext()->RSSetViewports(1, &scaledViewport);
+}
+
+void ScaledRenderTarget::End()
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+
+    ID3D11RenderTargetView *const targets[1] = { m_deviceResources->GetBackBufferRenderTargetView() };
+    context->OMSetRenderTargets(1, targets, m_deviceResources->GetDepthStencilView());
+    context->RSSetViewports(1, &m_viewport);
+}
+
+void ScaledRenderTarget::Composite(const D3D11_VIEWPORT &viewport, const float homography[9])
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+
+    context->RSSetViewports(1, &viewport);
+
+    CompositeConstantBuffer constants;
+    constants.texcoordScaleAndMax = XMFLOAT4(
+        m_scale / m_width,
+        m_scale / m_height,
+        (m_width * m_scale - 0.5f) / m_width,
+        (m_height * m_scale - 0.5f) / m_height);
+    constants.viewport = XMFLOAT4(viewport.TopLeftX, viewport.TopLeftY, viewport.Width, viewport.Height);
+    for (int row = 0; row < 3; row++)
+    {
+        constants.homography[row] = XMFLOAT4(homography[row * 3], homography[row * 3 + 1], homography[row * 3 + 2], 0.0f);
+    }
+    context->UpdateSubresource1(m_constantBuffer.Get(), 0, nullptr, &constants, 0, 0, 0);
+
+    UINT stride = sizeof(XMFLOAT2);
+    UINT offset = 0;
+    context->IASetVertexBuffers(0, 1, m_vertexBuffer.GetAddressOf(), &stride, &offset);
+    context->IASetInputLayout(m_inputLayout.Get());
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(m_vertexShader.Get(), nullptr, 0);
+    context->PSSetShader(m_pixelShader.Get(), nullptr, 0);
+    context->PSSetConstantBuffers(0, 1, m_constantBuffer.GetAddressOf());
+    context->PSSetShaderResources(0, 1, m_colorResourceView.GetAddressOf());
+    context->PSSetSamplers(0, 1, m_samplerState.GetAddressOf());
+    context->OMSetBlendState(m_blendState.Get(), nullptr, 0xffffffff);
+    context->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
+    context->RSSetState(m_rasterState.Get());
+
+    context->Draw(3, 0);
+
+    // The target is bound for output again next frame
+    ID3D11ShaderResourceView *const nullResources[1] = { nullptr };
+    context->PSSetShaderResources(0, 1, nullResources);
+}
+
+void ScaledRenderTarget::Resize(UINT width, UINT height)
+{
+    width = (std::max)(width, 1u);
+    height = (std::max)(height, 1u);
+    if (width == m_width && height == m_height)
+    {
+        return;
+    }
+
+    auto device = m_deviceResources->GetD3DDevice();
+
+    CD3D11_TEXTURE2D_DESC colorDesc(
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        width,
+        height,
+        1,
+        1,
+        D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE);
+    DX::ThrowIfFailed(device->CreateTexture2D(&colorDesc, nullptr, m_colorTexture.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(device->CreateRenderTargetView(m_colorTexture.Get(), nullptr, m_colorTargetView.ReleaseAndGetAddressOf()));
+    DX::ThrowIfFailed(device->CreateShaderResourceView(m_colorTexture.Get(), nullptr, m_colorResourceView.ReleaseAndGetAddressOf()));
+
+    CD3D11_TEXTURE2D_DESC depthDesc(
+        DXGI_FORMAT_D24_UNORM_S8_UINT,
+        width,
+        height,
+        1,
+        1,
+        D3D11_BIND_DEPTH_STENCIL);
+    DX::ThrowIfFailed(device->CreateTexture2D(&depthDesc, nullptr, m_depthTexture.ReleaseAndGetAddressOf()));
+
+    CD3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc(D3D11_DSV_DIMENSION_TEXTURE2D);
+    DX::ThrowIfFailed(device->CreateDepthStencilView(
+        m_depthTexture.Get(), &depthStencilViewDesc, m_depthStencilView.ReleaseAndGetAddressOf()));
+
+    m_width = width;
+    m_height = height;
+}
@@ -0,0 +1,95 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "DeviceResources.h"
+
+#include <memory>
+#include <wrl.h>
+
+namespace SampleCommon
+{
+    // Constant buffer used to composite a scaled render target.
+    struct CompositeConstantBuffer
+    {
+        // xy: scale from back buffer pixels to target texture coordinates,
+        // zw: highest texture coordinates written at the current scale
+        DirectX::XMFLOAT4 texcoordScaleAndMax;
+
+        // Viewport composited, in back buffer pixels: x, y, width, height
+        DirectX::XMFLOAT4 viewport;
+
+        // Rows of the homography from the viewport's normalized device
+        // coordinates to those the target is sampled at, w unused
+        DirectX::XMFLOAT4 homography[3];
+    };
+
+    // An offscreen color and depth target the size of the back buffer, of
+    // which only a scaled down part is rendered to. The part is then
+    // upscaled and blended over the back buffer, optionally warped by a
+    // homography to reproject it to a newer pose.
+    //
+    // Passes render with premultiplied alpha, which the usual SRC_ALPHA /
+    // INV_SRC_ALPHA blending with INV_DEST_ALPHA / ONE for alpha produces
+    // when the target starts out transparent.
+    class ScaledRenderTarget
+    {
+    public:
+        ScaledRenderTarget(const std::shared_ptr<DX::DeviceResources>& deviceResources);
+
+        void InitVertexShader(const void *shaderByteCode, SIZE_T byteCodeLength);
+        void InitPixelShader(const void *shaderByteCode, SIZE_T byteCodeLength);
+        void InitRenderState();
+        void ReleaseResources();
+
+        // Binds the target on the immediate context, with the current
+        // viewport scaled down, and clears the part that will be rendered
+        void Begin(float scale);
+
+        // Sets another viewport, in back buffer pixels, scaled down like
+        // the one current at Begin()
+        void SetViewport(const D3D11_VIEWPORT &viewport);
+
+        // Binds the back buffer and the original viewport again
+        void End();
+
+        // Blends the rendered part of a viewport over the same viewport of
+        // the back buffer, sampling each pixel where the homography maps it
+        // (see Reprojection). Leaves the viewport set.
+        void Composite(const D3D11_VIEWPORT &viewport, const float homography[9]);
+
+        float GetScale() const { return m_scale; }
+
+    private:
+        void Resize(UINT width, UINT height);
+
+        // Cached pointer to device resources.
+        std::shared_ptr<DX::DeviceResources> m_deviceResources;
+
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_colorTexture;
+        Microsoft::WRL::ComPtr<ID3D11RenderTargetView> m_colorTargetView;
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_colorResourceView;
+        Microsoft::WRL::ComPtr<ID3D11Texture2D> m_depthTexture;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+        UINT m_width;
+        UINT m_height;
+
+        Microsoft::WRL::ComPtr<ID3D11VertexShader> m_vertexShader;
+        Microsoft::WRL::ComPtr<ID3D11InputLayout> m_inputLayout;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
+        Microsoft::WRL::ComPtr<ID3D11PixelShader> m_pixelShader;
+        Microsoft::WRL::ComPtr<ID3D11Buffer> m_constantBuffer;
+        Microsoft::WRL::ComPtr<ID3D11SamplerState> m_samplerState;
+        Microsoft::WRL::ComPtr<ID3D11BlendState> m_blendState;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_depthStencilState;
+        Microsoft::WRL::ComPtr<ID3D11RasterizerState> m_rasterState;
+
+        // Scale of the current pass, and the viewport it replaced
+        float m_scale;
+        D3D11_VIEWPORT m_viewport;
+    };
+} // namespace SampleCommon
@@ -0,0 +1,426 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "SessionLifecycle.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace SampleCommon;
+
+namespace
+{
+    const char *const STATE_NAMES[SESSION_STATE_COUNT] = {
+        "uninitialized",
+        "initializing",
+        "ready",
+        "running",
+        "paused",
+        "failed"
+    };
+}
+
+SessionLifecycle::SessionLifecycle(SessionHandler *handler, uint32_t cameraRestartDelayMilliseconds) :
+    m_handler(handler),
+    m_cameraRestartDelayMilliseconds(cameraRestartDelayMilliseconds),
+    m_executing(false),
+    m_shutdown(false)
+{
+    m_current.state = SESSION_UNINITIALIZED;
+    m_current.cameraDirection = 0;
+    m_current.resumeCamera = false;
+    m_projected = m_current;
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_thread = std::thread(&SessionLifecycle::ThreadLoop, this);
+}
+
+SessionLifecycle::~SessionLifecycle()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_commandCondition.notify_all();
+    m_thread.join();
+}
+
+bool SessionLifecycle::WaitForIdle(uint32_t timeoutMilliseconds)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_idleCondition.wait_for(lock, std::chrono::milliseconds(timeoutMilliseconds), [this]()
+    {
+        return m_commands.empty() && !m_executing;
+    });
+}
+
+SessionState SessionLifecycle::GetState()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_current.state;
+}
+
+int SessionLifecycle::GetCameraDirection()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_current.cameraDirection;
+}
+
+SessionLifecycleStats SessionLifecycle::GetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+const char* SessionLifecycle::GetStateName(SessionState state)
+{
+    return (state >= 0 && state < SESSION_STATE_COUNT) ? STATE_NAMES[state] : "unknown";
+}
+
+void SessionLifecycle::Post(SessionCommandType type, int cameraDirection)
+{
+    Command command;
+    command.type = type;
+    command.cameraDirection = cameraDirection;
+    command.posted = Clock::now();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.commandsPosted++;
+
+    Snapshot to;
+    if (!Project(m_projected, type, cameraDirection, to))
+    {
+        m_stats.commandsCoalesced++;
+        return;
+    }
+
+    // Commands still queued can be merged with the new one; a restart is
+    // never cancelled, as it is asked for because of a change the snapshot
+    // doesn't show, e.g. of the video mode
+    if (!m_commands.empty())
+    {
+        Command &last = m_commands.back();
+        if (type == SESSION_COMMAND_RESTART_CAMERA && last.type == SESSION_COMMAND_RESTART_CAMERA)
+        {
+            last.cameraDirection = cameraDirection;
+            m_projected = to;
+            m_stats.commandsCoalesced++;
+            return;
+        }
+        if (type != SESSION_COMMAND_RESTART_CAMERA && last.type != SESSION_COMMAND_RESTART_CAMERA &&
+            SameSnapshot(to, last.before))
+        {
+            m_commands.pop_back();
+            m_projected = to;
+            m_stats.commandsCoalesced += 2;
+            if (m_commands.empty() && !m_executing)
+            {
+                m_idleCondition.notify_all();
+            }
+            return;
+        }
+    }
+
+    command.before = m_projected;
+    m_commands.push_back(command);
+    m_projected = to;
+    m_commandCondition.notify_one();
+}
+
+bool SessionLifecycle::Project(const Snapshot &from, SessionCommandType type, int cameraDirection, Snapshot &to)
+{
+    to = from;
+    switch (type)
+    {
+    case SESSION_COMMAND_INITIALIZE:
+        if (from.state == SESSION_UNINITIALIZED)
+        {
+            to.state = SESSION_READY;
+        }
+        break;
+
+    case SESSION_COMMAND_START:
+    case SESSION_COMMAND_RESTART_CAMERA:
+        if (from.state == SESSION_READY || from.state == SESSION_RUNNING)
+        {
+            to.state = SESSION_RUNNING;
+            to.cameraDirection = cameraDirection;
+
+            // A restart of the running camera changes nothing that is projected
+            if (type == SESSION_COMMAND_RESTART_CAMERA)
+            {
+                return true;
+            }
+        }
+        else if (from.state == SESSION_PAUSED)
+        {
+            to.cameraDirection = cameraDirection;
+            to.resumeCamera = true;
+        }
+        break;
+
+    case SESSION_COMMAND_STOP:
+        if (from.state == SESSION_RUNNING)
+        {
+            to.state = SESSION_READY;
+        }
+        else if (from.state == SESSION_PAUSED)
+        {
+            to.resumeCamera = false;
+        }
+        break;
+
+    case SESSION_COMMAND_PAUSE:
+        if (from.state == SESSION_READY || from.state == SESSION_RUNNING)
+        {
+            to.state = SESSION_PAUSED;
+            to.resumeCamera = from.state == SESSION_RUNNING;
+        }
+        break;
+
+    case SESSION_COMMAND_RESUME:
+        if (from.state == SESSION_PAUSED)
+        {
+            to.state = from.resumeCamera ? SESSION_RUNNING : SESSION_READY;
+            to.resumeCamera = false;
+        }
+        break;
+
+    case SESSION_COMMAND_DEINITIALIZE:
+        if (from.state != SESSION_UNINITIALIZED && from.state != SESSION_INITIALIZING)
+        {
+            to.state = SESSION_UNINITIALIZED;
+            to.resumeCamera = false;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return !SameSnapshot(from, to);
+}
+
+bool SessionLifecycle::SameSnapshot(const Snapshot &a, const Snapshot &b)
+{
+    return a.state == b.state && a.cameraDirection == b.cameraDirection && a.resumeCamera == b.resumeCamera;
+}
+
+void SessionLifecycle::ThreadLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_commandCondition.wait(lock, [this]() { return m_shutdown || !m_commands.empty(); });
+        if (m_commands.empty())
+        {
+            break;
+        }
+
+        Command command = m_commands.front();
+        m_commands.pop_front();
+        m_executing = true;
+        lock.unlock();
+
+        bool succeeded = Execute(command);
+        double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - command.posted).count();
+
+        lock.lock();
+        m_executing = false;
+        m_stats.commandsExecuted++;
+        if (!succeeded)
+        {
+            m_stats.commandsFailed++;
+        }
+
+        SessionTransitionTiming &timing = m_stats.transitions[command.type];
+        timing.count++;
+        timing.lastMilliseconds = milliseconds;
+        timing.meanMilliseconds += (milliseconds - timing.meanMilliseconds) / timing.count;
+        timing.maxMilliseconds = (std::max)(timing.maxMilliseconds, milliseconds);
+
+        Snapshot expected;
+        Project(command.before, command.type, command.cameraDirection, expected);
+        if (!SameSnapshot(m_current, expected))
+        {
+            Reproject();
+        }
+
+        if (m_commands.empty())
+        {
+            m_idleCondition.notify_all();
+        }
+    }
+}
+
+bool SessionLifecycle::Execute(const Command &command)
+{
+    Snapshot current;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        current = m_current;
+    }
+
+    switch (command.type)
+    {
+    case SESSION_COMMAND_INITIALIZE:
+    {
+        if (current.state != SESSION_UNINITIALIZED)
+        {
+            return true;
+        }
+        SetState(SESSION_INITIALIZING);
+        bool initialized = m_handler->InitializeSession();
+        SetState(initialized ? SESSION_READY : SESSION_FAILED);
+        return initialized;
+    }
+
+    case SESSION_COMMAND_START:
+    case SESSION_COMMAND_RESTART_CAMERA:
+    {
+        if (current.state == SESSION_PAUSED)
+        {
+            // Started once the application is resumed
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current.cameraDirection = command.cameraDirection;
+            m_current.resumeCamera = true;
+            return true;
+        }
+
+        if (current.state == SESSION_RUNNING)
+        {
+            if (command.type == SESSION_COMMAND_START && command.cameraDirection == current.cameraDirection)
+            {
+                return true;
+            }
+            if (!m_handler->StopCamera())
+            {
+                return false;
+            }
+            SetState(SESSION_READY);
+
+            // Some cameras need a moment before they can be opened again
+            std::this_thread::sleep_for(std::chrono::milliseconds(m_cameraRestartDelayMilliseconds));
+        }
+        else if (current.state != SESSION_READY)
+        {
+            return true;
+        }
+
+        if (!m_handler->StartCamera(command.cameraDirection))
+        {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current.cameraDirection = command.cameraDirection;
+        }
+        SetState(SESSION_RUNNING);
+        return true;
+    }
+
+    case SESSION_COMMAND_STOP:
+        if (current.state == SESSION_PAUSED)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current.resumeCamera = false;
+            return true;
+        }
+        if (current.state != SESSION_RUNNING)
+        {
+            return true;
+        }
+        if (!m_handler->StopCamera())
+        {
+            return false;
+        }
+        SetState(SESSION_READY);
+        return true;
+
+    case SESSION_COMMAND_PAUSE:
+    {
+        if (current.state != SESSION_READY && current.state != SESSION_RUNNING)
+        {
+            return true;
+        }
+
+        // The session is paused even if the camera couldn't be stopped, as
+        // the application is going to the background regardless
+        bool stopped = (current.state == SESSION_RUNNING) ? m_handler->StopCamera() : true;
+        m_handler->PauseSession();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current.resumeCamera = current.state == SESSION_RUNNING;
+        }
+        SetState(SESSION_PAUSED);
+        return stopped;
+    }
+
+    case SESSION_COMMAND_RESUME:
+    {
+        if (current.state != SESSION_PAUSED)
+        {
+            return true;
+        }
+
+        m_handler->ResumeSession();
+        bool started = current.resumeCamera ? m_handler->StartCamera(current.cameraDirection) : false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current.resumeCamera = false;
+        }
+        SetState(started ? SESSION_RUNNING : SESSION_READY);
+        return started || !current.resumeCamera;
+    }
+
+    case SESSION_COMMAND_DEINITIALIZE:
+    {
+        if (current.state == SESSION_UNINITIALIZED || current.state == SESSION_INITIALIZING)
+        {
+            return true;
+        }
+
+        bool stopped = (current.state == SESSION_RUNNING) ? m_handler->StopCamera() : true;
+        bool deinitialized = m_handler->DeinitializeSession();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_current.resumeCamera = false;
+        }
+        SetState(SESSION_UNINITIALIZED);
+        return stopped && deinitialized;
+    }
+
+    default:
+        return true;
+    }
+}
+
+void SessionLifecycle::SetState(SessionState state)
+{
+    SessionState previous;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        previous = m_current.state;
+        m_current.state = state;
+    }
+
+    if (previous != state)
+    {
+        m_handler->OnSessionStateChanged(previous, state);
+    }
+}
+
+void SessionLifecycle::Reproject()
+{
+    Snapshot snapshot = m_current;
+    for (auto &command : m_commands)
+    {
+        command.before = snapshot;
+        Project(command.before, command.type, command.cameraDirection, snapshot);
+    }
+    m_projected = snapshot;
+}
@@ -0,0 +1,183 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace SampleCommon
+{
+    enum SessionState
+    {
+        SESSION_UNINITIALIZED = 0,
+        SESSION_INITIALIZING,
+        SESSION_READY,      // initialized, camera stopped
+        SESSION_RUNNING,    // camera and trackers running
+        SESSION_PAUSED,     // the application is in the background
+        SESSION_FAILED,     // initialization failed, only deinitializing leaves it
+        SESSION_STATE_COUNT
+    };
+
+    enum SessionCommandType
+    {
+        SESSION_COMMAND_INITIALIZE = 0,
+        SESSION_COMMAND_START,          // starts the camera, or switches it to another direction
+        SESSION_COMMAND_RESTART_CAMERA, // restarts the camera even if it runs in that direction
+        SESSION_COMMAND_STOP,
+        SESSION_COMMAND_PAUSE,
+        SESSION_COMMAND_RESUME,
+        SESSION_COMMAND_DEINITIALIZE,
+        SESSION_COMMAND_COUNT
+    };
+
+    // Does the work of the transitions, on the lifecycle's thread. Failures
+    // are reported by returning false; the handler shows or logs them.
+    class SessionHandler
+    {
+    public:
+        virtual ~SessionHandler() {}
+
+        // Initializes the SDK, the trackers and their data
+        virtual bool InitializeSession() = 0;
+        virtual bool StartCamera(int direction) = 0;
+        virtual bool StopCamera() = 0;
+        virtual void PauseSession() = 0;
+        virtual void ResumeSession() = 0;
+        virtual bool DeinitializeSession() = 0;
+
+        // Called after every transition, also between the steps of a
+        // camera restart (RUNNING to READY to RUNNING)
+        virtual void OnSessionStateChanged(SessionState previous, SessionState state) = 0;
+    };
+
+    // Time from posting a command to its transition being done, queueing included
+    struct SessionTransitionTiming
+    {
+        uint32_t count;
+        double lastMilliseconds;
+        double meanMilliseconds;
+        double maxMilliseconds;
+    };
+
+    struct SessionLifecycleStats
+    {
+        uint64_t commandsPosted;
+        uint64_t commandsExecuted;
+
+        // Dropped when posted, as they wouldn't change the state the queue
+        // leads to, or cancelled by the opposite command posted after them
+        uint64_t commandsCoalesced;
+        uint64_t commandsFailed;
+
+        // Indexed by SessionCommandType, executed commands only
+        SessionTransitionTiming transitions[SESSION_COMMAND_COUNT];
+    };
+
+    // Drives a camera session through its states from a serialized queue of
+    // commands, executed on a thread of its own so that the calling threads
+    // never wait for the camera or the SDK.
+    //
+    // Each command is checked against the state the commands queued before
+    // it lead to: commands that wouldn't change it are dropped, and a
+    // command undoing the last queued one cancels it, so a burst of pause
+    // and resume events costs at most one transition. A command that still
+    // turns out to be redundant when executed, e.g. after a failure, does
+    // nothing.
+    class SessionLifecycle
+    {
+    public:
+        // cameraRestartDelayMilliseconds is waited between stopping and
+        // starting the camera when switching it
+        SessionLifecycle(SessionHandler *handler, uint32_t cameraRestartDelayMilliseconds);
+
+        // Finishes the queued commands, then stops the thread
+        ~SessionLifecycle();
+
+        void Initialize() { Post(SESSION_COMMAND_INITIALIZE, 0); }
+        void Start(int cameraDirection) { Post(SESSION_COMMAND_START, cameraDirection); }
+        void RestartCamera(int cameraDirection) { Post(SESSION_COMMAND_RESTART_CAMERA, cameraDirection); }
+        void Stop() { Post(SESSION_COMMAND_STOP, 0); }
+        void Pause() { Post(SESSION_COMMAND_PAUSE, 0); }
+        void Resume() { Post(SESSION_COMMAND_RESUME, 0); }
+        void Deinitialize() { Post(SESSION_COMMAND_DEINITIALIZE, 0); }
+
+        // Waits until all commands posted so far are done; false on timeout
+        bool WaitForIdle(uint32_t timeoutMilliseconds);
+
+        // State and camera direction after the last executed transition
+        SessionState GetState();
+        int GetCameraDirection();
+
+        SessionLifecycleStats GetStats();
+
+        static const char* GetStateName(SessionState state);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        // What the session is, or will be once the queued commands are done
+        struct Snapshot
+        {
+            SessionState state;
+
+            // Camera direction, and whether the camera runs again on resume
+            int cameraDirection;
+            bool resumeCamera;
+        };
+
+        struct Command
+        {
+            SessionCommandType type;
+            int cameraDirection;
+            Clock::time_point posted;
+
+            // The projected snapshot the command was posted against
+            Snapshot before;
+        };
+
+        SessionLifecycle(const SessionLifecycle&) = delete;
+        SessionLifecycle& operator=(const SessionLifecycle&) = delete;
+
+        void Post(SessionCommandType type, int cameraDirection);
+
+        // The snapshot a command leads to, without doing anything. Returns
+        // false if the command wouldn't change the snapshot.
+        static bool Project(const Snapshot &from, SessionCommandType type, int cameraDirection, Snapshot &to);
+        static bool SameSnapshot(const Snapshot &a, const Snapshot &b);
+
+        void ThreadLoop();
+
+        // Lifecycle thread: does the transition and returns false if a step failed
+        bool Execute(const Command &command);
+        void SetState(SessionState state);
+
+        // Lifecycle thread: the queued commands projected again from the
+        // actual snapshot, after a transition didn't go as projected
+        void Reproject();
+
+        SessionHandler *m_handler;
+        uint32_t m_cameraRestartDelayMilliseconds;
+
+        std::mutex m_mutex;
+        std::condition_variable m_commandCondition;
+        std::condition_variable m_idleCondition;
+
+        // Guarded by the mutex
+        std::deque<Command> m_commands;
+        bool m_executing;
+        bool m_shutdown;
+        Snapshot m_current;
+        Snapshot m_projected;
+        SessionLifecycleStats m_stats;
+
+        std::thread m_thread;
+    };
+} // namespace SampleCommon
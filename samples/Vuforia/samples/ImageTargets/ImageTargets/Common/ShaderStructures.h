@@ -11,18 +11,26 @@ countries.
 
 namespace SampleCommon
 {
-    // Constant buffer used to send MVP matrices to the vertex shader.
-    struct ModelViewProjectionConstantBuffer
+    // Constant buffer used to send projection matrices to the vertex shader.
+    struct ProjectionConstantBuffer
     {
-        DirectX::XMFLOAT4X4 model;
-        DirectX::XMFLOAT4X4 view;
         DirectX::XMFLOAT4X4 projection;
     };
 
-    // Constant buffer used to send projection matrices to the vertex shader.
-    struct ProjectionConstantBuffer
+    // Constant buffer used to send the clip space rectangle of each eye to the
+    // vertex shader, as (left, right, bottom, top). Monocular rendering uses
+    // the whole clip space for both.
+    struct StereoBoundsConstantBuffer
     {
-        DirectX::XMFLOAT4X4 projection;
+        DirectX::XMFLOAT4 eyeBounds[2];
+    };
+
+    // Constant buffer used to send the per-draw model-view-projection matrix of
+    // each eye to the vertex shader, which selects one per instance. Monocular
+    // rendering uses the same matrix for both.
+    struct ModelViewProjectionConstantBuffer
+    {
+        DirectX::XMFLOAT4X4 modelViewProjection[2];
     };
 
     // Used to send per-vertex data to the vertex shader.
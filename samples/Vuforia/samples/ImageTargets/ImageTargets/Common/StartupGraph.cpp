@@ -0,0 +1,114 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "StartupGraph.h"
+
+using namespace SampleCommon;
+
+StartupGraph::StartupGraph(const std::shared_ptr<StartupTracker> &tracker, uint32_t timeoutMilliseconds) :
+    m_tracker(tracker),
+    m_timeoutMilliseconds(timeoutMilliseconds),
+    m_stageMask(0),
+    m_doneMask(0),
+    m_failedMask(0)
+{
+}
+
+StartupGraph::~StartupGraph()
+{
+    Join();
+}
+
+void StartupGraph::Add(StartupStage stage, const StartupWork &work)
+{
+    Stage entry;
+    entry.stage = stage;
+    entry.work = work;
+    m_stages.push_back(entry);
+    m_stageMask |= StartupStageBit(stage);
+}
+
+void StartupGraph::Start()
+{
+    for (const Stage &stage : m_stages)
+    {
+        m_threads.push_back(std::thread(&StartupGraph::RunStage, this, std::cref(stage)));
+    }
+}
+
+bool StartupGraph::WaitFor(uint32_t stageMask)
+{
+    if ((stageMask & ~m_stageMask) != 0)
+    {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this, stageMask]()
+    {
+        return (m_doneMask & stageMask) == stageMask || (m_failedMask & stageMask) != 0;
+    });
+    return (m_doneMask & stageMask) == stageMask;
+}
+
+void StartupGraph::Join()
+{
+    for (auto &thread : m_threads)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+uint32_t StartupGraph::GetFailedMask()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failedMask;
+}
+
+void StartupGraph::RunStage(const Stage &stage)
+{
+    uint32_t dependencies = StartupTracker::GetDependencies(stage.stage);
+    bool ready =
+        WaitFor(dependencies & m_stageMask) &&
+        m_tracker->WaitFor(dependencies & ~m_stageMask, m_timeoutMilliseconds);
+
+    bool succeeded = false;
+    if (ready)
+    {
+        m_tracker->Begin(stage.stage);
+        try
+        {
+            succeeded = stage.work();
+        }
+        catch (...)
+        {
+            succeeded = false;
+        }
+    }
+
+    // Ended on the tracker first, so that a thread woken by the graph sees it there too
+    if (succeeded)
+    {
+        m_tracker->End(stage.stage);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (succeeded)
+        {
+            m_doneMask |= StartupStageBit(stage.stage);
+        }
+        else
+        {
+            m_failedMask |= StartupStageBit(stage.stage);
+        }
+    }
+    m_condition.notify_all();
+}
@@ -0,0 +1,91 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "StartupTracker.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SampleCommon
+{
+    // The work of a startup stage; returns false if it failed
+    typedef std::function<bool()> StartupWork;
+
+    // Runs the work of a set of startup stages, each as soon as the stages
+    // it depends on (see StartupTracker::GetDependencies) are done, so that
+    // stages that don't depend on each other run at the same time.
+    //
+    // Each stage runs on a thread of its own. Dependencies on stages of the
+    // graph are on this run of them; dependencies on other stages, e.g. the
+    // renderer assets, are waited for on the tracker. A stage whose work
+    // fails, or whose dependencies failed or timed out, fails, and the
+    // stages depending on it fail without running.
+    //
+    // The stages don't run on the JobSystem: they block, in SDK calls, on
+    // file reads and on the stages outside the graph, for up to seconds,
+    // and would hold its workers, which exist to run the short CPU jobs of
+    // the frames, for as long. A handful of threads, once per launch, costs
+    // less than that.
+    class StartupGraph
+    {
+    public:
+        // timeoutMilliseconds is the longest a stage waits for the stages
+        // outside the graph it depends on; the stages of the graph are all
+        // done or failed eventually, and are waited for as long as it takes
+        StartupGraph(const std::shared_ptr<StartupTracker> &tracker, uint32_t timeoutMilliseconds);
+
+        // Waits for the stages still running
+        ~StartupGraph();
+
+        // Before Start() only
+        void Add(StartupStage stage, const StartupWork &work);
+
+        void Start();
+
+        // After Start() only: waits until all stages of stageMask are done;
+        // false as soon as one of them failed, or at once if one isn't in
+        // the graph
+        bool WaitFor(uint32_t stageMask);
+
+        // Waits until every stage is done or failed
+        void Join();
+
+        uint32_t GetFailedMask();
+
+    private:
+        struct Stage
+        {
+            StartupStage stage;
+            StartupWork work;
+        };
+
+        StartupGraph(const StartupGraph&) = delete;
+        StartupGraph& operator=(const StartupGraph&) = delete;
+
+        void RunStage(const Stage &stage);
+
+        std::shared_ptr<StartupTracker> m_tracker;
+        uint32_t m_timeoutMilliseconds;
+
+        std::vector<Stage> m_stages;
+        uint32_t m_stageMask;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+
+        // Guarded by the mutex
+        uint32_t m_doneMask;
+        uint32_t m_failedMask;
+    };
+} // namespace SampleCommon
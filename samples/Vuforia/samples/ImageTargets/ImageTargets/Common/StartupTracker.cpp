@@ -0,0 +1,230 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "StartupTracker.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace SampleCommon;
+
+namespace
+{
+    const char *const STAGE_NAMES[STARTUP_STAGE_COUNT] = {
+        "sdk init",
+        "tracker init",
+        "dataset prefetch",
+        "dataset load",
+        "renderer assets",
+        "surface",
+        "camera start",
+        "first frame",
+        "first tracked frame"
+    };
+}
+
+StartupTracker::StartupTracker() :
+    m_origin(Clock::now()),
+    m_doneMask(0)
+{
+    memset(m_stages, 0, sizeof(m_stages));
+}
+
+void StartupTracker::Begin(StartupStage stage)
+{
+    double now = GetMilliseconds();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    StartupStageTiming &timing = m_stages[stage];
+    if (!timing.begun)
+    {
+        timing.begun = true;
+        timing.beginMilliseconds = now;
+    }
+}
+
+bool StartupTracker::End(StartupStage stage)
+{
+    double now = GetMilliseconds();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        StartupStageTiming &timing = m_stages[stage];
+        if (timing.done)
+        {
+            return false;
+        }
+
+        if (!timing.begun)
+        {
+            StartupStage dependency = GetLastDependency(stage);
+            timing.begun = true;
+            timing.beginMilliseconds = (dependency != STARTUP_STAGE_COUNT) ?
+                m_stages[dependency].endMilliseconds : 0.0;
+        }
+        timing.done = true;
+        timing.endMilliseconds = now;
+        timing.progress = 100;
+        m_doneMask.fetch_or(StartupStageBit(stage), std::memory_order_release);
+    }
+    m_doneCondition.notify_all();
+    return true;
+}
+
+void StartupTracker::SetProgress(StartupStage stage, int progress)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stages[stage].progress = progress;
+}
+
+bool StartupTracker::WaitFor(uint32_t stageMask, uint32_t timeoutMilliseconds)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_doneCondition.wait_for(lock, std::chrono::milliseconds(timeoutMilliseconds), [this, stageMask]()
+    {
+        return (m_doneMask.load(std::memory_order_relaxed) & stageMask) == stageMask;
+    });
+}
+
+StartupStageTiming StartupTracker::GetTiming(StartupStage stage)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stages[stage];
+}
+
+uint32_t StartupTracker::GetDependencies(StartupStage stage)
+{
+    switch (stage)
+    {
+    case STARTUP_STAGE_TRACKER_INIT:
+        return StartupStageBit(STARTUP_STAGE_SDK_INIT);
+    case STARTUP_STAGE_DATASET_LOAD:
+        return StartupStageBit(STARTUP_STAGE_TRACKER_INIT) |
+            StartupStageBit(STARTUP_STAGE_DATASET_PREFETCH);
+    case STARTUP_STAGE_CAMERA_START:
+        // The datasets are only needed by the trackers, which start after the camera
+        return StartupStageBit(STARTUP_STAGE_SDK_INIT) |
+            StartupStageBit(STARTUP_STAGE_RENDERER_ASSETS) |
+            StartupStageBit(STARTUP_STAGE_SURFACE);
+    case STARTUP_STAGE_FIRST_FRAME:
+        return StartupStageBit(STARTUP_STAGE_CAMERA_START);
+    case STARTUP_STAGE_FIRST_TRACKED_FRAME:
+        return StartupStageBit(STARTUP_STAGE_FIRST_FRAME) |
+            StartupStageBit(STARTUP_STAGE_DATASET_LOAD);
+    default:
+        return 0;
+    }
+}
+
+const char* StartupTracker::GetStageName(StartupStage stage)
+{
+    return (stage >= 0 && stage < STARTUP_STAGE_COUNT) ? STAGE_NAMES[stage] : "unknown";
+}
+
+void StartupTracker::FormatReport(std::string &text)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    char buffer[160];
+
+    // The furthest stage reached: the first tracked frame, or the last stage done
+    StartupStage last = STARTUP_STAGE_COUNT;
+    for (int s = 0; s < STARTUP_STAGE_COUNT; s++)
+    {
+        const StartupStageTiming &timing = m_stages[s];
+        if (timing.done && (last == STARTUP_STAGE_COUNT || timing.endMilliseconds >= m_stages[last].endMilliseconds))
+        {
+            last = static_cast<StartupStage>(s);
+        }
+    }
+    if (m_stages[STARTUP_STAGE_FIRST_TRACKED_FRAME].done)
+    {
+        last = STARTUP_STAGE_FIRST_TRACKED_FRAME;
+    }
+
+    if (last == STARTUP_STAGE_COUNT)
+    {
+        text += "startup: no stage done\n";
+        return;
+    }
+    snprintf(buffer, sizeof(buffer), "startup: %s after %.1f ms\n",
+        STAGE_NAMES[last], m_stages[last].endMilliseconds);
+    text += buffer;
+
+    for (int s = 0; s < STARTUP_STAGE_COUNT; s++)
+    {
+        const StartupStageTiming &timing = m_stages[s];
+        if (timing.done)
+        {
+            snprintf(buffer, sizeof(buffer), "  %s: %.1f to %.1f ms (%.1f ms)\n",
+                STAGE_NAMES[s], timing.beginMilliseconds, timing.endMilliseconds,
+                timing.endMilliseconds - timing.beginMilliseconds);
+        }
+        else if (timing.begun)
+        {
+            snprintf(buffer, sizeof(buffer), "  %s: begun at %.1f ms, %d%%\n",
+                STAGE_NAMES[s], timing.beginMilliseconds, timing.progress);
+        }
+        else
+        {
+            snprintf(buffer, sizeof(buffer), "  %s: pending\n", STAGE_NAMES[s]);
+        }
+        text += buffer;
+    }
+
+    // Back from the furthest stage along the dependencies that ended last
+    std::vector<StartupStage> path;
+    for (StartupStage stage = last; stage != STARTUP_STAGE_COUNT; stage = GetLastDependency(stage))
+    {
+        path.push_back(stage);
+    }
+
+    text += "critical path:\n";
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        const StartupStageTiming &timing = m_stages[*it];
+        double duration = timing.endMilliseconds - timing.beginMilliseconds;
+
+        StartupStage dependency = GetLastDependency(*it);
+        if (dependency == STARTUP_STAGE_COUNT)
+        {
+            snprintf(buffer, sizeof(buffer), "  %s: %.1f ms, began at %.1f ms\n",
+                STAGE_NAMES[*it], duration, timing.beginMilliseconds);
+        }
+        else
+        {
+            snprintf(buffer, sizeof(buffer), "  %s: %.1f ms, began %.1f ms after %s\n",
+                STAGE_NAMES[*it], duration,
+                timing.beginMilliseconds - m_stages[dependency].endMilliseconds,
+                STAGE_NAMES[dependency]);
+        }
+        text += buffer;
+    }
+}
+
+double StartupTracker::GetMilliseconds() const
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - m_origin).count();
+}
+
+StartupStage StartupTracker::GetLastDependency(StartupStage stage) const
+{
+    uint32_t dependencies = GetDependencies(stage);
+    StartupStage last = STARTUP_STAGE_COUNT;
+    for (int s = 0; s < STARTUP_STAGE_COUNT; s++)
+    {
+        if ((dependencies & StartupStageBit(static_cast<StartupStage>(s))) == 0 || !m_stages[s].done)
+        {
+            continue;
+        }
+        if (last == STARTUP_STAGE_COUNT || m_stages[s].endMilliseconds > m_stages[last].endMilliseconds)
+        {
+            last = static_cast<StartupStage>(s);
+        }
+    }
+    return last;
+}
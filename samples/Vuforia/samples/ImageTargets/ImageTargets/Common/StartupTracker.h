@@ -0,0 +1,100 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace SampleCommon
+{
+    // Stages between launch and the first tracked camera frame
+    enum StartupStage
+    {
+        STARTUP_STAGE_SDK_INIT = 0,
+        STARTUP_STAGE_TRACKER_INIT,
+        STARTUP_STAGE_DATASET_PREFETCH, // dataset files read ahead, while the SDK initializes
+        STARTUP_STAGE_DATASET_LOAD,
+        STARTUP_STAGE_RENDERER_ASSETS,  // shaders, meshes and textures loaded
+        STARTUP_STAGE_SURFACE,          // swap chain panel has its size
+        STARTUP_STAGE_CAMERA_START,
+        STARTUP_STAGE_FIRST_FRAME,
+        STARTUP_STAGE_FIRST_TRACKED_FRAME,
+        STARTUP_STAGE_COUNT
+    };
+
+    inline uint32_t StartupStageBit(StartupStage stage) { return 1u << stage; }
+
+    // Start and end of a stage, in milliseconds since the tracker was created
+    struct StartupStageTiming
+    {
+        bool begun;
+        bool done;
+        double beginMilliseconds;
+        double endMilliseconds;
+
+        // Last reported progress, 0 to 100
+        int progress;
+    };
+
+    // Records when each startup stage begins and ends, lets threads wait for
+    // stages to be done, and reports the critical path to the first tracked
+    // frame.
+    //
+    // Only the first run of a stage is recorded: stages done again later,
+    // e.g. renderer assets reloaded after a device loss, keep their startup
+    // timing. A stage that is ended without having begun starts when its
+    // last dependency ended, or at creation if it has none.
+    class StartupTracker
+    {
+    public:
+        StartupTracker();
+
+        void Begin(StartupStage stage);
+
+        // Returns true if this ended the stage, false if it was done before
+        bool End(StartupStage stage);
+
+        void SetProgress(StartupStage stage, int progress);
+
+        // Lock free, for checks on every frame
+        bool IsDone(StartupStage stage) const { return (m_doneMask.load(std::memory_order_acquire) & StartupStageBit(stage)) != 0; }
+
+        // Waits until all stages of stageMask are done; false on timeout
+        bool WaitFor(uint32_t stageMask, uint32_t timeoutMilliseconds);
+
+        StartupStageTiming GetTiming(StartupStage stage);
+
+        // The stages of a stage that must be done before it can begin
+        static uint32_t GetDependencies(StartupStage stage);
+        static const char* GetStageName(StartupStage stage);
+
+        // Stage by stage timings, then the chain of stages the furthest
+        // stage reached waited on, with the time lost between each stage
+        // and the one it waited for
+        void FormatReport(std::string &text);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        double GetMilliseconds() const;
+
+        // The dependency of a stage that ended last, or STARTUP_STAGE_COUNT.
+        // Called with the mutex held.
+        StartupStage GetLastDependency(StartupStage stage) const;
+
+        Clock::time_point m_origin;
+
+        std::mutex m_mutex;
+        std::condition_variable m_doneCondition;
+        StartupStageTiming m_stages[STARTUP_STAGE_COUNT];
+        std::atomic<uint32_t> m_doneMask;
+    };
+} // namespace SampleCommon
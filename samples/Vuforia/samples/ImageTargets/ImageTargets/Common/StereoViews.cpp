@@ -0,0 +1,88 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "StereoViews.h"
+
+using namespace SampleCommon;
+
+ViewportRect StereoUtil::ComputeUnionViewport(const ViewportRect *eyes, size_t eyeCount)
+{
+    if (eyeCount == 0)
+    {
+        ViewportRect empty = { 0.0f, 0.0f, 0.0f, 0.0f };
+        return empty;
+    }
+
+    float left = eyes[0].x;
+    float top = eyes[0].y;
+    float right = eyes[0].x + eyes[0].width;
+    float bottom = eyes[0].y + eyes[0].height;
+
+    for (size_t e = 1; e < eyeCount; ++e)
+    {
+        left = (eyes[e].x < left) ? eyes[e].x : left;
+        top = (eyes[e].y < top) ? eyes[e].y : top;
+        right = (eyes[e].x + eyes[e].width > right) ? eyes[e].x + eyes[e].width : right;
+        bottom = (eyes[e].y + eyes[e].height > bottom) ? eyes[e].y + eyes[e].height : bottom;
+    }
+
+    ViewportRect result = { left, top, right - left, bottom - top };
+    return result;
+}
+
+StereoEyeTransform StereoUtil::ComputeEyeTransform(const ViewportRect &eye, const ViewportRect &unionViewport)
+{
+    if (unionViewport.width <= 0.0f || unionViewport.height <= 0.0f)
+    {
+        return IdentityEyeTransform();
+    }
+
+    StereoEyeTransform transform;
+
+    // Clip space x grows to the right, while y grows upwards and
+    // viewport rows grow downwards
+    transform.scaleX = eye.width / unionViewport.width;
+    transform.scaleY = eye.height / unionViewport.height;
+    transform.offsetX = (2.0f * (eye.x - unionViewport.x) + eye.width) / unionViewport.width - 1.0f;
+    transform.offsetY = 1.0f - (2.0f * (eye.y - unionViewport.y) + eye.height) / unionViewport.height;
+
+    transform.bounds[0] = transform.offsetX - transform.scaleX;
+    transform.bounds[1] = transform.offsetX + transform.scaleX;
+    transform.bounds[2] = transform.offsetY - transform.scaleY;
+    transform.bounds[3] = transform.offsetY + transform.scaleY;
+    return transform;
+}
+
+StereoEyeTransform StereoUtil::IdentityEyeTransform()
+{
+    StereoEyeTransform transform = { 1.0f, 1.0f, 0.0f, 0.0f, { -1.0f, 1.0f, -1.0f, 1.0f } };
+    return transform;
+}
+
+StereoRenderingStats StereoUtil::ComputeDrawCounts(uint32_t augmentationCount, uint32_t eyeCount, bool instanced)
+{
+    uint32_t passCount = (eyeCount > 1 && !instanced) ? eyeCount : 1;
+
+    StereoRenderingStats stats;
+    stats.eyeCount = eyeCount;
+    stats.drawCalls = augmentationCount * passCount;
+    stats.twoPassDrawCalls = augmentationCount * eyeCount;
+    return stats;
+}
+
+void StereoUtil::ApplyEyeTransform(const StereoEyeTransform &transform, const float projection[16], float result[16])
+{
+    const float *row3 = projection + 12;
+    for (int i = 0; i < 4; ++i)
+    {
+        result[i] = transform.scaleX * projection[i] + transform.offsetX * row3[i];
+        result[4 + i] = transform.scaleY * projection[4 + i] + transform.offsetY * row3[i];
+        result[8 + i] = projection[8 + i];
+        result[12 + i] = row3[i];
+    }
+}
@@ -0,0 +1,70 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SampleCommon
+{
+    // Maximum number of views rendered in a single pass
+    static const uint32_t MAX_STEREO_EYES = 2;
+
+    // A viewport in render target pixels, with the origin at the top left.
+    struct ViewportRect
+    {
+        float x;
+        float y;
+        float width;
+        float height;
+    };
+
+    // Maps the clip space of one eye into the clip space of a viewport
+    // spanning all eyes: x' = scaleX * x + offsetX * w, and likewise for y.
+    // bounds holds the clip space rectangle of the eye in the shared
+    // viewport as (left, right, bottom, top), in units of w.
+    struct StereoEyeTransform
+    {
+        float scaleX;
+        float scaleY;
+        float offsetX;
+        float offsetY;
+        float bounds[4];
+    };
+
+    // Per-frame draw counts of the single-pass stereo path.
+    struct StereoRenderingStats
+    {
+        uint32_t eyeCount;
+
+        // Draw calls issued: one instanced draw per augmentation, or a draw
+        // per eye and augmentation on feature level 9 devices
+        uint32_t drawCalls;
+
+        // Draw calls a separate pass per eye would have issued
+        uint32_t twoPassDrawCalls;
+    };
+
+    namespace StereoUtil
+    {
+        // The smallest viewport containing all eye viewports
+        ViewportRect ComputeUnionViewport(const ViewportRect *eyes, size_t eyeCount);
+
+        StereoEyeTransform ComputeEyeTransform(const ViewportRect &eye, const ViewportRect &unionViewport);
+
+        // The transform that leaves a view untouched, for monocular rendering
+        StereoEyeTransform IdentityEyeTransform();
+
+        // The draw counts of drawing augmentationCount augmentations into
+        // eyeCount eyes, instanced or else in a pass per eye
+        StereoRenderingStats ComputeDrawCounts(uint32_t augmentationCount, uint32_t eyeCount, bool instanced);
+
+        // result = transform * projection, for projection matrices stored
+        // row-major and applied to column vectors (clip = projection * p)
+        void ApplyEyeTransform(const StereoEyeTransform &transform, const float projection[16], float result[16]);
+    }
+} // namespace SampleCommon
@@ -18,6 +18,7 @@ using namespace SampleCommon;
 TeapotMesh::TeapotMesh(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
         m_deviceResources(deviceResources), m_indexCount(0)
 {
+    memset(&m_boundingVolume, 0, sizeof(m_boundingVolume));
 }
 
 TeapotMesh::~TeapotMesh()
@@ -39,6 +40,11 @@ void TeapotMesh::InitMesh()
             (float)teapotTexCoords[2 * i + 1]);
     }
 
+    m_boundingVolume = BoundingVolumeUtil::ComputeBoundingVolume(
+        &meshVertices[0].pos.x,
+        NUM_TEAPOT_OBJECT_VERTEX,
+        sizeof(TexturedVertex) / sizeof(float));
+
     D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
     vertexBufferData.pSysMem = meshVertices;
     vertexBufferData.SysMemPitch = 0;
@@ -71,8 +77,13 @@ void TeapotMesh::InitMesh()
 
 void TeapotMesh::ReleaseResources()
 {
-    m_vertexBuffer.Reset();    
-    m_indexBuffer.Reset();
+    ReleaseDeviceResources();
     m_indexCount = 0;
     m_deviceResources.reset();
 }
+
+void TeapotMesh::ReleaseDeviceResources()
+{
+    m_vertexBuffer.Reset();
+    m_indexBuffer.Reset();
+}
@@ -8,6 +8,7 @@ countries.
 
 #include "DeviceResources.h"
 #include "ShaderStructures.h"
+#include "BoundingVolume.h"
 #include "Teapot.h"
 
 #include <wrl.h>
@@ -24,9 +25,13 @@ namespace SampleCommon
         void InitMesh();
         void ReleaseResources();
 
+        // Releases the buffers only, InitMesh() creates them again
+        void ReleaseDeviceResources();
+
         Microsoft::WRL::ComPtr<ID3D11Buffer> & GetVertexBuffer() { return m_vertexBuffer; }
         Microsoft::WRL::ComPtr<ID3D11Buffer> & GetIndexBuffer() { return m_indexBuffer; }
         uint32_t GetIndexCount() const { return m_indexCount; }
+        const BoundingVolume& GetBoundingVolume() const { return m_boundingVolume; }
 
     private:
         // Cached pointer to device resources.
@@ -36,5 +41,8 @@ namespace SampleCommon
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
         Microsoft::WRL::ComPtr<ID3D11Buffer> m_indexBuffer;
         uint32    m_indexCount;
+
+        // Model space bounds, computed when the mesh is created
+        BoundingVolume m_boundingVolume;
     };
 } // namespace SampleCommon
\ No newline at end of file
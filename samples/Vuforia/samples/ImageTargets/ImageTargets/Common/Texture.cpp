@@ -16,7 +16,7 @@ namespace SampleCommon
 {
     Texture::Texture(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
         m_deviceResources(deviceResources), 
-        m_texture(nullptr), m_initialized(false),
+        m_texture(nullptr), m_initialized(false), m_mipBias(0.0f),
         m_imageWidth(0), m_imageHeight(0), m_rowPitch(0), m_imageSize(0)
     {
     }
@@ -28,40 +28,42 @@ namespace SampleCommon
 
     void Texture::CreateFromFile(wchar_t *filename)
     {
-        IWICBitmapDecoder *decoder = nullptr;
-        if (nullptr == m_imagingFactory)
-        {
-            // Create the ImagingFactory
-            DX::ThrowIfFailed(
-                CoCreateInstance(
-                    CLSID_WICImagingFactory, nullptr,
-                    CLSCTX_INPROC_SERVER, IID_PPV_ARGS(m_imagingFactory.GetAddressOf()))
-                );
-        }
+        // The decoder objects are only needed while decoding, only the
+        // pixels are kept
+        Microsoft::WRL::ComPtr<IWICImagingFactory> imagingFactory;
+        Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+        Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+        Microsoft::WRL::ComPtr<IWICFormatConverter> formatConverter;
+
+        // Create the ImagingFactory
+        DX::ThrowIfFailed(
+            CoCreateInstance(
+                CLSID_WICImagingFactory, nullptr,
+                CLSCTX_INPROC_SERVER, IID_PPV_ARGS(imagingFactory.GetAddressOf()))
+            );
 
         DX::ThrowIfFailed(
-            m_imagingFactory->CreateDecoderFromFilename(
+            imagingFactory->CreateDecoderFromFilename(
                 filename,
                 NULL,
                 GENERIC_READ,
                 WICDecodeMetadataCacheOnDemand,
-                &decoder
+                decoder.GetAddressOf()
                 )
             );
 
         // Retrieve the first frame of the image from the decoder
-        IWICBitmapFrameDecode *frame = NULL;
         DX::ThrowIfFailed(
-            decoder->GetFrame(0, &frame)
+            decoder->GetFrame(0, frame.GetAddressOf())
             );
 
         DX::ThrowIfFailed(
-            m_imagingFactory->CreateFormatConverter(m_formatConverter.GetAddressOf())
+            imagingFactory->CreateFormatConverter(formatConverter.GetAddressOf())
             );
 
         DX::ThrowIfFailed(
-            m_formatConverter->Initialize(
-                frame,  // Input bitmap to convert
+            formatConverter->Initialize(
+                frame.Get(),  // Input bitmap to convert
                 GUID_WICPixelFormat32bppBGRA, // Destination pixel format
                 WICBitmapDitherTypeNone,                    
                 nullptr, 
@@ -71,7 +73,7 @@ namespace SampleCommon
             );
         
         DX::ThrowIfFailed(
-            m_formatConverter->GetSize(&m_imageWidth, &m_imageHeight)
+            formatConverter->GetSize(&m_imageWidth, &m_imageHeight)
             );
 
         // Allocate temporary memory for image
@@ -80,7 +82,7 @@ namespace SampleCommon
 
         std::unique_ptr<uint8_t[]> imageBytes(new (std::nothrow) uint8_t[m_imageSize]);
         DX::ThrowIfFailed(
-            m_formatConverter->CopyPixels(
+            formatConverter->CopyPixels(
                 0, static_cast<UINT>(m_rowPitch), static_cast<UINT>(m_imageSize), imageBytes.get()
                 )
             );
@@ -96,11 +98,11 @@ namespace SampleCommon
                 m_rowPitch);
         }
 
-        D3D11_SUBRESOURCE_DATA initData;
-        initData.pSysMem = m_imageBytes.get();
-        initData.SysMemPitch = static_cast<UINT>(m_rowPitch);
-        initData.SysMemSlicePitch = static_cast<UINT>(m_imageSize);
+        CreateDeviceResources();
+    }
 
+    void Texture::CreateDeviceResources()
+    {
         D3D11_TEXTURE2D_DESC texDesc;
         ZeroMemory(&texDesc, sizeof(D3D11_TEXTURE2D_DESC));
         texDesc.Width = m_imageWidth;
@@ -133,6 +135,39 @@ namespace SampleCommon
                 );
         }
 
+        CreateSamplerState();
+    }
+
+    void Texture::Init()
+    {
+        if (m_texture != nullptr)
+        {
+            m_deviceResources->GetD3DDeviceContext()->UpdateSubresource(
+                m_texture.Get(), 0, nullptr, m_imageBytes.get(),
+                static_cast<UINT>(m_rowPitch), static_cast<UINT>(m_imageSize)
+                );
+
+            m_deviceResources->GetD3DDeviceContext()->GenerateMips(m_textureView.Get());
+        }
+        m_initialized = true;
+    }
+
+    void Texture::SetMipBias(float mipBias)
+    {
+        if (mipBias == m_mipBias)
+        {
+            return;
+        }
+
+        m_mipBias = mipBias;
+        if (m_deviceResources != nullptr && m_samplerState != nullptr)
+        {
+            CreateSamplerState();
+        }
+    }
+
+    void Texture::CreateSamplerState()
+    {
         // Create a texture sampler state description.
         D3D11_SAMPLER_DESC samplerDesc;
         ZeroMemory(&samplerDesc, sizeof(D3D11_SAMPLER_DESC));
@@ -140,7 +175,7 @@ namespace SampleCommon
         samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
         samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
         samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-        samplerDesc.MipLODBias = 0.0f;
+        samplerDesc.MipLODBias = m_mipBias;
         samplerDesc.MaxAnisotropy = 1;
         samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
         samplerDesc.BorderColor[0] = 0;
@@ -152,31 +187,22 @@ namespace SampleCommon
 
         DX::ThrowIfFailed(
             m_deviceResources->GetD3DDevice()->CreateSamplerState(
-                &samplerDesc, m_samplerState.GetAddressOf())
+                &samplerDesc, m_samplerState.ReleaseAndGetAddressOf())
             );
     }
 
-    void Texture::Init()
+    void Texture::ReleaseResources()
     {
-        if (m_texture != nullptr)
-        {
-            m_deviceResources->GetD3DDeviceContext()->UpdateSubresource(
-                m_texture.Get(), 0, nullptr, m_imageBytes.get(),
-                static_cast<UINT>(m_rowPitch), static_cast<UINT>(m_imageSize)
-                );
-
-            m_deviceResources->GetD3DDeviceContext()->GenerateMips(m_textureView.Get());
-        }
-        m_initialized = true;
+        ReleaseDeviceResources();
+        m_imageBytes.reset();
+        m_deviceResources.reset();
     }
 
-    void Texture::ReleaseResources()
+    void Texture::ReleaseDeviceResources()
     {
-        m_imagingFactory.Reset();
-        m_formatConverter.Reset();
         m_samplerState.Reset();
         m_textureView.Reset();
         m_texture.Reset();
-        m_deviceResources.reset();
+        m_initialized = false;
     }
 }
\ No newline at end of file
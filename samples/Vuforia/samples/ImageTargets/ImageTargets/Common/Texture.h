@@ -19,16 +19,31 @@ namespace SampleCommon
         Texture(const std::shared_ptr<DX::DeviceResources>& deviceResources);
         ~Texture();
 
+        // Decodes the image, then creates the device resources for it
         void CreateFromFile(wchar_t *filename);
         void Init();
         void ReleaseResources();
 
+        // The decoded image is kept when the device resources are released,
+        // e.g. on a device loss, so that they are created again without
+        // decoding the file again. Init() uploads it again afterwards.
+        bool HasImage() const { return m_imageBytes != nullptr; }
+        void CreateDeviceResources();
+        void ReleaseDeviceResources();
+
+        // Biases the mip level the texture is sampled from; positive values
+        // sample smaller mips, which costs less bandwidth
+        void SetMipBias(float mipBias);
+        float GetMipBias() const { return m_mipBias; }
+
         bool IsInitialized() const { return m_initialized; }
         Microsoft::WRL::ComPtr<ID3D11SamplerState> & GetD3DSamplerState() { return m_samplerState; }
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> & GetD3DTextureView() { return m_textureView; }
         Microsoft::WRL::ComPtr<ID3D11Texture2D> & GetD3DTexture() { return m_texture; }
 
     private:
+        void CreateSamplerState();
+
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources> m_deviceResources;
 
@@ -36,14 +51,12 @@ namespace SampleCommon
         Microsoft::WRL::ComPtr<ID3D11SamplerState>  m_samplerState;
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_textureView;
 
-        Microsoft::WRL::ComPtr<IWICImagingFactory> m_imagingFactory;
-        Microsoft::WRL::ComPtr<IWICFormatConverter> m_formatConverter;
-
         UINT m_imageWidth;
         UINT m_imageHeight;
         size_t m_rowPitch;
         size_t m_imageSize;
         std::unique_ptr<uint8_t[]> m_imageBytes;
         bool m_initialized;
+        float m_mipBias;
     };
 } // SampleCommon
\ No newline at end of file
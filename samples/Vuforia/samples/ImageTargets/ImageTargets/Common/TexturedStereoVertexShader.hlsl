@@ -0,0 +1,57 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+// Draws an instance per eye, each kept within its part of a viewport
+// spanning all eyes. Instance ids and clip distances take feature level 10_0.
+
+// Updated once per frame, with the clip space rectangle of each eye
+cbuffer StereoBoundsConstantBuffer : register(b0)
+{
+    float4 eyeBounds[2];
+};
+
+// Updated once per draw, with one matrix per eye
+cbuffer ModelViewProjectionConstantBuffer : register(b1)
+{
+    matrix modelViewProjection[2];
+};
+
+struct VertexShaderInput
+{
+    float3 pos : POSITION;
+    float2 texcoord : TEXCOORD0;
+    uint instance : SV_InstanceID;
+};
+
+struct PixelShaderInput
+{
+    float4 pos : SV_POSITION;
+    float2 texcoord : TEXCOORD0;
+    float4 clip : SV_ClipDistance0;
+};
+
+PixelShaderInput main(VertexShaderInput input)
+{
+    PixelShaderInput output;
+    float4 pos = float4(input.pos, 1.0f);
+
+    // Each instance draws the augmentation for one eye
+    uint eye = min(input.instance, 1);
+
+    // Transform the vertex position into projected space.
+    pos = mul(pos, modelViewProjection[eye]);
+    output.pos = pos;
+    output.texcoord = input.texcoord;
+
+    // Keep the eye within its own part of the viewport
+    float4 bounds = eyeBounds[eye];
+    output.clip = float4(
+        pos.x - bounds.x * pos.w,
+        bounds.y * pos.w - pos.x,
+        pos.y - bounds.z * pos.w,
+        bounds.w * pos.w - pos.y);
+    return output;
+}
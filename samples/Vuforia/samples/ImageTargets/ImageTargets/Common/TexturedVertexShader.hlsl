@@ -4,11 +4,12 @@ Copyright (c) 2016 PTC Inc. All Rights Reserved.
 Vuforia is a trademark of PTC Inc., registered in the United States and other
 countries.
 ===============================================================================*/
-cbuffer ModelViewProjectionConstantBuffer : register(b0)
+// Draws a single eye, without instancing or clip distances, so that it runs
+// on feature level 9 devices. The constant buffers are laid out like those
+// of TexturedStereoVertexShader; only the first matrix is used.
+cbuffer ModelViewProjectionConstantBuffer : register(b1)
 {
-    matrix model;
-    matrix view;
-    matrix projection;
+    matrix modelViewProjection[2];
 };
 
 struct VertexShaderInput
@@ -29,9 +30,7 @@ PixelShaderInput main(VertexShaderInput input)
     float4 pos = float4(input.pos, 1.0f);
 
     // Transform the vertex position into projected space.
-    pos = mul(pos, model);
-    pos = mul(pos, view);
-    pos = mul(pos, projection);
+    pos = mul(pos, modelViewProjection[0]);
     output.pos = pos;
     output.texcoord = input.texcoord;
     return output;
@@ -0,0 +1,224 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "AtomicPublisher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SampleCommon
+{
+    struct UpdateSubscriberStats
+    {
+        uint32_t id;
+        std::string name;
+        int priority;
+        double budgetMilliseconds;
+
+        uint64_t calls;
+        double lastMilliseconds;
+        double meanMilliseconds;
+        double maxMilliseconds;
+
+        // Calls that took longer than the budget
+        uint64_t overruns;
+    };
+
+    // Hands each update, e.g. each camera frame's state, to a set of
+    // subscribers, highest priority first, and times each of them.
+    //
+    // Subscribers are added and removed from any thread; the list is
+    // published with an AtomicPublisher, so that Dispatch() neither locks
+    // nor allocates. Updates are dispatched from one thread at a time.
+    template <typename TUpdate>
+    class UpdateBus
+    {
+    public:
+        typedef std::function<void(const TUpdate &update)> Handler;
+
+        UpdateBus() :
+            m_nextId(1),
+            m_overruns(0)
+        {
+            m_subscribers.Publish(std::make_shared<const SubscriberList>());
+        }
+
+        // Subscribers of equal priority are called in the order they were
+        // added. budgetMilliseconds is the time a call may take before it
+        // counts as an overrun. Returns the id to unsubscribe with.
+        uint32_t Subscribe(const char *name, int priority, double budgetMilliseconds, const Handler &handler)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto subscriber = std::make_shared<Subscriber>(m_nextId++, name, priority, budgetMilliseconds, handler);
+
+            auto subscribers = std::make_shared<SubscriberList>(*m_subscribers.Acquire());
+            auto position = std::upper_bound(subscribers->begin(), subscribers->end(), subscriber,
+                [](const std::shared_ptr<Subscriber> &a, const std::shared_ptr<Subscriber> &b)
+            {
+                return a->priority > b->priority;
+            });
+            subscribers->insert(position, subscriber);
+            m_subscribers.Publish(subscribers);
+            return subscriber->id;
+        }
+
+        // Once it returns, the subscriber's handler isn't running and won't
+        // be called again. Not to be called from a handler.
+        void Unsubscribe(uint32_t id)
+        {
+            std::shared_ptr<Subscriber> removed;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto subscribers = std::make_shared<SubscriberList>(*m_subscribers.Acquire());
+                auto position = std::find_if(subscribers->begin(), subscribers->end(),
+                    [id](const std::shared_ptr<Subscriber> &subscriber) { return subscriber->id == id; });
+                if (position == subscribers->end())
+                {
+                    return;
+                }
+
+                removed = *position;
+                subscribers->erase(position);
+                m_subscribers.Publish(subscribers);
+            }
+
+            // Only the lists published before hold it now; a dispatch still
+            // holding one of those may be calling it. Waiting on the
+            // subscriber rather than on a whole list isn't held up by
+            // dispatches of later lists, nor by GetStats() copies.
+            while (removed.use_count() > 1)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void Dispatch(const TUpdate &update)
+        {
+            std::shared_ptr<const SubscriberList> subscribers = m_subscribers.Acquire();
+            for (const auto &subscriber : *subscribers)
+            {
+                Clock::time_point start = Clock::now();
+                subscriber->handler(update);
+                uint64_t nanoseconds = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+                // Written by the dispatching thread only, read by any
+                subscriber->calls.store(subscriber->calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                subscriber->totalNanoseconds.store(
+                    subscriber->totalNanoseconds.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+                subscriber->lastNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+                if (nanoseconds > subscriber->maxNanoseconds.load(std::memory_order_relaxed))
+                {
+                    subscriber->maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+                }
+                if (nanoseconds > subscriber->budgetNanoseconds)
+                {
+                    subscriber->overruns.store(subscriber->overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    m_overruns.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Overruns of all subscribers so far, cheap enough to poll every update
+        uint64_t GetOverrunCount() const { return m_overruns.load(std::memory_order_relaxed); }
+
+        // In dispatch order
+        void GetStats(std::vector<UpdateSubscriberStats> &stats) const
+        {
+            std::shared_ptr<const SubscriberList> subscribers = m_subscribers.Acquire();
+            stats.clear();
+            for (const auto &subscriber : *subscribers)
+            {
+                UpdateSubscriberStats entry;
+                entry.id = subscriber->id;
+                entry.name = subscriber->name;
+                entry.priority = subscriber->priority;
+                entry.budgetMilliseconds = subscriber->budgetNanoseconds / 1e6;
+                entry.calls = subscriber->calls.load(std::memory_order_relaxed);
+                entry.lastMilliseconds = subscriber->lastNanoseconds.load(std::memory_order_relaxed) / 1e6;
+                entry.meanMilliseconds = (entry.calls > 0) ?
+                    subscriber->totalNanoseconds.load(std::memory_order_relaxed) / 1e6 / entry.calls : 0.0;
+                entry.maxMilliseconds = subscriber->maxNanoseconds.load(std::memory_order_relaxed) / 1e6;
+                entry.overruns = subscriber->overruns.load(std::memory_order_relaxed);
+                stats.push_back(entry);
+            }
+        }
+
+        void FormatReport(std::string &text) const
+        {
+            std::vector<UpdateSubscriberStats> stats;
+            GetStats(stats);
+
+            char buffer[200];
+            text += "update subscribers:\n";
+            for (const auto &entry : stats)
+            {
+                snprintf(buffer, sizeof(buffer),
+                    "  %s (priority %d): %llu calls, last %.2f ms, mean %.2f ms, max %.2f ms, %llu over %.2f ms\n",
+                    entry.name.c_str(), entry.priority, static_cast<unsigned long long>(entry.calls),
+                    entry.lastMilliseconds, entry.meanMilliseconds, entry.maxMilliseconds,
+                    static_cast<unsigned long long>(entry.overruns), entry.budgetMilliseconds);
+                text += buffer;
+            }
+        }
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Subscriber
+        {
+            Subscriber(uint32_t subscriberId, const char *subscriberName, int subscriberPriority,
+                double budgetMilliseconds, const Handler &subscriberHandler) :
+                id(subscriberId),
+                name(subscriberName),
+                priority(subscriberPriority),
+                budgetNanoseconds(static_cast<uint64_t>(budgetMilliseconds * 1e6)),
+                handler(subscriberHandler),
+                calls(0),
+                totalNanoseconds(0),
+                lastNanoseconds(0),
+                maxNanoseconds(0),
+                overruns(0)
+            {
+            }
+
+            const uint32_t id;
+            const std::string name;
+            const int priority;
+            const uint64_t budgetNanoseconds;
+            const Handler handler;
+
+            std::atomic<uint64_t> calls;
+            std::atomic<uint64_t> totalNanoseconds;
+            std::atomic<uint64_t> lastNanoseconds;
+            std::atomic<uint64_t> maxNanoseconds;
+            std::atomic<uint64_t> overruns;
+        };
+
+        typedef std::vector<std::shared_ptr<Subscriber>> SubscriberList;
+
+        UpdateBus(const UpdateBus&) = delete;
+        UpdateBus& operator=(const UpdateBus&) = delete;
+
+        // Serializes the subscribers' changes; Dispatch() doesn't take it
+        std::mutex m_mutex;
+        uint32_t m_nextId;
+
+        AtomicPublisher<SubscriberList> m_subscribers;
+        std::atomic<uint64_t> m_overruns;
+    };
+} // namespace SampleCommon
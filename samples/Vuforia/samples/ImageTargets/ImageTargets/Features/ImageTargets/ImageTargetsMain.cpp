@@ -7,30 +7,51 @@ countries.
 #include "pch.h"
 #include "ImageTargetsMain.h"
 #include "Common\DirectXHelper.h"
+#include "Common\SampleUtil.h"
 #include <Vuforia\Vuforia_UWP.h>
 
+#include <chrono>
+#include <cstdio>
+
 using namespace ImageTargets;
 using namespace Windows::Foundation;
 using namespace Windows::System::Threading;
 using namespace Concurrency;
 
+// Without camera frames, e.g. while Vuforia is stopped, the render loop still
+// wakes this often to check whether it should stop
+static const uint32_t IDLE_WAIT_MILLISECONDS = 100;
+
+// Presented frames kept in the latency trace, a few seconds' worth
+static const size_t LATENCY_TRACE_CAPACITY = 300;
+
+// The frame pipeline stats are logged at most this often
+static const double PIPELINE_STATS_LOG_INTERVAL_SECONDS = 5.0;
+
 // Loads and initializes application assets when the application is loaded.
 ImageTargetsMain::ImageTargetsMain(
     const std::shared_ptr<DX::DeviceResources>& deviceResources,
     const std::shared_ptr<AppSession>& appSession) :
     m_deviceResources(deviceResources),
-    m_appSession(appSession)
+    m_appSession(appSession),
+    m_frameRateGovernor(SampleCommon::FrameRateGovernor::GetDefaultSettings()),
+    m_renderedFrameMilliseconds(-1.0),
+    m_latencyTracker(LATENCY_TRACE_CAPACITY),
+    m_pipelineStatsLogTime(0.0)
 {
+    memset(&m_pipelineStats, 0, sizeof(m_pipelineStats));
+
     // Register to be notified if the Device is lost or recreated
     m_deviceResources->RegisterDeviceNotify(this);
 
+    m_jobSystem = std::make_shared<SampleCommon::JobSystem>(SampleCommon::JobSystem::GetDefaultWorkerCount());
+
     // Init the Image Targets scene renderer
-    m_imageTargetsRenderer = std::unique_ptr<ImageTargetsRenderer>(new ImageTargetsRenderer(m_deviceResources));
+    m_imageTargetsRenderer = std::unique_ptr<ImageTargetsRenderer>(
+        new ImageTargetsRenderer(m_deviceResources, m_jobSystem, m_appSession->GetStartupTracker()));
 
-    // We set the desired frame rate here
-    float fps = 30;
-    m_timer.SetFixedTimeStep(true);
-    m_timer.SetTargetElapsedSeconds(1.0 / fps);
+    // The render loop runs once per camera frame, so the timer follows it
+    m_timer.SetFixedTimeStep(false);
 }
 
 ImageTargetsMain::~ImageTargetsMain()
@@ -49,6 +70,12 @@ void ImageTargetsMain::CreateWindowSizeDependentResources()
     // inform Vuforia of the window size change
     Vuforia::onSurfaceChanged((int)screenSize.Width, (int)screenSize.Height);
 
+    // The camera isn't started before the video background can be sized
+    if (screenSize.Width > 0 && screenSize.Height > 0)
+    {
+        m_appSession->GetStartupTracker()->End(SampleCommon::STARTUP_STAGE_SURFACE);
+    }
+
     if (m_imageTargetsRenderer->IsVuforiaStarted())
     {
         m_appSession->ConfigureVideoBackground(
@@ -72,14 +99,66 @@ void ImageTargetsMain::StartRenderLoop()
     // Create a task that will be run on a background thread.
     auto workItemHandler = ref new WorkItemHandler([this](IAsyncAction ^ action)
     {
-        // Calculate the updated frame and render once per vertical blanking interval.
+        // Render once per new camera frame, rather than once per vertical blank:
+        // the camera is slower than the display, and redrawing the same frame
+        // only burns power. The CPU work of the frame was done by the tracking
+        // thread, see ImageTargetsRenderer::PrepareFrame, so only the draws happen here.
         while (action->Status == AsyncStatus::Started)
         {
-            critical_section::scoped_lock lock(m_criticalSection);
-            Update();
-            if (Render())
+            SampleCommon::FrameWakeReason wakeReason = m_frameScheduler.WaitForFrame(IDLE_WAIT_MILLISECONDS);
+            if (wakeReason == SampleCommon::FRAME_WAKE_TIMEOUT || action->Status != AsyncStatus::Started)
+            {
+                continue;
+            }
+
+            RunMainThreadJobs();
+
+            bool rendered;
+            auto start = std::chrono::high_resolution_clock::now();
+            {
+                critical_section::scoped_lock lock(m_criticalSection);
+                auto locked = std::chrono::high_resolution_clock::now();
+                m_pipelineStats.renderLockWaitMilliseconds =
+                    std::chrono::duration<double, std::milli>(locked - start).count();
+
+                Update();
+                rendered = Render();
+            }
+
+            // Presenting waits for the vertical blank, which must not block window events.
+            // The frame latency is 1, so at most one frame is queued for display, and
+            // the next camera frame is waited for only once this one has been handed over.
+            if (rendered)
             {
-                m_deviceResources->Present();
+                auto presentStart = std::chrono::high_resolution_clock::now();
+                {
+                    critical_section::scoped_lock lock(m_presentLock);
+                    m_deviceResources->Present();
+                }
+                auto presentEnd = std::chrono::high_resolution_clock::now();
+
+                SampleCommon::FrameLatencyRecord latency = m_imageTargetsRenderer->GetFrameLatencyRecord();
+                latency.times[SampleCommon::LATENCY_STAGE_PRESENTED] = SampleCommon::LatencyTracker::Now();
+                m_latencyTracker.AddFrame(latency);
+
+                double renderLockWait = m_pipelineStats.renderLockWaitMilliseconds;
+                m_pipelineStats = m_imageTargetsRenderer->GetFramePipelineStats();
+                m_pipelineStats.renderLockWaitMilliseconds = renderLockWait;
+                m_pipelineStats.presentMilliseconds =
+                    std::chrono::duration<double, std::milli>(presentEnd - presentStart).count();
+                m_renderedFrameMilliseconds =
+                    m_pipelineStats.prepareMilliseconds +
+                    m_pipelineStats.submitMilliseconds +
+                    m_pipelineStats.presentMilliseconds;
+
+                double presentTime = latency.times[SampleCommon::LATENCY_STAGE_PRESENTED];
+                if (presentTime - m_pipelineStatsLogTime >= PIPELINE_STATS_LOG_INTERVAL_SECONDS)
+                {
+                    LogPipelineStats();
+                    m_pipelineStatsLogTime = presentTime;
+                }
+
+                m_frameScheduler.FrameRendered(wakeReason == SampleCommon::FRAME_WAKE_NEW_FRAME);
             }
         }
     });
@@ -91,6 +170,71 @@ void ImageTargetsMain::StartRenderLoop()
 void ImageTargetsMain::StopRenderLoop()
 {
     m_renderLoopWorker->Cancel();
+    m_frameScheduler.Wake();
+}
+
+// Render thread: the totals of the pipeline and the stages of the last frame
+void ImageTargetsMain::LogPipelineStats()
+{
+    char buffer[320];
+    snprintf(buffer, sizeof(buffer),
+        "%u frames rendered, %u dropped, %u repeated. Last frame: prepare %.2f ms, submit %.2f ms, "
+        "present %.2f ms, lock waits %.2f/%.2f ms, %u bytes of constant data uploaded",
+        m_pipelineStats.framesRendered,
+        m_pipelineStats.framesDropped,
+        m_pipelineStats.framesRepeated,
+        m_pipelineStats.prepareMilliseconds,
+        m_pipelineStats.submitMilliseconds,
+        m_pipelineStats.presentMilliseconds,
+        m_pipelineStats.prepareLockWaitMilliseconds,
+        m_pipelineStats.renderLockWaitMilliseconds,
+        m_pipelineStats.constantBufferBytes);
+    SampleCommon::SampleUtil::Log("ImageTargetsMain", SampleCommon::SampleUtil::ToPlatformString(buffer));
+}
+
+void ImageTargetsMain::PrepareFrame(const Vuforia::State &state, double callbackTime)
+{
+    bool tracking = state.getNumTrackableResults() > 0;
+    const SampleCommon::FrameRateDecision &decision =
+        m_frameRateGovernor.Update(tracking, m_renderedFrameMilliseconds.exchange(-1.0));
+
+    m_imageTargetsRenderer->SetTextureMipBias(decision.textureMipBias);
+
+    // Skipped states aren't prepared either, which saves their CPU work too
+    if (!decision.render)
+    {
+        return;
+    }
+
+    if (m_imageTargetsRenderer->PrepareFrame(state, callbackTime))
+    {
+        m_frameScheduler.NotifyFrame();
+    }
+}
+
+void ImageTargetsMain::PostToRenderThread(const std::function<void()> &action)
+{
+    // The render loop may be waiting for the next camera frame
+    m_jobSystem->RunOnMainThread(action);
+    m_frameScheduler.Wake();
+}
+
+void ImageTargetsMain::RunMainThreadJobs()
+{
+    if (!m_jobSystem->HasMainThreadJobs())
+    {
+        return;
+    }
+
+    critical_section::scoped_lock lock(m_criticalSection);
+    m_jobSystem->RunMainThreadJobs();
+}
+
+void ImageTargetsMain::Trim()
+{
+    critical_section::scoped_lock lock(m_criticalSection);
+    critical_section::scoped_lock presentLock(m_presentLock);
+    m_deviceResources->Trim();
 }
 
 // Updates the application state once per frame.
@@ -8,9 +8,16 @@ countries.
 
 #include "Common\StepTimer.h"
 #include "Common\DeviceResources.h"
+#include "Common\FrameRateGovernor.h"
+#include "Common\FrameScheduler.h"
+#include "Common\JobSystem.h"
+#include "Common\LatencyTracker.h"
 #include "Features\ImageTargets\ImageTargetsRenderer.h"
 #include "SampleApplication\AppSession.h"
 
+#include <atomic>
+#include <functional>
+
 // Renders Direct2D and 3D content on the screen.
 namespace ImageTargets
 {
@@ -25,8 +32,39 @@ namespace ImageTargets
         void CreateWindowSizeDependentResources();
         void StartRenderLoop();
         void StopRenderLoop();
+
+        // Called on the tracking thread with each new Vuforia state; wakes
+        // the render loop once the state's frame is ready to be drawn.
+        // The frame rate governor decides whether the state is drawn at all.
+        // callbackTime is when Vuforia's callback received the state.
+        void PrepareFrame(const Vuforia::State &state, double callbackTime);
+
+        // Tracking thread only: the governor's decision for the last state
+        const SampleCommon::FrameRateDecision& GetFrameRateDecision() const { return m_frameRateGovernor.GetDecision(); }
         Concurrency::critical_section& GetCriticalSection() { return m_criticalSection; }
 
+        // Runs an action on the render thread before its next frame. Window
+        // events use this for their device work, so that they never wait
+        // for the render thread to finish a frame or a Present.
+        void PostToRenderThread(const std::function<void()> &action);
+
+        // Releases temporary device memory, for suspension
+        void Trim();
+
+        // Worker threads shared by the application
+        const std::shared_ptr<SampleCommon::JobSystem>& GetJobSystem() const { return m_jobSystem; }
+
+        // Duplicate frames, frame interval jitter and duty cycle of the render loop.
+        // Only consistent when read on the render thread.
+        const SampleCommon::FrameSchedulerStats& GetFrameSchedulerStats() const { return m_frameScheduler.GetStats(); }
+
+        // Hand-off and stage timings of the last frame
+        const SampleCommon::FramePipelineStats& GetFramePipelineStats() const { return m_pipelineStats; }
+
+        // Latency from camera capture to present of the presented frames.
+        // Only consistent when read on the render thread.
+        const SampleCommon::LatencyTracker& GetLatencyTracker() const { return m_latencyTracker; }
+
         // IDeviceNotify
         virtual void OnDeviceLost();
         virtual void OnDeviceRestored();
@@ -36,20 +74,48 @@ namespace ImageTargets
         ImageTargetsRenderer* GetRenderer() { return m_imageTargetsRenderer.get(); }
 
     private:
+        void RunMainThreadJobs();
         void ProcessInput();
         void Update();
         bool Render();
+        void LogPipelineStats();
 
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources> m_deviceResources;
         std::shared_ptr<AppSession> m_appSession;
 
+        // Worker threads for the CPU work of the application. The render
+        // thread is its main thread: it runs the jobs posted to it between frames.
+        std::shared_ptr<SampleCommon::JobSystem> m_jobSystem;
+
         // Image Targets scene renderer
         std::shared_ptr<ImageTargetsRenderer> m_imageTargetsRenderer;
 
         Windows::Foundation::IAsyncAction^ m_renderLoopWorker;
+
+        // Paces the render loop by the camera frames
+        SampleCommon::FrameScheduler m_frameScheduler;
+
+        // Lowers the frame rate while nothing is tracked, and the quality while
+        // frames overrun. Used by the tracking thread, which the render thread
+        // tells the time of each frame it renders.
+        SampleCommon::FrameRateGovernor m_frameRateGovernor;
+        std::atomic<double> m_renderedFrameMilliseconds;
+
+        // Held by the render thread while it updates and draws a frame, but
+        // not while it presents it
         Concurrency::critical_section m_criticalSection;
 
+        // Held while presenting, only needed by device work that can't be
+        // posted to the render thread
+        Concurrency::critical_section m_presentLock;
+
+        SampleCommon::FramePipelineStats m_pipelineStats;
+        SampleCommon::LatencyTracker m_latencyTracker;
+
+        // Render thread only: when the pipeline stats were last logged
+        double m_pipelineStatsLogTime;
+
         // Rendering loop timer.
         SampleCommon::StepTimer m_timer;
     };
@@ -15,6 +15,7 @@ countries.
 #include <Vuforia\CameraDevice.h>
 #include <Vuforia\Device.h>
 #include <Vuforia\DXRenderer.h>
+#include <Vuforia\Frame.h>
 #include <Vuforia\Renderer.h>
 #include <Vuforia\Tool.h>
 #include <Vuforia\VideoBackgroundConfig.h>
@@ -24,6 +25,9 @@ countries.
 #include <Vuforia\TrackableResult.h>
 #include <Vuforia\ImageTarget.h>
 
+#include <cfloat>
+#include <chrono>
+
 using namespace ImageTargets;
 using namespace DirectX;
 using namespace Windows::Foundation;
@@ -32,19 +36,69 @@ using namespace Microsoft::WRL;
 static const float TEAPOT_SCALE = 0.003f;
 static const float TOWER_SCALE = 0.012f;
 
+// Names the scene description uses for the meshes and textures,
+// indexed by AugmentationMesh and AugmentationTexture
+static const char *const MESH_NAMES[] = { "teapot", "tower" };
+static const char *const TEXTURE_NAMES[] = { "teapot_blue", "teapot_brass", "teapot_red", "tower" };
+
+// Set to true for rendering translucent models
+static const bool TRANSLUCENT_AUGMENTATION = false;
+
+// Render queues smaller than this are recorded directly on the immediate
+// context, as the deferred context overhead outweighs the parallelism
+static const size_t PARALLEL_RECORDING_MIN_DRAWS = 32;
+static const uint32_t DRAWS_PER_RECORDING_JOB = 16;
+
+// Constant data of one frame: the eye bounds and one model-view-projection per draw,
+// each padded to 256 bytes, so this holds about a thousand draws per frame
+static const uint32_t CONSTANT_BUFFER_RING_SIZE = 1024 * 1024;
+
+// Passes that can be in flight before their GPU time is read back
+static const uint32_t AUGMENTATION_TIMER_LATENCY = 3;
+
+// Camera capture, tracking, rendering and presentation of a frame
+static const float DEFAULT_PREDICTION_HORIZON_MILLISECONDS = 50.0f;
+
 static const float VIRTUAL_FOV_Y_DEGS = 85.0f;
 static const float M_PI = 3.14159f;
 
 
 // Loads vertex and pixel shaders from files, create the teapot mesh and load the textures.
-ImageTargetsRenderer::ImageTargetsRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
+ImageTargetsRenderer::ImageTargetsRenderer(
+    const std::shared_ptr<DX::DeviceResources>& deviceResources,
+    const std::shared_ptr<SampleCommon::JobSystem>& jobSystem,
+    const std::shared_ptr<SampleCommon::StartupTracker>& startupTracker) :
     m_deviceResources(deviceResources),
+    m_jobSystem(jobSystem),
+    m_startupTracker(startupTracker),
     m_rendererInitialized(false),
     m_vuforiaInitialized(false),
     m_vuforiaStarted(false),
-    m_extTracking(false)
+    m_extTracking(false),
+    m_textureMipBias(0.0f),
+    m_posePrediction(true),
+    m_predictionHorizonMilliseconds(DEFAULT_PREDICTION_HORIZON_MILLISECONDS),
+    m_posePredictor(SampleCommon::PosePredictor::GetDefaultSettings()),
+    m_reprojectionMode(SampleCommon::REPROJECTION_PLANAR),
+    m_resolutionController(SampleCommon::ResolutionController::GetDefaultSettings()),
+    m_resolutionScale(1.0f),
+    m_constantBufferBytes(0)
 {
-    memset(&m_cameraProjection, 0, sizeof(float) * 16);
+    memset(&m_stereoStats, 0, sizeof(m_stereoStats));
+    memset(&m_commandRecordingStats, 0, sizeof(m_commandRecordingStats));
+    memset(&m_cullingStats, 0, sizeof(m_cullingStats));
+    memset(&m_renderQueueStats, 0, sizeof(m_renderQueueStats));
+    memset(&m_pipelineStats, 0, sizeof(m_pipelineStats));
+    memset(&m_reprojectionStats, 0, sizeof(m_reprojectionStats));
+    memset(&m_frameLatency, 0, sizeof(m_frameLatency));
+
+    // Set the model matrices (the 'model' part of the 'model-view' matrix)
+    auto teapotScale = XMMatrixScaling(TEAPOT_SCALE, TEAPOT_SCALE, TEAPOT_SCALE);
+    XMStoreFloat4x4(&m_meshModelMatrices[MESH_TEAPOT], XMMatrixIdentity() * teapotScale);
+
+    auto towerScale = XMMatrixScaling(TOWER_SCALE, TOWER_SCALE, TOWER_SCALE);
+    auto towerRotation = XMMatrixTranspose(XMMatrixRotationX(3.14159f / 2));
+    XMStoreFloat4x4(&m_meshModelMatrices[MESH_TOWER], XMMatrixIdentity() * towerRotation * towerScale);
     CreateDeviceDependentResources();
     CreateWindowSizeDependentResources();
 }
@@ -71,27 +125,14 @@ void ImageTargetsRenderer::CreateWindowSizeDependentResources()
 
 void ImageTargetsRenderer::UpdateRenderingPrimitives()
 {
-    Concurrency::critical_section::scoped_lock lock(m_renderingPrimitivesLock);
-    if (m_renderingPrimitives != nullptr)
-    {
-        m_renderingPrimitives.reset();
-    }
-    m_renderingPrimitives = std::shared_ptr<Vuforia::RenderingPrimitives>(
+    auto renderingPrimitives = std::shared_ptr<Vuforia::RenderingPrimitives>(
         new Vuforia::RenderingPrimitives(Vuforia::Device::getInstance().getRenderingPrimitives())
         );
 
-    // Calculate the DX Projection matrix
-    auto projectionMatrix = Vuforia::Tool::convertPerspectiveProjection2GLMatrix(
-        m_renderingPrimitives->getProjectionMatrix(Vuforia::VIEW_SINGULAR, Vuforia::COORDINATE_SYSTEM_CAMERA), 
-        m_near, m_far);
-
-    XMFLOAT4X4 dxProjection;
-    memcpy(dxProjection.m, projectionMatrix.data, sizeof(float) * 16);
-    XMStoreFloat4x4(&dxProjection, XMMatrixTranspose(XMLoadFloat4x4(&dxProjection)));
-
-    m_cameraProjection = dxProjection;
-
-    m_videoBackground->ResetForNewRenderingPrimitives();
+    // The configuration is complete before it is published, so frames
+    // never see a partial update. The video background is reset by the
+    // render thread, once it draws a frame prepared with the new one.
+    m_viewConfiguration.Publish(CreateViewConfiguration(renderingPrimitives));
 }
 
 // Called once per frame
@@ -102,6 +143,9 @@ void ImageTargetsRenderer::Update(SampleCommon::StepTimer const& timer)
 // Renders one frame using the vertex and pixel shaders.
 void ImageTargetsRenderer::Render()
 {
+    // A present without a displayed camera frame is traced without stage times
+    memset(&m_frameLatency, 0, sizeof(m_frameLatency));
+
     // Vuforia initialization and data loading is asynchronous.
     // Only starts rendering after Vuforia init/loading is complete.
     if (!m_rendererInitialized || !m_vuforiaStarted)
@@ -109,270 +153,899 @@ void ImageTargetsRenderer::Render()
         return;
     }
 
-    // Get the state from Vuforia and mark the beginning of a rendering section
-    Vuforia::DXRenderData dxRenderData(m_deviceResources->GetD3DDevice());
+    // The latest frame prepared by the tracking thread; the same frame is
+    // drawn again when tracking hasn't produced a new one since
+    const PreparedFrame *frame = m_preparedFrames.Acquire();
+    if (frame == nullptr)
+    {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Textures recreated after a device loss start unbiased, so this is checked every frame
+    float mipBias = m_textureMipBias;
+    for (auto &texture : m_textures)
+    {
+        texture->SetMipBias(mipBias);
+    }
+
+    // The time of an earlier augmentation pass picks the scale of this one
+    double augmentationMilliseconds;
+    if (m_augmentationTimer->TryGetMilliseconds(augmentationMilliseconds))
+    {
+        m_resolutionScale = m_resolutionController.Update(augmentationMilliseconds);
+    }
+
+    m_constantBufferBytes = 0;
+    m_constantBufferRing->BeginFrame();
+
+    // The augmentations are rendered offscreen first, with the poses of the frame
     Vuforia::Renderer &vuforiaRenderer = Vuforia::Renderer::getInstance();
-    Vuforia::State state = vuforiaRenderer.begin(&dxRenderData);
+    RenderAugmentations(vuforiaRenderer, *frame);
+    m_renderedView = frame->view;
+    m_renderedPoses.assign(frame->trackedPoses.begin(), frame->trackedPoses.end());
+
+    // Tracking may have prepared a newer frame while they were rendered. Its
+    // camera image is drawn then, and the augmentations are warped to its
+    // poses, so they stay on their targets however long they took to render.
+    // The first frame may be reused by the tracking thread from here on.
+    const PreparedFrame *displayed = frame;
+    if (m_reprojectionMode != SampleCommon::REPROJECTION_OFF)
+    {
+        const PreparedFrame *newer = m_preparedFrames.AcquireNewer();
+        displayed = (newer != nullptr) ? newer : frame;
+    }
+    bool reproject = displayed != frame;
+
+    // Mark the beginning of a rendering section for the displayed frame's state
+    Vuforia::DXRenderData dxRenderData(m_deviceResources->GetD3DDevice());
+    vuforiaRenderer.begin(displayed->state, &dxRenderData);
+    double renderBeginTime = SampleCommon::LatencyTracker::Now();
+
+    RenderVideoBackground(vuforiaRenderer, *displayed);
+    CompositeAugmentations(*displayed, reproject);
 
-    RenderScene(vuforiaRenderer, state);
+    m_constantBufferRing->EndFrame();
 
     Vuforia::Renderer::getInstance().end();
+
+    // The present time is added by the caller
+    m_frameLatency.frameId = displayed->frameId;
+    m_frameLatency.times[SampleCommon::LATENCY_STAGE_CAPTURE] = displayed->cameraTimestamp;
+    m_frameLatency.times[SampleCommon::LATENCY_STAGE_CALLBACK] = displayed->callbackTime;
+    m_frameLatency.times[SampleCommon::LATENCY_STAGE_RENDER_BEGIN] = renderBeginTime;
+    m_frameLatency.times[SampleCommon::LATENCY_STAGE_SUBMITTED] = SampleCommon::LatencyTracker::Now();
+    m_frameLatency.times[SampleCommon::LATENCY_STAGE_PRESENTED] = 0.0;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    m_pipelineStats.framesPrepared = m_preparedFrames.GetPublishedCount();
+    m_pipelineStats.framesRendered++;
+    m_pipelineStats.framesDropped = m_preparedFrames.GetDroppedCount();
+    m_pipelineStats.framesRepeated = m_preparedFrames.GetRepeatedCount();
+    m_pipelineStats.prepareMilliseconds = displayed->prepareMilliseconds;
+    m_pipelineStats.prepareLockWaitMilliseconds = displayed->lockWaitMilliseconds;
+    m_pipelineStats.submitMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    m_pipelineStats.constantBufferBytes = m_constantBufferBytes;
 }
 
-void ImageTargetsRenderer::RenderScene(Vuforia::Renderer &renderer, Vuforia::State &state)
+void ImageTargetsRenderer::GetProjectionMatrix(
+    const Vuforia::RenderingPrimitives &renderingPrimitives,
+    Vuforia::VIEW viewId,
+    XMFLOAT4X4 &projection)
 {
-    Concurrency::critical_section::scoped_lock lock(m_renderingPrimitivesLock);
+    auto projection44F = Vuforia::Tool::convertPerspectiveProjection2GLMatrix(
+        renderingPrimitives.getProjectionMatrix(viewId, Vuforia::COORDINATE_SYSTEM_CAMERA),
+        m_near, m_far);
+
+    XMFLOAT4X4 projectionDX;
+    SampleCommon::SampleMath::FromGLMatrix(projection44F.data, &projectionDX.m[0][0]);
 
-    Vuforia::ViewList &viewList = m_renderingPrimitives->getRenderingViews();
-    if (!viewList.contains(Vuforia::VIEW::VIEW_SINGULAR))
+    // Apply the appropriate eye adjustment to the raw projection matrix
+    XMFLOAT4X4 eyeAdjustmentDX;
+    SampleCommon::SampleMath::FromMatrix34(
+        renderingPrimitives.getEyeDisplayAdjustmentMatrix(viewId).data, &eyeAdjustmentDX.m[0][0]);
+
+    SampleCommon::SampleMath::Multiply(&projectionDX.m[0][0], &eyeAdjustmentDX.m[0][0], &projection.m[0][0]);
+}
+
+std::shared_ptr<const ImageTargetsRenderer::ViewConfiguration> ImageTargetsRenderer::CreateViewConfiguration(
+    const std::shared_ptr<Vuforia::RenderingPrimitives> &renderingPrimitives)
+{
+    // Video see-through eyewear renders a view per eye, other devices a single view
+    Vuforia::ViewList &viewList = renderingPrimitives->getRenderingViews();
+    bool stereo = viewList.contains(Vuforia::VIEW::VIEW_LEFTEYE) && viewList.contains(Vuforia::VIEW::VIEW_RIGHTEYE);
+    if (!stereo && !viewList.contains(Vuforia::VIEW::VIEW_SINGULAR))
     {
-        SampleCommon::SampleUtil::Log("ImageTargetsRenderer", "Monocular view not found.");
-        return;
+        SampleCommon::SampleUtil::Log("ImageTargetsRenderer", "Monocular or stereo views not found.");
+        return nullptr;
     }
 
-    auto context = m_deviceResources->GetD3DDeviceContext();
-    XMMATRIX xmCameraProjection = XMLoadFloat4x4(&m_cameraProjection);
+    auto view = std::make_shared<ViewConfiguration>();
+    view->renderingPrimitives = renderingPrimitives;
+    view->eyeCount = stereo ? 2 : 1;
+    view->eyeViews[0] = stereo ? Vuforia::VIEW::VIEW_LEFTEYE : Vuforia::VIEW::VIEW_SINGULAR;
+    view->eyeViews[1] = stereo ? Vuforia::VIEW::VIEW_RIGHTEYE : Vuforia::VIEW::VIEW_SINGULAR;
+
+    // Projection of each eye; in stereo, each eye also has its own viewport
+    for (uint32_t eye = 0; eye < view->eyeCount; eye++)
+    {
+        GetProjectionMatrix(*renderingPrimitives, view->eyeViews[eye], view->eyeProjections[eye]);
+
+        Vuforia::Vec4I viewport = renderingPrimitives->getViewport(view->eyeViews[eye]);
+        SampleCommon::ViewportRect eyeViewport = {
+            static_cast<float>(viewport.data[0]),
+            static_cast<float>(viewport.data[1]),
+            static_cast<float>(viewport.data[2]),
+            static_cast<float>(viewport.data[3])
+        };
+        view->eyeViewports[eye] = eyeViewport;
+    }
 
-    for (size_t v = 0; v < viewList.getNumViews(); v++) 
+    // Augmentations are drawn once for all eyes: each draw has an instance per eye,
+    // which the vertex shader moves into the eye's part of a viewport spanning all eyes.
+    // Feature level 9 devices have neither instance ids nor clip distances, and draw
+    // each eye in a pass of its own instead.
+    view->instancedStereo = stereo &&
+        (m_deviceResources->GetDeviceFeatureLevel() >= D3D_FEATURE_LEVEL_10_0);
+
+    SampleCommon::ViewportRect unionViewport = { 0.0f, 0.0f, 0.0f, 0.0f };
+    if (view->instancedStereo)
     {
-        Vuforia::VIEW viewId = viewList.getView(static_cast<int>(v));
+        unionViewport = SampleCommon::StereoUtil::ComputeUnionViewport(view->eyeViewports, view->eyeCount);
+    }
+    view->unionViewport = unionViewport;
+
+    for (uint32_t eye = 0; eye < SampleCommon::MAX_STEREO_EYES; eye++)
+    {
+        // Monocular rendering draws a single instance, the second slot only mirrors the first
+        uint32_t sourceEye = (eye < view->eyeCount) ? eye : 0;
+        SampleCommon::StereoEyeTransform transform = view->instancedStereo ?
+            SampleCommon::StereoUtil::ComputeEyeTransform(view->eyeViewports[sourceEye], unionViewport) :
+            SampleCommon::StereoUtil::IdentityEyeTransform();
+
+        SampleCommon::StereoUtil::ApplyEyeTransform(
+            transform, &view->eyeProjections[sourceEye].m[0][0], view->unionProjections[eye]);
+        view->frameConstants.eyeBounds[eye] = XMFLOAT4(transform.bounds);
+    }
 
-        // Apply the appropriate eye adjustment to the raw projection matrix, and assign to the global variable
-        Vuforia::Matrix44F eyeAdjustment44F = Vuforia::Tool::convert2GLMatrix(
-            m_renderingPrimitives->getEyeDisplayAdjustmentMatrix(viewId));
+    return view;
+}
+
+bool ImageTargetsRenderer::PrepareFrame(const Vuforia::State &state, double callbackTime)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    Concurrency::critical_section::scoped_lock sceneLock(m_sceneLock);
+    auto locked = std::chrono::high_resolution_clock::now();
+
+    // Checked under the lock, as reloading the scene clears the flag before taking it
+    if (!m_rendererInitialized || !m_vuforiaStarted)
+    {
+        return false;
+    }
 
-        // Convert the matrix to XMFLOAT4X4 format
-        XMFLOAT4X4 eyeAdjustmentDX;
-        memcpy(eyeAdjustmentDX.m, eyeAdjustment44F.data, sizeof(float) * 16);
-        XMStoreFloat4x4(&eyeAdjustmentDX, XMMatrixTranspose(XMLoadFloat4x4(&eyeAdjustmentDX)));
-        XMMATRIX eyeAdjustmentMatrix = XMLoadFloat4x4(&eyeAdjustmentDX);
+    // Never blocks, even while a new configuration is being published
+    std::shared_ptr<const ViewConfiguration> view = m_viewConfiguration.Acquire();
+    if (view == nullptr)
+    {
+        return false;
+    }
 
-        // Compute final adjusted projection matrix
-        XMMATRIX projectionMatrix = xmCameraProjection * eyeAdjustmentMatrix;
+    PreparedFrame &frame = m_preparedFrames.GetWriteBuffer();
+    frame.state = state;
+    frame.view = view;
+
+    // Collect the augmentations of all trackable results, so that they
+    // can be culled and then sorted to minimize state changes before being drawn
+    frame.draws.clear();
+    frame.renderQueue.Clear();
+    frame.candidateModels.clear();
+    frame.trackedPoses.clear();
+    frame.poseBatch.Clear();
+
+    SampleCommon::AugmentationMode mode = m_extTracking ?
+        SampleCommon::AUGMENTATION_MODE_EXTENDED : SampleCommon::AUGMENTATION_MODE_STANDARD;
+
+    // Poses are predicted for the time the frame is expected on the display
+    bool predict = m_posePrediction;
+    double frameTime = state.getFrame().getTimeStamp();
+    frame.frameId = state.getFrame().getIndex();
+    frame.cameraTimestamp = frameTime;
+    frame.callbackTime = callbackTime;
+    double displayTime = frameTime + m_predictionHorizonMilliseconds / 1000.0;
+    float predictedPose[12];
+
+    for (int tIdx = 0; tIdx < state.getNumTrackableResults(); tIdx++)
+    {
+        // Get the trackable:
+        const Vuforia::TrackableResult *result = state.getTrackableResult(tIdx);
+        const Vuforia::Trackable &trackable = result->getTrackable();
 
-        if (viewId == Vuforia::VIEW::VIEW_SINGULAR)
+        // Targets without an augmentation in the scene description aren't drawn
+        uint32_t model = m_augmentationRegistry.Resolve(trackable.getId(), trackable.getName(), mode);
+        if (model == SampleCommon::AugmentationRegistry::INVALID_ENTRY)
         {
-            // Render the camera video background
-            m_videoBackground->Render(renderer, m_renderingPrimitives.get(), viewId);
+            continue;
+        }
 
-            // Setup rendering pipeline for augmentation rendering
-            if (renderer.getVideoBackgroundConfig().mReflection == Vuforia::VIDEO_BACKGROUND_REFLECTION_ON)
-            {
-                context->RSSetState(m_augmentationRasterStateCullFront.Get()); // Typically when using the front facing camera
-            }
-            else
-            {
-                context->RSSetState(m_augmentationRasterStateCullBack.Get()); // Typically when using the rear facing camera
-            }
+        // The history is kept while prediction is disabled, so that it
+        // applies as soon as it is enabled again
+        const float *pose = result->getPose().data;
+        m_posePredictor.AddPose(trackable.getId(), frameTime, pose);
+        if (predict && m_posePredictor.Predict(trackable.getId(), displayTime, predictedPose))
+        {
+            pose = predictedPose;
+        }
 
-            context->OMSetDepthStencilState(m_augmentationDepthStencilState.Get(), 1);
-            context->OMSetBlendState(m_augmentationBlendState.Get(), NULL, 0xffffffff);
+        // Kept for reprojecting the frame's augmentations to a newer frame
+        TrackedPose trackedPose;
+        trackedPose.trackableId = trackable.getId();
+        memcpy(trackedPose.pose, pose, sizeof(trackedPose.pose));
+        frame.trackedPoses.push_back(trackedPose);
+
+        // The pose is only gathered here, the matrices of all results are computed together
+        const AugmentationModel &augmentationModel = m_augmentationModels[model];
+        frame.poseBatch.Add(
+            pose,
+            &augmentationModel.modelMatrix.m[0][0],
+            &augmentationModel.bounds.center.x);
+        frame.candidateModels.push_back(model);
+    }
+    m_posePredictor.Prune(frameTime);
 
-            for (int tIdx = 0; tIdx < state.getNumTrackableResults(); tIdx++)
-            {
-                // Get the trackable:
-                const Vuforia::TrackableResult *result = state.getTrackableResult(tIdx);
-                const Vuforia::Trackable &trackable = result->getTrackable();
-                const char* trackableName = trackable.getName();
-
-                // Set up the modelview matrix
-                auto poseGL = Vuforia::Tool::convertPose2GLMatrix(result->getPose());
-                XMFLOAT4X4 poseDX;
-                memcpy(poseDX.m, poseGL.data, sizeof(float) * 16);
-                XMStoreFloat4x4(&poseDX, XMMatrixTranspose(XMLoadFloat4x4(&poseDX)));
-                XMMATRIX poseMatrix = XMLoadFloat4x4(&poseDX);
-
-                std::shared_ptr<SampleCommon::Texture> texture = GetAugmentationTexture(trackable.getName());
-                if (!texture->IsInitialized()) {
-                    texture->Init();
-                }
+    // Model-view-projection of every result for every eye, and the centers
+    // of their bounding spheres in camera space
+    frame.poseBatch.Compute(view->unionProjections, view->eyeCount);
 
-                if (m_extTracking) {
-                    RenderTower(poseMatrix, projectionMatrix, texture);
-                }
-                else {
-                    RenderTeapot(poseMatrix, projectionMatrix, texture);
-                }
-            }
+    CullAugmentations(frame);
+    for (size_t c = 0; c < frame.candidateModels.size(); c++)
+    {
+        if (m_cullVisible[c])
+        {
+            SubmitAugmentation(frame, static_cast<uint32_t>(c), frame.candidateModels[c]);
         }
     }
+
+    frame.renderQueue.Sort();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    frame.prepareMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    frame.lockWaitMilliseconds = std::chrono::duration<double, std::milli>(locked - start).count();
+    m_preparedFrames.Publish();
+    return true;
 }
 
-void ImageTargetsRenderer::RenderTeapot(
-    const XMMATRIX &poseMatrix,
-    const XMMATRIX &projectionMatrix,
-    const std::shared_ptr<SampleCommon::Texture> texture
-    )
+void ImageTargetsRenderer::RenderVideoBackground(Vuforia::Renderer &renderer, const PreparedFrame &frame)
 {
     auto context = m_deviceResources->GetD3DDeviceContext();
- 
-    auto scale = XMMatrixScaling(TEAPOT_SCALE, TEAPOT_SCALE, TEAPOT_SCALE);
-    auto modelMatrix = XMMatrixIdentity() * scale;
+    const ViewConfiguration &view = *frame.view;
+    bool stereo = view.eyeCount > 1;
 
-    // Set the model matrix (the 'model' part of the 'model-view' matrix)
-    XMStoreFloat4x4(&m_augmentationConstantBufferData.model, modelMatrix);
+    if (frame.view != m_videoBackgroundView)
+    {
+        m_videoBackground->ResetForNewRenderingPrimitives();
+        m_videoBackgroundView = frame.view;
+    }
 
-    // Set the pose matrix (the 'view' part of the 'model-view' matrix)
-    XMStoreFloat4x4(&m_augmentationConstantBufferData.view, poseMatrix);
+    for (uint32_t eye = 0; eye < view.eyeCount; eye++)
+    {
+        if (stereo)
+        {
+            // The video background is drawn separately for each eye, into its own viewport
+            const SampleCommon::ViewportRect &eyeViewport = view.eyeViewports[eye];
+            CD3D11_VIEWPORT d3dViewport(eyeViewport.x, eyeViewport.y, eyeViewport.width, eyeViewport.height);
+            context->RSSetViewports(1, &d3dViewport);
+        }
 
-    // Set the projection matrix
-    XMStoreFloat4x4(&m_augmentationConstantBufferData.projection, projectionMatrix);
+        // Render the camera video background
+        m_videoBackground->Render(renderer, view.renderingPrimitives.get(), view.eyeViews[eye]);
+    }
 
-    // Prepare the constant buffer to send it to the graphics device.
-    context->UpdateSubresource1(
-        m_augmentationConstantBuffer.Get(),
-        0,
-        NULL,
-        &m_augmentationConstantBufferData,
-        0,
-        0,
-        0
-        );
+    if (stereo)
+    {
+        auto viewport = m_deviceResources->GetScreenViewport();
+        context->RSSetViewports(1, &viewport);
+    }
+}
 
-    // Each vertex is one instance of the TexturedVertex struct.
-    UINT stride = sizeof(SampleCommon::TexturedVertex);
-    UINT offset = 0;
-    context->IASetVertexBuffers(
-        0,
-        1,
-        m_teapotMesh->GetVertexBuffer().GetAddressOf(),
-        &stride,
-        &offset
-        );
+void ImageTargetsRenderer::RenderAugmentations(Vuforia::Renderer &renderer, const PreparedFrame &frame)
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+    const ViewConfiguration &view = *frame.view;
+    bool stereo = view.eyeCount > 1;
 
-    context->IASetIndexBuffer(
-        m_teapotMesh->GetIndexBuffer().Get(),
-        DXGI_FORMAT_R16_UINT, // Each index is one 16-bit unsigned integer (short).
-        0
-        );
+    if (view.instancedStereo)
+    {
+        const SampleCommon::ViewportRect &unionViewport = view.unionViewport;
+        CD3D11_VIEWPORT d3dViewport(unionViewport.x, unionViewport.y, unionViewport.width, unionViewport.height);
+        context->RSSetViewports(1, &d3dViewport);
+    }
 
-    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    // Setup rendering pipeline for augmentation rendering
+    ID3D11RasterizerState *rasterState;
+    if (renderer.getVideoBackgroundConfig().mReflection == Vuforia::VIDEO_BACKGROUND_REFLECTION_ON)
+    {
+        rasterState = m_augmentationRasterStateCullFront.Get(); // Typically when using the front facing camera
+    }
+    else
+    {
+        rasterState = m_augmentationRasterStateCullBack.Get(); // Typically when using the rear facing camera
+    }
 
-    context->IASetInputLayout(m_augmentationInputLayout.Get());
+    // The augmentations are drawn into the scaled target, which is
+    // composited later; the timer covers the drawing only
+    m_augmentationTimer->Begin();
+    m_augmentationTarget->Begin(m_resolutionScale);
 
-    // Attach our vertex shader.
-    context->VSSetShader(m_augmentationVertexShader.Get(), nullptr, 0);
+    // A repeated frame executes its queue again, so the statistics are
+    // taken from the frame rather than accumulated in its queue
+    m_renderQueueStats = frame.renderQueue.GetStats();
+    if (!stereo || view.instancedStereo)
+    {
+        m_renderQueueStats.stateChanges = ExecuteRenderQueue(frame, rasterState, 0, view.eyeCount);
+    }
+    else
+    {
+        // A pass per eye, each into the eye's viewport
+        m_renderQueueStats.stateChanges = 0;
+        for (uint32_t eye = 0; eye < view.eyeCount; eye++)
+        {
+            const SampleCommon::ViewportRect &eyeViewport = view.eyeViewports[eye];
+            m_augmentationTarget->SetViewport(
+                CD3D11_VIEWPORT(eyeViewport.x, eyeViewport.y, eyeViewport.width, eyeViewport.height));
+            m_renderQueueStats.stateChanges += ExecuteRenderQueue(frame, rasterState, eye, 1);
+        }
+    }
 
-    // Send the constant buffer to the graphics device.
-    context->VSSetConstantBuffers1(
-        0,
-        1,
-        m_augmentationConstantBuffer.GetAddressOf(),
-        nullptr,
-        nullptr
-        );
+    m_augmentationTarget->End();
+    m_augmentationTimer->End();
+    m_cullingStats = frame.cullingStats;
 
-    // Attach our pixel shader.
-    context->PSSetShader(m_augmentationPixelShader.Get(), nullptr, 0);
+    m_stereoStats = SampleCommon::StereoUtil::ComputeDrawCounts(
+        static_cast<uint32_t>(frame.renderQueue.Size()), view.eyeCount, view.instancedStereo);
 
-    context->PSSetSamplers(0, 1, texture->GetD3DSamplerState().GetAddressOf());
-    context->PSSetShaderResources(0, 1, texture->GetD3DTextureView().GetAddressOf());
+    if (view.instancedStereo)
+    {
+        auto viewport = m_deviceResources->GetScreenViewport();
+        context->RSSetViewports(1, &viewport);
+    }
+}
+
+void ImageTargetsRenderer::CompositeAugmentations(const PreparedFrame &displayed, bool reproject)
+{
+    auto context = m_deviceResources->GetD3DDeviceContext();
+    const ViewConfiguration &view = *m_renderedView;
+    bool stereo = view.eyeCount > 1;
+    SampleCommon::ReprojectionMode mode = m_reprojectionMode;
+
+    // The layer is warped for the target nearest to the camera that is
+    // tracked in both frames, as it covers most of the screen
+    const float *renderedPose = nullptr;
+    const float *displayedPose = nullptr;
+    if (reproject && displayed.view == m_renderedView)
+    {
+        float nearest = FLT_MAX;
+        for (const auto &rendered : m_renderedPoses)
+        {
+            float distance = rendered.pose[3] * rendered.pose[3] + rendered.pose[7] * rendered.pose[7] + rendered.pose[11] * rendered.pose[11];
+            if (distance >= nearest)
+            {
+                continue;
+            }
+            for (const auto &current : displayed.trackedPoses)
+            {
+                if (current.trackableId == rendered.trackableId)
+                {
+                    nearest = distance;
+                    renderedPose = rendered.pose;
+                    displayedPose = current.pose;
+                    break;
+                }
+            }
+        }
+    }
+
+    bool reprojected = true;
+    for (uint32_t eye = 0; eye < view.eyeCount; eye++)
+    {
+        // Monocular augmentations are rendered into the screen viewport
+        D3D11_VIEWPORT d3dViewport = m_deviceResources->GetScreenViewport();
+        if (stereo)
+        {
+            const SampleCommon::ViewportRect &eyeViewport = view.eyeViewports[eye];
+            d3dViewport = CD3D11_VIEWPORT(eyeViewport.x, eyeViewport.y, eyeViewport.width, eyeViewport.height);
+        }
 
-    // Draw the objects.
-    context->DrawIndexed(m_teapotMesh->GetIndexCount(), 0, 0);
+        float homography[9];
+        bool warped = false;
+        if (renderedPose != nullptr)
+        {
+            const float *projection = &view.eyeProjections[eye].m[0][0];
+            warped = (mode == SampleCommon::REPROJECTION_ROTATIONAL) ?
+                SampleCommon::Reprojection::ComputeRotationalHomography(projection, renderedPose, displayedPose, homography) :
+                SampleCommon::Reprojection::ComputePlanarHomography(projection, renderedPose, displayedPose, homography);
+        }
+        if (!warped)
+        {
+            SampleCommon::Reprojection::Identity(homography);
+            reprojected = false;
+        }
+
+        m_augmentationTarget->Composite(d3dViewport, homography);
+    }
+
+    if (!reproject)
+    {
+        m_reprojectionStats.currentFrames++;
+    }
+    else if (reprojected)
+    {
+        m_reprojectionStats.reprojectedFrames++;
+    }
+    else
+    {
+        m_reprojectionStats.fallbackFrames++;
+    }
+
+    auto viewport = m_deviceResources->GetScreenViewport();
+    context->RSSetViewports(1, &viewport);
 }
 
-void ImageTargetsRenderer::RenderTower(
-    const XMMATRIX &poseMatrix,
-    const XMMATRIX &projectionMatrix,
-    const std::shared_ptr<SampleCommon::Texture> texture
+void ImageTargetsRenderer::CullAugmentations(PreparedFrame &frame)
+{
+    const ViewConfiguration &view = *frame.view;
+    size_t count = frame.candidateModels.size();
+    m_cullRadius.resize(count);
+    m_cullVisible.resize(count);
+    m_cullVisibleInEye.resize(count);
+
+    // The pose batch has already moved the sphere centers into camera space
+    for (size_t c = 0; c < count; c++)
+    {
+        m_cullRadius[c] = m_augmentationModels[frame.candidateModels[c]].bounds.radius;
+    }
+
+    // An augmentation is drawn if any eye can see it
+    for (uint32_t eye = 0; eye < view.eyeCount; eye++)
+    {
+        SampleCommon::FrustumPlanes frustum =
+            SampleCommon::BoundingVolumeUtil::ExtractFrustumPlanes(&view.eyeProjections[eye].m[0][0]);
+
+        SampleCommon::BoundingVolumeUtil::CullSpheres(
+            frustum,
+            frame.poseBatch.GetPointsX(),
+            frame.poseBatch.GetPointsY(),
+            frame.poseBatch.GetPointsZ(),
+            m_cullRadius.data(),
+            count,
+            (eye == 0) ? m_cullVisible.data() : m_cullVisibleInEye.data());
+
+        if (eye > 0)
+        {
+            for (size_t c = 0; c < count; c++)
+            {
+                m_cullVisible[c] |= m_cullVisibleInEye[c];
+            }
+        }
+    }
+
+    size_t drawnCount = 0;
+    for (size_t c = 0; c < count; c++)
+    {
+        drawnCount += m_cullVisible[c];
+    }
+
+    frame.cullingStats.testedCount = static_cast<uint32_t>(count);
+    frame.cullingStats.drawnCount = static_cast<uint32_t>(drawnCount);
+    frame.cullingStats.culledCount = static_cast<uint32_t>(count - drawnCount);
+}
+
+void ImageTargetsRenderer::SubmitAugmentation(PreparedFrame &frame, uint32_t instance, uint32_t model)
+{
+    const AugmentationModel &augmentationModel = m_augmentationModels[model];
+
+    AugmentationDraw draw;
+    draw.instance = instance;
+    draw.model = model;
+    draw.mesh = augmentationModel.mesh;
+    draw.texture = augmentationModel.texture;
+
+    // Sorted by the depth of the bounding sphere center.
+    // The camera looks down the positive z axis.
+    float normalizedDepth = frame.poseBatch.GetPointsZ()[instance] / m_far;
+
+    SampleCommon::RenderPass pass = TRANSLUCENT_AUGMENTATION ?
+        SampleCommon::RENDER_PASS_TRANSLUCENT : SampleCommon::RENDER_PASS_OPAQUE;
+
+    uint64_t sortKey = SampleCommon::RenderQueue::MakeSortKey(
+        pass,
+        TRANSLUCENT_AUGMENTATION ? 1 : 0, // blend mode
+        0, // all augmentations share the textured shader
+        draw.texture,
+        draw.mesh,
+        normalizedDepth);
+
+    frame.renderQueue.Submit(sortKey, static_cast<uint32_t>(frame.draws.size()));
+    frame.draws.push_back(draw);
+}
+
+uint32_t ImageTargetsRenderer::ExecuteRenderQueue(
+    const PreparedFrame &frame,
+    ID3D11RasterizerState *rasterState,
+    uint32_t firstEye,
+    uint32_t drawEyeCount
     )
 {
+    const SampleCommon::RenderQueue &renderQueue = frame.renderQueue;
+    if (renderQueue.Size() == 0)
+    {
+        return 0;
+    }
+
     auto context = m_deviceResources->GetD3DDeviceContext();
 
-    // Set pose matrix (the 'view' part of the 'model-view' matrix)
-    XMStoreFloat4x4(&m_augmentationConstantBufferData.view, poseMatrix);
+    // Textures are uploaded on first use, on the immediate context
+    for (const AugmentationDraw &draw : frame.draws)
+    {
+        std::shared_ptr<SampleCommon::Texture> texture = m_textures[draw.texture];
+        if (!texture->IsInitialized()) {
+            texture->Init();
+        }
+    }
+
+    // Write the constants of the whole queue with a single map of the ring:
+    // the eye bounds first, then the matrices of each draw in queue order.
+    // Command lists recorded afterwards only bind offsets into it.
+    const SampleCommon::ConstantBufferAllocation *constants = nullptr;
+    SampleCommon::ConstantBufferAllocation ringAllocation;
+    if (m_constantBufferRing->IsSupported())
+    {
+        const uint32_t elementSize = SampleCommon::ConstantBufferRing::BYTES_ALIGNMENT;
+        uint32_t elementCount = static_cast<uint32_t>(renderQueue.Size()) + 1;
+
+        uint8_t *data = static_cast<uint8_t*>(m_constantBufferRing->Map(elementCount * elementSize, ringAllocation));
+        if (data != nullptr)
+        {
+            memcpy(data, &frame.view->frameConstants, sizeof(frame.view->frameConstants));
 
-    // Set model matrix (the 'model' part of the 'model-view' matrix)
-    auto scale = XMMatrixScaling(TOWER_SCALE, TOWER_SCALE, TOWER_SCALE);
-    auto rotation = XMMatrixTranspose(XMMatrixRotationX(3.14159f / 2));
-    auto modelMatrix = XMMatrixIdentity() * rotation * scale;
-    XMStoreFloat4x4(&m_augmentationConstantBufferData.model, modelMatrix);
+            for (size_t p = 0; p < renderQueue.Size(); p++)
+            {
+                SampleCommon::ModelViewProjectionConstantBuffer instanceData;
+                GetInstanceConstants(frame, frame.draws[renderQueue[p].drawIndex], firstEye, drawEyeCount, instanceData);
+                memcpy(data + (p + 1) * elementSize, &instanceData, sizeof(instanceData));
+            }
 
-    // Set projection matrix
-    XMStoreFloat4x4(&m_augmentationConstantBufferData.projection, projectionMatrix);
+            m_constantBufferRing->Unmap();
+            m_constantBufferBytes += sizeof(frame.view->frameConstants) +
+                static_cast<uint32_t>(renderQueue.Size() * sizeof(SampleCommon::ModelViewProjectionConstantBuffer));
+            constants = &ringAllocation;
+        }
+    }
 
-    // Prepare the constant buffer to send it to the graphics device.
-    context->UpdateSubresource1(
-        m_augmentationConstantBuffer.Get(),
-        0,
-        NULL,
-        &m_augmentationConstantBufferData,
-        0,
-        0,
-        0
-        );
+    if (constants == nullptr)
+    {
+        // The eye bounds are shared by all draws, so they are uploaded
+        // once, before any recorded command list reads them
+        context->UpdateSubresource1(
+            m_augmentationFrameConstantBuffer.Get(),
+            0,
+            NULL,
+            &frame.view->frameConstants,
+            0,
+            0,
+            0
+            );
+        m_constantBufferBytes += sizeof(frame.view->frameConstants);
+    }
+
+    if (renderQueue.Size() < PARALLEL_RECORDING_MIN_DRAWS)
+    {
+        return RecordRenderQueue(context, frame, rasterState, constants, firstEye, drawEyeCount, 0, renderQueue.Size());
+    }
 
-    // Each vertex is one instance of the TexturedVertex struct.
-    UINT stride = sizeof(SampleCommon::TexturedVertex);
-    UINT offset = 0;
-    context->IASetVertexBuffers(
+    // Split the sorted queue into jobs; each job is recorded on a deferred
+    // context and the command lists are replayed in queue order.
+    // The eyes of a pass are drawn by the same instanced draws, so all jobs belong to view 0.
+    m_recordingJobs.clear();
+    SampleCommon::ParallelCommandRecorder::SplitJobs(
         0,
-        1,
-        m_towerModel->GetVertexBuffer().GetAddressOf(),
-        &stride,
-        &offset
-        );
+        static_cast<uint32_t>(renderQueue.Size()),
+        DRAWS_PER_RECORDING_JOB,
+        m_recordingJobs);
 
-    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    std::atomic<uint32_t> stateChanges(0);
+    m_commandRecorder->Record(m_recordingJobs,
+        [&](uint32_t worker, const SampleCommon::RecordingJob &job)
+    {
+        stateChanges += RecordRenderQueue(
+            m_commandRecordingBackend->GetContext(worker),
+            frame,
+            rasterState,
+            constants,
+            firstEye,
+            drawEyeCount,
+            job.firstDraw,
+            job.drawCount);
+    });
 
+    m_commandRecorder->Execute();
+    m_commandRecordingStats = m_commandRecorder->GetStats();
+    return stateChanges;
+}
+
+uint32_t ImageTargetsRenderer::RecordRenderQueue(
+    ID3D11DeviceContext3 *context,
+    const PreparedFrame &frame,
+    ID3D11RasterizerState *rasterState,
+    const SampleCommon::ConstantBufferAllocation *constants,
+    uint32_t firstEye,
+    uint32_t drawEyeCount,
+    size_t firstPacket,
+    size_t packetCount
+    )
+{
+    // State shared by all augmentations is set once
+    context->RSSetState(rasterState);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     context->IASetInputLayout(m_augmentationInputLayout.Get());
 
-    // Attach our vertex shader.
-    context->VSSetShader(m_augmentationVertexShader.Get(), nullptr, 0);
+    // Attach our vertex shader; a single eye needs neither instancing nor clip distances
+    ID3D11VertexShader *vertexShader = (drawEyeCount > 1) ?
+        m_augmentationStereoVertexShader.Get() : m_augmentationVertexShader.Get();
+    context->VSSetShader(vertexShader, nullptr, 0);
 
-    // Send the constant buffer to the graphics device.
-    context->VSSetConstantBuffers1(
-        0,
-        1,
-        m_augmentationConstantBuffer.GetAddressOf(),
-        nullptr,
-        nullptr
-        );
+    // Send the per-view and per-draw constant buffers to the graphics device.
+    if (constants != nullptr)
+    {
+        SampleCommon::ConstantBufferAllocation frameConstants =
+            SampleCommon::ConstantBufferRing::GetElement(*constants, 0);
+        context->VSSetConstantBuffers1(
+            0,
+            1,
+            &frameConstants.buffer,
+            &frameConstants.firstConstant,
+            &frameConstants.numConstants
+            );
+    }
+    else
+    {
+        ID3D11Buffer *const constantBuffers[2] = {
+            m_augmentationFrameConstantBuffer.Get(),
+            m_augmentationInstanceConstantBuffer.Get()
+        };
+        context->VSSetConstantBuffers1(
+            0,
+            2,
+            constantBuffers,
+            nullptr,
+            nullptr
+            );
+    }
 
     // Attach our pixel shader.
     context->PSSetShader(m_augmentationPixelShader.Get(), nullptr, 0);
 
-    context->PSSetSamplers(0, 1, texture->GetD3DSamplerState().GetAddressOf());
-    context->PSSetShaderResources(0, 1, texture->GetD3DTextureView().GetAddressOf());
+    // Only bind the per-draw state that differs from the previous draw
+    uint32_t stateChanges = 0;
+    int boundPass = -1;
+    int boundMesh = -1;
+    int boundTexture = -1;
 
-    // Draw the objects.
-    context->Draw(m_towerModel->GetVertexCount(), 0);
+    for (size_t p = firstPacket; p < firstPacket + packetCount; p++)
+    {
+        const SampleCommon::DrawPacket &packet = frame.renderQueue[p];
+        const AugmentationDraw &draw = frame.draws[packet.drawIndex];
+
+        SampleCommon::RenderPass pass = SampleCommon::RenderQueue::GetPass(packet.sortKey);
+        if (pass != boundPass)
+        {
+            if (pass == SampleCommon::RENDER_PASS_TRANSLUCENT)
+            {
+                context->OMSetDepthStencilState(m_augmentationTranslucentDepthStencilState.Get(), 1);
+                context->OMSetBlendState(m_augmentationTranslucentBlendState.Get(), NULL, 0xffffffff);
+            }
+            else
+            {
+                context->OMSetDepthStencilState(m_augmentationDepthStencilState.Get(), 1);
+                context->OMSetBlendState(m_augmentationBlendState.Get(), NULL, 0xffffffff);
+            }
+            boundPass = pass;
+            stateChanges++;
+        }
+
+        if (draw.mesh != boundMesh)
+        {
+            // Each vertex is one instance of the TexturedVertex struct.
+            UINT stride = sizeof(SampleCommon::TexturedVertex);
+            UINT offset = 0;
+
+            if (draw.mesh == MESH_TOWER)
+            {
+                context->IASetVertexBuffers(0, 1, m_towerModel->GetVertexBuffer().GetAddressOf(), &stride, &offset);
+            }
+            else
+            {
+                context->IASetVertexBuffers(0, 1, m_teapotMesh->GetVertexBuffer().GetAddressOf(), &stride, &offset);
+                context->IASetIndexBuffer(
+                    m_teapotMesh->GetIndexBuffer().Get(),
+                    DXGI_FORMAT_R16_UINT, // Each index is one 16-bit unsigned integer (short).
+                    0
+                    );
+            }
+            boundMesh = draw.mesh;
+            stateChanges++;
+        }
+
+        if (draw.texture != boundTexture)
+        {
+            std::shared_ptr<SampleCommon::Texture> texture = m_textures[draw.texture];
+            context->PSSetSamplers(0, 1, texture->GetD3DSamplerState().GetAddressOf());
+            context->PSSetShaderResources(0, 1, texture->GetD3DTextureView().GetAddressOf());
+            boundTexture = draw.texture;
+            stateChanges++;
+        }
+
+        if (constants != nullptr)
+        {
+            // Per-draw constants live right after the eye bounds, in queue order
+            SampleCommon::ConstantBufferAllocation instanceConstants =
+                SampleCommon::ConstantBufferRing::GetElement(*constants, static_cast<uint32_t>(p + 1));
+            context->VSSetConstantBuffers1(
+                1,
+                1,
+                &instanceConstants.buffer,
+                &instanceConstants.firstConstant,
+                &instanceConstants.numConstants
+                );
+        }
+        else
+        {
+            // Kept on the stack, as draws may be recorded on several threads at once
+            SampleCommon::ModelViewProjectionConstantBuffer instanceData;
+            GetInstanceConstants(frame, draw, firstEye, drawEyeCount, instanceData);
+
+            context->UpdateSubresource1(
+                m_augmentationInstanceConstantBuffer.Get(),
+                0,
+                NULL,
+                &instanceData,
+                0,
+                0,
+                0
+                );
+            m_constantBufferBytes += sizeof(instanceData);
+        }
+
+        RenderAugmentation(context, draw, drawEyeCount);
+    }
+
+    return stateChanges;
 }
 
-const std::shared_ptr<SampleCommon::Texture> ImageTargetsRenderer::GetAugmentationTexture(const char *targetName)
+void ImageTargetsRenderer::GetInstanceConstants(
+    const PreparedFrame &frame,
+    const AugmentationDraw &draw,
+    uint32_t firstEye,
+    uint32_t drawEyeCount,
+    SampleCommon::ModelViewProjectionConstantBuffer &constants
+    )
 {
-    if (m_extTracking) {
-        return m_textureTower;
+    // The matrices were computed by the pose batch. Slot i holds the eye drawn by
+    // instance i; a single eye draw only reads the first, the others mirror it.
+    for (uint32_t slot = 0; slot < SampleCommon::MAX_STEREO_EYES; slot++)
+    {
+        uint32_t sourceEye = firstEye + ((slot < drawEyeCount) ? slot : 0);
+        memcpy(
+            &constants.modelViewProjection[slot],
+            frame.poseBatch.GetModelViewProjection(sourceEye, draw.instance),
+            sizeof(constants.modelViewProjection[slot]));
     }
+}
 
-    // Choose the texture based on the target name:
-    if (strcmp(targetName, "chips") == 0)
+void ImageTargetsRenderer::RenderAugmentation(
+    ID3D11DeviceContext3 *context,
+    const AugmentationDraw &draw,
+    uint32_t drawEyeCount
+    )
+{
+    // Draw the objects, with one instance per eye when drawing several
+    if (draw.mesh == MESH_TOWER)
     {
-        return m_textureTeapotBrass;
+        if (drawEyeCount > 1)
+        {
+            context->DrawInstanced(m_towerModel->GetVertexCount(), drawEyeCount, 0, 0);
+        }
+        else
+        {
+            context->Draw(m_towerModel->GetVertexCount(), 0);
+        }
     }
-    else if (strcmp(targetName, "stones") == 0)
+    else
     {
-        return m_textureTeapotBlue;
+        if (drawEyeCount > 1)
+        {
+            context->DrawIndexedInstanced(m_teapotMesh->GetIndexCount(), drawEyeCount, 0, 0, 0);
+        }
+        else
+        {
+            context->DrawIndexed(m_teapotMesh->GetIndexCount(), 0, 0);
+        }
     }
-    else
+}
+
+void ImageTargetsRenderer::CreateAugmentationModels()
+{
+    // Bounding volumes of the meshes, in mesh space
+    const SampleCommon::BoundingVolume *volumes[MESH_COUNT] = {
+        &m_teapotMesh->GetBoundingVolume(),
+        &m_towerModel->GetBoundingVolume()
+    };
+
+    m_augmentationModels.resize(m_augmentationRegistry.GetEntryCount());
+    for (uint32_t e = 0; e < m_augmentationRegistry.GetEntryCount(); e++)
     {
-        return m_textureTeapotRed;
+        const SampleCommon::AugmentationEntry &entry = m_augmentationRegistry.GetEntry(e);
+        AugmentationModel &model = m_augmentationModels[e];
+        model.mesh = static_cast<AugmentationMesh>(entry.mesh);
+        model.texture = static_cast<AugmentationTexture>(entry.texture);
+
+        // The transform of the entry is applied after the model matrix of the mesh.
+        // Model matrices are stored transposed, see the pose conversion.
+        auto scale = XMMatrixScaling(entry.scale, entry.scale, entry.scale);
+        auto rotation = XMMatrixTranspose(XMMatrixRotationZ(XMConvertToRadians(entry.rotation)));
+        auto translation = XMMatrixTranspose(
+            XMMatrixTranslation(entry.translation[0], entry.translation[1], entry.translation[2]));
+        XMMATRIX modelMatrix = translation * rotation * scale * XMLoadFloat4x4(&m_meshModelMatrices[model.mesh]);
+        XMStoreFloat4x4(&model.modelMatrix, modelMatrix);
+
+        // Bounding sphere in pose space. The model matrices scale uniformly,
+        // so the radius scales with any axis.
+        const SampleCommon::BoundingVolume *volume = volumes[model.mesh];
+        XMVECTOR center = XMVectorSet(volume->sphereCenter[0], volume->sphereCenter[1], volume->sphereCenter[2], 1.0f);
+        XMStoreFloat3(&model.bounds.center, XMVector3Transform(center, XMMatrixTranspose(modelMatrix)));
+        model.bounds.radius = volume->sphereRadius * XMVectorGetX(XMVector3Length(modelMatrix.r[0]));
     }
 }
 
 void ImageTargetsRenderer::CreateDeviceDependentResources()
 {
     m_rendererInitialized = false;
+    m_startupTracker->Begin(SampleCommon::STARTUP_STAGE_RENDERER_ASSETS);
 
     m_videoBackground = std::shared_ptr<SampleCommon::VideoBackground>(
         new SampleCommon::VideoBackground(m_deviceResources));
 
+    m_augmentationTarget = std::shared_ptr<SampleCommon::ScaledRenderTarget>(
+        new SampleCommon::ScaledRenderTarget(m_deviceResources));
+
     // Load shaders asynchronously.
     auto loadVSTask = DX::ReadDataAsync(L"TexturedVertexShader.cso");
     auto loadPSTask = DX::ReadDataAsync(L"TexturedPixelShader.cso");
     auto loadVideoBgVSTask = DX::ReadDataAsync(L"VideoBackgroundVertexShader.cso");
     auto loadVideoBgPSTask = DX::ReadDataAsync(L"VideoBackgroundPixelShader.cso");
+    auto loadCompositeVSTask = DX::ReadDataAsync(L"CompositeVertexShader.cso");
+    auto loadCompositePSTask = DX::ReadDataAsync(L"CompositePixelShader.cso");
+
+    // Load the scene description mapping targets to augmentations
+    auto loadSceneTask = DX::ReadDataAsync(L"Assets/ImageTargets/ImageTargetsScene.txt").then([this](const std::vector<byte>& fileData) {
+        Concurrency::critical_section::scoped_lock lock(m_sceneLock);
+        bool loaded = m_augmentationRegistry.Load(
+            reinterpret_cast<const char*>(fileData.data()),
+            fileData.size(),
+            MESH_NAMES,
+            MESH_COUNT,
+            TEXTURE_NAMES,
+            TEXTURE_COUNT);
+
+        if (m_augmentationRegistry.GetStats().rejectedLines > 0)
+        {
+            SampleCommon::SampleUtil::Log("ImageTargetsRenderer", "Skipped invalid lines of the scene description.");
+        }
+        if (!loaded)
+        {
+            SampleCommon::SampleUtil::Log("ImageTargetsRenderer", "The scene description has no augmentations.");
+        }
+    });
 
     // After the vertex shader file is loaded, create the shader and input layout.
     auto createVSTask = loadVSTask.then([this](const std::vector<byte>& fileData) {
@@ -402,6 +1075,23 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
             );
     });
 
+    // The instanced stereo shader takes feature level 10_0; below it, stereo
+    // views are drawn a pass per eye with the single eye shader above
+    auto createStereoVSTask = Concurrency::create_task([]() {});
+    if (m_deviceResources->GetDeviceFeatureLevel() >= D3D_FEATURE_LEVEL_10_0)
+    {
+        createStereoVSTask = DX::ReadDataAsync(L"TexturedStereoVertexShader.cso").then([this](const std::vector<byte>& fileData) {
+            DX::ThrowIfFailed(
+                m_deviceResources->GetD3DDevice()->CreateVertexShader(
+                    &fileData[0],
+                    fileData.size(),
+                    nullptr,
+                    &m_augmentationStereoVertexShader
+                    )
+                );
+        });
+    }
+
     auto createVideoBgVSTask = loadVideoBgVSTask.then([this](const std::vector<byte>& fileData) {
         m_videoBackground->InitVertexShader(&fileData[0], fileData.size());
     });
@@ -417,15 +1107,27 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
                 )
             );
 
-        CD3D11_BUFFER_DESC constantBufferDesc(
-            sizeof(SampleCommon::ModelViewProjectionConstantBuffer), 
+        CD3D11_BUFFER_DESC frameConstantBufferDesc(
+            sizeof(SampleCommon::StereoBoundsConstantBuffer),
+            D3D11_BIND_CONSTANT_BUFFER);
+
+        DX::ThrowIfFailed(
+            m_deviceResources->GetD3DDevice()->CreateBuffer(
+                &frameConstantBufferDesc,
+                nullptr,
+                &m_augmentationFrameConstantBuffer
+                )
+            );
+
+        CD3D11_BUFFER_DESC instanceConstantBufferDesc(
+            sizeof(SampleCommon::ModelViewProjectionConstantBuffer),
             D3D11_BIND_CONSTANT_BUFFER);
 
         DX::ThrowIfFailed(
             m_deviceResources->GetD3DDevice()->CreateBuffer(
-                &constantBufferDesc,
+                &instanceConstantBufferDesc,
                 nullptr,
-                &m_augmentationConstantBuffer
+                &m_augmentationInstanceConstantBuffer
                 )
             );
     });
@@ -435,32 +1137,53 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
         m_videoBackground->InitFragmentShader(&fileData[0], fileData.size());
     });
 
-    // Once both shaders are loaded, create the mesh.
-    auto createAugmentationModelsTask = (createPSTask && createVSTask && createVideoBgPSTask && createVideoBgVSTask).then([this] () {
-        m_teapotMesh = std::shared_ptr<SampleCommon::TeapotMesh>(
-            new SampleCommon::TeapotMesh(m_deviceResources));
+    // Shaders upscaling the augmentation target over the back buffer
+    auto createCompositeVSTask = loadCompositeVSTask.then([this](const std::vector<byte>& fileData) {
+        m_augmentationTarget->InitVertexShader(&fileData[0], fileData.size());
+    });
+
+    auto createCompositePSTask = loadCompositePSTask.then([this](const std::vector<byte>& fileData) {
+        m_augmentationTarget->InitPixelShader(&fileData[0], fileData.size());
+    });
+
+    // The meshes and textures don't need the shaders: they are parsed and
+    // decoded on the thread pool while the shaders load. Texture::Init(),
+    // which uses the immediate context, is left to the render thread.
+    // After a device loss, they are created again from the data kept.
+    auto createTeapotTask = Concurrency::create_task([this]() {
+        if (!m_teapotMesh)
+        {
+            m_teapotMesh = std::shared_ptr<SampleCommon::TeapotMesh>(
+                new SampleCommon::TeapotMesh(m_deviceResources));
+        }
         m_teapotMesh->InitMesh();
+    });
 
-        m_towerModel = std::shared_ptr<SampleCommon::SampleApp3DModel>(
-            new SampleCommon::SampleApp3DModel(m_deviceResources, "Assets/ImageTargets/buildings.txt"));
+    auto createTowerTask = Concurrency::create_task([this]() {
+        if (!m_towerModel)
+        {
+            m_towerModel = std::shared_ptr<SampleCommon::SampleApp3DModel>(
+                new SampleCommon::SampleApp3DModel(m_deviceResources, "Assets/ImageTargets/buildings.txt"));
+        }
         m_towerModel->InitMesh();
     });
 
-    auto createTextureTask = createAugmentationModelsTask.then([this]() {
-        m_textureTeapotBlue = std::shared_ptr<SampleCommon::Texture>(new SampleCommon::Texture(m_deviceResources));
-        m_textureTeapotBlue->CreateFromFile(L"Assets/TextureTeapotBlue.png");
-
-        m_textureTeapotBrass = std::shared_ptr<SampleCommon::Texture>(new SampleCommon::Texture(m_deviceResources));
-        m_textureTeapotBrass->CreateFromFile(L"Assets/TextureTeapotBrass.png");
+    // Once both the meshes and the scene description are loaded, set up the augmentations
+    auto createAugmentationsTask = (createTeapotTask && createTowerTask && loadSceneTask).then([this]() {
+        Concurrency::critical_section::scoped_lock lock(m_sceneLock);
+        CreateAugmentationModels();
+    });
 
-        m_textureTeapotRed = std::shared_ptr<SampleCommon::Texture>(new SampleCommon::Texture(m_deviceResources));
-        m_textureTeapotRed->CreateFromFile(L"Assets/TextureTeapotRed.png");
+    // Each texture is decoded on its own, into its own slot
+    auto createTextureTask = CreateTextureAsync(TEXTURE_TEAPOT_BLUE, L"Assets/TextureTeapotBlue.png") &&
+        CreateTextureAsync(TEXTURE_TEAPOT_BRASS, L"Assets/TextureTeapotBrass.png") &&
+        CreateTextureAsync(TEXTURE_TEAPOT_RED, L"Assets/TextureTeapotRed.png") &&
+        CreateTextureAsync(TEXTURE_TOWER, L"Assets/ImageTargets/building_texture.jpeg");
 
-        m_textureTower = std::shared_ptr<SampleCommon::Texture>(new SampleCommon::Texture(m_deviceResources));
-        m_textureTower->CreateFromFile(L"Assets/ImageTargets/building_texture.jpeg");
-    });
+    auto createShadersTask = createPSTask && createVSTask && createStereoVSTask && createVideoBgPSTask && createVideoBgVSTask &&
+        createCompositePSTask && createCompositeVSTask;
 
-    auto setupRasterizersTask = createTextureTask.then([this]() {
+    auto setupRasterizersTask = (createShadersTask && createAugmentationsTask && createTextureTask).then([this]() {
         // setup the rasterizer
         auto context = m_deviceResources->GetD3DDeviceContext();
 
@@ -470,6 +1193,11 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
         // Init rendering pipeline state for video background
         m_videoBackground->InitRenderState();
 
+        // Init the upscaling of the augmentation target, and the timing of its pass
+        m_augmentationTarget->InitRenderState();
+        m_augmentationTimer = std::unique_ptr<SampleCommon::GpuTimer>(
+            new SampleCommon::GpuTimer(m_deviceResources, AUGMENTATION_TIMER_LATENCY));
+
         // Create the rasterizer for augmentation rendering
         // with back-face culling
         D3D11_RASTERIZER_DESC augmentationRasterDescCullBack = SampleCommon::RenderUtil::CreateRasterizerDesc(
@@ -499,10 +1227,31 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
             );
         device->CreateDepthStencilState(&augmentDepthStencilDesc, m_augmentationDepthStencilState.GetAddressOf());
 
-        // Create blend state for augmentation rendering
-        bool translucentAugmentation = false;// set to TRUE for rendering translucent models
-        D3D11_BLEND_DESC augmentationBlendDesc = SampleCommon::RenderUtil::CreateBlendDesc(translucentAugmentation);
+        // Translucent augmentations are depth tested but don't write depth,
+        // so that augmentations behind them still show through
+        D3D11_DEPTH_STENCIL_DESC translucentDepthStencilDesc = SampleCommon::RenderUtil::CreateDepthStencilDesc(
+            true,
+            D3D11_DEPTH_WRITE_MASK_ZERO,
+            D3D11_COMPARISON_LESS
+            );
+        device->CreateDepthStencilState(&translucentDepthStencilDesc, m_augmentationTranslucentDepthStencilState.GetAddressOf());
+
+        // Create blend states for opaque and translucent augmentation rendering
+        D3D11_BLEND_DESC augmentationBlendDesc = SampleCommon::RenderUtil::CreateBlendDesc(false);
         device->CreateBlendState(&augmentationBlendDesc, m_augmentationBlendState.GetAddressOf());
+
+        D3D11_BLEND_DESC translucentBlendDesc = SampleCommon::RenderUtil::CreateBlendDesc(true);
+        device->CreateBlendState(&translucentBlendDesc, m_augmentationTranslucentBlendState.GetAddressOf());
+
+        m_constantBufferRing = std::unique_ptr<SampleCommon::ConstantBufferRing>(
+            new SampleCommon::ConstantBufferRing(m_deviceResources, CONSTANT_BUFFER_RING_SIZE));
+
+        // One deferred context per job system worker, plus one for the render thread
+        uint32_t workerCount = m_jobSystem->GetWorkerCount() + 1;
+        m_commandRecordingBackend = std::unique_ptr<SampleCommon::D3D11CommandRecordingBackend>(
+            new SampleCommon::D3D11CommandRecordingBackend(m_deviceResources, workerCount));
+        m_commandRecorder = std::unique_ptr<SampleCommon::ParallelCommandRecorder>(
+            new SampleCommon::ParallelCommandRecorder(m_commandRecordingBackend.get(), m_jobSystem.get()));
     });
 
     setupRasterizersTask.then([this](Concurrency::task<void> t) {
@@ -514,6 +1263,7 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
 
             // Now we are ready for rendering
             m_rendererInitialized = true;
+            m_startupTracker->End(SampleCommon::STARTUP_STAGE_RENDERER_ASSETS);
         }
         catch (Platform::Exception ^ex) {
             SampleCommon::SampleUtil::ShowError(L"Renderer init error", ex->Message);
@@ -521,24 +1271,63 @@ void ImageTargetsRenderer::CreateDeviceDependentResources()
     });
 }
 
+Concurrency::task<void> ImageTargetsRenderer::CreateTextureAsync(AugmentationTexture texture, wchar_t *filename)
+{
+    return Concurrency::create_task([this, texture, filename]() {
+        if (m_textures[texture] && m_textures[texture]->HasImage())
+        {
+            m_textures[texture]->CreateDeviceResources();
+            return;
+        }
+        m_textures[texture] = std::shared_ptr<SampleCommon::Texture>(new SampleCommon::Texture(m_deviceResources));
+        m_textures[texture]->CreateFromFile(filename);
+    });
+}
+
 void ImageTargetsRenderer::ReleaseDeviceDependentResources()
 {
     m_rendererInitialized = false;
 
     m_videoBackground->ReleaseResources();
     m_videoBackground.reset();
+    m_videoBackgroundView.reset();
+    m_renderedView.reset();
+
+    m_augmentationTarget->ReleaseResources();
+    m_augmentationTarget.reset();
+    if (m_augmentationTimer)
+    {
+        m_augmentationTimer->ReleaseResources();
+        m_augmentationTimer.reset();
+    }
 
     m_augmentationInputLayout.Reset();
     m_augmentationVertexShader.Reset();
+    m_augmentationStereoVertexShader.Reset();
     m_augmentationPixelShader.Reset();
-    m_augmentationConstantBuffer.Reset();
-
-    m_teapotMesh->ReleaseResources();
-    m_towerModel->ReleaseResources();
-    m_textureTeapotBlue->ReleaseResources();
-    m_textureTeapotBrass->ReleaseResources();
-    m_textureTeapotRed->ReleaseResources();
-    m_textureTower->ReleaseResources();
+    m_augmentationFrameConstantBuffer.Reset();
+    m_augmentationInstanceConstantBuffer.Reset();
+
+    if (m_constantBufferRing)
+    {
+        m_constantBufferRing->ReleaseResources();
+        m_constantBufferRing.reset();
+    }
+
+    m_commandRecorder.reset();
+    if (m_commandRecordingBackend)
+    {
+        m_commandRecordingBackend->ReleaseResources();
+        m_commandRecordingBackend.reset();
+    }
+
+    // The meshes and the decoded textures are kept for the new device
+    m_teapotMesh->ReleaseDeviceResources();
+    m_towerModel->ReleaseDeviceResources();
+    for (auto &texture : m_textures)
+    {
+        texture->ReleaseDeviceResources();
+    }
     
-    m_renderingPrimitives.reset();
+    m_viewConfiguration.Publish(nullptr);
 }
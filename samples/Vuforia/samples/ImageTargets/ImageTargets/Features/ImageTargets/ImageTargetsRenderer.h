@@ -12,7 +12,25 @@ countries.
 #include "..\..\Common\Texture.h"
 #include "..\..\Common\TeapotMesh.h"
 #include "..\..\Common\SampleApp3DModel.h"
+#include "..\..\Common\RenderQueue.h"
+#include "..\..\Common\CommandRecorder.h"
+#include "..\..\Common\D3D11CommandRecordingBackend.h"
+#include "..\..\Common\ConstantBufferRing.h"
+#include "..\..\Common\BoundingVolume.h"
+#include "..\..\Common\StereoViews.h"
+#include "..\..\Common\AugmentationRegistry.h"
+#include "..\..\Common\SampleMath.h"
+#include "..\..\Common\PoseBatch.h"
+#include "..\..\Common\FramePipeline.h"
+#include "..\..\Common\AtomicPublisher.h"
 #include "..\..\Common\VideoBackground.h"
+#include "..\..\Common\ScaledRenderTarget.h"
+#include "..\..\Common\GpuTimer.h"
+#include "..\..\Common\ResolutionController.h"
+#include "..\..\Common\PosePredictor.h"
+#include "..\..\Common\Reprojection.h"
+#include "..\..\Common\LatencyTracker.h"
+#include "..\..\Common\StartupTracker.h"
 
 #include <Vuforia\Matrices.h>
 #include <Vuforia\Renderer.h>
@@ -25,7 +43,10 @@ namespace ImageTargets
     class ImageTargetsRenderer
     {
     public:
-        ImageTargetsRenderer(const std::shared_ptr<DX::DeviceResources>& deviceResources);
+        ImageTargetsRenderer(
+            const std::shared_ptr<DX::DeviceResources>& deviceResources,
+            const std::shared_ptr<SampleCommon::JobSystem>& jobSystem,
+            const std::shared_ptr<SampleCommon::StartupTracker>& startupTracker);
         
         void CreateDeviceDependentResources();
         void CreateWindowSizeDependentResources();
@@ -33,6 +54,12 @@ namespace ImageTargets
        
         void Update(SampleCommon::StepTimer const& timer);
         void Render();
+
+        // Called on the tracking thread with each new Vuforia state. Does all the
+        // CPU work of a frame, so that Render() only draws the latest prepared frame.
+        // Returns false if no frame was prepared, e.g. before the renderer is ready.
+        // callbackTime is when Vuforia's callback received the state.
+        bool PrepareFrame(const Vuforia::State &state, double callbackTime);
         
         bool IsRendererInitialized() { return m_rendererInitialized; }
         bool IsVuforiaInitialized() { return m_vuforiaInitialized; }
@@ -41,69 +68,311 @@ namespace ImageTargets
         void SetVuforiaStarted(bool started);
         void SetExtendedTracking(bool enabled) { m_extTracking = enabled; }
 
+        // Can be called from any thread, the textures are updated by the next Render()
+        void SetTextureMipBias(float mipBias) { m_textureMipBias = mipBias; }
+
+        // Augmentations are drawn with their poses predicted for the time the
+        // frame is displayed, horizon milliseconds after its camera frame was
+        // taken. Can be called from any thread, applies from the next frame.
+        void SetPosePrediction(bool enabled) { m_posePrediction = enabled; }
+        void SetPredictionHorizon(float milliseconds) { m_predictionHorizonMilliseconds = milliseconds; }
+
+        // How augmentations are warped to the poses of a frame prepared while
+        // they were rendered. Can be called from any thread.
+        void SetReprojectionMode(SampleCommon::ReprojectionMode mode) { m_reprojectionMode = mode; }
+
         void UpdateRenderingPrimitives();
+
+        const SampleCommon::RenderQueueStats& GetRenderQueueStats() const { return m_renderQueueStats; }
+        const SampleCommon::CommandRecordingStats& GetCommandRecordingStats() const { return m_commandRecordingStats; }
+        const SampleCommon::CullingStats& GetCullingStats() const { return m_cullingStats; }
+        const SampleCommon::StereoRenderingStats& GetStereoRenderingStats() const { return m_stereoStats; }
+        const SampleCommon::AugmentationRegistryStats& GetAugmentationRegistryStats() const { return m_augmentationRegistry.GetStats(); }
+        const SampleCommon::FramePipelineStats& GetFramePipelineStats() const { return m_pipelineStats; }
+        const SampleCommon::ResolutionControllerStats& GetResolutionStats() const { return m_resolutionController.GetStats(); }
+        const SampleCommon::PosePredictorStats& GetPosePredictorStats() const { return m_posePredictor.GetStats(); }
+        const SampleCommon::ReprojectionStats& GetReprojectionStats() const { return m_reprojectionStats; }
+
+        // Stage times of the frame the last Render() displayed, up to its submission
+        const SampleCommon::FrameLatencyRecord& GetFrameLatencyRecord() const { return m_frameLatency; }
+
+        // Resolution scale the augmentations are rendered at
+        float GetResolutionScale() const { return m_resolutionScale; }
         
     private:
-        void RenderScene(Vuforia::Renderer &renderer, Vuforia::State &state);
-        
-        void RenderTeapot(
-            const DirectX::XMMATRIX &poseMatrix,
-            const DirectX::XMMATRIX &projectionMatrix,
-            const std::shared_ptr<SampleCommon::Texture> texture);
+        // Meshes and textures used by augmentations, also used as sort key ids
+        enum AugmentationMesh
+        {
+            MESH_TEAPOT = 0,
+            MESH_TOWER,
+            MESH_COUNT
+        };
+
+        enum AugmentationTexture
+        {
+            TEXTURE_TEAPOT_BLUE = 0,
+            TEXTURE_TEAPOT_BRASS,
+            TEXTURE_TEAPOT_RED,
+            TEXTURE_TOWER,
+            TEXTURE_COUNT
+        };
+
+        // Bounding sphere of a mesh, with its model matrix applied
+        struct MeshBounds
+        {
+            DirectX::XMFLOAT3 center;
+            float radius;
+        };
+
+        // An augmentation of the scene description, with its transform
+        // folded into the model matrix of its mesh
+        struct AugmentationModel
+        {
+            DirectX::XMFLOAT4X4 modelMatrix;
+            MeshBounds bounds;
+            AugmentationMesh mesh;
+            AugmentationTexture texture;
+        };
+
+        // Everything needed to issue one augmentation draw, its matrices
+        // being those of instance in the pose batch of its frame
+        struct AugmentationDraw
+        {
+            uint32_t instance;
+            uint32_t model;
+            AugmentationMesh mesh;
+            AugmentationTexture texture;
+        };
+
+        // The pose a trackable's augmentations were drawn with
+        struct TrackedPose
+        {
+            int trackableId;
+            float pose[12];
+        };
+
+        // Everything derived from a set of rendering primitives. It is built
+        // whole when the primitives change and never modified once published.
+        struct ViewConfiguration
+        {
+            std::shared_ptr<Vuforia::RenderingPrimitives> renderingPrimitives;
+
+            // Rendering view, viewport and projection of each eye, the left eye first
+            uint32_t eyeCount;
+            Vuforia::VIEW eyeViews[SampleCommon::MAX_STEREO_EYES];
+            SampleCommon::ViewportRect eyeViewports[SampleCommon::MAX_STEREO_EYES];
+            DirectX::XMFLOAT4X4 eyeProjections[SampleCommon::MAX_STEREO_EYES];
+
+            // Whether stereo views are drawn with an instance per eye, which
+            // takes feature level 10_0; below it each eye is drawn in a pass
+            // of its own, into its own viewport, with its own projection
+            bool instancedStereo;
+
+            // With instanced stereo, the projections moved into the eye's part
+            // of the union viewport, and the clip space bounds of each eye within it
+            SampleCommon::ViewportRect unionViewport;
+            float unionProjections[SampleCommon::MAX_STEREO_EYES][16];
+            SampleCommon::StereoBoundsConstantBuffer frameConstants;
+        };
+
+        // Everything the render thread needs to draw one Vuforia state, prepared
+        // on the tracking thread. The vectors keep their allocations from frame to frame.
+        struct PreparedFrame
+        {
+            Vuforia::State state;
+
+            // The view configuration the frame was prepared with
+            std::shared_ptr<const ViewConfiguration> view;
+
+            // Augmentations before culling, indexed like the pose batch
+            std::vector<uint32_t> candidateModels;
+            std::vector<TrackedPose> trackedPoses;
+            SampleCommon::PoseBatch poseBatch;
+
+            // Visible augmentations, sorted through the render queue
+            std::vector<AugmentationDraw> draws;
+            SampleCommon::RenderQueue renderQueue;
+
+            SampleCommon::CullingStats cullingStats;
+            double prepareMilliseconds;
+            double lockWaitMilliseconds;
+
+            // Camera frame index and timestamp, and when the callback received the state
+            int64_t frameId;
+            double cameraTimestamp;
+            double callbackTime;
+        };
+
+        void RenderVideoBackground(Vuforia::Renderer &renderer, const PreparedFrame &frame);
+
+        // Draws the augmentations of a frame into the scaled target
+        void RenderAugmentations(Vuforia::Renderer &renderer, const PreparedFrame &frame);
 
-        void RenderTower(
-            const DirectX::XMMATRIX &poseMatrix,
-            const DirectX::XMMATRIX &projectionMatrix,
-            const std::shared_ptr<SampleCommon::Texture> texture);
+        // Blends the scaled target over the displayed frame, warped from the
+        // poses it was rendered with to those of the frame if reproject is set
+        void CompositeAugmentations(const PreparedFrame &displayed, bool reproject);
 
-        const std::shared_ptr<SampleCommon::Texture> GetAugmentationTexture(const char *targetName);
+        // Returns nullptr if the primitives have neither a monocular nor a stereo view
+        std::shared_ptr<const ViewConfiguration> CreateViewConfiguration(
+            const std::shared_ptr<Vuforia::RenderingPrimitives> &renderingPrimitives);
 
-        // Lock to protect updates to RenderingPrimitives
-        Concurrency::critical_section m_renderingPrimitivesLock;
+        // Eye adjusted projection matrix of a view
+        void GetProjectionMatrix(
+            const Vuforia::RenderingPrimitives &renderingPrimitives,
+            Vuforia::VIEW viewId,
+            DirectX::XMFLOAT4X4 &projection);
 
-        // Cached pointer to the rendering primitives
-        std::shared_ptr<Vuforia::RenderingPrimitives> m_renderingPrimitives;
+        // Tests the candidate augmentations against the frustum of each eye,
+        // setting m_cullVisible for those visible in any of them
+        void CullAugmentations(PreparedFrame &frame);
+
+        void SubmitAugmentation(PreparedFrame &frame, uint32_t instance, uint32_t model);
+
+        // Draws the queue for drawEyeCount eyes from firstEye on, with an
+        // instance per eye. Returns the number of state changes made.
+        uint32_t ExecuteRenderQueue(
+            const PreparedFrame &frame,
+            ID3D11RasterizerState *rasterState,
+            uint32_t firstEye,
+            uint32_t drawEyeCount);
+
+        // Records a range of the sorted render queue on the given context and
+        // returns the number of state changes it made
+        uint32_t RecordRenderQueue(
+            ID3D11DeviceContext3 *context,
+            const PreparedFrame &frame,
+            ID3D11RasterizerState *rasterState,
+            const SampleCommon::ConstantBufferAllocation *constants,
+            uint32_t firstEye,
+            uint32_t drawEyeCount,
+            size_t firstPacket,
+            size_t packetCount);
+
+        void GetInstanceConstants(
+            const PreparedFrame &frame,
+            const AugmentationDraw &draw,
+            uint32_t firstEye,
+            uint32_t drawEyeCount,
+            SampleCommon::ModelViewProjectionConstantBuffer &constants);
+
+        void RenderAugmentation(
+            ID3D11DeviceContext3 *context,
+            const AugmentationDraw &draw,
+            uint32_t drawEyeCount);
+
+        // Builds m_augmentationModels from the registry, once the meshes are loaded
+        void CreateAugmentationModels();
+
+        // Decodes a texture on the thread pool into its slot of m_textures,
+        // or only creates its device resources if it was decoded before
+        Concurrency::task<void> CreateTextureAsync(AugmentationTexture texture, wchar_t *filename);
+
+        // Held by the tracking thread while it prepares a frame, and while the
+        // scene description and the augmentations are (re)loaded
+        Concurrency::critical_section m_sceneLock;
+
+        // The current view configuration, replaced whenever the rendering
+        // primitives change. Frames keep the one they were prepared with.
+        SampleCommon::AtomicPublisher<ViewConfiguration> m_viewConfiguration;
 
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources> m_deviceResources;
 
-        // Video background
+        // Shared with the rest of the application
+        std::shared_ptr<SampleCommon::JobSystem> m_jobSystem;
+        std::shared_ptr<SampleCommon::StartupTracker> m_startupTracker;
+
+        // Video background, and the view configuration it was last drawn with
         std::shared_ptr<SampleCommon::VideoBackground> m_videoBackground;
+        std::shared_ptr<const ViewConfiguration> m_videoBackgroundView;
 
         // DX States for video background and augmentation rendering
         Microsoft::WRL::ComPtr<ID3D11RasterizerState>   m_augmentationRasterStateCullBack;
         Microsoft::WRL::ComPtr<ID3D11RasterizerState>   m_augmentationRasterStateCullFront;
         Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_augmentationDepthStencilState;
+        Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_augmentationTranslucentDepthStencilState;
         Microsoft::WRL::ComPtr<ID3D11BlendState>        m_augmentationBlendState;
+        Microsoft::WRL::ComPtr<ID3D11BlendState>        m_augmentationTranslucentBlendState;
 
        // Direct3D resources for mesh rendering
         Microsoft::WRL::ComPtr<ID3D11InputLayout>    m_augmentationInputLayout;
         Microsoft::WRL::ComPtr<ID3D11VertexShader>    m_augmentationVertexShader;
+        Microsoft::WRL::ComPtr<ID3D11VertexShader>    m_augmentationStereoVertexShader; // null below feature level 10_0
         Microsoft::WRL::ComPtr<ID3D11PixelShader>    m_augmentationPixelShader;
-        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_augmentationConstantBuffer;
+        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_augmentationFrameConstantBuffer;
+        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_augmentationInstanceConstantBuffer;
         
+        // Augmentations are rendered offscreen, at a resolution scaled to
+        // keep the GPU time of the pass within its budget
+        std::shared_ptr<SampleCommon::ScaledRenderTarget> m_augmentationTarget;
+        std::unique_ptr<SampleCommon::GpuTimer> m_augmentationTimer;
+        SampleCommon::ResolutionController m_resolutionController;
+        float m_resolutionScale;
+
+        // View configuration and poses the scaled target was rendered with,
+        // kept as the frame they came from may be reused before compositing
+        std::shared_ptr<const ViewConfiguration> m_renderedView;
+        std::vector<TrackedPose> m_renderedPoses;
+        std::atomic<SampleCommon::ReprojectionMode> m_reprojectionMode;
+        SampleCommon::ReprojectionStats m_reprojectionStats;
+
         // Teapot mesh
         std::shared_ptr<SampleCommon::TeapotMesh> m_teapotMesh;
         std::shared_ptr<SampleCommon::SampleApp3DModel> m_towerModel;
 
-        // Textures
-        std::shared_ptr<SampleCommon::Texture> m_textureTeapotBlue;
-        std::shared_ptr<SampleCommon::Texture> m_textureTeapotBrass;
-        std::shared_ptr<SampleCommon::Texture> m_textureTeapotRed;
-        std::shared_ptr<SampleCommon::Texture> m_textureTower;
-        
-        // System resources for model-view projection.
-        SampleCommon::ModelViewProjectionConstantBuffer    m_augmentationConstantBufferData;
-        
-        // Projection matrix, stored as an XMFLOAT4X4 to avoid imposing SSE alignment constraints 
-        // required by an XMMATRIX on this class
-        DirectX::XMFLOAT4X4 m_cameraProjection;
+        // Model matrices, indexed by AugmentationMesh. They never change, so they
+        // are folded into the per-draw model-view matrix on the CPU.
+        DirectX::XMFLOAT4X4 m_meshModelMatrices[MESH_COUNT];
+
+        // Augmentations of the scene description, indexed by registry entry
+        SampleCommon::AugmentationRegistry m_augmentationRegistry;
+        std::vector<AugmentationModel> m_augmentationModels;
+
+        // Textures, indexed by AugmentationTexture
+        std::shared_ptr<SampleCommon::Texture> m_textures[TEXTURE_COUNT];
+
+        // Frames handed from the tracking thread to the render thread
+        SampleCommon::TripleBuffer<PreparedFrame> m_preparedFrames;
+        SampleCommon::FramePipelineStats m_pipelineStats;
+        SampleCommon::FrameLatencyRecord m_frameLatency;
+
+        // Pose histories of the trackables, used by the tracking thread
+        SampleCommon::PosePredictor m_posePredictor;
+
+        // Culling scratch data of the tracking thread
+        std::vector<float> m_cullRadius;
+        std::vector<uint8_t> m_cullVisible;
+        std::vector<uint8_t> m_cullVisibleInEye;
+
+        // Statistics of the last rendered frame
+        SampleCommon::CullingStats m_cullingStats;
+        SampleCommon::RenderQueueStats m_renderQueueStats;
+
+        // Records large render queues on deferred contexts, on the workers of the
+        // job system. The recorder uses the backend, so it is released first.
+        std::unique_ptr<SampleCommon::D3D11CommandRecordingBackend> m_commandRecordingBackend;
+        std::unique_ptr<SampleCommon::ParallelCommandRecorder> m_commandRecorder;
+        std::vector<SampleCommon::RecordingJob> m_recordingJobs;
+        SampleCommon::CommandRecordingStats m_commandRecordingStats;
+
+        // Per-frame constant data is sub-allocated from a ring when the driver
+        // supports it, otherwise the constant buffers above are updated
+        std::unique_ptr<SampleCommon::ConstantBufferRing> m_constantBufferRing;
+
+        // Constant data uploaded in the current frame
+        std::atomic<uint32_t> m_constantBufferBytes;
+
+        // Draw counts of the last frame, with one instance per eye
+        SampleCommon::StereoRenderingStats m_stereoStats;
 
         // Variables used with the rendering loop.
         std::atomic<bool> m_rendererInitialized;
         std::atomic<bool> m_vuforiaInitialized;
         std::atomic<bool> m_vuforiaStarted;
         std::atomic<bool> m_extTracking;
+        std::atomic<float> m_textureMipBias;
+        std::atomic<bool> m_posePrediction;
+        std::atomic<float> m_predictionHorizonMilliseconds;
 
         // Near and Far clipping planes
         const float m_near = 0.01f;
@@ -8,17 +8,21 @@ countries.
 
 #include "ImageTargetsView.xaml.h"
 #include "Common\SampleUtil.h"
+#include "Common\DirectXHelper.h"
 
 #include <Vuforia\Vuforia.h>
 #include <Vuforia\Vuforia_UWP.h>
 #include <Vuforia\CameraDevice.h>
 #include <Vuforia\Device.h>
 #include <Vuforia\State.h>
+#include <Vuforia\Frame.h>
 #include <Vuforia\TrackerManager.h>
 #include <Vuforia\Tracker.h>
 #include <Vuforia\ObjectTracker.h>
 #include <Vuforia\ObjectTarget.h>
 
+#include <chrono>
+
 using namespace Platform;
 using namespace Windows::Foundation;
 using namespace Windows::Foundation::Collections;
@@ -38,20 +42,67 @@ using namespace concurrency;
 
 using namespace ImageTargets;
 
+// The files of the datasets, read ahead by DoPrefetchTrackersData()
+static const wchar_t *const TRACKERS_DATA_FILES[] = {
+    L"Assets\\ImageTargets\\StonesAndChips.xml",
+    L"Assets\\ImageTargets\\StonesAndChips.dat",
+    L"Assets\\ImageTargets\\Tarmac.xml",
+    L"Assets\\ImageTargets\\Tarmac.dat"
+};
+
+// By SampleDataSet
+static const char *const DATASET_FILES[DATASET_COUNT] = {
+    "Assets\\ImageTargets\\StonesAndChips.xml",
+    "Assets\\ImageTargets\\Tarmac.xml"
+};
+static const wchar_t *const DATASET_DATA_FILES[DATASET_COUNT] = {
+    L"Assets\\ImageTargets\\StonesAndChips.dat",
+    L"Assets\\ImageTargets\\Tarmac.dat"
+};
+
+// Memory the loaded datasets not in use are kept within, and how many of
+// the datasets most often switched to next are loaded ahead
+static const size_t DATASET_MEMORY_BUDGET_BYTES = 64 * 1024 * 1024;
+static const int DATASET_PREFETCH_COUNT = 1;
+
+// Update subscribers, called in this order before OnVuforiaUpdate(), and
+// the time each may take per frame before it counts as an overrun. The
+// dataset is swapped first, so the frame is prepared with the new one.
+static const int DATASET_SWITCHER_UPDATE_PRIORITY = 200;
+static const double DATASET_SWITCHER_UPDATE_BUDGET_MILLISECONDS = 2.0;
+static const int RENDERER_UPDATE_PRIORITY = 100;
+static const double RENDERER_UPDATE_BUDGET_MILLISECONDS = 8.0;
+
+// Size of a file of the app package, 0 if it can't be read
+static size_t GetPackageFileBytes(const wchar_t *filename)
+{
+    try
+    {
+        auto folder = Windows::ApplicationModel::Package::Current->InstalledLocation;
+        StorageFile^ file = create_task(folder->GetFileAsync(Platform::StringReference(filename))).get();
+        return static_cast<size_t>(create_task(file->GetBasicPropertiesAsync()).get()->Size);
+    }
+    catch (Platform::Exception^)
+    {
+        return 0;
+    }
+}
 
 ImageTargetsView::ImageTargetsView():
     m_windowVisible(true),
     m_showingMenu(false),
     m_showingProgress(true),
     m_coreInput(nullptr),
-    m_swapDataset(false),
     m_autofocusEnabled(true),
     m_extTracking(false),
     m_flashTorchEnabled(false),
-    m_currentDataSet(nullptr),
-    m_stonesDataSet(nullptr),
-    m_tarmacDataSet(nullptr)
+    m_fastVideoMode(false)
 {
+    for (int i = 0; i < DATASET_COUNT; i++)
+    {
+        m_dataSets[i] = nullptr;
+    }
+
     InitializeComponent();
     Application^ app = Application::Current; 
     app->Suspending += ref new SuspendingEventHandler(this, &ImageTargetsView::OnSuspending);
@@ -108,12 +159,44 @@ ImageTargetsView::ImageTargetsView():
     // Run task on a dedicated high priority background thread.
     m_inputLoopWorker = ThreadPool::RunAsync(workItemHandler, WorkItemPriority::High, WorkItemOptions::TimeSliced);
 
-    // Init Vuforia App Session
+    // Datasets asked for are loaded off the tracking thread, which only
+    // swaps the active one; those likely to be asked for are loaded ahead
+    m_datasetManager = std::unique_ptr<SampleCommon::DatasetManager>(new SampleCommon::DatasetManager(
+        DATASET_COUNT, DATASET_MEMORY_BUDGET_BYTES, DATASET_PREFETCH_COUNT,
+        [this](int dataset, size_t &bytes) { return LoadDataSet(dataset, bytes); },
+        [this](int dataset) { UnloadDataSet(dataset); }));
+
+    m_datasetSwitcher = std::unique_ptr<SampleCommon::DatasetSwitcher>(new SampleCommon::DatasetSwitcher(
+        [this](int dataset) { return m_datasetManager->Acquire(dataset); },
+        [this](int previous, int dataset) { return ActivateDataSet(previous, dataset); }));
+
+    // Init Vuforia App Session. Its callbacks use m_main, so it is only
+    // started once m_main exists; the camera then waits for the renderer
+    // and the swap chain panel to be ready.
     m_appSession = std::shared_ptr<AppSession>(new AppSession(this));
-    m_appSession->InitAR();
 
     m_main = std::unique_ptr<ImageTargetsMain>(new ImageTargetsMain(m_deviceResources, m_appSession));
     m_main->StartRenderLoop();
+
+    // A dataset switched to is swapped in at the frame boundary, once it
+    // has been loaded
+    m_appSession->GetUpdateBus().Subscribe("dataset switcher",
+        DATASET_SWITCHER_UPDATE_PRIORITY, DATASET_SWITCHER_UPDATE_BUDGET_MILLISECONDS,
+        [this](const VuforiaUpdate &update)
+    {
+        m_datasetSwitcher->OnFrameBoundary(update.state->getFrame().getIndex());
+    });
+
+    // Do the CPU work of this state's frame here, on the tracking thread,
+    // while the render thread draws the previous one
+    m_appSession->GetUpdateBus().Subscribe("renderer",
+        RENDERER_UPDATE_PRIORITY, RENDERER_UPDATE_BUDGET_MILLISECONDS,
+        [this](const VuforiaUpdate &update)
+    {
+        m_main->PrepareFrame(*update.state, update.callbackTime);
+    });
+
+    m_appSession->InitAR();
 }
 
 ImageTargetsView::~ImageTargetsView()
@@ -132,11 +215,10 @@ ImageTargetsView::~ImageTargetsView()
 // Saves the current state of the app for suspend and terminate events.
 void ImageTargetsView::SaveInternalState(IPropertySet^ state)
 {
-    critical_section::scoped_lock lock(m_main->GetCriticalSection());
-    m_deviceResources->Trim();
-
-    // Stop rendering when the app is suspended.
+    // Stop rendering when the app is suspended, then release the driver's
+    // temporary memory; a frame rendered after trimming would take it again
     m_main->StopRenderLoop();
+    m_main->Trim();
 
     // Put code to save app state here.
 }
@@ -185,6 +267,25 @@ bool ImageTargetsView::DoInitTrackers()
     return true;
 }
 
+bool ImageTargetsView::DoPrefetchTrackersData()
+{
+    // Loading the datasets has to wait for the object tracker; reading
+    // their files before that leaves them in the file cache
+    try
+    {
+        for (auto filename : TRACKERS_DATA_FILES)
+        {
+            DX::ReadDataAsync(filename).get();
+        }
+    }
+    catch (Platform::Exception^ ex)
+    {
+        SampleCommon::SampleUtil::Log("ImageTargetsView", ex->Message);
+        return false;
+    }
+    return true;
+}
+
 bool ImageTargetsView::DoLoadTrackersData()
 {    
     Vuforia::TrackerManager &trackerMgr = Vuforia::TrackerManager::getInstance();
@@ -197,36 +298,16 @@ bool ImageTargetsView::DoLoadTrackersData()
         return false;
     }
 
-    m_stonesDataSet = objTracker->createDataSet();
-    if (m_stonesDataSet == nullptr) {
-        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to create dataset.");
-        return false;
-    }
-    if (!m_stonesDataSet->load("Assets\\ImageTargets\\StonesAndChips.xml", Vuforia::STORAGE_TYPE::STORAGE_APPRESOURCE))
-    {
-        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to load 'StonesAndChips' dataset.");
-        return false;
-    }
-
-    m_tarmacDataSet = objTracker->createDataSet();
-    if (m_tarmacDataSet == nullptr) {
-        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to create dataset.");
-        return false;
-    }
-    if (!m_tarmacDataSet->load("Assets\\ImageTargets\\Tarmac.xml", Vuforia::STORAGE_TYPE::STORAGE_APPRESOURCE))
-    {
-        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to load 'Tarmac' dataset.");
-        return false;
-    }
-
-    m_currentDataSet = m_stonesDataSet;
-
-    if (!objTracker->activateDataSet(m_currentDataSet))
+    if (!m_datasetManager->Acquire(DATASET_STONES_AND_CHIPS) ||
+        !ActivateDataSet(-1, DATASET_STONES_AND_CHIPS))
     {
-        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to activate dataset.");
         return false;
     }
+    m_datasetSwitcher->Reset(DATASET_STONES_AND_CHIPS);
 
+    // The other dataset is kept loaded in the background, ready to be
+    // switched to
+    m_datasetManager->Hint(DATASET_TARMAC);
     return true;
 }
 
@@ -244,7 +325,7 @@ bool ImageTargetsView::DoStartCamera(int direction)
     }
 
     if (!Vuforia::CameraDevice::getInstance().selectVideoMode(
-            Vuforia::CameraDevice::MODE_DEFAULT))
+            m_appSession->VideoMode()))
     {
         return false;
     }
@@ -331,21 +412,9 @@ bool ImageTargetsView::DoUnloadTrackersData()
         return false;
     }
 
-    Vuforia::DataSet *activeDataSet = objTracker->getActiveDataSet(0);
-    if (activeDataSet == m_currentDataSet)
-    {
-        if (!objTracker->deactivateDataSet(m_currentDataSet))
-        {
-            SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to deactivate dataset.");
-            return false;
-        }
-        if (!objTracker->destroyDataSet(m_currentDataSet)) {
-            SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to destroy dataset.");
-            return false;
-        }
-    }
-
-    m_currentDataSet = nullptr;
+    // Waits for a dataset being loaded or activated
+    m_datasetSwitcher->Reset(-1);
+    m_datasetManager->UnloadAll();
     return true;
 }
 
@@ -360,9 +429,9 @@ bool ImageTargetsView::DoDeinitTrackers()
     return true;
 }
 
-// This callback is called after the Vuforia initialization is complete,
-// the trackers are initialized, their data loaded and
-// tracking is ready to start
+// This callback is called after the Vuforia initialization is complete
+// and the trackers are initialized; their data may still be loading,
+// the trackers are started once it is loaded
 void ImageTargetsView::OnInitARDone()
 { 
     m_main->GetRenderer()->SetVuforiaInitialized(true);
@@ -403,34 +472,23 @@ void ImageTargetsView::OnARStarted()
     Vuforia::onSurfaceCreated();
 }
 
-// This callback is called every cycle
+// This callback is called every cycle, after the update subscribers
 void ImageTargetsView::OnVuforiaUpdate(VuforiaState^ vuforiaState)
 {
-    Vuforia::State* state = vuforiaState->m_nativeState;
-
-    if (m_swapDataset)
+    // Sustained overruns can ask for the speed optimized camera mode, which
+    // needs a camera restart; that is done on the UI thread
+    bool fastVideoMode = m_main->GetFrameRateDecision().fastVideoMode;
+    if (fastVideoMode != m_fastVideoMode)
     {
-        m_swapDataset = false;
-           
-        Vuforia::TrackerManager &trackerMgr = Vuforia::TrackerManager::getInstance();
-        Vuforia::ObjectTracker *objTracker = static_cast<Vuforia::ObjectTracker*>(
-            trackerMgr.getTracker(Vuforia::ObjectTracker::getClassType()));
-
-        if (objTracker != nullptr) {
-            Vuforia::DataSet* activeDataset = objTracker->getActiveDataSet(0);
-            Vuforia::DataSet* datasetToActivate = (activeDataset == m_stonesDataSet) ? 
-                m_tarmacDataSet : m_stonesDataSet;
-
-            // Deactivate currently active dataset
-            objTracker->deactivateDataSet(activeDataset);
-            
-            // Activate the 'other' dataset
-            if (!objTracker->activateDataSet(datasetToActivate)) {
-                SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to activate dataset.");
-            }
-
-            m_currentDataSet = datasetToActivate;
-        }
+        m_fastVideoMode = fastVideoMode;
+        Windows::ApplicationModel::Core::CoreApplication::MainView->CoreWindow->Dispatcher->RunAsync(
+            Windows::UI::Core::CoreDispatcherPriority::Normal,
+            ref new Windows::UI::Core::DispatchedHandler([=]()
+        {
+            m_appSession->SetVideoMode(fastVideoMode ?
+                Vuforia::CameraDevice::MODE_OPTIMIZE_SPEED : Vuforia::CameraDevice::MODE_DEFAULT);
+            RestartCameraAsync(m_appSession->CameraDirection());
+        }));
     }
 }
 
@@ -465,42 +523,60 @@ void ImageTargetsView::OnVisibilityChanged(CoreWindow^ sender, VisibilityChanged
 
 // DisplayInformation event handlers.
 
+// The device work of these events is posted to the render thread, so the UI
+// thread doesn't wait for a frame to be presented.
+
 void ImageTargetsView::OnDpiChanged(DisplayInformation^ sender, Object^ args)
 {
-    critical_section::scoped_lock lock(m_main->GetCriticalSection());
     // Note: The value for LogicalDpi retrieved here may not match the effective DPI of the app
     // if it is being scaled for high resolution devices. Once the DPI is set on DeviceResources,
     // you should always retrieve it using the GetDpi method.
     // See DeviceResources.cpp for more details.
-    m_deviceResources->SetDpi(sender->LogicalDpi);
-    m_main->CreateWindowSizeDependentResources();
+    float dpi = sender->LogicalDpi;
+    m_main->PostToRenderThread([this, dpi]()
+    {
+        m_deviceResources->SetDpi(dpi);
+        m_main->CreateWindowSizeDependentResources();
+    });
 }
 
 void ImageTargetsView::OnOrientationChanged(DisplayInformation^ sender, Object^ args)
 {
-    critical_section::scoped_lock lock(m_main->GetCriticalSection());
-    m_deviceResources->SetCurrentOrientation(sender->CurrentOrientation);
-    m_main->CreateWindowSizeDependentResources();
+    DisplayOrientations orientation = sender->CurrentOrientation;
+    m_main->PostToRenderThread([this, orientation]()
+    {
+        m_deviceResources->SetCurrentOrientation(orientation);
+        m_main->CreateWindowSizeDependentResources();
+    });
 }
 
 void ImageTargetsView::OnDisplayContentsInvalidated(DisplayInformation^ sender, Object^ args)
 {
-    critical_section::scoped_lock lock(m_main->GetCriticalSection());
-    m_deviceResources->ValidateDevice();
+    m_main->PostToRenderThread([this]()
+    {
+        m_deviceResources->ValidateDevice();
+    });
 }
 
 void ImageTargetsView::OnCompositionScaleChanged(SwapChainPanel^ sender, Object^ args)
 {
-    critical_section::scoped_lock lock(m_main->GetCriticalSection());
-    m_deviceResources->SetCompositionScale(sender->CompositionScaleX, sender->CompositionScaleY);
-    m_main->CreateWindowSizeDependentResources();
+    float scaleX = sender->CompositionScaleX;
+    float scaleY = sender->CompositionScaleY;
+    m_main->PostToRenderThread([this, scaleX, scaleY]()
+    {
+        m_deviceResources->SetCompositionScale(scaleX, scaleY);
+        m_main->CreateWindowSizeDependentResources();
+    });
 }
 
 void ImageTargetsView::OnSwapChainPanelSizeChanged(Object^ sender, SizeChangedEventArgs^ e)
 {
-    critical_section::scoped_lock lock(m_main->GetCriticalSection());
-    m_deviceResources->SetLogicalSize(e->NewSize);
-    m_main->CreateWindowSizeDependentResources();
+    Size size = e->NewSize;
+    m_main->PostToRenderThread([this, size]()
+    {
+        m_deviceResources->SetLogicalSize(size);
+        m_main->CreateWindowSizeDependentResources();
+    });
 }
 
 // Pointer (touch) callbacks
@@ -633,16 +709,26 @@ void ImageTargetsView::OnExtTrackingToggled(Object^ sender, RoutedEventArgs^ e)
     ToggleSwitch^ toggleSwitch = (ToggleSwitch^)sender;
     if (m_appSession != nullptr && m_appSession->VuforiaInitialized()) 
     {
+        // Datasets loaded later start it when they are loaded
+        std::lock_guard<std::mutex> lock(m_dataSetLock);
         if (toggleSwitch->IsOn)
         {
-            m_extTracking = 
-                StartExtendedTracking(m_stonesDataSet) &&
-                StartExtendedTracking(m_tarmacDataSet);
+            bool started = true;
+            for (auto dataSet : m_dataSets)
+            {
+                started = started && (dataSet == nullptr || StartExtendedTracking(dataSet));
+            }
+            m_extTracking = started;
         }
         else
         {
-            StopExtendedTracking(m_stonesDataSet);
-            StopExtendedTracking(m_tarmacDataSet);
+            for (auto dataSet : m_dataSets)
+            {
+                if (dataSet != nullptr)
+                {
+                    StopExtendedTracking(dataSet);
+                }
+            }
             m_extTracking = false;
         }
         m_main->GetRenderer()->SetExtendedTracking(m_extTracking);
@@ -685,32 +771,112 @@ void ImageTargetsView::StopExtendedTracking(Vuforia::DataSet* dataset)
     }
 }
 
-void ImageTargetsView::RestartCameraAsync(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection)
+bool ImageTargetsView::LoadDataSet(int dataset, size_t &bytes)
 {
-    auto restartCameraTask = Concurrency::create_task([this, cameraDirection]() {
-        m_appSession->StopCamera();
+    Vuforia::TrackerManager &trackerMgr = Vuforia::TrackerManager::getInstance();
+    Vuforia::ObjectTracker *objTracker = static_cast<Vuforia::ObjectTracker*>(
+        trackerMgr.getTracker(Vuforia::ObjectTracker::getClassType()));
+    if (objTracker == nullptr)
+    {
+        return false;
+    }
 
-        // Wait a few milliseconds after camera stop,
-        // before restarting the camera
-        WaitForSingleObjectEx(GetCurrentThread(), 200, FALSE);
-        SampleCommon::SampleUtil::Log("ImageTargetsView", "Restart camera...");
+    // Loaded without the lock, the tracking thread may swap datasets meanwhile
+    Vuforia::DataSet *dataSet = objTracker->createDataSet();
+    if (dataSet == nullptr) {
+        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to create dataset.");
+        return false;
+    }
+    if (!dataSet->load(DATASET_FILES[dataset], Vuforia::STORAGE_TYPE::STORAGE_APPRESOURCE))
+    {
+        SampleCommon::SampleUtil::Log("ImageTargetsView",
+            "Failed to load dataset " + SampleCommon::SampleUtil::ToPlatformString(DATASET_FILES[dataset]));
+        objTracker->destroyDataSet(dataSet);
+        return false;
+    }
 
-        m_appSession->StartAR(cameraDirection);
-        OnARStarted();
-    }, task_continuation_context::use_current());
+    // The targets' data is most of what a dataset takes in memory
+    bytes = GetPackageFileBytes(DATASET_DATA_FILES[dataset]);
 
-    restartCameraTask.then([this](task<void> t) {
-        try 
-        {
-            // If any exceptions were thrown back in the async chain then
-            // this call throws that exception here and we can catch it below
-            t.get();
-        }
-        catch (Platform::Exception^ ex)
+    std::lock_guard<std::mutex> lock(m_dataSetLock);
+    if (m_extTracking)
+    {
+        StartExtendedTracking(dataSet);
+    }
+    m_dataSets[dataset] = dataSet;
+    return true;
+}
+
+void ImageTargetsView::UnloadDataSet(int dataset)
+{
+    Vuforia::TrackerManager &trackerMgr = Vuforia::TrackerManager::getInstance();
+    Vuforia::ObjectTracker *objTracker = static_cast<Vuforia::ObjectTracker*>(
+        trackerMgr.getTracker(Vuforia::ObjectTracker::getClassType()));
+
+    std::lock_guard<std::mutex> lock(m_dataSetLock);
+    Vuforia::DataSet *dataSet = m_dataSets[dataset];
+    m_dataSets[dataset] = nullptr;
+    if (objTracker == nullptr || dataSet == nullptr)
+    {
+        return;
+    }
+
+    if (dataSet->isActive() && !objTracker->deactivateDataSet(dataSet))
+    {
+        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to deactivate dataset.");
+    }
+    if (!objTracker->destroyDataSet(dataSet)) {
+        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to destroy dataset.");
+    }
+}
+
+bool ImageTargetsView::ActivateDataSet(int previous, int dataset)
+{
+    Vuforia::TrackerManager &trackerMgr = Vuforia::TrackerManager::getInstance();
+    Vuforia::ObjectTracker *objTracker = static_cast<Vuforia::ObjectTracker*>(
+        trackerMgr.getTracker(Vuforia::ObjectTracker::getClassType()));
+    if (objTracker == nullptr)
+    {
+        return false;
+    }
+
+    Vuforia::DataSet *previousDataSet;
+    Vuforia::DataSet *dataSet;
+    {
+        std::lock_guard<std::mutex> lock(m_dataSetLock);
+        previousDataSet = (previous >= 0) ? m_dataSets[previous] : nullptr;
+        dataSet = m_dataSets[dataset];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (previousDataSet != nullptr)
+    {
+        objTracker->deactivateDataSet(previousDataSet);
+    }
+
+    if (!objTracker->activateDataSet(dataSet))
+    {
+        SampleCommon::SampleUtil::Log("ImageTargetsView", "Failed to activate dataset.");
+
+        // Keep tracking the previous one
+        if (previousDataSet != nullptr)
         {
-            SampleCommon::SampleUtil::ShowError(L"Camera restart error", ex->Message);
+            objTracker->activateDataSet(previousDataSet);
         }
-    });
+        return false;
+    }
+
+    m_datasetManager->OnActivated(previous, dataset,
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+void ImageTargetsView::RestartCameraAsync(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection)
+{
+    // Queued with the other session changes, OnARStarted() is called once
+    // the camera runs again
+    SampleCommon::SampleUtil::Log("ImageTargetsView", "Restart camera...");
+    m_appSession->RestartCamera(cameraDirection);
 }
 
 void ImageTargetsView::OnRearCameraChecked(Object^ sender, RoutedEventArgs^ e)
@@ -740,7 +906,26 @@ void ImageTargetsView::OnFrontCameraChecked(Object^ sender, RoutedEventArgs^ e)
 void ImageTargetsView::OnSwapDataset(Object^ sender, RoutedEventArgs^ e)
 {
     if (m_appSession != nullptr && m_appSession->VuforiaInitialized()) {
-        m_swapDataset = true;
+        SampleCommon::DatasetSwitchStats stats = m_datasetSwitcher->GetStats();
+        if (stats.swaps > 0)
+        {
+            Platform::String^ message = "Last dataset switch: ";
+            message += stats.lastRequestToSwapMilliseconds.ToString();
+            message += " ms after the request, tracking thread held ";
+            message += stats.lastActivateMilliseconds.ToString();
+            message += " ms, ";
+            message += stats.lastGapFrames.ToString();
+            message += " frames dropped";
+            SampleCommon::SampleUtil::Log("ImageTargetsView", message);
+        }
+
+        std::string report;
+        m_datasetManager->FormatReport(report);
+        SampleCommon::SampleUtil::Log("ImageTargetsView", SampleCommon::SampleUtil::ToPlatformString(report.c_str()));
+
+        int target = m_datasetSwitcher->GetTargetDataset();
+        m_datasetSwitcher->RequestSwitch(
+            (target == DATASET_STONES_AND_CHIPS) ? DATASET_TARMAC : DATASET_STONES_AND_CHIPS);
 
         HideMenu();
     }
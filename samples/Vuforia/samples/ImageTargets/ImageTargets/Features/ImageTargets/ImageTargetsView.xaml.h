@@ -11,7 +11,11 @@ countries.
 #include "ImageTargetsMain.h"
 #include "SampleApplication\AppSession.h"
 #include "SampleApplication\AppControl.h"
+#include "Common\DatasetSwitcher.h"
+#include "Common\DatasetManager.h"
 
+#include <memory>
+#include <mutex>
 #include <ppltasks.h>
 #include <vector>
 
@@ -20,6 +24,14 @@ countries.
 
 namespace ImageTargets
 {
+    // The datasets the sample switches between
+    enum SampleDataSet
+    {
+        DATASET_STONES_AND_CHIPS = 0,
+        DATASET_TARMAC,
+        DATASET_COUNT
+    };
+
     /// <summary>
     /// A page that hosts a DirectX SwapChainPanel.
     /// </summary>
@@ -41,6 +53,10 @@ namespace ImageTargets
         // To be called to initialize the trackers
         virtual bool DoInitTrackers();
 
+        // To be called to read the trackers' data files ahead of loading
+        // them, while Vuforia initializes
+        virtual bool DoPrefetchTrackersData();
+
         // To be called to load the trackers' data
         virtual bool DoLoadTrackersData();
 
@@ -62,9 +78,9 @@ namespace ImageTargets
         // To be called to deinitialize the trackers
         virtual bool DoDeinitTrackers();
 
-        // This callback is called after the Vuforia initialization is complete,
-        // the trackers are initialized, their data loaded and
-        // tracking is ready to start
+        // This callback is called after the Vuforia initialization is complete
+        // and the trackers are initialized; their data may still be loading,
+        // the trackers are started once it is loaded
         virtual void OnInitARDone();
 
         // This callback is called after the Vuforia Camera and Trackers have started
@@ -111,6 +127,14 @@ namespace ImageTargets
         bool StartExtendedTracking(Vuforia::DataSet* dataset);
         void StopExtendedTracking(Vuforia::DataSet* dataset);
 
+        // Called by the dataset manager, on its I/O thread or the one
+        // acquiring the dataset
+        bool LoadDataSet(int dataset, size_t &bytes);
+        void UnloadDataSet(int dataset);
+
+        // Called by the dataset switcher on the tracking thread
+        bool ActivateDataSet(int previous, int dataset);
+
         void OnRearCameraChecked(Platform::Object^ sender, Windows::UI::Xaml::RoutedEventArgs^ e);
         void OnFrontCameraChecked(Platform::Object^ sender, Windows::UI::Xaml::RoutedEventArgs^ e);
         void RestartCameraAsync(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection);
@@ -126,18 +150,24 @@ namespace ImageTargets
         // Vuforia Sample App Session
         std::shared_ptr<AppSession> m_appSession;
 
-        // Vuforia Dataset
-        Vuforia::DataSet *m_currentDataSet;
-        Vuforia::DataSet *m_stonesDataSet;
-        Vuforia::DataSet *m_tarmacDataSet;
+        // Vuforia Datasets, nullptr unless loaded; guarded by the lock, as
+        // they are loaded and unloaded by the dataset manager's threads
+        Vuforia::DataSet *m_dataSets[DATASET_COUNT];
+        std::mutex m_dataSetLock;
+
+        std::unique_ptr<SampleCommon::DatasetManager> m_datasetManager;
+        std::unique_ptr<SampleCommon::DatasetSwitcher> m_datasetSwitcher;
 
-        std::atomic<bool> m_swapDataset;
         std::atomic<bool> m_autofocusEnabled;
         std::atomic<bool> m_extTracking;
         std::atomic<bool> m_flashTorchEnabled;
         std::atomic<bool> m_windowVisible;
         std::atomic<bool> m_showingMenu;
         std::atomic<bool> m_showingProgress;
+
+        // Camera video mode last asked for by the frame rate governor,
+        // only used on the tracking thread
+        bool m_fastVideoMode;
 };
 }
 
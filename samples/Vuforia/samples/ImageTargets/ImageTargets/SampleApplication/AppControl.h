@@ -16,10 +16,15 @@ namespace ImageTargets
     public:
         VuforiaState() {
             m_nativeState = nullptr;
+            m_callbackTime = 0.0;
         }
 
     internal:
         Vuforia::State *m_nativeState;
+
+        // When the callback received the state, in seconds of
+        // SampleCommon::LatencyTracker::Now()
+        double m_callbackTime;
     };
 
     public interface class AppControl
@@ -27,6 +32,10 @@ namespace ImageTargets
         // To be called to initialize the trackers
         bool DoInitTrackers();
 
+        // To be called to read the trackers' data files ahead of loading
+        // them, while Vuforia initializes
+        bool DoPrefetchTrackersData();
+
         // To be called to load the trackers' data
         bool DoLoadTrackersData();
 
@@ -48,9 +57,9 @@ namespace ImageTargets
         // To be called to deinitialize the trackers
         bool DoDeinitTrackers();
 
-        // This callback is called after the Vuforia initialization is complete,
-        // the trackers are initialized, their data loaded and
-        // tracking is ready to start
+        // This callback is called after the Vuforia initialization is complete
+        // and the trackers are initialized; their data may still be loading,
+        // the trackers are started once it is loaded
         void OnInitARDone();
 
         // This callback is called after the Vuforia Camera and Trackers have started
@@ -8,6 +8,11 @@ countries.
 #include "AppSession.h"
 
 #include "..\Common\SampleUtil.h"
+#include "..\Common\LatencyTracker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #include <Vuforia\Vuforia.h>
 #include <Vuforia\Vuforia_UWP.h>
@@ -23,98 +28,249 @@ using namespace Concurrency;
 using namespace Vuforia;
 using namespace ImageTargets;
 
+// Time the camera is given between being stopped and started again
+static const uint32_t CAMERA_RESTART_DELAY_MILLISECONDS = 200;
+
+// Longest time StopAR() waits for the session to be deinitialized
+static const uint32_t STOP_TIMEOUT_MILLISECONDS = 10000;
+
+// Longest time the camera start waits for the renderer and the surface;
+// the camera is started regardless afterwards
+static const uint32_t CAMERA_READY_TIMEOUT_MILLISECONDS = 10000;
+
+// Longest time an initialization stage waits for the stages it depends on
+// that are not part of the initialization
+static const uint32_t STARTUP_STAGE_TIMEOUT_MILLISECONDS = 10000;
+
+// The AppControl is called after the app's own update subscribers
+static const int APP_CONTROL_UPDATE_PRIORITY = 0;
+static const double APP_CONTROL_UPDATE_BUDGET_MILLISECONDS = 4.0;
+
+// Subscribers running over their budget are reported at most this often
+static const double UPDATE_OVERRUNS_LOG_INTERVAL_SECONDS = 5.0;
+
 AppSession::AppSession(AppControl^ appControl) :
-    m_cameraRunning(false),
-    m_vuforiaInitialized(false),
-    m_cameraDirection(Vuforia::CameraDevice::CAMERA_DIRECTION_DEFAULT),
-    m_appControl(appControl)
+    m_appControl(appControl),
+    m_vuforiaState(ref new VuforiaState()),
+    m_loggedOverruns(0),
+    m_overrunsLogTime(0.0),
+    m_videoMode(Vuforia::CameraDevice::MODE_DEFAULT),
+    m_startupTracker(std::make_shared<SampleCommon::StartupTracker>()),
+    m_pausePosted(false),
+    m_resumeRequested(0.0),
+    m_resumeCameraRunning(0.0)
 {
+    memset(&m_resumeTiming, 0, sizeof(m_resumeTiming));
+
+    m_updateBus.Subscribe("app control", APP_CONTROL_UPDATE_PRIORITY, APP_CONTROL_UPDATE_BUDGET_MILLISECONDS,
+        [this](const VuforiaUpdate &update)
+    {
+        m_vuforiaState->m_nativeState = const_cast<Vuforia::State*>(update.state);
+        m_vuforiaState->m_callbackTime = update.callbackTime;
+        m_appControl->OnVuforiaUpdate(m_vuforiaState);
+    });
+
+    m_lifecycle = std::unique_ptr<SampleCommon::SessionLifecycle>(
+        new SampleCommon::SessionLifecycle(this, CAMERA_RESTART_DELAY_MILLISECONDS));
 }
 
-void AppSession::Vuforia_onUpdate(Vuforia::State& state)
+AppSession::~AppSession()
 {
-    VuforiaState^ vuforiaState = ref new VuforiaState();
-    vuforiaState->m_nativeState = &state;
-    m_appControl->OnVuforiaUpdate(vuforiaState);
+    // Finishes the queued changes while the session is still whole
+    m_lifecycle.reset();
 }
 
-void AppSession::InitAR()
+void AppSession::Vuforia_onUpdate(Vuforia::State& state)
 {
-    Vuforia::setInitParameters("");
-    
-    auto initVuforiaTask = InitVuforiaAsync();
-    
-    auto initTrackersTask = initVuforiaTask.then([this](int result) {    
-        if (result < 0) {
-            ThrowInitError(result);
+    VuforiaUpdate update;
+    update.state = &state;
+    update.callbackTime = SampleCommon::LatencyTracker::Now();
+
+    if (!m_startupTracker->IsDone(SampleCommon::STARTUP_STAGE_FIRST_TRACKED_FRAME))
+    {
+        if (!m_startupTracker->IsDone(SampleCommon::STARTUP_STAGE_FIRST_FRAME))
+        {
+            m_startupTracker->End(SampleCommon::STARTUP_STAGE_FIRST_FRAME);
         }
-        
-        if (!m_appControl->DoInitTrackers()) {
-            throw ref new Platform::Exception(E_FAIL, "Failed to init Trackers.");
+        if (state.getNumTrackableResults() > 0 &&
+            m_startupTracker->End(SampleCommon::STARTUP_STAGE_FIRST_TRACKED_FRAME))
+        {
+            std::string report;
+            m_startupTracker->FormatReport(report);
+            SampleCommon::SampleUtil::Log("AppSession", SampleCommon::SampleUtil::ToPlatformString(report.c_str()));
         }
-    });
+    }
 
-    auto loadTrackersDataTask = initTrackersTask.then([this]() {
-        if (!m_appControl->DoLoadTrackersData()) {
-            throw ref new Platform::Exception(E_FAIL, "Failed to Load Tracker Data.");
-        }
+    double resumeRequested = m_resumeRequested.load();
+    if (resumeRequested != 0.0 && m_resumeRequested.compare_exchange_strong(resumeRequested, 0.0))
+    {
+        ReportResume(resumeRequested, update.callbackTime);
+    }
 
-        m_vuforiaInitialized = true;
-        m_appControl->OnInitARDone();
-    });
+    m_updateBus.Dispatch(update);
 
-    auto startARTask = loadTrackersDataTask.then([this]() {
-        // Wait a couple of seconds
-        WaitForSingleObjectEx(GetCurrentThread(), 2000, FALSE);
+    // A subscriber over its budget delays every one after it, and in the
+    // end the tracking itself
+    uint64_t overruns = m_updateBus.GetOverrunCount();
+    if (overruns != m_loggedOverruns &&
+        update.callbackTime - m_overrunsLogTime >= UPDATE_OVERRUNS_LOG_INTERVAL_SECONDS)
+    {
+        char buffer[80];
+        snprintf(buffer, sizeof(buffer), "%llu update callbacks over their budget\n",
+            static_cast<unsigned long long>(overruns - m_loggedOverruns));
+        std::string report(buffer);
+        m_updateBus.FormatReport(report);
+        SampleCommon::SampleUtil::Log("AppSession", SampleCommon::SampleUtil::ToPlatformString(report.c_str()));
+
+        m_loggedOverruns = overruns;
+        m_overrunsLogTime = update.callbackTime;
+    }
+}
 
-        // Start default camera (typically this is the rear camera)
-        m_cameraDirection = Vuforia::CameraDevice::CAMERA_DIRECTION_DEFAULT;
-        StartAR(m_cameraDirection);
+void AppSession::InitAR()
+{
+    Vuforia::setInitParameters("");
 
-        // Register Vuforia UpdateCallback
-        Vuforia::registerCallback(this);
-    });
+    // Start default camera (typically this is the rear camera) once initialized
+    m_lifecycle->Initialize();
+    m_lifecycle->Start(Vuforia::CameraDevice::CAMERA_DIRECTION_DEFAULT);
+}
 
-    startARTask.then([this](task<void> t) {
+bool AppSession::InitializeSession()
+{
+    // The SDK initializes while the dataset files are read ahead, and the
+    // renderer loads its assets meanwhile too. The trackers follow the SDK,
+    // and their data the trackers; the camera doesn't wait for the data,
+    // see StartCamera(). An earlier initialization is joined first.
+    m_startupGraph.reset();
+    m_startupGraph = std::unique_ptr<SampleCommon::StartupGraph>(
+        new SampleCommon::StartupGraph(m_startupTracker, STARTUP_STAGE_TIMEOUT_MILLISECONDS));
+
+    m_startupGraph->Add(SampleCommon::STARTUP_STAGE_SDK_INIT, [this]()
+    {
         try
         {
-            // If any exceptions were thrown back in the async chain then
-            // this call throws that exception here and we can catch it below
-            t.get();
-
-            // If we are here, it means Vuforia has started successfully
-            m_appControl->OnARStarted();
+            ThrowInitError(InitVuforia());
         }
         catch (Platform::Exception^ ex)
         {
             SampleCommon::SampleUtil::ShowError(L"Vuforia Initialization Error", ex->Message);
+            return false;
+        }
+        return true;
+    });
+
+    m_startupGraph->Add(SampleCommon::STARTUP_STAGE_DATASET_PREFETCH, [this]()
+    {
+        // Only saves time, the data is loaded regardless
+        if (!m_appControl->DoPrefetchTrackersData())
+        {
+            SampleCommon::SampleUtil::Log("AppSession", "Failed to prefetch tracker data.");
+        }
+        return true;
+    });
+
+    m_startupGraph->Add(SampleCommon::STARTUP_STAGE_TRACKER_INIT, [this]()
+    {
+        if (!m_appControl->DoInitTrackers())
+        {
+            SampleCommon::SampleUtil::ShowError(L"Vuforia Initialization Error", L"Failed to init Trackers.");
+            return false;
+        }
+        return true;
+    });
+
+    m_startupGraph->Add(SampleCommon::STARTUP_STAGE_DATASET_LOAD, [this]()
+    {
+        if (!m_appControl->DoLoadTrackersData())
+        {
+            SampleCommon::SampleUtil::ShowError(L"Vuforia Initialization Error", L"Failed to Load Tracker Data.");
+            return false;
         }
+        return true;
     });
+
+    m_startupGraph->Start();
+
+    uint32_t initialized =
+        SampleCommon::StartupStageBit(SampleCommon::STARTUP_STAGE_SDK_INIT) |
+        SampleCommon::StartupStageBit(SampleCommon::STARTUP_STAGE_TRACKER_INIT);
+    if (!m_startupGraph->WaitFor(initialized))
+    {
+        // The error was shown by the stage that failed
+        m_startupGraph.reset();
+        return false;
+    }
+
+    m_appControl->OnInitARDone();
+
+    // Register Vuforia UpdateCallback
+    Vuforia::registerCallback(this);
+    return true;
 }
 
 void AppSession::StartAR(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection)
 {
-    if (m_cameraRunning)
+    m_lifecycle->Start(cameraDirection);
+}
+
+void AppSession::RestartCamera(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection)
+{
+    m_lifecycle->RestartCamera(cameraDirection);
+}
+
+bool AppSession::VuforiaInitialized()
+{
+    SampleCommon::SessionState state = m_lifecycle->GetState();
+    return state == SampleCommon::SESSION_READY ||
+        state == SampleCommon::SESSION_RUNNING ||
+        state == SampleCommon::SESSION_PAUSED;
+}
+
+bool AppSession::StartCamera(int direction)
+{
+    // Starting the camera configures the video background, which needs the
+    // size of the surface, and its frames are only drawn once the renderer
+    // is ready. Both are done long before any later start.
+    uint32_t readiness = SampleCommon::StartupTracker::GetDependencies(SampleCommon::STARTUP_STAGE_CAMERA_START);
+    if (!m_startupTracker->WaitFor(readiness, CAMERA_READY_TIMEOUT_MILLISECONDS))
     {
-        // Camera already running
-        return;
+        SampleCommon::SampleUtil::Log("AppSession", "Renderer or surface not ready, starting the camera anyway.");
     }
-    
-    if (!m_appControl->DoStartCamera((int)cameraDirection))
+
+    m_startupTracker->Begin(SampleCommon::STARTUP_STAGE_CAMERA_START);
+    try
     {
-        throw ref new Platform::Exception(E_FAIL, "Failed to start camera.");
-    }
-    
-    m_cameraDirection = cameraDirection;
+        if (!m_appControl->DoStartCamera(direction))
+        {
+            throw ref new Platform::Exception(E_FAIL, "Failed to start camera.");
+        }
+
+        // The trackers need their data, which may still be loading. A
+        // failure to load it was shown when it happened.
+        if (!m_startupGraph || !m_startupGraph->WaitFor(
+            SampleCommon::StartupStageBit(SampleCommon::STARTUP_STAGE_DATASET_LOAD)))
+        {
+            m_appControl->DoStopCamera();
+            SampleCommon::SampleUtil::Log("AppSession", "Tracker data not loaded, camera stopped.");
+            return false;
+        }
 
-    // Start Trackers
-    if (!m_appControl->DoStartTrackers())
+        // Start Trackers
+        if (!m_appControl->DoStartTrackers())
+        {
+            throw ref new Platform::Exception(E_FAIL, "Failed to start trackers.");
+        }
+    }
+    catch (Platform::Exception^ ex)
     {
-        throw ref new Platform::Exception(E_FAIL, "Failed to start trackers.");
+        SampleCommon::SampleUtil::ShowError(L"Camera start error", ex->Message);
+        return false;
     }
 
     // AR camera is now up and running
-    m_cameraRunning = true;
+    m_startupTracker->End(SampleCommon::STARTUP_STAGE_CAMERA_START);
+    return true;
 }
 
 void AppSession::ConfigureVideoBackground(
@@ -129,9 +285,9 @@ void AppSession::ConfigureVideoBackground(
         return;
     }
     
-    // Get the default video mode:
+    // Get the selected video mode:
     Vuforia::CameraDevice& cameraDevice = Vuforia::CameraDevice::getInstance();
-    Vuforia::VideoMode videoMode = cameraDevice.getVideoMode(Vuforia::CameraDevice::MODE_DEFAULT);
+    Vuforia::VideoMode videoMode = cameraDevice.getVideoMode(m_videoMode);
 
     if (videoMode.mWidth <= 0 || videoMode.mHeight <= 0)
     {
@@ -191,156 +347,153 @@ void AppSession::ConfigureVideoBackground(
 
 void AppSession::StopAR()
 {
-    if (!m_vuforiaInitialized)
-        return;
+    // Also stops an initialization still queued or in progress, once it is done
+    m_lifecycle->Deinitialize();
+    if (!m_lifecycle->WaitForIdle(STOP_TIMEOUT_MILLISECONDS))
+    {
+        SampleCommon::SampleUtil::Log("AppSession", "Timed out stopping Vuforia.");
+    }
+}
 
-    StopCamera();
+bool AppSession::DeinitializeSession()
+{
+    // The tracker data may still be loading if the camera never started
+    m_startupGraph.reset();
 
     // Unregister the Vuforia callback
     Vuforia::registerCallback(nullptr);
 
-    // Ensure that all asynchronous operations to initialize Vuforia
-    // and loading the tracker datasets do not overlap:
-    boolean unloadTrackersResult;
-    boolean deinitTrackersResult;
-    
     // Destroy the tracking data set:
-    unloadTrackersResult = m_appControl->DoUnloadTrackersData();
+    bool unloadTrackersResult = m_appControl->DoUnloadTrackersData();
 
     // Deinitialize the trackers:
-    deinitTrackersResult = m_appControl->DoDeinitTrackers();
+    bool deinitTrackersResult = m_appControl->DoDeinitTrackers();
 
     // Deinitialize Vuforia SDK:
     Vuforia::deinit();
 
-    m_vuforiaInitialized = false;
-
     if (!unloadTrackersResult)
-        throw ref new Platform::Exception(E_FAIL, "Failed to unload trackers data.");
+        SampleCommon::SampleUtil::Log("AppSession", "Failed to unload trackers data.");
 
     if (!deinitTrackersResult)
-        throw ref new Platform::Exception(E_FAIL, "Failed to unload trackers data.");
+        SampleCommon::SampleUtil::Log("AppSession", "Failed to deinit trackers.");
+
+    return unloadTrackersResult && deinitTrackersResult;
 }
 
-void AppSession::StopCamera()
+bool AppSession::StopCamera()
 {
-    if (m_cameraRunning)
-    {
-        if (!m_appControl->DoStopTrackers())
-            throw ref new Platform::Exception(E_FAIL, "Failed to stop trackers.");
+    // The camera is stopped even if the trackers couldn't be
+    bool trackersStopped = m_appControl->DoStopTrackers();
+    if (!trackersStopped)
+        SampleCommon::SampleUtil::Log("AppSession", "Failed to stop trackers.");
 
-        if (!m_appControl->DoStopCamera())
-            throw ref new Platform::Exception(E_FAIL, "Failed to stop camera.");
+    bool cameraStopped = m_appControl->DoStopCamera();
+    if (!cameraStopped)
+        SampleCommon::SampleUtil::Log("AppSession", "Failed to stop camera.");
 
-        m_cameraRunning = false;
-    }
+    return trackersStopped && cameraStopped;
 }
 
 // Resumes Vuforia, restarts the trackers and the camera
 void AppSession::ResumeAR()
 {
-    if (m_vuforiaInitialized)
+    // Timed to the first camera frame, if a pause was asked for before
+    if (m_pausePosted.exchange(false))
     {
-        // For an explanation of the following see the comment above
-        // the declaration of m_resumeTask
-
-        // Check for existing running resume task
-        if (m_resumeTask == nullptr || m_resumeTask->Status != AsyncStatus::Started)
-        {
-            // To make sure we check the currently running pause task
-            // (and not one created while we're running) we capture the
-            // pointer here
-            IAsyncAction^ localPauseTask = m_pauseTask;
-
-            m_resumeTask = Concurrency::create_async([this, localPauseTask]() {
-                if (localPauseTask != nullptr)
-                {
-                    while (localPauseTask->Status == AsyncStatus::Started)
-                    {
-                         Concurrency::wait(100);
-                    }
-                }
-
-                // Only perform actions if we want to resume even after further events
-                // Check that the same number or more pause events have been received
-                if (m_ignoredResume >= m_ignoredPaused)
-                {
-                    Vuforia::onResume();
-                    StartAR(m_cameraDirection);
-
-                    // Notify app control
-                    m_appControl->OnARStarted();
-                }
-                else
-                {
-                    m_ignoredPaused--;
-                }
-            });
-        }
-        else
-        {
-            m_ignoredResume++;
-        }
+        m_resumeCameraRunning = 0.0;
+        m_resumeRequested = SampleCommon::LatencyTracker::Now();
     }
+    m_lifecycle->Resume();
 }
 
-// Pauses Vuforia and stops the camera
+// Pauses Vuforia and stops the camera. The datasets, the trackers and the
+// renderer's assets are all kept, so that resuming only has to start the
+// camera again.
 void AppSession::PauseAR() 
 {
-    if (m_vuforiaInitialized)
+    m_resumeRequested = 0.0;
+    m_pausePosted = true;
+    m_lifecycle->Pause();
+}
+
+SampleCommon::SessionTransitionTiming AppSession::GetResumeTiming()
+{
+    std::lock_guard<std::mutex> lock(m_resumeMutex);
+    return m_resumeTiming;
+}
+
+void AppSession::ReportResume(double requested, double firstFrame)
+{
+    double milliseconds = (firstFrame - requested) * 1000.0;
+    double cameraRunning = m_resumeCameraRunning.load();
     {
-        // For an explanation of the following see the comment above
-        // the declaration of m_pauseTask
+        std::lock_guard<std::mutex> lock(m_resumeMutex);
+        m_resumeTiming.count++;
+        m_resumeTiming.lastMilliseconds = milliseconds;
+        m_resumeTiming.meanMilliseconds += (milliseconds - m_resumeTiming.meanMilliseconds) / m_resumeTiming.count;
+        m_resumeTiming.maxMilliseconds = (std::max)(m_resumeTiming.maxMilliseconds, milliseconds);
+    }
 
-        // Check for existing running pause task
-        if (m_pauseTask == nullptr || m_pauseTask->Status != AsyncStatus::Started)
-        {
-            // To make sure we check the currently running resume task
-            // (and not one created while we're running) we capture the
-            // pointer here
-            IAsyncAction^ localResumeTask = m_resumeTask;
-
-            // The camera must be stopped asynchronously
-            m_pauseTask = Concurrency::create_async([this, localResumeTask]() {
-                if (localResumeTask != nullptr)
-                {
-                    while (localResumeTask->Status == AsyncStatus::Started)
-                    {
-                        Concurrency::wait(100);
-                    }
-                }
-
-                // Only perform actions if we want to pause even after further events
-                // Check that the same number or more resume events have been received
-                if (m_ignoredPaused >= m_ignoredResume)
-                {
-                    StopCamera();
-                    Vuforia::onPause();
-                }
-                else
-                {
-                    m_ignoredResume--;
-                }
-            });
-        }
-        else
+    Platform::String^ resumeMsg = L"Resume to first frame: ";
+    resumeMsg += static_cast<int>(milliseconds).ToString();
+    resumeMsg += L" ms";
+    if (cameraRunning != 0.0)
+    {
+        resumeMsg += L", camera running after ";
+        resumeMsg += static_cast<int>((cameraRunning - requested) * 1000.0).ToString();
+        resumeMsg += L" ms";
+    }
+    SampleCommon::SampleUtil::Log("AppSession", resumeMsg);
+}
+
+void AppSession::PauseSession()
+{
+    Vuforia::onPause();
+}
+
+void AppSession::ResumeSession()
+{
+    Vuforia::onResume();
+}
+
+void AppSession::OnSessionStateChanged(SampleCommon::SessionState previous, SampleCommon::SessionState state)
+{
+    Platform::String^ stateMsg = L"Session ";
+    stateMsg += SampleCommon::SampleUtil::ToPlatformString(SampleCommon::SessionLifecycle::GetStateName(state));
+    SampleCommon::SampleUtil::Log("AppSession", stateMsg);
+
+    // Notify app control
+    if (state == SampleCommon::SESSION_RUNNING)
+    {
+        if (m_resumeRequested.load() != 0.0)
         {
-            m_ignoredPaused++;
+            m_resumeCameraRunning = SampleCommon::LatencyTracker::Now();
         }
+        m_appControl->OnARStarted();
     }
 }
 
-Concurrency::task<int> AppSession::InitVuforiaAsync()
+int AppSession::InitVuforia()
 {
-    return Concurrency::create_task([]()
+    // Each call does the next step of the initialization and returns the
+    // progress made, which is reported as it changes
+    int progress = 0;
+    int reported = -1;
+    while (progress >= 0 && progress < 100)
     {
-        int progress = 0;
-        while (progress >= 0 && progress < 100)
+        progress = Vuforia::init();
+        if (progress != reported && progress >= 0)
         {
-            progress = Vuforia::init();
+            m_startupTracker->SetProgress(SampleCommon::STARTUP_STAGE_SDK_INIT, progress);
+
+            Platform::String^ progressMsg = L"Vuforia init progress: ";
+            progressMsg += progress.ToString();
+            SampleCommon::SampleUtil::Log("AppSession", progressMsg);
+            reported = progress;
         }
-        return progress;
-    });
+    }
+    return progress;
 }
 
 void AppSession::ThrowInitError(int errorCode)
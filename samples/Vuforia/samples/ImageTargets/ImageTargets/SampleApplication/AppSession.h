@@ -7,8 +7,14 @@ countries.
 #pragma once
 
 #include "AppControl.h"
+#include "..\Common\SessionLifecycle.h"
+#include "..\Common\StartupGraph.h"
+#include "..\Common\StartupTracker.h"
+#include "..\Common\UpdateBus.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <wrl.h>
 #include <ppltasks.h>
 
@@ -17,24 +23,64 @@ countries.
 
 namespace ImageTargets
 {
-    class AppSession : public Vuforia::UpdateCallback
+    // What the update bus hands its subscribers for each camera frame
+    struct VuforiaUpdate
+    {
+        const Vuforia::State *state;
+
+        // When the callback received the state, in seconds of
+        // SampleCommon::LatencyTracker::Now()
+        double callbackTime;
+    };
+
+    typedef SampleCommon::UpdateBus<VuforiaUpdate> VuforiaUpdateBus;
+
+    // Drives Vuforia through its lifecycle. The methods changing its state
+    // only queue the change and return at once; the changes are made in
+    // order on the session's own thread, see SampleCommon::SessionLifecycle.
+    class AppSession : public Vuforia::UpdateCallback, public SampleCommon::SessionHandler
     {
     public:
         AppSession(AppControl^ appControl);
+        ~AppSession();
 
         void InitAR();
         void StartAR(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection);
+
+        // Stops and deinitializes Vuforia, waiting until it is done
         void StopAR();
-        void StopCamera();
+
+        // Restarts the camera even if it already runs in that direction,
+        // e.g. for a new video mode to take effect
+        void RestartCamera(Vuforia::CameraDevice::CAMERA_DIRECTION cameraDirection);
         void PauseAR();
         void ResumeAR();
 
-        bool VuforiaInitialized() const { return m_vuforiaInitialized; }
-        bool CameraRunning() const { return m_cameraRunning; }
-        Vuforia::CameraDevice::CAMERA_DIRECTION CameraDirection() const {
-            return m_cameraDirection;
+        bool VuforiaInitialized();
+        bool CameraRunning() { return m_lifecycle->GetState() == SampleCommon::SESSION_RUNNING; }
+        Vuforia::CameraDevice::CAMERA_DIRECTION CameraDirection() {
+            return static_cast<Vuforia::CameraDevice::CAMERA_DIRECTION>(m_lifecycle->GetCameraDirection());
         }
 
+        // Transition counts and latencies
+        SampleCommon::SessionLifecycleStats GetLifecycleStats() { return m_lifecycle->GetStats(); }
+
+        // Time from ResumeAR() after a pause to the first camera frame. Only
+        // the camera is started again, everything else is kept while paused.
+        SampleCommon::SessionTransitionTiming GetResumeTiming();
+
+        // Startup stages, which the renderer and the window report too.
+        // Its report is logged once the first target is tracked.
+        const std::shared_ptr<SampleCommon::StartupTracker>& GetStartupTracker() const { return m_startupTracker; }
+
+        // Video mode the camera is started with; takes effect on the next camera start
+        Vuforia::CameraDevice::MODE VideoMode() const { return m_videoMode; }
+        void SetVideoMode(Vuforia::CameraDevice::MODE videoMode) { m_videoMode = videoMode; }
+
+        // Every camera frame is dispatched on it, on the tracking thread;
+        // the AppControl's OnVuforiaUpdate() is one of its subscribers
+        VuforiaUpdateBus& GetUpdateBus() { return m_updateBus; }
+
         // Vuforia UpdateCallback interface
         virtual void Vuforia_onUpdate(Vuforia::State& state) override;
 
@@ -46,28 +92,53 @@ namespace ImageTargets
     private:
         AppControl^ m_appControl;
 
-        Concurrency::task<int> InitVuforiaAsync();
+        // Handed to the AppControl every frame, allocated once
+        VuforiaState^ m_vuforiaState;
+
+        VuforiaUpdateBus m_updateBus;
+
+        // Tracking thread only: overruns of the subscribers last logged
+        uint64_t m_loggedOverruns;
+        double m_overrunsLogTime;
+
+        // SessionHandler interface, called on the session's thread
+        virtual bool InitializeSession() override;
+        virtual bool StartCamera(int direction) override;
+        virtual bool StopCamera() override;
+        virtual void PauseSession() override;
+        virtual void ResumeSession() override;
+        virtual bool DeinitializeSession() override;
+        virtual void OnSessionStateChanged(SampleCommon::SessionState previous, SampleCommon::SessionState state) override;
+
+        int InitVuforia();
         void ThrowInitError(int errorCode);
+
+        // Tracking thread: records and logs a resume, with its times in
+        // seconds of SampleCommon::LatencyTracker::Now()
+        void ReportResume(double requested, double firstFrame);
         
-        Vuforia::CameraDevice::CAMERA_DIRECTION m_cameraDirection;
-        std::atomic<bool> m_cameraRunning;
-        std::atomic<bool> m_vuforiaInitialized;
-
-        /* For suspending and resuming we create an async task.
-         * This is necessary because stopping and starting the camera takes
-         * too long to run on the UI thread and the SDK doesn't allow this.
-         * We need to ensure that these don't end up running concurrently and
-         * that we always end up in the desired state even if the user
-         * repeatedly suspend/resumes the app.
-         */
-
-         /// Handle to the suspend action
-        Windows::Foundation::IAsyncAction^ m_pauseTask;
-        /// Count the times we have ignored a suspend notification
-        int m_ignoredPaused = 0;
-        /// Handle to the resume action
-        Windows::Foundation::IAsyncAction^ m_resumeTask;
-        /// Count the times we have ignored the resume notification
-        int m_ignoredResume = 0;
+        std::atomic<Vuforia::CameraDevice::MODE> m_videoMode;
+        std::shared_ptr<SampleCommon::StartupTracker> m_startupTracker;
+
+        // The initialization's stages, run concurrently where they don't
+        // depend on each other; kept until deinitialization, as the camera
+        // start waits on the tracker data loading
+        std::unique_ptr<SampleCommon::StartupGraph> m_startupGraph;
+
+        // Set by PauseAR(), so that only a resume after a pause is timed.
+        // The times are 0 while no resume is timed.
+        std::atomic<bool> m_pausePosted;
+        std::atomic<double> m_resumeRequested;
+        std::atomic<double> m_resumeCameraRunning;
+
+        std::mutex m_resumeMutex;
+        SampleCommon::SessionTransitionTiming m_resumeTiming;
+
+        // Stopping and starting the camera takes too long to run on the UI
+        // thread, and the SDK doesn't allow it there. The lifecycle runs the
+        // changes on its own thread, one at a time, and merges redundant
+        // ones, so that repeated suspend/resume events end in the last state
+        // asked for without waiting for each other.
+        std::unique_ptr<SampleCommon::SessionLifecycle> m_lifecycle;
     };
 };
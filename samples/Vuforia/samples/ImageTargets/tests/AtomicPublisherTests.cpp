@@ -0,0 +1,231 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "AtomicPublisher.h"
+#include "FramePipeline.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const int STORM_PUBLISHES = 100000;
+static const int STORM_WRITERS = 2;
+static const int STORM_READERS = 3;
+static const uint64_t HANDOFF_FRAMES = 200000;
+
+// Stands in for the renderer's view configuration: everything is derived
+// from the size, so a reader seeing a partly written one would notice
+struct TestConfiguration
+{
+    static std::atomic<int> s_live;
+
+    TestConfiguration(int configWidth, int configHeight) :
+        width(configWidth),
+        height(configHeight)
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            projection[i] = static_cast<float>(width * i + height);
+        }
+        s_live++;
+    }
+
+    ~TestConfiguration()
+    {
+        width = -1;
+        s_live--;
+    }
+
+    bool IsConsistent() const
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            if (projection[i] != static_cast<float>(width * i + height))
+            {
+                return false;
+            }
+        }
+        return width >= 0;
+    }
+
+    int width;
+    int height;
+    float projection[16];
+};
+
+std::atomic<int> TestConfiguration::s_live(0);
+
+static void TestPublishAndAcquire()
+{
+    {
+        AtomicPublisher<TestConfiguration> publisher;
+        CHECK(publisher.Acquire() == nullptr);
+        CHECK(publisher.GetVersion() == 0);
+
+        publisher.Publish(std::make_shared<TestConfiguration>(640, 480));
+        std::shared_ptr<const TestConfiguration> held = publisher.Acquire();
+        CHECK(held != nullptr && held->width == 640);
+
+        // A reader keeps the object it acquired after a newer one is published
+        publisher.Publish(std::make_shared<TestConfiguration>(480, 640));
+        CHECK(publisher.GetVersion() == 2);
+        CHECK(held->width == 640 && held->IsConsistent());
+        CHECK(publisher.Acquire()->width == 480);
+        CHECK(TestConfiguration::s_live == 2);
+
+        held.reset();
+        CHECK(TestConfiguration::s_live == 1);
+
+        publisher.Publish(nullptr);
+        CHECK(publisher.Acquire() == nullptr);
+        CHECK(TestConfiguration::s_live == 0);
+    }
+    CHECK(TestConfiguration::s_live == 0);
+}
+
+// Rendering primitives changing on every resize event while the tracking
+// and render threads keep acquiring the view configuration
+static void TestResizeStorm()
+{
+    {
+        AtomicPublisher<TestConfiguration> publisher;
+        publisher.Publish(std::make_shared<TestConfiguration>(1, 1));
+
+        std::atomic<bool> stop(false);
+        std::atomic<uint64_t> reads(0);
+        std::atomic<uint64_t> inconsistent(0);
+        std::atomic<uint64_t> versionRegressions(0);
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < STORM_READERS; r++)
+        {
+            readers.emplace_back([&]()
+            {
+                uint32_t lastVersion = 0;
+                uint64_t readerReads = 0;
+                std::shared_ptr<const TestConfiguration> frameView;
+                while (!stop)
+                {
+                    uint32_t version = publisher.GetVersion();
+                    versionRegressions += (version < lastVersion) ? 1 : 0;
+                    lastVersion = version;
+
+                    // Like a prepared frame, a configuration is held across
+                    // several later acquires before it is dropped
+                    std::shared_ptr<const TestConfiguration> view = publisher.Acquire();
+                    inconsistent += (view == nullptr || !view->IsConsistent()) ? 1 : 0;
+                    if ((readerReads++ % 8) == 0)
+                    {
+                        frameView = view;
+                    }
+                    inconsistent += frameView->IsConsistent() ? 0 : 1;
+                }
+                reads += readerReads;
+            });
+        }
+
+        std::vector<std::thread> writers;
+        for (int w = 0; w < STORM_WRITERS; w++)
+        {
+            writers.emplace_back([&publisher, w]()
+            {
+                for (int i = 0; i < STORM_PUBLISHES; i++)
+                {
+                    publisher.Publish(std::make_shared<TestConfiguration>(i + w, 2 * i));
+                }
+            });
+        }
+
+        for (auto &writer : writers)
+        {
+            writer.join();
+        }
+        stop = true;
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+
+        printf("  %llu reads during %d publishes\n",
+            static_cast<unsigned long long>(reads.load()), STORM_WRITERS * STORM_PUBLISHES);
+        CHECK(reads > 0);
+        CHECK(inconsistent == 0);
+        CHECK(versionRegressions == 0);
+        CHECK(publisher.GetVersion() == static_cast<uint32_t>(STORM_WRITERS * STORM_PUBLISHES + 1));
+        CHECK(TestConfiguration::s_live == 1);
+    }
+
+    // Every configuration was freed by whichever thread dropped it last
+    CHECK(TestConfiguration::s_live == 0);
+}
+
+struct TestFrame
+{
+    uint64_t sequence;
+    uint64_t check;
+};
+
+// The tracking thread preparing frames as fast as it can while the render
+// thread takes the latest one: frames only go forward, are never torn, and
+// each is either rendered or dropped
+static void TestTripleBufferHandoff(bool acquireNewer)
+{
+    TripleBuffer<TestFrame> frames;
+    std::thread producer([&frames]()
+    {
+        for (uint64_t sequence = 1; sequence <= HANDOFF_FRAMES; sequence++)
+        {
+            TestFrame &frame = frames.GetWriteBuffer();
+            frame.sequence = sequence;
+            frame.check = sequence * 7;
+            frames.Publish();
+
+            // Lets the consumer in now and then even on a single core
+            if ((sequence % 4) == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t last = 0;
+    uint64_t torn = 0;
+    uint64_t backwards = 0;
+    while (last < HANDOFF_FRAMES)
+    {
+        TestFrame *frame = acquireNewer ? frames.AcquireNewer() : frames.Acquire();
+        if (frame == nullptr || frame->sequence == last)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        torn += (frame->check != frame->sequence * 7) ? 1 : 0;
+        backwards += (frame->sequence < last) ? 1 : 0;
+        CHECK(!acquireNewer || frame->sequence > last);
+        last = frame->sequence;
+    }
+    producer.join();
+
+    printf("  %u published, %u acquired, %u dropped, %u repeated\n",
+        frames.GetPublishedCount(), frames.GetAcquiredCount(), frames.GetDroppedCount(), frames.GetRepeatedCount());
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(frames.GetPublishedCount() == HANDOFF_FRAMES);
+    CHECK(frames.GetAcquiredCount() + frames.GetDroppedCount() == HANDOFF_FRAMES);
+    CHECK(!acquireNewer || frames.GetRepeatedCount() == 0);
+}
+
+int main()
+{
+    SampleTests::RunTest("AtomicPublisher publish and acquire", TestPublishAndAcquire);
+    SampleTests::RunTest("AtomicPublisher resize storm", TestResizeStorm);
+    SampleTests::RunTest("TripleBuffer handoff with Acquire", []() { TestTripleBufferHandoff(false); });
+    SampleTests::RunTest("TripleBuffer handoff with AcquireNewer", []() { TestTripleBufferHandoff(true); });
+    return SampleTests::Result();
+}
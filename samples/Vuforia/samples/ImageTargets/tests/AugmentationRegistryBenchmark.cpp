@@ -0,0 +1,97 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "AugmentationRegistry.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const uint32_t TARGET_COUNTS[] = { 100, 500, 1000, 2000, 5000 };
+
+static const char *const MESH_NAMES[] = { "teapot", "building", "astronaut", "drone" };
+static const char *const TEXTURE_NAMES[] = { "brass", "blue", "red", "yellow", "grey", "orange", "white", "black" };
+
+// A scene description with a line per target in each mode, some of them with
+// a transform, and a fallback
+static std::string MakeScene(const std::vector<std::string> &targets)
+{
+    std::string text = "# generated\nstandard * teapot brass\n";
+    char line[128];
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+        snprintf(line, sizeof(line), "standard %s %s %s\n", targets[i].c_str(), MESH_NAMES[i % 4], TEXTURE_NAMES[i % 8]);
+        text += line;
+        snprintf(line, sizeof(line), "extended %s %s %s 0.5 0 0.1 0 %u\n",
+            targets[i].c_str(), MESH_NAMES[(i + 1) % 4], TEXTURE_NAMES[(i + 3) % 8], static_cast<uint32_t>(i % 360));
+        text += line;
+    }
+    return text;
+}
+
+// Time to load a scene of N targets, and per lookup to resolve the targets
+// through the trackable cache and without it
+int main(int argc, char **argv)
+{
+    // Lookups per measurement, whatever the target count
+    const size_t lookups = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : 10000000;
+
+    printf("targets   load ms   probe   cached ns   uncached ns\n");
+    double checksum = 0.0;
+    for (uint32_t targetCount : TARGET_COUNTS)
+    {
+        std::vector<std::string> targets(targetCount);
+        for (uint32_t i = 0; i < targetCount; i++)
+        {
+            targets[i] = "target_" + std::to_string(i * 7919 % 100003) + "_marker";
+        }
+        std::string scene = MakeScene(targets);
+
+        AugmentationRegistry registry;
+        const int loads = 20;
+        auto start = std::chrono::steady_clock::now();
+        for (int load = 0; load < loads; load++)
+        {
+            registry.Load(scene.c_str(), scene.size(), MESH_NAMES, 4, TEXTURE_NAMES, 8);
+        }
+        double loadMilliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) / loads;
+
+        // A frame's worth of trackables at a time, as the renderer sees them
+        const size_t rounds = (std::max)(static_cast<size_t>(1), lookups / targetCount);
+        start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; round++)
+        {
+            AugmentationMode mode = static_cast<AugmentationMode>(round % AUGMENTATION_MODE_COUNT);
+            for (uint32_t i = 0; i < targetCount; i++)
+            {
+                checksum += registry.Resolve(static_cast<int>(i), targets[i].c_str(), mode);
+            }
+        }
+        double cachedNanoseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) * 1e6 /
+            (static_cast<double>(rounds) * targetCount);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; round++)
+        {
+            AugmentationMode mode = static_cast<AugmentationMode>(round % AUGMENTATION_MODE_COUNT);
+            for (uint32_t i = 0; i < targetCount; i++)
+            {
+                checksum += registry.Resolve(-1, targets[i].c_str(), mode);
+            }
+        }
+        double uncachedNanoseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) * 1e6 /
+            (static_cast<double>(rounds) * targetCount);
+
+        printf("%7u %9.3f %7u %11.2f %13.2f\n", targetCount, loadMilliseconds, registry.GetStats().maxProbeLength,
+            cachedNanoseconds, uncachedNanoseconds);
+    }
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
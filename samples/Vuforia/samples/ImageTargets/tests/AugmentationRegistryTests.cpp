@@ -0,0 +1,194 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "AugmentationRegistry.h"
+
+#include <cstring>
+
+using namespace SampleCommon;
+
+static const char *const MESH_NAMES[] = { "teapot", "building" };
+static const char *const TEXTURE_NAMES[] = { "brass", "blue", "red" };
+
+static bool Load(AugmentationRegistry &registry, const char *text)
+{
+    return registry.Load(text, strlen(text), MESH_NAMES, 2, TEXTURE_NAMES, 3);
+}
+
+static void TestParse()
+{
+    AugmentationRegistry registry;
+    CHECK(Load(registry,
+        "# comment\n"
+        "\n"
+        "standard stones teapot brass\n"
+        "standard chips building blue 2.5\n"
+        "  extended tarmac\tteapot red 0.5 1 -2 3 90  \r\n"
+        "standard last teapot blue"));
+    CHECK(registry.GetStats().entryCount == 4);
+    CHECK(registry.GetStats().rejectedLines == 0);
+
+    const AugmentationEntry &stones = registry.GetEntry(registry.Find("stones", AUGMENTATION_MODE_STANDARD));
+    CHECK(stones.mesh == 0 && stones.texture == 0);
+    CHECK(stones.scale == 1.0f && stones.rotation == 0.0f);
+    CHECK(stones.translation[0] == 0.0f && stones.translation[1] == 0.0f && stones.translation[2] == 0.0f);
+
+    const AugmentationEntry &chips = registry.GetEntry(registry.Find("chips", AUGMENTATION_MODE_STANDARD));
+    CHECK(chips.mesh == 1 && chips.texture == 1 && chips.scale == 2.5f);
+
+    const AugmentationEntry &tarmac = registry.GetEntry(registry.Find("tarmac", AUGMENTATION_MODE_EXTENDED));
+    CHECK(tarmac.mesh == 0 && tarmac.texture == 2 && tarmac.scale == 0.5f);
+    CHECK(tarmac.translation[0] == 1.0f && tarmac.translation[1] == -2.0f && tarmac.translation[2] == 3.0f);
+    CHECK(tarmac.rotation == 90.0f);
+
+    // The last line needs no newline
+    CHECK(registry.Find("last", AUGMENTATION_MODE_STANDARD) != AugmentationRegistry::INVALID_ENTRY);
+}
+
+static void TestMalformedLines()
+{
+    AugmentationRegistry registry;
+    CHECK(Load(registry,
+        "standard stones teapot brass\n"
+        "standard short teapot\n"
+        "standard partial teapot brass 1 2\n"
+        "standard toolong teapot brass 1 2 3 4 5 6\n"
+        "sideways mode teapot brass\n"
+        "standard mesh cube brass\n"
+        "standard texture teapot green\n"
+        "standard scale teapot brass big\n"
+        "standard offset teapot brass 1 2 x 3\n"
+        "standard rotation teapot brass 1 2 3 4 5deg\n"));
+    CHECK(registry.GetStats().entryCount == 1);
+    CHECK(registry.GetStats().rejectedLines == 9);
+
+    const char *rejected[] = { "short", "partial", "toolong", "mode", "mesh", "texture", "scale", "offset", "rotation" };
+    for (const char *name : rejected)
+    {
+        CHECK(registry.Find(name, AUGMENTATION_MODE_STANDARD) == AugmentationRegistry::INVALID_ENTRY);
+    }
+
+    // Nothing valid fails the load and leaves the registry empty
+    CHECK(!Load(registry, "# only a comment\nstandard short teapot\n"));
+    CHECK(registry.GetEntryCount() == 0);
+    CHECK(registry.GetStats().rejectedLines == 1);
+    CHECK(registry.Find("stones", AUGMENTATION_MODE_STANDARD) == AugmentationRegistry::INVALID_ENTRY);
+}
+
+static void TestFallback()
+{
+    AugmentationRegistry registry;
+    CHECK(Load(registry,
+        "standard stones teapot brass\n"
+        "standard * building blue\n"));
+
+    uint32_t stones = registry.Find("stones", AUGMENTATION_MODE_STANDARD);
+    uint32_t fallback = registry.Find("chips", AUGMENTATION_MODE_STANDARD);
+    CHECK(stones != AugmentationRegistry::INVALID_ENTRY && fallback != AugmentationRegistry::INVALID_ENTRY);
+    CHECK(stones != fallback);
+    CHECK(registry.GetEntry(fallback).mesh == 1 && registry.GetEntry(fallback).texture == 1);
+    CHECK(registry.Find("", AUGMENTATION_MODE_STANDARD) == fallback);
+
+    // The fallback is per mode too
+    CHECK(registry.Find("chips", AUGMENTATION_MODE_EXTENDED) == AugmentationRegistry::INVALID_ENTRY);
+
+    // Without a fallback unknown targets have no entry
+    CHECK(Load(registry, "standard stones teapot brass\n"));
+    CHECK(registry.Find("chips", AUGMENTATION_MODE_STANDARD) == AugmentationRegistry::INVALID_ENTRY);
+}
+
+static void TestLaterLineReplaces()
+{
+    AugmentationRegistry registry;
+    CHECK(Load(registry,
+        "standard stones teapot brass\n"
+        "standard * teapot brass\n"
+        "standard chips teapot brass\n"
+        "standard stones building red 3\n"
+        "standard * building blue\n"));
+
+    const AugmentationEntry &stones = registry.GetEntry(registry.Find("stones", AUGMENTATION_MODE_STANDARD));
+    CHECK(stones.mesh == 1 && stones.texture == 2 && stones.scale == 3.0f);
+
+    const AugmentationEntry &fallback = registry.GetEntry(registry.Find("unknown", AUGMENTATION_MODE_STANDARD));
+    CHECK(fallback.mesh == 1 && fallback.texture == 1);
+
+    // Targets in between are unaffected
+    const AugmentationEntry &chips = registry.GetEntry(registry.Find("chips", AUGMENTATION_MODE_STANDARD));
+    CHECK(chips.mesh == 0 && chips.texture == 0);
+}
+
+static void TestModesAreSeparate()
+{
+    AugmentationRegistry registry;
+    CHECK(Load(registry,
+        "standard stones teapot brass\n"
+        "extended stones building red\n"
+        "extended tarmac teapot blue\n"
+        "extended * building blue\n"));
+
+    uint32_t standard = registry.Find("stones", AUGMENTATION_MODE_STANDARD);
+    uint32_t extended = registry.Find("stones", AUGMENTATION_MODE_EXTENDED);
+    CHECK(standard != extended);
+    CHECK(registry.GetEntry(standard).mesh == 0 && registry.GetEntry(standard).texture == 0);
+    CHECK(registry.GetEntry(extended).mesh == 1 && registry.GetEntry(extended).texture == 2);
+
+    // A line of one mode doesn't replace the other mode's
+    CHECK(registry.Find("tarmac", AUGMENTATION_MODE_STANDARD) == AugmentationRegistry::INVALID_ENTRY);
+    CHECK(registry.Find("tarmac", AUGMENTATION_MODE_EXTENDED) != AugmentationRegistry::INVALID_ENTRY);
+
+    // The names hash differently per mode
+    CHECK(AugmentationRegistry::HashName("stones", 6, AUGMENTATION_MODE_STANDARD) !=
+        AugmentationRegistry::HashName("stones", 6, AUGMENTATION_MODE_EXTENDED));
+}
+
+static void TestResolveCache()
+{
+    AugmentationRegistry registry;
+    CHECK(Load(registry,
+        "standard stones teapot brass\n"
+        "extended stones building red\n"
+        "standard * building blue\n"));
+
+    uint32_t stones = registry.Resolve(3, "stones", AUGMENTATION_MODE_STANDARD);
+    CHECK(stones == registry.Find("stones", AUGMENTATION_MODE_STANDARD));
+    CHECK(registry.GetStats().lookups == 1 && registry.GetStats().cacheHits == 0);
+
+    // The cache is keyed by trackable id, not by name
+    CHECK(registry.Resolve(3, "chips", AUGMENTATION_MODE_STANDARD) == stones);
+    CHECK(registry.GetStats().cacheHits == 1);
+
+    // And by mode
+    CHECK(registry.Resolve(3, "stones", AUGMENTATION_MODE_EXTENDED) == registry.Find("stones", AUGMENTATION_MODE_EXTENDED));
+    CHECK(registry.GetStats().cacheHits == 1);
+
+    // Targets without an entry are cached as such too
+    CHECK(registry.Resolve(7, "chips", AUGMENTATION_MODE_EXTENDED) == AugmentationRegistry::INVALID_ENTRY);
+    CHECK(registry.Resolve(7, "chips", AUGMENTATION_MODE_EXTENDED) == AugmentationRegistry::INVALID_ENTRY);
+    CHECK(registry.GetStats().cacheHits == 2);
+
+    // Negative ids are never cached
+    CHECK(registry.Resolve(-1, "stones", AUGMENTATION_MODE_STANDARD) == stones);
+    CHECK(registry.Resolve(-1, "chips", AUGMENTATION_MODE_STANDARD) == registry.Find("chips", AUGMENTATION_MODE_STANDARD));
+    CHECK(registry.GetStats().lookups == 7 && registry.GetStats().cacheHits == 2);
+
+    // Loading again drops the cache
+    CHECK(Load(registry, "standard chips teapot red\n"));
+    CHECK(registry.Resolve(3, "chips", AUGMENTATION_MODE_STANDARD) == registry.Find("chips", AUGMENTATION_MODE_STANDARD));
+    CHECK(registry.GetStats().cacheHits == 0);
+}
+
+int main()
+{
+    SampleTests::RunTest("parse", TestParse);
+    SampleTests::RunTest("malformed lines", TestMalformedLines);
+    SampleTests::RunTest("fallback", TestFallback);
+    SampleTests::RunTest("later line replaces", TestLaterLineReplaces);
+    SampleTests::RunTest("modes are separate", TestModesAreSeparate);
+    SampleTests::RunTest("resolve cache", TestResolveCache);
+    return SampleTests::Result();
+}
@@ -0,0 +1,85 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "BoundingVolume.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+typedef size_t (*CullFunction)(const FrustumPlanes&, const float*, const float*, const float*, const float*, size_t, uint8_t*);
+
+static const size_t SPHERE_COUNTS[] = { 4, 16, 64, 256, 1024, 4096 };
+
+static const float PROJECTION[16] = {
+    1.7f, 0.0f, 0.0f, 0.0f,
+    0.0f, 2.2f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.004f, -20.04f,
+    0.0f, 0.0f, 1.0f, 0.0f
+};
+
+struct Spheres
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+    std::vector<uint8_t> visible;
+};
+
+static double NanosecondsPerSphere(CullFunction cull, const FrustumPlanes &frustum, Spheres &spheres,
+    size_t spheresTested, size_t &checksum)
+{
+    size_t count = spheres.x.size();
+    size_t passes = (std::max)(static_cast<size_t>(1), spheresTested / count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t pass = 0; pass < passes; pass++)
+    {
+        checksum += cull(frustum, spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(),
+            count, spheres.visible.data());
+    }
+    double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+    return milliseconds * 1e6 / (static_cast<double>(passes) * count);
+}
+
+// Time per sphere of the SIMD culling against the scalar reference, with
+// about half of the spheres visible
+int main(int argc, char **argv)
+{
+    const size_t spheresTested = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : 50000000;
+
+    FrustumPlanes frustum = BoundingVolumeUtil::ExtractFrustumPlanes(PROJECTION);
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> lateral(-600.0f, 600.0f);
+    std::uniform_real_distribution<float> depth(-100.0f, 5500.0f);
+    std::uniform_real_distribution<float> size(0.0f, 150.0f);
+
+    printf("spheres      simd    scalar   speedup\n");
+    size_t checksum = 0;
+    for (size_t count : SPHERE_COUNTS)
+    {
+        Spheres spheres;
+        for (size_t i = 0; i < count; i++)
+        {
+            spheres.x.push_back(lateral(random));
+            spheres.y.push_back(lateral(random));
+            spheres.z.push_back(depth(random));
+            spheres.radius.push_back(size(random));
+        }
+        spheres.visible.resize(count);
+
+        double simd = NanosecondsPerSphere(BoundingVolumeUtil::CullSpheres, frustum, spheres, spheresTested, checksum);
+        double scalar = NanosecondsPerSphere(BoundingVolumeUtil::CullSpheresScalar, frustum, spheres, spheresTested, checksum);
+        printf("%7u %6.2f ns %6.2f ns %8.2fx\n", static_cast<uint32_t>(count), simd, scalar, scalar / simd);
+    }
+    printf("(checksum %u)\n", static_cast<uint32_t>(checksum));
+    return 0;
+}
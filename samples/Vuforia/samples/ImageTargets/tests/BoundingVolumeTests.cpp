@@ -0,0 +1,170 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "BoundingVolume.h"
+
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+// About 60 degrees, looking down +z, near 10 and far 5000
+static const float PROJECTION[16] = {
+    1.7f, 0.0f, 0.0f, 0.0f,
+    0.0f, 2.2f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.004f, -20.04f,
+    0.0f, 0.0f, 1.0f, 0.0f
+};
+
+struct Spheres
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+
+    void Add(float centerX, float centerY, float centerZ, float sphereRadius)
+    {
+        x.push_back(centerX);
+        y.push_back(centerY);
+        z.push_back(centerZ);
+        radius.push_back(sphereRadius);
+    }
+
+    size_t Size() const { return x.size(); }
+};
+
+// Distance of a point to a plane, summed as the culling does
+static float PlaneDistance(const float plane[4], float x, float y, float z)
+{
+    return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+}
+
+// Culls the first count spheres both ways; checks they agree and returns
+// the visibility
+static std::vector<uint8_t> CullBothWays(const FrustumPlanes &frustum, const Spheres &spheres, size_t count)
+{
+    // One guard byte past the end, which must not be written
+    std::vector<uint8_t> simd(count + 1, 0xcd);
+    std::vector<uint8_t> scalar(count + 1, 0xcd);
+    size_t simdCount = BoundingVolumeUtil::CullSpheres(
+        frustum, spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(), count, simd.data());
+    size_t scalarCount = BoundingVolumeUtil::CullSpheresScalar(
+        frustum, spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(), count, scalar.data());
+
+    CHECK(simdCount == scalarCount);
+    CHECK(simd == scalar);
+    CHECK(simd[count] == 0xcd);
+
+    size_t visible = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK(simd[i] <= 1);
+        visible += simd[i];
+    }
+    CHECK(visible == simdCount);
+
+    simd.pop_back();
+    return simd;
+}
+
+static void TestRandomSpheres()
+{
+    FrustumPlanes frustum = BoundingVolumeUtil::ExtractFrustumPlanes(PROJECTION);
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> lateral(-600.0f, 600.0f);
+    std::uniform_real_distribution<float> depth(-100.0f, 5500.0f);
+    std::uniform_real_distribution<float> size(0.0f, 150.0f);
+    Spheres spheres;
+    for (int i = 0; i < 1031; i++)
+    {
+        spheres.Add(lateral(random), lateral(random), depth(random), size(random));
+    }
+
+    // Every remainder of the four wide loop
+    for (size_t count = 0; count <= 13; count++)
+    {
+        CullBothWays(frustum, spheres, count);
+    }
+
+    std::vector<uint8_t> visible = CullBothWays(frustum, spheres, spheres.Size());
+    size_t visibleCount = 0;
+    for (uint8_t v : visible)
+    {
+        visibleCount += v;
+    }
+    printf("  %u of %u random spheres visible\n", static_cast<uint32_t>(visibleCount), static_cast<uint32_t>(spheres.Size()));
+    CHECK(visibleCount > 0 && visibleCount < spheres.Size());
+}
+
+// Spheres whose centers are outside a plane by about their radius: those
+// reaching across it are visible, those just short of it are culled, and
+// those touching it are visible
+static void TestSpheresStraddlingPlanes()
+{
+    FrustumPlanes frustum = BoundingVolumeUtil::ExtractFrustumPlanes(PROJECTION);
+
+    // A point well inside, moved out along each plane's normal
+    const float inside[3] = { 0.0f, 0.0f, 800.0f };
+    const float radius = 20.0f;
+    Spheres spheres;
+    std::vector<uint8_t> expected;
+    for (int p = 0; p < 6; p++)
+    {
+        const float *plane = frustum.planes[p];
+        float distance = PlaneDistance(plane, inside[0], inside[1], inside[2]);
+
+        const float overlaps[] = { -0.5f, 0.5f, 0.98f, 1.02f, 2.0f };
+        for (float overlap : overlaps)
+        {
+            float move = distance + overlap * radius;
+            spheres.Add(inside[0] - plane[0] * move, inside[1] - plane[1] * move, inside[2] - plane[2] * move, radius);
+            expected.push_back(overlap < 1.0f ? 1 : 0);
+        }
+
+        // The last one grown to exactly touch the plane, as the culling
+        // computes it
+        size_t last = spheres.Size() - 1;
+        spheres.Add(spheres.x[last], spheres.y[last], spheres.z[last],
+            -PlaneDistance(plane, spheres.x[last], spheres.y[last], spheres.z[last]));
+        expected.push_back(1);
+    }
+
+    // 36 spheres, and every count short of that by up to three
+    CHECK(CullBothWays(frustum, spheres, spheres.Size()) == expected);
+    for (size_t count = spheres.Size() - 3; count < spheres.Size(); count++)
+    {
+        std::vector<uint8_t> visible = CullBothWays(frustum, spheres, count);
+        CHECK(std::vector<uint8_t>(expected.begin(), expected.begin() + count) == visible);
+    }
+}
+
+static void TestBoundingVolume()
+{
+    const float positions[] = {
+        -1.0f, 2.0f, 0.0f, 9.0f,
+        3.0f, -2.0f, 1.0f, 9.0f,
+        1.0f, 0.0f, 5.0f, 9.0f
+    };
+    BoundingVolume volume = BoundingVolumeUtil::ComputeBoundingVolume(positions, 3, 4);
+    CHECK(volume.boxMin[0] == -1.0f && volume.boxMin[1] == -2.0f && volume.boxMin[2] == 0.0f);
+    CHECK(volume.boxMax[0] == 3.0f && volume.boxMax[1] == 2.0f && volume.boxMax[2] == 5.0f);
+    CHECK(volume.sphereCenter[0] == 1.0f && volume.sphereCenter[1] == 0.0f && volume.sphereCenter[2] == 2.5f);
+    CHECK_NEAR(volume.sphereRadius, std::sqrt(4.0f + 4.0f + 6.25f), 1e-5f);
+
+    volume = BoundingVolumeUtil::ComputeBoundingVolume(positions, 0, 4);
+    CHECK(volume.sphereRadius == 0.0f);
+}
+
+int main()
+{
+    SampleTests::RunTest("random spheres", TestRandomSpheres);
+    SampleTests::RunTest("spheres straddling planes", TestSpheresStraddlingPlanes);
+    SampleTests::RunTest("bounding volume", TestBoundingVolume);
+    return SampleTests::Result();
+}
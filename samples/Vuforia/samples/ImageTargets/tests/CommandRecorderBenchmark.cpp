@@ -0,0 +1,96 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "MockCommandRecordingBackend.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+using namespace SampleCommon;
+
+static const int FRAMES = 100;
+static const uint32_t DRAWS_PER_VIEW = 256;
+static const uint32_t DRAWS_PER_JOB = 16;
+
+// Stands in for the API calls of recording one draw
+static double RecordDrawWork(int iterations)
+{
+    double x = 0.0;
+    for (int i = 0; i < iterations; i++)
+    {
+        x += std::sqrt(static_cast<double>(i));
+    }
+    return x;
+}
+
+// Frame time of recording and executing a stereo frame's draws with 1 to N
+// recording workers, N being the hardware threads unless given
+int main(int argc, char **argv)
+{
+    const uint32_t hardwareThreads = (std::max)(1u, std::thread::hardware_concurrency());
+    const uint32_t maxWorkers = (argc > 1) ? static_cast<uint32_t>(atoi(argv[1])) : hardwareThreads;
+    const int drawCosts[] = { 100, 1000, 5000 };
+
+    std::vector<RecordingJob> jobs;
+    for (uint32_t view = 0; view < 2; view++)
+    {
+        ParallelCommandRecorder::SplitJobs(view, DRAWS_PER_VIEW, DRAWS_PER_JOB, jobs);
+    }
+
+    printf("%u hardware threads, %u jobs of %u draws per frame\n",
+        hardwareThreads, static_cast<uint32_t>(jobs.size()), DRAWS_PER_JOB);
+    double checksum = 0.0;
+    for (int iterations : drawCosts)
+    {
+        printf("%5d iterations per draw:\n", iterations);
+        double oneWorkerMilliseconds = 0.0;
+        for (uint32_t workerCount = 1; workerCount <= maxWorkers; workerCount++)
+        {
+            // The thread calling Record() is worker 0; the job system runs the others
+            JobSystem jobSystem((std::max)(1u, workerCount - 1));
+            MockCommandRecordingBackend backend(workerCount);
+            ParallelCommandRecorder recorder(&backend, &jobSystem);
+            std::vector<double> results(workerCount, 0.0);
+            ParallelCommandRecorder::RecordFunction record = [&](uint32_t worker, const RecordingJob &job)
+            {
+                // Summed locally, the workers' results sharing a cache line
+                double result = 0.0;
+                for (uint32_t draw = job.firstDraw; draw < job.firstDraw + job.drawCount; draw++)
+                {
+                    result += RecordDrawWork(iterations);
+                    backend.RecordDraw(worker, draw);
+                }
+                results[worker] += result;
+            };
+
+            double recordMilliseconds = 0.0;
+            auto start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < FRAMES; frame++)
+            {
+                recorder.Record(jobs, record);
+                recorder.Execute();
+                recordMilliseconds += recorder.GetStats().recordMilliseconds;
+            }
+            double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) / FRAMES;
+            if (workerCount == 1)
+            {
+                oneWorkerMilliseconds = milliseconds;
+            }
+            for (double result : results)
+            {
+                checksum += result;
+            }
+
+            printf("  %2u workers: %.3f ms/frame (record %.3f ms), %.2fx one worker%s\n",
+                workerCount, milliseconds, recordMilliseconds / FRAMES, oneWorkerMilliseconds / milliseconds,
+                (backend.GetErrors() == 0) ? "" : ", BACKEND MISUSED");
+        }
+    }
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
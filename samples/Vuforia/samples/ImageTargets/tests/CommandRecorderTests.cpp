@@ -0,0 +1,156 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "MockCommandRecordingBackend.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace SampleCommon;
+
+// Records the draws of a job as the renderer does, numbering the draws of
+// view v from v * VIEW_DRAWS
+static const uint32_t VIEW_DRAWS = 1000;
+
+static ParallelCommandRecorder::RecordFunction MakeRecordFunction(MockCommandRecordingBackend &backend)
+{
+    return [&backend](uint32_t worker, const RecordingJob &job)
+    {
+        for (uint32_t draw = job.firstDraw; draw < job.firstDraw + job.drawCount; draw++)
+        {
+            backend.RecordDraw(worker, job.viewIndex * VIEW_DRAWS + draw);
+        }
+    };
+}
+
+// The draws of the jobs, in job order
+static std::vector<uint32_t> GetJobDraws(const std::vector<RecordingJob> &jobs)
+{
+    std::vector<uint32_t> draws;
+    for (const auto &job : jobs)
+    {
+        for (uint32_t draw = job.firstDraw; draw < job.firstDraw + job.drawCount; draw++)
+        {
+            draws.push_back(job.viewIndex * VIEW_DRAWS + draw);
+        }
+    }
+    return draws;
+}
+
+static void TestSplitJobs()
+{
+    std::vector<RecordingJob> jobs;
+
+    // No draws, no jobs
+    ParallelCommandRecorder::SplitJobs(0, 0, 8, jobs);
+    CHECK(jobs.empty());
+
+    // A whole multiple
+    ParallelCommandRecorder::SplitJobs(0, 16, 8, jobs);
+    CHECK(jobs.size() == 2);
+    CHECK(jobs[1].viewIndex == 0 && jobs[1].firstDraw == 8 && jobs[1].drawCount == 8);
+
+    // Appended after the first view's, the last job taking the remainder
+    ParallelCommandRecorder::SplitJobs(1, 19, 8, jobs);
+    CHECK(jobs.size() == 5);
+    CHECK(jobs[2].viewIndex == 1 && jobs[2].firstDraw == 0 && jobs[2].drawCount == 8);
+    CHECK(jobs[4].viewIndex == 1 && jobs[4].firstDraw == 16 && jobs[4].drawCount == 3);
+
+    // Fewer draws than a job holds
+    jobs.clear();
+    ParallelCommandRecorder::SplitJobs(2, 3, 8, jobs);
+    CHECK(jobs.size() == 1);
+    CHECK(jobs[0].firstDraw == 0 && jobs[0].drawCount == 3);
+
+    // Zero draws per job is taken as one
+    jobs.clear();
+    ParallelCommandRecorder::SplitJobs(0, 3, 0, jobs);
+    CHECK(jobs.size() == 3);
+    CHECK(jobs[2].firstDraw == 2 && jobs[2].drawCount == 1);
+}
+
+static void TestRecordAndExecuteInOrder()
+{
+    JobSystem jobSystem(3);
+    MockCommandRecordingBackend backend(4);
+    ParallelCommandRecorder recorder(&backend, &jobSystem);
+    ParallelCommandRecorder::RecordFunction record = MakeRecordFunction(backend);
+
+    for (int frame = 0; frame < 50; frame++)
+    {
+        std::vector<RecordingJob> jobs;
+        ParallelCommandRecorder::SplitJobs(0, 37 + frame, 4, jobs);
+        ParallelCommandRecorder::SplitJobs(1, 37 + frame, 4, jobs);
+
+        recorder.Record(jobs, record);
+        recorder.Execute();
+
+        CHECK(recorder.GetStats().jobCount == jobs.size());
+        CHECK(backend.GetExecutedDraws() == GetJobDraws(jobs));
+    }
+    CHECK(recorder.GetStats().workerCount == 4);
+    CHECK(backend.GetErrors() == 0);
+
+    // Fewer jobs than workers only uses as many workers as there are jobs
+    std::vector<RecordingJob> jobs;
+    ParallelCommandRecorder::SplitJobs(0, 2, 1, jobs);
+    recorder.Record(jobs, record);
+    recorder.Execute();
+    CHECK(backend.GetExecutedDraws() == GetJobDraws(jobs));
+    for (int worker : backend.GetJobWorkers())
+    {
+        CHECK(worker >= 0 && worker < 2);
+    }
+
+    // And none at all records and executes nothing
+    jobs.clear();
+    recorder.Record(jobs, record);
+    recorder.Execute();
+    CHECK(recorder.GetStats().jobCount == 0);
+    CHECK(backend.GetExecutedDraws().empty());
+    CHECK(backend.GetErrors() == 0);
+}
+
+// Jobs are handed out as workers become free: while one worker records a
+// slow job the others take the rest, and the result still executes in
+// job order
+static void TestDynamicJobDistribution()
+{
+    JobSystem jobSystem(3);
+    MockCommandRecordingBackend backend(4);
+    ParallelCommandRecorder recorder(&backend, &jobSystem);
+    ParallelCommandRecorder::RecordFunction fast = MakeRecordFunction(backend);
+    ParallelCommandRecorder::RecordFunction record = [&fast](uint32_t worker, const RecordingJob &job)
+    {
+        if (job.viewIndex == 0 && job.firstDraw == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        fast(worker, job);
+    };
+
+    std::vector<RecordingJob> jobs;
+    ParallelCommandRecorder::SplitJobs(0, 64, 4, jobs);
+    recorder.Record(jobs, record);
+    recorder.Execute();
+
+    CHECK(backend.GetExecutedDraws() == GetJobDraws(jobs));
+    CHECK(backend.GetErrors() == 0);
+
+    const std::vector<int> &workers = backend.GetJobWorkers();
+    long slowWorkerJobs = std::count(workers.begin(), workers.end(), workers[0]);
+    printf("  the worker of the slow job recorded %ld of %u jobs\n", slowWorkerJobs, static_cast<uint32_t>(jobs.size()));
+    CHECK(slowWorkerJobs < static_cast<long>(jobs.size()) / 2);
+}
+
+int main()
+{
+    SampleTests::RunTest("split jobs", TestSplitJobs);
+    SampleTests::RunTest("record and execute in order", TestRecordAndExecuteInOrder);
+    SampleTests::RunTest("dynamic job distribution", TestDynamicJobDistribution);
+    return SampleTests::Result();
+}
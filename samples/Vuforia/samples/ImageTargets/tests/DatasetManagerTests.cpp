@@ -0,0 +1,448 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "DatasetManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+
+using namespace SampleCommon;
+
+static const size_t MB = 1024 * 1024;
+static const int TOUR_DATASETS = 20;
+static const size_t TOUR_BUDGET_BYTES = 64 * MB;
+static const int TOUR_SWITCHES = 100;
+static const int FAILING_DATASET = 13;
+
+// Stands in for the tracker's datasets: checks that the active dataset and
+// the one being acquired are never unloaded, and that no two dataset calls
+// run at once
+class MockTracker
+{
+public:
+    explicit MockTracker(double loadMillisecondsPerMB) :
+        m_loadMillisecondsPerMB(loadMillisecondsPerMB),
+        m_loadThread(),
+        m_gatedDataset(-1),
+        m_gateOpen(true),
+        m_gatedLoadStarted(false),
+        m_callsInFlight(0),
+        m_overlappingCalls(0),
+        m_active(-1),
+        m_pending(-1),
+        m_loads(0),
+        m_bytes(0),
+        m_peakBytes(0),
+        m_pinnedUnloads(0)
+    {
+    }
+
+    static size_t Size(int dataset) { return (10 + (dataset * 7) % 21) * MB; }
+
+    bool Load(int dataset, size_t &bytes)
+    {
+        BeginCall();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_loadThread = std::this_thread::get_id();
+            if (dataset == m_gatedDataset)
+            {
+                m_gatedLoadStarted = true;
+                m_condition.notify_all();
+                m_condition.wait(lock, [this]() { return m_gateOpen; });
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(
+            static_cast<int64_t>(Size(dataset) / MB * m_loadMillisecondsPerMB * 1000.0)));
+
+        bool loaded = (dataset != FAILING_DATASET);
+        if (loaded)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            bytes = Size(dataset);
+            m_loaded.insert(dataset);
+            m_loads++;
+            m_bytes += bytes;
+            m_peakBytes = (std::max)(m_peakBytes, m_bytes);
+        }
+        EndCall();
+        return loaded;
+    }
+
+    void Unload(int dataset)
+    {
+        BeginCall();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (dataset == m_active || dataset == m_pending)
+            {
+                m_pinnedUnloads++;
+            }
+            m_loaded.erase(dataset);
+            m_bytes -= Size(dataset);
+        }
+        EndCall();
+    }
+
+    // The load of this dataset waits for OpenGate()
+    void CloseGate(int dataset)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_gatedDataset = dataset;
+        m_gateOpen = false;
+        m_gatedLoadStarted = false;
+    }
+
+    void WaitForGatedLoad()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_gatedLoadStarted; });
+    }
+
+    void OpenGate()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_gateOpen = true;
+        m_condition.notify_all();
+    }
+
+    void SetPending(int dataset)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = dataset;
+    }
+
+    void SetActive(int dataset)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active = dataset;
+        if (m_pending == dataset)
+        {
+            m_pending = -1;
+        }
+    }
+
+    bool IsLoaded(int dataset)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_loaded.count(dataset) > 0;
+    }
+
+    size_t LoadedCount()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_loaded.size();
+    }
+
+    std::thread::id LoadThread()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_loadThread;
+    }
+
+    int Loads()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_loads;
+    }
+
+    size_t PeakBytes()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_peakBytes;
+    }
+
+    int PinnedUnloads()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pinnedUnloads;
+    }
+
+    int OverlappingCalls() const { return m_overlappingCalls; }
+
+private:
+    void BeginCall()
+    {
+        if (m_callsInFlight.fetch_add(1) != 0)
+        {
+            m_overlappingCalls++;
+        }
+    }
+
+    void EndCall() { m_callsInFlight--; }
+
+    const double m_loadMillisecondsPerMB;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread::id m_loadThread;
+    int m_gatedDataset;
+    bool m_gateOpen;
+    bool m_gatedLoadStarted;
+
+    std::atomic<int> m_callsInFlight;
+    std::atomic<int> m_overlappingCalls;
+
+    std::set<int> m_loaded;
+    int m_active;
+    int m_pending;
+    int m_loads;
+    size_t m_bytes;
+    size_t m_peakBytes;
+    int m_pinnedUnloads;
+};
+
+static DatasetManager* CreateManager(MockTracker &tracker, int datasetCount, size_t budgetBytes, int prefetchCount)
+{
+    return new DatasetManager(datasetCount, budgetBytes, prefetchCount,
+        [&tracker](int dataset, size_t &bytes) { return tracker.Load(dataset, bytes); },
+        [&tracker](int dataset) { tracker.Unload(dataset); });
+}
+
+// Acquires and activates a dataset the way the app does
+static bool Switch(DatasetManager &manager, MockTracker &tracker, int previous, int dataset)
+{
+    tracker.SetPending(dataset);
+    bool acquired = manager.Acquire(dataset);
+    if (acquired)
+    {
+        tracker.SetActive(dataset);
+        manager.OnActivated(previous, dataset, 0.5);
+    }
+    return acquired;
+}
+
+static void WaitForLoaded(MockTracker &tracker, int dataset)
+{
+    while (!tracker.IsLoaded(dataset))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static void TestMissLoadsOnIOThread()
+{
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, 4, 64 * MB, 0));
+
+    CHECK(Switch(*manager, tracker, -1, 0));
+    CHECK(tracker.IsLoaded(0));
+    CHECK(tracker.LoadThread() != std::this_thread::get_id());
+
+    DatasetManagerStats stats = manager->GetStats();
+    CHECK(stats.acquires == 1);
+    CHECK(stats.misses == 1);
+    CHECK(stats.prefetches == 0);
+    CHECK(stats.loads == 1);
+}
+
+static void TestLruEviction()
+{
+    // Datasets 0, 3, 6 and 9 take 10 MB each
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, 10, 34 * MB, 0));
+
+    CHECK(Switch(*manager, tracker, -1, 0));
+    CHECK(Switch(*manager, tracker, 0, 3));
+    CHECK(Switch(*manager, tracker, 3, 6));
+    CHECK(manager->GetStats().evictions == 0);
+
+    // The least recently used one makes room; the active one stays
+    CHECK(Switch(*manager, tracker, 6, 0));
+    CHECK(Switch(*manager, tracker, 0, 9));
+    CHECK(!tracker.IsLoaded(3));
+    CHECK(tracker.IsLoaded(0));
+    CHECK(tracker.IsLoaded(9));
+    CHECK(manager->GetStats().evictions == 1);
+    CHECK(manager->GetStats().hits == 1);
+    CHECK(tracker.PinnedUnloads() == 0);
+}
+
+static void TestPinnedKeptOverBudget()
+{
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, 10, 15 * MB, 0));
+
+    CHECK(Switch(*manager, tracker, -1, 1));
+    tracker.SetPending(2);
+    CHECK(manager->Acquire(2));
+
+    // Both are pinned, the active one and the one about to be
+    DatasetManagerStats stats = manager->GetStats();
+    CHECK(stats.loadedCount == 2);
+    CHECK(stats.loadedBytes > 15 * MB);
+    CHECK(stats.evictions == 0);
+
+    tracker.SetActive(2);
+    manager->OnActivated(1, 2, 0.5);
+    CHECK(tracker.PinnedUnloads() == 0);
+}
+
+static void TestPrefetchHits()
+{
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, 10, 64 * MB, 1));
+
+    // A hint is prefetched
+    CHECK(Switch(*manager, tracker, -1, 0));
+    manager->Hint(5);
+    WaitForLoaded(tracker, 5);
+    CHECK(Switch(*manager, tracker, 0, 5));
+
+    DatasetManagerStats stats = manager->GetStats();
+    CHECK(stats.prefetches == 1);
+    CHECK(stats.hits + stats.inFlightHits == 1);
+    CHECK(stats.prefetchHits == 1);
+
+    // So is the dataset activated after this one last time, once evicted
+    CHECK(Switch(*manager, tracker, 5, 0));
+    manager->UnloadAll();
+    CHECK(Switch(*manager, tracker, -1, 5));
+    WaitForLoaded(tracker, 0);
+    CHECK(Switch(*manager, tracker, 5, 0));
+    CHECK(manager->GetStats().prefetchHits == 2);
+}
+
+static void TestAcquireWhilePrefetching()
+{
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, 10, 64 * MB, 0));
+    CHECK(Switch(*manager, tracker, -1, 0));
+
+    tracker.CloseGate(7);
+    manager->Hint(7);
+    tracker.WaitForGatedLoad();
+
+    std::atomic<bool> acquired(false);
+    std::thread acquirer([&]()
+    {
+        acquired = Switch(*manager, tracker, 0, 7);
+    });
+
+    // The acquire waits for the prefetch rather than loading it again
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(!acquired);
+    tracker.OpenGate();
+    acquirer.join();
+
+    CHECK(acquired);
+    DatasetManagerStats stats = manager->GetStats();
+    CHECK(stats.inFlightHits == 1);
+    CHECK(stats.prefetchHits == 1);
+    CHECK(stats.misses == 1);
+    CHECK(tracker.Loads() == 2);
+}
+
+static void TestMissWaitsForPrefetch()
+{
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, 10, 64 * MB, 0));
+    CHECK(Switch(*manager, tracker, -1, 0));
+
+    // A miss queued behind a prefetch under way is loaded once it is done,
+    // on the same thread
+    tracker.CloseGate(7);
+    manager->Hint(7);
+    tracker.WaitForGatedLoad();
+    manager->Hint(8);
+
+    std::atomic<bool> acquired(false);
+    std::thread acquirer([&]()
+    {
+        acquired = Switch(*manager, tracker, 0, 3);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    CHECK(!acquired);
+    CHECK(!tracker.IsLoaded(3));
+    tracker.OpenGate();
+    acquirer.join();
+
+    CHECK(acquired);
+    CHECK(tracker.OverlappingCalls() == 0);
+    CHECK(manager->GetStats().misses == 2);
+}
+
+static void TestFailedLoad()
+{
+    MockTracker tracker(0.0);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, TOUR_DATASETS, 64 * MB, 1));
+
+    tracker.SetPending(FAILING_DATASET);
+    CHECK(!manager->Acquire(FAILING_DATASET));
+    CHECK(manager->GetStats().loadFailures == 1);
+
+    CHECK(Switch(*manager, tracker, -1, 2));
+    CHECK(manager->GetStats().loadedCount == 1);
+}
+
+// A tour of a 20 dataset catalog, mostly in order with detours, each
+// dataset taking 10 to 30 MB of a 64 MB budget
+static void TestCatalogTour()
+{
+    MockTracker tracker(0.05);
+    std::unique_ptr<DatasetManager> manager(CreateManager(tracker, TOUR_DATASETS, TOUR_BUDGET_BYTES, 1));
+
+    std::mt19937 random(7);
+    int current = -1;
+    bool allAcquired = true;
+    for (int i = 0; i < TOUR_SWITCHES; i++)
+    {
+        int next = (current < 0) ? 0 :
+            ((random() % 5 == 0) ? static_cast<int>(random() % TOUR_DATASETS) : (current + 1) % TOUR_DATASETS);
+        if (next == current || next == FAILING_DATASET)
+        {
+            next = (next + 1) % TOUR_DATASETS;
+        }
+
+        allAcquired = Switch(*manager, tracker, current, next) && allAcquired;
+        current = next;
+        manager->Hint((current + 1 == FAILING_DATASET) ? current + 2 : (current + 1) % TOUR_DATASETS);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    DatasetManagerStats stats = manager->GetStats();
+    std::string report;
+    manager->FormatReport(report);
+    printf("%s", report.c_str());
+
+    CHECK(allAcquired);
+    CHECK(stats.acquires == TOUR_SWITCHES);
+    CHECK(stats.hits + stats.inFlightHits + stats.misses == stats.acquires);
+    CHECK(stats.prefetchHits >= TOUR_SWITCHES / 2);
+    CHECK(stats.evictions > 0);
+    CHECK(tracker.PinnedUnloads() == 0);
+    CHECK(tracker.OverlappingCalls() == 0);
+
+    // A first load's size isn't known ahead, so the budget is exceeded by at
+    // most one dataset until the load is done
+    CHECK(tracker.PeakBytes() <= TOUR_BUDGET_BYTES + 30 * MB);
+
+    tracker.SetActive(-1);
+    manager->UnloadAll();
+    CHECK(tracker.LoadedCount() == 0);
+    CHECK(manager->GetStats().loadedBytes == 0);
+}
+
+int main()
+{
+    SampleTests::RunTest("miss loads on the I/O thread", TestMissLoadsOnIOThread);
+    SampleTests::RunTest("least recently used eviction", TestLruEviction);
+    SampleTests::RunTest("pinned kept over budget", TestPinnedKeptOverBudget);
+    SampleTests::RunTest("prefetch hits", TestPrefetchHits);
+    SampleTests::RunTest("acquire while prefetching", TestAcquireWhilePrefetching);
+    SampleTests::RunTest("miss waits for prefetch", TestMissWaitsForPrefetch);
+    SampleTests::RunTest("failed load", TestFailedLoad);
+    SampleTests::RunTest("catalog tour", TestCatalogTour);
+    return SampleTests::Result();
+}
@@ -0,0 +1,345 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "DatasetSwitcher.h"
+
+#include <utility>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const std::chrono::milliseconds WAIT_TIMEOUT(2000);
+
+// Frames the tests run at most while waiting for a swap, a millisecond apart
+static const int MAX_FRAMES = 2000;
+
+// Stands in for loading and activating datasets. Prepare runs on the
+// switcher's worker and can be held back to keep it in flight; activation
+// runs on the tracking thread, here the test's frame loop, and can be made
+// to take the time of some camera frames.
+class MockDatasets
+{
+public:
+    MockDatasets() :
+        m_blocked(false),
+        m_preparing(-1),
+        m_prepared(0),
+        m_failPrepare(-1),
+        m_failActivate(-1),
+        m_activateFrames(0),
+        m_frameIndex(0)
+    {
+    }
+
+    bool Prepare(int dataset)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_preparing = dataset;
+        m_prepareCalls.push_back(dataset);
+        m_condition.notify_all();
+        m_condition.wait(lock, [this]() { return !m_blocked; });
+        m_preparing = -1;
+        m_prepared++;
+        m_condition.notify_all();
+        return dataset != m_failPrepare;
+    }
+
+    bool Activate(int previous, int dataset)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activations.push_back(std::make_pair(previous, dataset));
+        m_frameIndex += m_activateFrames;
+        return dataset != m_failActivate;
+    }
+
+    void SetBlocked(bool blocked)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_blocked = blocked;
+        m_condition.notify_all();
+    }
+
+    void SetFailures(int prepare, int activate)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failPrepare = prepare;
+        m_failActivate = activate;
+    }
+
+    void SetActivateFrames(int64_t frames)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_activateFrames = frames;
+    }
+
+    bool WaitForPrepare(int dataset)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_condition.wait_for(lock, WAIT_TIMEOUT, [this, dataset]() { return m_preparing == dataset; });
+    }
+
+    bool WaitForPrepared(int count)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_condition.wait_for(lock, WAIT_TIMEOUT, [this, count]() { return m_prepared >= count; });
+    }
+
+    // Runs the tracking thread's frame loop until a frame activates a
+    // dataset or the given frames went by. Returns true if one was swapped to.
+    bool RunFrames(DatasetSwitcher &switcher, int frames)
+    {
+        for (int frame = 0; frame < frames; frame++)
+        {
+            int64_t frameIndex;
+            size_t activations;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                frameIndex = ++m_frameIndex;
+                activations = m_activations.size();
+            }
+            bool swapped = switcher.OnFrameBoundary(frameIndex);
+            if (swapped || GetActivations().size() != activations)
+            {
+                return swapped;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    std::vector<int> GetPrepareCalls()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_prepareCalls;
+    }
+
+    std::vector<std::pair<int, int>> GetActivations()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_activations;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_blocked;
+    int m_preparing;
+    int m_prepared;
+    int m_failPrepare;
+    int m_failActivate;
+    int64_t m_activateFrames;
+    int64_t m_frameIndex;
+    std::vector<int> m_prepareCalls;
+    std::vector<std::pair<int, int>> m_activations;
+};
+
+// A switcher on the mock, with dataset 0 active
+struct SwitcherFixture
+{
+    MockDatasets datasets;
+    DatasetSwitcher switcher;
+
+    SwitcherFixture() :
+        switcher(
+            [this](int dataset) { return datasets.Prepare(dataset); },
+            [this](int previous, int dataset) { return datasets.Activate(previous, dataset); })
+    {
+        switcher.Reset(0);
+    }
+};
+
+static void TestSwitch()
+{
+    SwitcherFixture fixture;
+    DatasetSwitcher &switcher = fixture.switcher;
+
+    fixture.datasets.SetBlocked(true);
+    switcher.RequestSwitch(1);
+    CHECK(fixture.datasets.WaitForPrepare(1));
+    CHECK(switcher.GetTargetDataset() == 1 && switcher.GetActiveDataset() == 0);
+
+    // The active dataset keeps tracking while the next one is prepared
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    fixture.datasets.SetBlocked(false);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+
+    CHECK(switcher.GetActiveDataset() == 1 && switcher.GetTargetDataset() == 1);
+    std::vector<std::pair<int, int>> activations = fixture.datasets.GetActivations();
+    CHECK(activations.size() == 1 && activations[0] == std::make_pair(0, 1));
+
+    DatasetSwitchStats stats = switcher.GetStats();
+    CHECK(stats.requests == 1 && stats.swaps == 1 && stats.coalesced == 0 && stats.failures == 0);
+    CHECK(stats.lastRequestToSwapMilliseconds >= stats.lastActivateMilliseconds);
+
+    // Asking for the active dataset does nothing
+    switcher.RequestSwitch(1);
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    CHECK(fixture.datasets.GetPrepareCalls().size() == 1);
+
+    // Nor does asking before any dataset is active
+    switcher.Reset(-1);
+    switcher.RequestSwitch(2);
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    CHECK(switcher.GetStats().requests == 2);
+}
+
+static void TestRequestsCoalesce()
+{
+    SwitcherFixture fixture;
+    DatasetSwitcher &switcher = fixture.switcher;
+
+    // Requests made while 1 is prepared replace it, and only the last is
+    // prepared next
+    fixture.datasets.SetBlocked(true);
+    switcher.RequestSwitch(1);
+    CHECK(fixture.datasets.WaitForPrepare(1));
+    switcher.RequestSwitch(2);
+    switcher.RequestSwitch(3);
+    CHECK(switcher.GetTargetDataset() == 3);
+    fixture.datasets.SetBlocked(false);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+
+    CHECK(switcher.GetActiveDataset() == 3);
+    CHECK((fixture.datasets.GetPrepareCalls() == std::vector<int>{ 1, 3 }));
+    std::vector<std::pair<int, int>> activations = fixture.datasets.GetActivations();
+    CHECK(activations.size() == 1 && activations[0] == std::make_pair(0, 3));
+
+    DatasetSwitchStats stats = switcher.GetStats();
+    CHECK(stats.requests == 3 && stats.coalesced == 2 && stats.swaps == 1);
+
+    // A request replacing a prepared dataset before its swap
+    switcher.RequestSwitch(4);
+    CHECK(fixture.datasets.WaitForPrepared(3));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    switcher.RequestSwitch(5);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+    CHECK(switcher.GetActiveDataset() == 5);
+    activations = fixture.datasets.GetActivations();
+    CHECK(activations.size() == 2 && activations[1] == std::make_pair(3, 5));
+
+    // Going back to the active dataset before the swap cancels it
+    fixture.datasets.SetBlocked(true);
+    switcher.RequestSwitch(6);
+    CHECK(fixture.datasets.WaitForPrepare(6));
+    switcher.RequestSwitch(5);
+    CHECK(switcher.GetTargetDataset() == 5);
+    fixture.datasets.SetBlocked(false);
+    CHECK(fixture.datasets.WaitForPrepared(5));
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    CHECK(switcher.GetActiveDataset() == 5);
+    CHECK(switcher.GetStats().coalesced == 4);
+}
+
+static void TestResetDropsInFlightWork()
+{
+    SwitcherFixture fixture;
+    DatasetSwitcher &switcher = fixture.switcher;
+
+    // Reset waits for the dataset being prepared, and drops it
+    fixture.datasets.SetBlocked(true);
+    switcher.RequestSwitch(1);
+    CHECK(fixture.datasets.WaitForPrepare(1));
+    std::thread release([&fixture]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        fixture.datasets.SetBlocked(false);
+    });
+    switcher.Reset(7);
+    release.join();
+
+    CHECK(switcher.GetActiveDataset() == 7 && switcher.GetTargetDataset() == 7);
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    CHECK(fixture.datasets.GetActivations().empty());
+
+    // And a prepared dataset waiting for its swap
+    switcher.RequestSwitch(2);
+    CHECK(fixture.datasets.WaitForPrepared(2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    switcher.Reset(8);
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    CHECK(fixture.datasets.GetActivations().empty());
+    CHECK(switcher.GetActiveDataset() == 8);
+
+    // Switches work as before afterwards
+    switcher.RequestSwitch(3);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+    std::vector<std::pair<int, int>> activations = fixture.datasets.GetActivations();
+    CHECK(activations.size() == 1 && activations[0] == std::make_pair(8, 3));
+}
+
+static void TestFailures()
+{
+    SwitcherFixture fixture;
+    DatasetSwitcher &switcher = fixture.switcher;
+
+    // A dataset that fails to prepare is never activated; the active one stays
+    fixture.datasets.SetFailures(1, 2);
+    switcher.RequestSwitch(1);
+    CHECK(fixture.datasets.WaitForPrepared(1));
+    CHECK(!fixture.datasets.RunFrames(switcher, 20));
+    CHECK(fixture.datasets.GetActivations().empty());
+    CHECK(switcher.GetActiveDataset() == 0 && switcher.GetTargetDataset() == 0);
+    CHECK(switcher.GetStats().failures == 1);
+
+    // Nor does one that fails to activate
+    switcher.RequestSwitch(2);
+    CHECK(!fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+    CHECK(fixture.datasets.GetActivations().size() == 1);
+    CHECK(switcher.GetActiveDataset() == 0 && switcher.GetTargetDataset() == 0);
+
+    DatasetSwitchStats stats = switcher.GetStats();
+    CHECK(stats.failures == 2 && stats.swaps == 0);
+
+    // Either can be asked for again
+    fixture.datasets.SetFailures(-1, -1);
+    switcher.RequestSwitch(1);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+    CHECK(switcher.GetActiveDataset() == 1);
+}
+
+static void TestGapFrames()
+{
+    SwitcherFixture fixture;
+    DatasetSwitcher &switcher = fixture.switcher;
+
+    // An activation taking the time of 3 camera frames misses them
+    fixture.datasets.SetActivateFrames(3);
+    switcher.RequestSwitch(1);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+
+    // Measured at the frame after the swap
+    CHECK(switcher.GetStats().lastGapFrames == 0);
+    fixture.datasets.RunFrames(switcher, 1);
+    DatasetSwitchStats stats = switcher.GetStats();
+    CHECK(stats.lastGapFrames == 3 && stats.maxGapFrames == 3);
+
+    fixture.datasets.SetActivateFrames(1);
+    switcher.RequestSwitch(2);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+    fixture.datasets.RunFrames(switcher, 1);
+    stats = switcher.GetStats();
+    CHECK(stats.lastGapFrames == 1 && stats.maxGapFrames == 3);
+
+    // A swap within the frame misses none
+    fixture.datasets.SetActivateFrames(0);
+    switcher.RequestSwitch(3);
+    CHECK(fixture.datasets.RunFrames(switcher, MAX_FRAMES));
+    fixture.datasets.RunFrames(switcher, 1);
+    stats = switcher.GetStats();
+    CHECK(stats.lastGapFrames == 0 && stats.maxGapFrames == 3);
+    CHECK(stats.swaps == 3);
+}
+
+int main()
+{
+    SampleTests::RunTest("switch", TestSwitch);
+    SampleTests::RunTest("requests coalesce", TestRequestsCoalesce);
+    SampleTests::RunTest("reset drops in-flight work", TestResetDropsInFlightWork);
+    SampleTests::RunTest("failures", TestFailures);
+    SampleTests::RunTest("gap frames", TestGapFrames);
+    return SampleTests::Result();
+}
@@ -0,0 +1,208 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "FrameRateGovernor.h"
+
+using namespace SampleCommon;
+
+// Against the default 33 ms budget: over it, within it, and under the
+// recovery headroom of 60%
+static const double SLOW_FRAME = 40.0;
+static const double OK_FRAME = 25.0;
+static const double FAST_FRAME = 10.0;
+
+// Runs camera frames through the governor as the renderer does, passing the
+// time of a frame only when the previous decision was to render it. Returns
+// the number of frames rendered.
+static int RunFrames(FrameRateGovernor &governor, int frames, bool tracking, double frameMilliseconds)
+{
+    int rendered = 0;
+    for (int frame = 0; frame < frames; frame++)
+    {
+        double time = governor.GetDecision().render ? frameMilliseconds : -1.0;
+        rendered += governor.Update(tracking, time).render ? 1 : 0;
+    }
+    return rendered;
+}
+
+static void TestIdle()
+{
+    FrameRateGovernorSettings settings = FrameRateGovernor::GetDefaultSettings();
+    FrameRateGovernor governor(settings);
+    CHECK(RunFrames(governor, 100, true, OK_FRAME) == 100);
+
+    // Not idle until idleFrames camera frames in a row had no target
+    CHECK(RunFrames(governor, settings.idleFrames - 1, false, OK_FRAME) == static_cast<int>(settings.idleFrames) - 1);
+    CHECK(!governor.GetDecision().idle);
+    RunFrames(governor, 1, false, OK_FRAME);
+    CHECK(governor.GetDecision().idle);
+    CHECK(governor.GetDecision().renderInterval == settings.idleRenderInterval);
+    CHECK(governor.GetStats().idlePeriods == 1);
+
+    // Then one frame out of idleRenderInterval is rendered
+    int rendered = RunFrames(governor, 60, false, OK_FRAME);
+    printf("  %d of 60 idle frames rendered\n", rendered);
+    CHECK(rendered == 60 / static_cast<int>(settings.idleRenderInterval));
+    CHECK(governor.GetStats().framesSkipped > 0);
+
+    // A tracked frame in between starts the count again
+    RunFrames(governor, 1, true, OK_FRAME);
+    CHECK(!governor.GetDecision().idle);
+    RunFrames(governor, settings.idleFrames - 1, false, OK_FRAME);
+    CHECK(!governor.GetDecision().idle);
+    RunFrames(governor, 1, false, OK_FRAME);
+    CHECK(governor.GetDecision().idle);
+    CHECK(governor.GetStats().idlePeriods == 2);
+
+    // Idle frames are cheap, and their times don't count towards quality
+    RunFrames(governor, 300, false, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FULL);
+    CHECK(governor.GetStats().qualityStepsDown == 0);
+}
+
+static void TestRenderOnDetection()
+{
+    FrameRateGovernor governor(FrameRateGovernor::GetDefaultSettings());
+    RunFrames(governor, 100, false, OK_FRAME);
+    CHECK(governor.GetDecision().idle);
+
+    // Whichever camera frame a target is found in, it is rendered at once
+    for (int offset = 0; offset < 3; offset++)
+    {
+        RunFrames(governor, 30 + offset, false, OK_FRAME);
+        const FrameRateDecision &decision = governor.Update(true, -1.0);
+        CHECK(decision.render && !decision.idle && decision.renderInterval == 1);
+    }
+
+    // At half rate too, although the frame after is then skipped
+    FrameRateGovernorSettings settings = FrameRateGovernor::GetDefaultSettings();
+    settings.allowVideoModeChange = false;
+    FrameRateGovernor halfRate(settings);
+    RunFrames(halfRate, 200, true, SLOW_FRAME);
+    CHECK(halfRate.GetDecision().qualityLevel == QUALITY_HALF_RATE);
+    RunFrames(halfRate, 100, false, OK_FRAME);
+    for (int offset = 0; offset < 3; offset++)
+    {
+        RunFrames(halfRate, 30 + offset, false, OK_FRAME);
+        CHECK(halfRate.Update(true, -1.0).render);
+        CHECK(!halfRate.Update(true, OK_FRAME).render);
+    }
+}
+
+static void TestStepDown()
+{
+    FrameRateGovernorSettings settings = FrameRateGovernor::GetDefaultSettings();
+    FrameRateGovernor governor(settings);
+
+    // overrunFrames overruns before the window is full don't step down
+    RunFrames(governor, settings.overrunFrames, true, SLOW_FRAME);
+    RunFrames(governor, settings.windowFrames - settings.overrunFrames - 1, true, OK_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FULL);
+
+    // The frame that fills the window does
+    RunFrames(governor, 1, true, OK_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+    CHECK(governor.GetDecision().textureMipBias == 1.0f);
+    CHECK(governor.GetStats().qualityStepsDown == 1);
+
+    // One overrun fewer than overrunFrames in a window doesn't
+    RunFrames(governor, settings.windowFrames - settings.overrunFrames + 1, true, OK_FRAME);
+    RunFrames(governor, settings.overrunFrames - 1, true, SLOW_FRAME);
+    RunFrames(governor, 3 * settings.windowFrames, true, OK_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+
+    // Nor do occasional spikes
+    for (int frame = 0; frame < 300; frame++)
+    {
+        governor.Update(true, (frame % 10 == 0) ? 2.0 * SLOW_FRAME : OK_FRAME);
+    }
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+
+    // The window slides once full: overrunFrames overruns in a row step down
+    RunFrames(governor, settings.windowFrames, true, OK_FRAME);
+    RunFrames(governor, settings.overrunFrames - 1, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+    RunFrames(governor, 1, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_HALF_RATE);
+    CHECK(governor.GetDecision().renderInterval == 2);
+
+    // After a step the window fills again first. At half rate only rendered
+    // frames are timed, so that takes twice the camera frames.
+    RunFrames(governor, 2 * settings.windowFrames - 2, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_HALF_RATE);
+    RunFrames(governor, 2, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FAST_CAMERA);
+    CHECK(governor.GetDecision().fastVideoMode && governor.GetDecision().renderInterval == 2);
+
+    RunFrames(governor, 500, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FAST_CAMERA);
+    CHECK(governor.GetStats().qualityStepsDown == 3);
+}
+
+static void TestStepUp()
+{
+    FrameRateGovernorSettings settings = FrameRateGovernor::GetDefaultSettings();
+    FrameRateGovernor governor(settings);
+    RunFrames(governor, settings.windowFrames, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+
+    // Frames within the budget but over the headroom don't step up
+    RunFrames(governor, 3 * settings.recoveryFrames, true, OK_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+
+    // A slower frame restarts the count of fast ones
+    RunFrames(governor, settings.recoveryFrames - 1, true, FAST_FRAME);
+    RunFrames(governor, 1, true, OK_FRAME);
+    RunFrames(governor, settings.recoveryFrames - 1, true, FAST_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_REDUCED_TEXTURES);
+
+    RunFrames(governor, 1, true, FAST_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FULL);
+    CHECK(governor.GetDecision().textureMipBias == 0.0f);
+    CHECK(governor.GetStats().qualityStepsUp == 1);
+
+    // From the bottom, one step per recoveryFrames rendered frames
+    RunFrames(governor, 500, true, SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FAST_CAMERA);
+    int cameraFrames = 0;
+    while (governor.GetDecision().qualityLevel != QUALITY_FULL && cameraFrames < 10000)
+    {
+        RunFrames(governor, 1, true, FAST_FRAME);
+        cameraFrames++;
+    }
+    printf("  back to full quality after %d camera frames\n", cameraFrames);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FULL);
+    CHECK(governor.GetStats().qualityStepsUp == 4);
+
+    // Half rate levels render every other camera frame, so they take twice as many
+    CHECK(cameraFrames == static_cast<int>(2 * settings.recoveryFrames + 2 * settings.recoveryFrames + settings.recoveryFrames));
+}
+
+static void TestNoVideoModeChange()
+{
+    FrameRateGovernorSettings settings = FrameRateGovernor::GetDefaultSettings();
+    settings.allowVideoModeChange = false;
+    FrameRateGovernor governor(settings);
+
+    RunFrames(governor, 1000, true, 2.0 * SLOW_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_HALF_RATE);
+    CHECK(!governor.GetDecision().fastVideoMode);
+    CHECK(governor.GetStats().qualityStepsDown == 2);
+
+    RunFrames(governor, 1000, true, FAST_FRAME);
+    CHECK(governor.GetDecision().qualityLevel == QUALITY_FULL);
+}
+
+int main()
+{
+    SampleTests::RunTest("idle", TestIdle);
+    SampleTests::RunTest("render on detection", TestRenderOnDetection);
+    SampleTests::RunTest("step down", TestStepDown);
+    SampleTests::RunTest("step up", TestStepUp);
+    SampleTests::RunTest("no video mode change", TestNoVideoModeChange);
+    return SampleTests::Result();
+}
@@ -0,0 +1,79 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace SampleCommon;
+
+static const int FRAMES = 200;
+
+// Each job stands in for preparing a few augmentations
+static void Work(int iterations, double &result)
+{
+    double x = 0.0;
+    for (int i = 0; i < iterations; i++)
+    {
+        x += std::sqrt(static_cast<double>(i));
+    }
+    result = x;
+}
+
+// Frame time of a fan-out of jobsPerFrame jobs waited for by the frame, with
+// 1 to N workers, N being the hardware threads unless given
+int main(int argc, char **argv)
+{
+    const uint32_t hardwareThreads = (std::max)(1u, std::thread::hardware_concurrency());
+    const uint32_t maxWorkers = (argc > 1) ? static_cast<uint32_t>(atoi(argv[1])) : hardwareThreads;
+    const int jobSizes[] = { 200, 2000, 20000 };
+    const int jobsPerFrame = 64;
+
+    printf("%u hardware threads, %d jobs per frame\n", hardwareThreads, jobsPerFrame);
+    for (int iterations : jobSizes)
+    {
+        std::vector<double> results(jobsPerFrame);
+        double serialMilliseconds = 0.0;
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < FRAMES; frame++)
+            {
+                for (int job = 0; job < jobsPerFrame; job++)
+                {
+                    Work(iterations, results[job]);
+                }
+            }
+            serialMilliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) / FRAMES;
+        }
+        printf("%6d iterations per job: serial %.3f ms/frame\n", iterations, serialMilliseconds);
+
+        for (uint32_t workerCount = 1; workerCount <= maxWorkers; workerCount++)
+        {
+            JobSystem jobs(workerCount);
+            auto start = std::chrono::steady_clock::now();
+            for (int frame = 0; frame < FRAMES; frame++)
+            {
+                JobCounter counter;
+                for (int job = 0; job < jobsPerFrame; job++)
+                {
+                    double *result = &results[job];
+                    jobs.Run([iterations, result]() { Work(iterations, *result); }, &counter);
+                }
+                jobs.Wait(counter);
+            }
+            double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) / FRAMES;
+
+            JobSystemStats stats = jobs.GetStats();
+            printf("  %2u workers: %.3f ms/frame, %.2fx serial, %llu stolen, %llu sleeps\n",
+                workerCount, milliseconds, serialMilliseconds / milliseconds,
+                static_cast<unsigned long long>(stats.jobsStolen),
+                static_cast<unsigned long long>(stats.workerSleeps));
+        }
+    }
+    return 0;
+}
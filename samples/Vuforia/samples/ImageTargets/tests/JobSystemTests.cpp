@@ -0,0 +1,181 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const uint32_t WORKER_COUNTS[] = { 1, 2, 4 };
+
+static void TestFanOut(JobSystem &jobs)
+{
+    const int jobCount = 10000;
+    std::atomic<int> sum(0);
+    JobCounter counter;
+    for (int i = 0; i < jobCount; i++)
+    {
+        jobs.Run([&sum, i]() { sum += i; }, &counter);
+    }
+    jobs.Wait(counter);
+
+    CHECK(counter.IsDone());
+    CHECK(sum == jobCount * (jobCount - 1) / 2);
+}
+
+static void TestNestedFanOut(JobSystem &jobs)
+{
+    // Jobs started from a worker go to its own queue, and the others steal them
+    std::atomic<int> leaves(0);
+    JobCounter counter;
+    for (int i = 0; i < 16; i++)
+    {
+        jobs.Run([&]()
+        {
+            for (int j = 0; j < 64; j++)
+            {
+                jobs.Run([&leaves]() { leaves++; }, &counter);
+            }
+        }, &counter);
+    }
+    jobs.Wait(counter);
+    CHECK(leaves == 16 * 64);
+}
+
+static void TestDependencies(JobSystem &jobs)
+{
+    JobCounter first;
+    JobCounter second;
+    JobCounter third;
+    std::atomic<int> stage(0);
+    std::atomic<int> outOfOrder(0);
+
+    for (int i = 0; i < 100; i++)
+    {
+        jobs.Run([&stage]() { stage.fetch_add(1); }, &first);
+    }
+    jobs.RunAfter(first, [&]()
+    {
+        outOfOrder += (stage.load() == 100) ? 0 : 1;
+        stage += 1000;
+    }, &second);
+    jobs.RunAfter(second, [&]()
+    {
+        outOfOrder += (stage.load() == 1100) ? 0 : 1;
+        stage += 10000;
+    }, &third);
+
+    // A dependency already done runs the job right away
+    JobCounter done;
+    JobCounter afterDone;
+    bool ranAfterDone = false;
+    jobs.RunAfter(done, [&ranAfterDone]() { ranAfterDone = true; }, &afterDone);
+
+    jobs.Wait(third);
+    jobs.Wait(afterDone);
+    CHECK(outOfOrder == 0);
+    CHECK(stage == 11100);
+    CHECK(ranAfterDone);
+}
+
+static void TestMainThreadJobs(JobSystem &jobs)
+{
+    // Main thread jobs only run when the main thread asks for them,
+    // whichever thread queued them
+    JobCounter counter;
+    int mainThreadRuns = 0;
+    std::thread::id mainThread = std::this_thread::get_id();
+    bool onMainThread = true;
+
+    jobs.Run([&]()
+    {
+        jobs.RunOnMainThread([&]()
+        {
+            mainThreadRuns++;
+            onMainThread = onMainThread && (std::this_thread::get_id() == mainThread);
+        }, &counter);
+    }, &counter);
+    jobs.RunOnMainThread([&mainThreadRuns]() { mainThreadRuns++; }, &counter);
+
+    uint32_t ran = 0;
+    while (!counter.IsDone())
+    {
+        ran += jobs.RunMainThreadJobs();
+        std::this_thread::yield();
+    }
+    CHECK(ran == 2);
+    CHECK(mainThreadRuns == 2);
+    CHECK(onMainThread);
+    CHECK(!jobs.HasMainThreadJobs());
+    CHECK(jobs.RunMainThreadJobs() == 0);
+}
+
+static void TestExternalThreads(JobSystem &jobs)
+{
+    // Counters on the stack, waited for from threads outside the system
+    std::atomic<int> total(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; t++)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int round = 0; round < 300; round++)
+            {
+                JobCounter counter;
+                for (int i = 0; i < 8; i++)
+                {
+                    jobs.Run([&total]() { total++; }, &counter);
+                }
+                jobs.Wait(counter);
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(total == 3 * 300 * 8);
+}
+
+static void TestShutdownFinishesJobs()
+{
+    std::atomic<int> ran(0);
+    {
+        JobSystem jobs(2);
+        for (int i = 0; i < 1000; i++)
+        {
+            jobs.Run([&ran]() { ran++; });
+        }
+    }
+    CHECK(ran == 1000);
+}
+
+int main()
+{
+    for (uint32_t workerCount : WORKER_COUNTS)
+    {
+        JobSystem jobs(workerCount);
+        printf("%u workers:\n", workerCount);
+        SampleTests::RunTest("JobSystem fan-out", [&jobs]() { TestFanOut(jobs); });
+        SampleTests::RunTest("JobSystem nested fan-out", [&jobs]() { TestNestedFanOut(jobs); });
+        SampleTests::RunTest("JobSystem dependencies", [&jobs]() { TestDependencies(jobs); });
+        SampleTests::RunTest("JobSystem main thread jobs", [&jobs]() { TestMainThreadJobs(jobs); });
+        SampleTests::RunTest("JobSystem external threads", [&jobs]() { TestExternalThreads(jobs); });
+
+        JobSystemStats stats = jobs.GetStats();
+        printf("  %llu jobs, %llu stolen, %llu on the main thread, %llu worker sleeps\n",
+            static_cast<unsigned long long>(stats.jobsExecuted),
+            static_cast<unsigned long long>(stats.jobsStolen),
+            static_cast<unsigned long long>(stats.mainThreadJobs),
+            static_cast<unsigned long long>(stats.workerSleeps));
+    }
+    SampleTests::RunTest("JobSystem shutdown finishes queued jobs", TestShutdownFinishesJobs);
+    return SampleTests::Result();
+}
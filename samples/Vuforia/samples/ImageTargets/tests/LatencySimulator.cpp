@@ -0,0 +1,121 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "LatencyTracker.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const double CAMERA_INTERVAL = 1.0 / 30.0;
+static const double DISPLAY_INTERVAL = 1.0 / 60.0;
+
+// Time from capture to the update callback: tracking plus some jitter
+static const double CALLBACK_DELAY = 0.012;
+static const double CALLBACK_JITTER = 0.008;
+
+// The camera stamps its frames on a clock of its own
+static const double CAMERA_CLOCK_BEHIND = 12345.678;
+
+static const size_t TRACE_FRAMES = 600;
+
+// Feeds the LatencyTracker with the stage times of a simulated app: a 30 fps
+// camera whose frames reach the update callback after tracking, and a render
+// loop presenting the newest of them at a 60 Hz display's vsync. Prints the
+// summary as estimated from camera timestamps on another clock, and against
+// it the true capture to present latency:
+//
+//   LatencySimulator [seconds [render ms [trace file]]]
+int main(int argc, char **argv)
+{
+    const double seconds = (argc > 1) ? atof(argv[1]) : 60.0;
+    const double renderMilliseconds = (argc > 2) ? atof(argv[2]) : 8.0;
+    const char *tracePath = (argc > 3) ? argv[3] : nullptr;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    LatencyTracker tracker(TRACE_FRAMES);
+    LatencyTracker trueTracker(1);
+
+    // Capture and callback times of the camera frames, on the tracker's clock
+    std::vector<double> captures;
+    std::vector<double> callbacks;
+    for (double capture = 0.0; capture < seconds; capture += CAMERA_INTERVAL)
+    {
+        captures.push_back(capture);
+        callbacks.push_back(capture + CALLBACK_DELAY + CALLBACK_JITTER * unit(random));
+    }
+
+    // Each frame starts rendering at a vsync with the newest frame that
+    // reached the callback by then, and is presented at the first vsync after
+    // its rendering was submitted
+    size_t newest = 0;
+    bool hasFrame = false;
+    for (double vsync = DISPLAY_INTERVAL; vsync < seconds; )
+    {
+        while (newest < callbacks.size() && callbacks[newest] <= vsync)
+        {
+            newest++;
+            hasFrame = true;
+        }
+        if (!hasFrame)
+        {
+            vsync += DISPLAY_INTERVAL;
+            continue;
+        }
+
+        size_t frame = newest - 1;
+        FrameLatencyRecord record;
+        record.frameId = static_cast<int64_t>(frame);
+        record.times[LATENCY_STAGE_CAPTURE] = captures[frame];
+        record.times[LATENCY_STAGE_CALLBACK] = callbacks[frame];
+        record.times[LATENCY_STAGE_RENDER_BEGIN] = vsync + 0.0003;
+        record.times[LATENCY_STAGE_SUBMITTED] = record.times[LATENCY_STAGE_RENDER_BEGIN] +
+            renderMilliseconds / 1000.0 * (0.5 + unit(random));
+        record.times[LATENCY_STAGE_PRESENTED] =
+            std::ceil(record.times[LATENCY_STAGE_SUBMITTED] / DISPLAY_INTERVAL) * DISPLAY_INTERVAL;
+        record.repeated = false;
+        trueTracker.AddFrame(record);
+
+        record.times[LATENCY_STAGE_CAPTURE] -= CAMERA_CLOCK_BEHIND;
+        tracker.AddFrame(record);
+
+        vsync = record.times[LATENCY_STAGE_PRESENTED];
+    }
+
+    const LatencyTrackerStats &stats = tracker.GetStats();
+    printf("%.0f s, %.1f ms render: %llu frames presented, %llu repeated\n", seconds, renderMilliseconds,
+        static_cast<unsigned long long>(stats.framesPresented), static_cast<unsigned long long>(stats.framesRepeated));
+
+    std::string summary;
+    tracker.FormatSummary(summary);
+    printf("%s", summary.c_str());
+
+    LatencyPercentiles truth = trueTracker.GetPercentiles(LATENCY_INTERVAL_CAPTURE_TO_PRESENT);
+    printf("true capture to present: p50=%.2f p95=%.2f p99=%.2f max=%.2f ms\n", truth.p50, truth.p95, truth.p99, truth.max);
+
+    if (tracePath != nullptr)
+    {
+        std::string trace;
+        tracker.FormatTrace(trace);
+        FILE *file = fopen(tracePath, "wb");
+        if (file == nullptr)
+        {
+            printf("can't write %s\n", tracePath);
+            return 1;
+        }
+        fwrite(trace.data(), 1, trace.size(), file);
+        fclose(file);
+        printf("trace of the last %u frames written to %s\n", static_cast<uint32_t>(TRACE_FRAMES), tracePath);
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "LatencyTracker.h"
+
+#include <vector>
+
+using namespace SampleCommon;
+
+static const double TOLERANCE = 1e-6;
+
+// A frame captured at capture seconds, with the other stages following
+// after the given milliseconds
+static FrameLatencyRecord MakeRecord(int64_t frameId, double capture, double callbackMs, double renderMs,
+    double submitMs, double presentMs)
+{
+    FrameLatencyRecord record;
+    record.frameId = frameId;
+    record.times[LATENCY_STAGE_CAPTURE] = capture;
+    record.times[LATENCY_STAGE_CALLBACK] = capture + callbackMs / 1000.0;
+    record.times[LATENCY_STAGE_RENDER_BEGIN] = record.times[LATENCY_STAGE_CALLBACK] + renderMs / 1000.0;
+    record.times[LATENCY_STAGE_SUBMITTED] = record.times[LATENCY_STAGE_RENDER_BEGIN] + submitMs / 1000.0;
+    record.times[LATENCY_STAGE_PRESENTED] = record.times[LATENCY_STAGE_SUBMITTED] + presentMs / 1000.0;
+    record.repeated = false;
+    return record;
+}
+
+static void TestHistogramPercentiles()
+{
+    LatencyHistogram histogram;
+    LatencyPercentiles empty = histogram.GetPercentiles();
+    CHECK(empty.count == 0 && empty.p50 == 0.0 && empty.max == 0.0);
+
+    // One sample in the middle of each whole millisecond's first bin
+    for (int i = 0; i < 100; i++)
+    {
+        histogram.Add(i + 0.05);
+    }
+    LatencyPercentiles percentiles = histogram.GetPercentiles();
+    CHECK(percentiles.count == 100);
+    CHECK_NEAR(percentiles.p50, 49.05, LatencyHistogram::BIN_MILLISECONDS);
+    CHECK_NEAR(percentiles.p95, 94.05, LatencyHistogram::BIN_MILLISECONDS);
+    CHECK_NEAR(percentiles.p99, 98.05, LatencyHistogram::BIN_MILLISECONDS);
+    CHECK_NEAR(percentiles.max, 99.05, TOLERANCE);
+    CHECK(histogram.GetPercentile(100.0) <= percentiles.max);
+
+    // Interpolated within a bin, and never above the maximum
+    histogram.Reset();
+    for (int i = 0; i < 5; i++)
+    {
+        histogram.Add(20.01);
+        histogram.Add(20.09);
+    }
+    CHECK_NEAR(histogram.GetPercentile(50.0), 20.05, TOLERANCE);
+    CHECK_NEAR(histogram.GetPercentile(100.0), 20.09, TOLERANCE);
+
+    // Negative latencies are counted as none
+    histogram.Reset();
+    histogram.Add(-3.0);
+    CHECK(histogram.GetCount() == 1);
+    CHECK(histogram.GetPercentile(50.0) == 0.0);
+}
+
+static void TestHistogramOverflow()
+{
+    const double lastBinStart = (LatencyHistogram::BIN_COUNT - 1) * LatencyHistogram::BIN_MILLISECONDS;
+
+    LatencyHistogram histogram;
+    for (int i = 0; i < 90; i++)
+    {
+        histogram.Add(10.05);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        histogram.Add(lastBinStart + 50.0 * (i + 1));
+    }
+
+    // Percentiles in the overflow bin can only be given as the maximum seen
+    LatencyPercentiles percentiles = histogram.GetPercentiles();
+    CHECK(percentiles.count == 100);
+    CHECK_NEAR(percentiles.p50, 10.05, LatencyHistogram::BIN_MILLISECONDS);
+    CHECK_NEAR(percentiles.max, lastBinStart + 500.0, TOLERANCE);
+    CHECK(percentiles.p95 == percentiles.max);
+    CHECK(percentiles.p99 == percentiles.max);
+    printf("  p50 %.2f p95 %.2f p99 %.2f max %.2f ms\n", percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+
+    // Including samples at the very edge of it
+    histogram.Reset();
+    histogram.Add(lastBinStart + 0.01);
+    CHECK_NEAR(histogram.GetPercentile(50.0), lastBinStart + 0.01, TOLERANCE);
+}
+
+static void TestRepeatedFrames()
+{
+    LatencyTracker tracker(16);
+    tracker.AddFrame(MakeRecord(1, 100.0, 10.0, 2.0, 5.0, 8.0));
+
+    // The same frame presented again, later
+    FrameLatencyRecord repeat = MakeRecord(1, 100.0, 10.0, 19.0, 5.0, 8.0);
+    tracker.AddFrame(repeat);
+    tracker.AddFrame(repeat);
+    tracker.AddFrame(MakeRecord(2, 100.033, 10.0, 2.0, 5.0, 8.0));
+
+    CHECK(tracker.GetStats().framesPresented == 4);
+    CHECK(tracker.GetStats().framesRepeated == 2);
+    CHECK(tracker.GetHistogram(LATENCY_INTERVAL_CAPTURE_TO_PRESENT).GetCount() == 2);
+    CHECK_NEAR(tracker.GetPercentiles(LATENCY_INTERVAL_CAPTURE_TO_PRESENT).max, 25.0, 1e-6);
+
+    std::vector<FrameLatencyRecord> trace;
+    tracker.GetTrace(trace);
+    CHECK(trace.size() == 4);
+    CHECK(!trace[0].repeated && trace[1].repeated && trace[2].repeated && !trace[3].repeated);
+    CHECK(trace[3].frameId == 2);
+
+    // A frame id seen before, but not last, is a new presentation
+    tracker.AddFrame(MakeRecord(1, 100.066, 10.0, 2.0, 5.0, 8.0));
+    CHECK(tracker.GetStats().framesRepeated == 2);
+    CHECK(tracker.GetHistogram(LATENCY_INTERVAL_CAPTURE_TO_PRESENT).GetCount() == 3);
+}
+
+static void TestIncompleteFrames()
+{
+    LatencyTracker tracker(16);
+    tracker.AddFrame(MakeRecord(1, 100.0, 10.0, 2.0, 5.0, 8.0));
+
+    FrameLatencyRecord noCallback = MakeRecord(2, 100.033, 10.0, 2.0, 5.0, 8.0);
+    noCallback.times[LATENCY_STAGE_CALLBACK] = 0.0;
+    tracker.AddFrame(noCallback);
+    FrameLatencyRecord noPresent = MakeRecord(3, 100.066, 10.0, 2.0, 5.0, 8.0);
+    noPresent.times[LATENCY_STAGE_PRESENTED] = 0.0;
+    tracker.AddFrame(noPresent);
+
+    CHECK(tracker.GetStats().framesPresented == 3);
+    CHECK(tracker.GetStats().incompleteFrames == 2);
+    for (int interval = 0; interval < LATENCY_INTERVAL_COUNT; interval++)
+    {
+        CHECK(tracker.GetHistogram(static_cast<LatencyInterval>(interval)).GetCount() == 1);
+    }
+
+    std::vector<FrameLatencyRecord> trace;
+    tracker.GetTrace(trace);
+    CHECK(trace.size() == 3);
+    CHECK(trace[1].times[LATENCY_STAGE_CALLBACK] == 0.0);
+
+    // An incomplete first frame doesn't decide the camera clock
+    LatencyTracker other(16);
+    FrameLatencyRecord noCapture = MakeRecord(1, 100.0, 10.0, 2.0, 5.0, 8.0);
+    noCapture.times[LATENCY_STAGE_CAPTURE] = 0.0;
+    other.AddFrame(noCapture);
+    other.AddFrame(MakeRecord(2, 100.033, 12.0, 2.0, 5.0, 8.0));
+    CHECK(!other.GetStats().cameraClockEstimated);
+    CHECK_NEAR(other.GetPercentiles(LATENCY_INTERVAL_CAPTURE_TO_CALLBACK).max, 12.0, 1e-6);
+}
+
+static void TestCameraClockOffset()
+{
+    // Camera timestamps on the tracker's clock are taken as they are
+    LatencyTracker sameClock(16);
+    sameClock.AddFrame(MakeRecord(1, 100.0, 20.0, 2.0, 5.0, 8.0));
+    sameClock.AddFrame(MakeRecord(2, 100.033, 15.0, 2.0, 5.0, 8.0));
+    CHECK(!sameClock.GetStats().cameraClockEstimated);
+    CHECK_NEAR(sameClock.GetPercentiles(LATENCY_INTERVAL_CAPTURE_TO_CALLBACK).max, 20.0, 1e-6);
+
+    // A camera clock 5000 s behind: the offset is the shortest capture to
+    // callback interval seen so far, so the intervals are lower bounds
+    const double cameraClockBehind = 5000.0;
+    const double callbackMs[] = { 20.0, 15.0, 30.0, 18.0 };
+    LatencyTracker tracker(16);
+    for (int frame = 0; frame < 4; frame++)
+    {
+        double capture = 100.0 + frame / 30.0;
+        FrameLatencyRecord record = MakeRecord(frame + 1, capture, callbackMs[frame], 2.0, 5.0, 8.0);
+        record.times[LATENCY_STAGE_CAPTURE] -= cameraClockBehind;
+        tracker.AddFrame(record);
+    }
+    CHECK(tracker.GetStats().cameraClockEstimated);
+
+    // 0 ms for the first two frames, then 15 ms and 3 ms over the 15 ms minimum
+    const LatencyHistogram &captureToCallback = tracker.GetHistogram(LATENCY_INTERVAL_CAPTURE_TO_CALLBACK);
+    CHECK(captureToCallback.GetCount() == 4);
+    CHECK_NEAR(captureToCallback.GetPercentiles().max, 15.0, 1e-3);
+    CHECK_NEAR(tracker.GetPercentiles(LATENCY_INTERVAL_CAPTURE_TO_PRESENT).max, 15.0 + 15.0, 1e-3);
+
+    // The trace has the capture times moved onto the tracker's clock
+    std::vector<FrameLatencyRecord> trace;
+    tracker.GetTrace(trace);
+    CHECK_NEAR(trace[3].times[LATENCY_STAGE_CAPTURE], 100.0 + 3 / 30.0 + 0.015, 1e-6);
+
+    std::string summary;
+    tracker.FormatSummary(summary);
+    CHECK(summary.find("camera clock estimated") != std::string::npos);
+
+    // Camera timestamps after the callback are on another clock too
+    LatencyTracker ahead(16);
+    FrameLatencyRecord record = MakeRecord(1, 100.0, 20.0, 2.0, 5.0, 8.0);
+    record.times[LATENCY_STAGE_CAPTURE] += 2.0;
+    ahead.AddFrame(record);
+    CHECK(ahead.GetStats().cameraClockEstimated);
+
+    // Reset forgets the offset
+    ahead.Reset();
+    ahead.AddFrame(MakeRecord(1, 100.0, 20.0, 2.0, 5.0, 8.0));
+    CHECK(!ahead.GetStats().cameraClockEstimated);
+    CHECK_NEAR(ahead.GetPercentiles(LATENCY_INTERVAL_CAPTURE_TO_CALLBACK).max, 20.0, 1e-6);
+}
+
+static void TestTrace()
+{
+    LatencyTracker tracker(3);
+    for (int frame = 1; frame <= 5; frame++)
+    {
+        tracker.AddFrame(MakeRecord(frame, 100.0 + frame / 30.0, 10.0, 2.0, 5.0, 8.0));
+    }
+
+    // Only the last frames are kept, oldest first
+    std::vector<FrameLatencyRecord> trace;
+    tracker.GetTrace(trace);
+    CHECK(trace.size() == 3);
+    CHECK(trace[0].frameId == 3 && trace[2].frameId == 5);
+
+    std::string text;
+    tracker.FormatTrace(text);
+    CHECK(text.find("frame,repeated,") == 0);
+    CHECK(text.find("\n5,0,10.000,12.000,17.000,25.000\n") != std::string::npos);
+    CHECK(text.find("\n2,") == std::string::npos);
+}
+
+int main()
+{
+    SampleTests::RunTest("histogram percentiles", TestHistogramPercentiles);
+    SampleTests::RunTest("histogram overflow", TestHistogramOverflow);
+    SampleTests::RunTest("repeated frames", TestRepeatedFrames);
+    SampleTests::RunTest("incomplete frames", TestIncompleteFrames);
+    SampleTests::RunTest("camera clock offset", TestCameraClockOffset);
+    SampleTests::RunTest("trace", TestTrace);
+    return SampleTests::Result();
+}
@@ -0,0 +1,108 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include "CommandRecorder.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Stands in for the deferred contexts of D3D11CommandRecordingBackend: each
+// job records into a command list of its own, which is a list of draw
+// numbers here, and executing a job appends its list to the executed draws.
+// Misuse of the interface is counted rather than asserted, so that the
+// tests can check for it from any thread.
+class MockCommandRecordingBackend : public SampleCommon::ICommandRecordingBackend
+{
+public:
+    explicit MockCommandRecordingBackend(uint32_t workerCount) :
+        m_workerCount(workerCount),
+        m_openJobs(new std::atomic<int>[workerCount]),
+        m_errors(0),
+        m_nextExecutedJob(0)
+    {
+        for (uint32_t worker = 0; worker < workerCount; worker++)
+        {
+            m_openJobs[worker] = -1;
+        }
+    }
+
+    virtual uint32_t GetWorkerCount() const { return m_workerCount; }
+
+    virtual void PrepareJobs(uint32_t jobCount)
+    {
+        m_lists.assign(jobCount, std::vector<uint32_t>());
+        m_jobWorkers.assign(jobCount, -1);
+        m_nextExecutedJob = 0;
+        m_executedDraws.clear();
+    }
+
+    virtual void BeginJob(uint32_t worker, uint32_t job)
+    {
+        // A worker's context records one job at a time, and only on one thread
+        int none = -1;
+        if (worker >= m_workerCount || job >= m_lists.size() || m_jobWorkers[job] != -1 ||
+            !m_openJobs[worker].compare_exchange_strong(none, static_cast<int>(job)))
+        {
+            m_errors++;
+            return;
+        }
+        m_jobWorkers[job] = static_cast<int>(worker);
+    }
+
+    virtual void EndJob(uint32_t worker, uint32_t job)
+    {
+        int open = static_cast<int>(job);
+        if (worker >= m_workerCount || !m_openJobs[worker].compare_exchange_strong(open, -1))
+        {
+            m_errors++;
+        }
+    }
+
+    virtual void ExecuteJob(uint32_t job)
+    {
+        if (job != m_nextExecutedJob++ || job >= m_lists.size() || m_jobWorkers[job] == -1)
+        {
+            m_errors++;
+            return;
+        }
+        m_executedDraws.insert(m_executedDraws.end(), m_lists[job].begin(), m_lists[job].end());
+    }
+
+    // Records a draw into the job open on the worker
+    void RecordDraw(uint32_t worker, uint32_t draw)
+    {
+        int job = (worker < m_workerCount) ? m_openJobs[worker].load() : -1;
+        if (job < 0)
+        {
+            m_errors++;
+            return;
+        }
+        m_lists[job].push_back(draw);
+    }
+
+    // The worker each job of the last frame was recorded on, or -1
+    const std::vector<int>& GetJobWorkers() const { return m_jobWorkers; }
+
+    // The draws of the last frame in the order they were executed
+    const std::vector<uint32_t>& GetExecutedDraws() const { return m_executedDraws; }
+
+    int GetErrors() const { return m_errors; }
+
+private:
+    uint32_t m_workerCount;
+    std::unique_ptr<std::atomic<int>[]> m_openJobs;
+    std::atomic<int> m_errors;
+
+    // Written by the worker recording the job only
+    std::vector<std::vector<uint32_t>> m_lists;
+    std::vector<int> m_jobWorkers;
+
+    uint32_t m_nextExecutedJob;
+    std::vector<uint32_t> m_executedDraws;
+};
@@ -0,0 +1,135 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "PoseBatch.h"
+#include "SampleMath.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const size_t RESULT_COUNTS[] = { 1, 4, 16, 64, 256 };
+
+// Views of a stereo frame
+static const uint32_t VIEW_COUNT = 2;
+
+struct Frame
+{
+    std::vector<float> poses;
+    std::vector<float> models;
+    std::vector<float> points;
+    float projections[VIEW_COUNT][16];
+};
+
+static void MakeFrame(size_t count, Frame &frame)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    frame.poses.resize(count * 12);
+    frame.models.resize(count * 16);
+    frame.points.resize(count * 3);
+    for (auto &value : frame.poses)
+    {
+        value = distribution(random);
+    }
+    for (auto &value : frame.models)
+    {
+        value = distribution(random);
+    }
+    for (auto &value : frame.points)
+    {
+        value = distribution(random);
+    }
+    for (auto &projection : frame.projections)
+    {
+        for (auto &value : projection)
+        {
+            value = distribution(random);
+        }
+    }
+}
+
+// The model-view and model-view-projections computed one result at a time,
+// converting the pose to 4x4 first, as before the batch
+static double PerResultNanoseconds(const Frame &frame, size_t count, int frames, float &checksum)
+{
+    std::vector<float> modelViews(count * 16);
+    std::vector<float> modelViewProjections(count * 16 * VIEW_COUNT);
+    std::vector<float> points(count * 3);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            float pose[16];
+            float *modelView = &modelViews[i * 16];
+            SampleMath::FromMatrix34(&frame.poses[i * 12], pose);
+            SampleMath::Multiply(pose, &frame.models[i * 16], modelView);
+            for (uint32_t view = 0; view < VIEW_COUNT; view++)
+            {
+                SampleMath::Multiply(frame.projections[view], modelView, &modelViewProjections[(i * VIEW_COUNT + view) * 16]);
+            }
+
+            const float *point = &frame.points[i * 3];
+            for (int row = 0; row < 3; row++)
+            {
+                points[i * 3 + row] = pose[row * 4] * point[0] + pose[row * 4 + 1] * point[1] + pose[row * 4 + 2] * point[2] + pose[row * 4 + 3];
+            }
+        }
+        checksum += modelViewProjections[f % modelViewProjections.size()] + points[f % points.size()];
+    }
+    double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+    return milliseconds * 1e6 / frames;
+}
+
+static double BatchNanoseconds(const Frame &frame, size_t count, int frames, float &checksum)
+{
+    PoseBatch batch;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++)
+    {
+        batch.Clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            batch.Add(&frame.poses[i * 12], &frame.models[i * 16], &frame.points[i * 3]);
+        }
+        batch.Compute(frame.projections, VIEW_COUNT);
+        uint32_t instance = static_cast<uint32_t>(f % count);
+        checksum += batch.GetModelViewProjection(VIEW_COUNT - 1, instance)[f % 16] + batch.GetPointsZ()[instance];
+    }
+    double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+    return milliseconds * 1e6 / frames;
+}
+
+// Time per frame of transforming the trackable results of a stereo frame,
+// with PoseBatch against one result at a time
+int main(int argc, char **argv)
+{
+    // Products per measurement, whatever the result count
+    const int products = (argc > 1) ? atoi(argv[1]) : 4000000;
+
+    printf("%s backend, %u views\n", SampleMath::GetBackendName(), VIEW_COUNT);
+    printf("results   per-result     batch   speedup\n");
+    float checksum = 0.0f;
+    for (size_t count : RESULT_COUNTS)
+    {
+        Frame frame;
+        MakeFrame(count, frame);
+        int frames = (std::max)(1, static_cast<int>(products / count));
+
+        double perResult = PerResultNanoseconds(frame, count, frames, checksum);
+        double batch = BatchNanoseconds(frame, count, frames, checksum);
+        printf("%7u %9.0f ns %9.0f ns %8.2fx\n", static_cast<uint32_t>(count), perResult, batch, perResult / batch);
+    }
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "PoseBatch.h"
+#include "SampleMath.h"
+
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+static const float TOLERANCE = 1e-3f;
+
+struct TestInstance
+{
+    float pose[12];
+    float model[16];
+    float point[3];
+};
+
+static void MakeInstances(size_t count, std::vector<TestInstance> &instances)
+{
+    std::mt19937 random(static_cast<uint32_t>(count));
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> translation(-200.0f, 200.0f);
+    instances.resize(count);
+    for (auto &instance : instances)
+    {
+        for (int i = 0; i < 12; i++)
+        {
+            instance.pose[i] = (i % 4 == 3) ? translation(random) : unit(random);
+        }
+        for (int i = 0; i < 16; i++)
+        {
+            instance.model[i] = (i < 12) ? unit(random) * 50.0f : ((i == 15) ? 1.0f : 0.0f);
+        }
+        for (int i = 0; i < 3; i++)
+        {
+            instance.point[i] = translation(random);
+        }
+    }
+}
+
+static void MakeProjections(float projections[PoseBatch::MAX_VIEWS][16])
+{
+    for (uint32_t view = 0; view < PoseBatch::MAX_VIEWS; view++)
+    {
+        const float projection[16] = {
+            1.7f, 0.0f, 0.05f * view, -0.03f * view,
+            0.0f, 2.2f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.001f, -10.0f,
+            0.0f, 0.0f, 1.0f, 0.0f
+        };
+        for (int i = 0; i < 16; i++)
+        {
+            projections[view][i] = projection[i];
+        }
+    }
+}
+
+static void CheckMatrix(const float *actual, const float *expected)
+{
+    for (int i = 0; i < 16; i++)
+    {
+        // Relative to the size of the entry
+        float tolerance = TOLERANCE * (std::fabs(expected[i]) > 1.0f ? std::fabs(expected[i]) : 1.0f);
+        CHECK_NEAR(actual[i], expected[i], tolerance);
+    }
+}
+
+// Checks the outputs of the batch against per-result conversions and
+// products, as drawing without the batch does
+static void CheckAgainstPerResult(const PoseBatch &batch, const std::vector<TestInstance> &instances,
+    const float projections[PoseBatch::MAX_VIEWS][16], uint32_t viewCount)
+{
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        const TestInstance &instance = instances[i];
+        float pose[16], modelView[16];
+        SampleMath::FromMatrix34(instance.pose, pose);
+        SampleMath::MultiplyScalar(pose, instance.model, modelView);
+        CheckMatrix(batch.GetModelView(static_cast<uint32_t>(i)), modelView);
+
+        for (uint32_t view = 0; view < viewCount; view++)
+        {
+            float modelViewProjection[16];
+            SampleMath::MultiplyScalar(projections[view], modelView, modelViewProjection);
+            CheckMatrix(batch.GetModelViewProjection(view, static_cast<uint32_t>(i)), modelViewProjection);
+        }
+
+        const float *points[3] = { batch.GetPointsX(), batch.GetPointsY(), batch.GetPointsZ() };
+        for (int row = 0; row < 3; row++)
+        {
+            float expected = pose[row * 4 + 3];
+            for (int k = 0; k < 3; k++)
+            {
+                expected += pose[row * 4 + k] * instance.point[k];
+            }
+            CHECK_NEAR(points[row][i], expected, TOLERANCE * 100.0f);
+        }
+    }
+}
+
+static void TestMatchesPerResult()
+{
+    float projections[PoseBatch::MAX_VIEWS][16];
+    MakeProjections(projections);
+
+    const size_t counts[] = { 1, 3, 4, 17, 64 };
+    for (size_t count : counts)
+    {
+        std::vector<TestInstance> instances;
+        MakeInstances(count, instances);
+
+        PoseBatch batch;
+        for (size_t i = 0; i < count; i++)
+        {
+            CHECK(batch.Add(instances[i].pose, instances[i].model, instances[i].point) == i);
+        }
+        CHECK(batch.Size() == count);
+
+        for (uint32_t viewCount = 1; viewCount <= PoseBatch::MAX_VIEWS; viewCount++)
+        {
+            batch.Compute(projections, viewCount);
+            CheckAgainstPerResult(batch, instances, projections, viewCount);
+            batch.ComputeScalar(projections, viewCount);
+            CheckAgainstPerResult(batch, instances, projections, viewCount);
+        }
+    }
+}
+
+// A frame with fewer results than the last reuses the buffers, and only
+// its own instances are computed
+static void TestReuseAcrossFrames()
+{
+    float projections[PoseBatch::MAX_VIEWS][16];
+    MakeProjections(projections);
+
+    PoseBatch batch;
+    std::vector<TestInstance> instances;
+    const size_t counts[] = { 8, 2, 0, 5 };
+    for (size_t count : counts)
+    {
+        MakeInstances(count, instances);
+        batch.Clear();
+        for (const auto &instance : instances)
+        {
+            batch.Add(instance.pose, instance.model, instance.point);
+        }
+        CHECK(batch.Size() == count);
+        batch.Compute(projections, PoseBatch::MAX_VIEWS);
+        CheckAgainstPerResult(batch, instances, projections, PoseBatch::MAX_VIEWS);
+    }
+}
+
+int main()
+{
+    SampleTests::RunTest("matches per-result products", TestMatchesPerResult);
+    SampleTests::RunTest("reuse across frames", TestReuseAcrossFrames);
+    return SampleTests::Result();
+}
@@ -0,0 +1,92 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "PosePredictionEvaluator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace SampleCommon;
+
+// Horizons evaluated when none are given, in milliseconds
+static const double DEFAULT_HORIZONS[] = { 8.0, 16.0, 33.0, 50.0, 67.0, 100.0 };
+
+static bool ReadFile(const char *path, std::string &text)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        text.append(buffer, read);
+    }
+    fclose(file);
+    return true;
+}
+
+// Replays a recorded pose sequence through the PosePredictor with its
+// default settings and prints the prediction error against the horizon:
+//
+//   PosePredictionEvaluator <sequence file> [horizon in milliseconds ...]
+//
+// data/PoseSequence.txt is a sample sequence.
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <sequence file> [horizon in milliseconds ...]\n", argv[0]);
+        return 1;
+    }
+
+    std::string text;
+    if (!ReadFile(argv[1], text))
+    {
+        printf("can't read %s\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<RecordedPose> sequence;
+    uint32_t rejected = PosePredictionEvaluator::ParseSequence(text.c_str(), text.size(), sequence);
+    printf("%s: %u poses, %u lines rejected\n", argv[1], static_cast<uint32_t>(sequence.size()), rejected);
+    if (sequence.empty())
+    {
+        return 1;
+    }
+
+    std::vector<double> horizons;
+    for (int i = 2; i < argc; i++)
+    {
+        horizons.push_back(atof(argv[i]) / 1000.0);
+    }
+    if (horizons.empty())
+    {
+        for (double horizon : DEFAULT_HORIZONS)
+        {
+            horizons.push_back(horizon / 1000.0);
+        }
+    }
+
+    std::vector<PredictionError> errors;
+    PosePredictionEvaluator::Evaluate(sequence, PosePredictor::GetDefaultSettings(), horizons.data(), horizons.size(), errors);
+
+    printf("horizon   count   translation mean/max   rotation mean/max (deg)   held: translation   rotation\n");
+    for (const auto &error : errors)
+    {
+        printf("%5.0f ms  %5u   %8.3f %9.3f     %8.3f %8.3f             %8.3f    %8.3f\n",
+            error.horizon * 1000.0, error.count,
+            error.meanTranslation, error.maxTranslation,
+            error.meanRotationDegrees, error.maxRotationDegrees,
+            error.meanTranslationHeld, error.meanRotationDegreesHeld);
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "PosePredictor.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace SampleCommon;
+
+static const float IDENTITY[12] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f
+};
+
+static const double FRAME_SECONDS = 1.0 / 30.0;
+
+// A target about 30 cm in front of the camera, seen at an angle
+static void GetBasePose(float pose[12])
+{
+    const double twist[6] = { 0.3, -0.2, 0.1, 40.0, -25.0, 300.0 };
+    PoseMath::ApplyTwist(twist, 1.0, IDENTITY, pose);
+}
+
+// Compares the rotations entry by entry, as the angle between two nearly
+// equal float rotations is lost in the acos of their trace
+static bool PosesNear(const float a[12], const float b[12], double translationTolerance, double rotationTolerance)
+{
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            if (std::fabs(a[r * 4 + c] - b[r * 4 + c]) > rotationTolerance)
+            {
+                return false;
+            }
+        }
+    }
+    return PoseMath::TranslationDistance(a, b) <= translationTolerance;
+}
+
+static void TestTwistRoundTrip()
+{
+    float from[12];
+    GetBasePose(from);
+
+    // Up to large rotations, with and without translation
+    const double twists[][6] = {
+        { 0.0, 0.0, 0.0, 5.0, -3.0, 1.0 },
+        { 0.02, -0.01, 0.005, 1.5, 0.5, -2.0 },
+        { 0.5, 0.3, -0.4, 0.0, 0.0, 0.0 },
+        { -1.2, 0.8, 1.5, 30.0, 10.0, -50.0 }
+    };
+    for (const auto &twist : twists)
+    {
+        float to[12];
+        PoseMath::ApplyTwist(twist, 1.0, from, to);
+
+        double measured[6];
+        PoseMath::RelativeTwist(from, to, measured);
+        for (int i = 0; i < 3; i++)
+        {
+            CHECK_NEAR(measured[i], twist[i], 1e-5);
+            CHECK_NEAR(measured[i + 3], twist[i + 3], 1e-3);
+        }
+
+        float result[12];
+        PoseMath::ApplyTwist(measured, 1.0, from, result);
+        CHECK(PosesNear(result, to, 1e-3, 1e-5));
+
+        // Half of it twice is all of it, and none of it is the identity
+        float half[12];
+        PoseMath::ApplyTwist(measured, 0.5, from, half);
+        PoseMath::ApplyTwist(measured, 0.5, half, half);
+        CHECK(PosesNear(half, to, 1e-3, 1e-5));
+        PoseMath::ApplyTwist(measured, 0.0, from, result);
+        CHECK(memcmp(result, from, sizeof(result)) == 0);
+    }
+}
+
+// Below 1e-4 radians the coefficients are series expansions; the twist
+// is recovered the same on both sides of that
+static void TestSmallAngle()
+{
+    float from[12];
+    GetBasePose(from);
+
+    const double angles[] = { 0.0, 1e-6, 0.9e-4, 1.1e-4, 1e-3 };
+    for (double angle : angles)
+    {
+        const double twist[6] = { angle * 0.6, angle * -0.8, 0.0, 2.0, -1.0, 0.5 };
+        float to[12];
+        PoseMath::ApplyTwist(twist, 1.0, from, to);
+
+        double measured[6];
+        PoseMath::RelativeTwist(from, to, measured);
+        for (int i = 0; i < 3; i++)
+        {
+            CHECK_NEAR(measured[i], twist[i], 1e-6);
+            CHECK_NEAR(measured[i + 3], twist[i + 3], 1e-3);
+        }
+        CHECK_NEAR(PoseMath::RotationAngle(from, to), angle, 1e-3);
+    }
+}
+
+// A trackable moving at a constant twist is predicted exactly, at any
+// horizon up to maxHorizon
+static void TestConstantVelocity()
+{
+    PosePredictorSettings settings = PosePredictor::GetDefaultSettings();
+    PosePredictor predictor(settings);
+
+    float base[12];
+    GetBasePose(base);
+    const double twist[6] = { 0.4, -0.3, 0.2, 60.0, 20.0, -40.0 };
+
+    // A single pose has no velocity: its pose is held
+    float predicted[12];
+    predictor.AddPose(1, 0.0, base);
+    CHECK(!predictor.Predict(1, 0.05, predicted));
+    CHECK(memcmp(predicted, base, sizeof(predicted)) == 0);
+    CHECK(predictor.GetStats().fallbacks == 1);
+
+    double latest = 0.0;
+    for (int frame = 1; frame <= 20; frame++)
+    {
+        latest = frame * FRAME_SECONDS;
+        float pose[12];
+        PoseMath::ApplyTwist(twist, latest, base, pose);
+        predictor.AddPose(1, latest, pose);
+    }
+
+    const double horizons[] = { 0.0, 0.008, 0.016, 0.05, settings.maxHorizon };
+    for (double horizon : horizons)
+    {
+        float expected[12];
+        PoseMath::ApplyTwist(twist, latest + horizon, base, expected);
+        CHECK(predictor.Predict(1, latest + horizon, predicted));
+        CHECK(PosesNear(predicted, expected, 0.01, 1e-5));
+    }
+
+    // Further ahead is clamped to maxHorizon
+    float clamped[12];
+    predictor.Predict(1, latest + settings.maxHorizon, clamped);
+    predictor.Predict(1, latest + 1.0, predicted);
+    CHECK(memcmp(predicted, clamped, sizeof(predicted)) == 0);
+    CHECK(predictor.GetStats().predictions == 7);
+}
+
+static void TestGapRestartAndPruning()
+{
+    PosePredictorSettings settings = PosePredictor::GetDefaultSettings();
+    PosePredictor predictor(settings);
+
+    float base[12];
+    GetBasePose(base);
+    const double twist[6] = { 0.0, 0.5, 0.0, 30.0, 0.0, 0.0 };
+    float pose[12];
+    float predicted[12];
+    for (int frame = 0; frame < 5; frame++)
+    {
+        PoseMath::ApplyTwist(twist, frame * FRAME_SECONDS, base, pose);
+        predictor.AddPose(1, frame * FRAME_SECONDS, pose);
+        predictor.AddPose(2, frame * FRAME_SECONDS, base);
+    }
+    double latest = 4 * FRAME_SECONDS;
+    CHECK(predictor.Predict(1, latest + 0.02, predicted));
+    CHECK(predictor.GetStats().trackCount == 2);
+
+    // The same camera frame again is ignored
+    predictor.AddPose(1, latest, base);
+    CHECK(predictor.Predict(1, latest, predicted));
+    CHECK(PosesNear(predicted, pose, 1e-3, 1e-6));
+
+    // After a gap the history starts again, without a velocity
+    double resumed = latest + settings.maxGap + FRAME_SECONDS;
+    predictor.AddPose(1, resumed, base);
+    CHECK(predictor.GetStats().restarts == 1);
+    CHECK(!predictor.Predict(1, resumed + 0.02, predicted));
+    CHECK(memcmp(predicted, base, sizeof(predicted)) == 0);
+    predictor.AddPose(1, resumed + FRAME_SECONDS, base);
+    CHECK(predictor.Predict(1, resumed + FRAME_SECONDS, predicted));
+
+    // Trackable 2 wasn't seen for longer than maxGap; trackable 1 was
+    predictor.Prune(resumed + FRAME_SECONDS);
+    CHECK(predictor.GetStats().trackCount == 1);
+    memcpy(predicted, IDENTITY, sizeof(predicted));
+    CHECK(!predictor.Predict(2, resumed, predicted));
+    CHECK(memcmp(predicted, IDENTITY, sizeof(predicted)) == 0);
+    CHECK(predictor.Predict(1, resumed + FRAME_SECONDS, predicted));
+
+    // Seen again, it starts over
+    predictor.AddPose(2, resumed + FRAME_SECONDS, base);
+    CHECK(predictor.GetStats().trackCount == 2);
+    CHECK(predictor.GetStats().restarts == 1);
+
+    predictor.Reset();
+    CHECK(predictor.GetStats().trackCount == 0);
+    CHECK(!predictor.Predict(1, resumed, predicted));
+}
+
+int main()
+{
+    SampleTests::RunTest("twist round trip", TestTwistRoundTrip);
+    SampleTests::RunTest("small angle", TestSmallAngle);
+    SampleTests::RunTest("constant velocity", TestConstantVelocity);
+    SampleTests::RunTest("gap restart and pruning", TestGapRestartAndPruning);
+    return SampleTests::Result();
+}
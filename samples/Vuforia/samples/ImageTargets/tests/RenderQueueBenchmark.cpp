@@ -0,0 +1,121 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+// Sizes on both sides of the insertion sort threshold of 64 packets
+static const size_t QUEUE_SIZES[] = { 8, 16, 32, 33, 64, 65, 128, 256, 1024, 4096 };
+
+static const uint32_t TEXTURE_COUNT = 8;
+static const uint32_t MESH_COUNT = 4;
+
+struct BenchmarkDraw
+{
+    RenderPass pass;
+    uint32_t texture;
+    uint32_t mesh;
+};
+
+// Pass, mesh and texture bindings of executing the draws in an order, as
+// the renderer counts them
+static uint32_t CountStateChanges(const std::vector<BenchmarkDraw> &draws, const std::vector<uint32_t> &order)
+{
+    uint32_t stateChanges = 0;
+    int boundPass = -1;
+    int boundMesh = -1;
+    int boundTexture = -1;
+    for (uint32_t index : order)
+    {
+        const BenchmarkDraw &draw = draws[index];
+        stateChanges += (draw.pass != boundPass) ? 1 : 0;
+        stateChanges += (static_cast<int>(draw.mesh) != boundMesh) ? 1 : 0;
+        stateChanges += (static_cast<int>(draw.texture) != boundTexture) ? 1 : 0;
+        boundPass = draw.pass;
+        boundMesh = static_cast<int>(draw.mesh);
+        boundTexture = static_cast<int>(draw.texture);
+    }
+    return stateChanges;
+}
+
+// Time to submit and sort a frame's draws with the render queue, against
+// std::sort of the same packets, and the state changes sorting saves
+int main(int argc, char **argv)
+{
+    // Packets sorted per measurement, whatever the queue size
+    const size_t packets = (argc > 1) ? static_cast<size_t>(atol(argv[1])) : 20000000;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+
+    printf("packets   queue sort   std::sort   state changes submitted/sorted\n");
+    double checksum = 0.0;
+    for (size_t size : QUEUE_SIZES)
+    {
+        std::vector<BenchmarkDraw> draws(size);
+        std::vector<uint64_t> keys(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            BenchmarkDraw &draw = draws[i];
+            draw.pass = (random() % 8 == 0) ? RENDER_PASS_TRANSLUCENT : RENDER_PASS_OPAQUE;
+            draw.texture = random() % TEXTURE_COUNT;
+            draw.mesh = random() % MESH_COUNT;
+            keys[i] = RenderQueue::MakeSortKey(draw.pass, (draw.pass == RENDER_PASS_TRANSLUCENT) ? 1 : 0, 0,
+                draw.texture, draw.mesh, depth(random));
+        }
+        size_t frames = (std::max)(static_cast<size_t>(1), packets / size);
+
+        RenderQueue queue;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frames; frame++)
+        {
+            queue.Clear();
+            for (size_t i = 0; i < size; i++)
+            {
+                queue.Submit(keys[i], static_cast<uint32_t>(i));
+            }
+            queue.Sort();
+            checksum += queue[frame % size].drawIndex;
+        }
+        double queueMicroseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) * 1000.0 / frames;
+
+        std::vector<DrawPacket> sorted;
+        start = std::chrono::steady_clock::now();
+        for (size_t frame = 0; frame < frames; frame++)
+        {
+            sorted.clear();
+            for (size_t i = 0; i < size; i++)
+            {
+                DrawPacket packet = { keys[i], static_cast<uint32_t>(i) };
+                sorted.push_back(packet);
+            }
+            std::sort(sorted.begin(), sorted.end(),
+                [](const DrawPacket &a, const DrawPacket &b) { return a.sortKey < b.sortKey; });
+            checksum += sorted[frame % size].drawIndex;
+        }
+        double stdMicroseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now()) * 1000.0 / frames;
+
+        std::vector<uint32_t> submittedOrder(size);
+        std::vector<uint32_t> sortedOrder(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            submittedOrder[i] = static_cast<uint32_t>(i);
+            sortedOrder[i] = queue[i].drawIndex;
+        }
+
+        printf("%7u %9.2f us %9.2f us   %6u / %u\n", static_cast<uint32_t>(size), queueMicroseconds, stdMicroseconds,
+            CountStateChanges(draws, submittedOrder), CountStateChanges(draws, sortedOrder));
+    }
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
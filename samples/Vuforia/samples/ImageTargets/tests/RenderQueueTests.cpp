@@ -0,0 +1,235 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+// Sizes on both sides of the insertion sort threshold of 64 packets
+static const size_t QUEUE_SIZES[] = { 0, 1, 2, 33, 63, 64, 65, 128, 1000 };
+
+struct TestDraw
+{
+    RenderPass pass;
+    uint32_t texture;
+    uint32_t mesh;
+    float depth;
+};
+
+static void MakeDraws(size_t count, uint32_t textures, uint32_t meshes, uint32_t seed, std::vector<TestDraw> &draws)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+    draws.resize(count);
+    for (auto &draw : draws)
+    {
+        draw.pass = (random() % 8 == 0) ? RENDER_PASS_TRANSLUCENT : RENDER_PASS_OPAQUE;
+        draw.texture = random() % textures;
+        draw.mesh = random() % meshes;
+        draw.depth = depth(random);
+    }
+}
+
+static uint64_t GetSortKey(const TestDraw &draw)
+{
+    return RenderQueue::MakeSortKey(draw.pass, (draw.pass == RENDER_PASS_TRANSLUCENT) ? 1 : 0, 0, draw.texture, draw.mesh, draw.depth);
+}
+
+// Pipeline state changes of executing the draws in an order, counted as
+// the renderer binds them: the pass state, the mesh and the texture, each
+// when it differs from the previous draw
+static uint32_t CountStateChanges(const std::vector<TestDraw> &draws, const std::vector<uint32_t> &order)
+{
+    uint32_t stateChanges = 0;
+    int boundPass = -1;
+    int boundMesh = -1;
+    int boundTexture = -1;
+    for (uint32_t index : order)
+    {
+        const TestDraw &draw = draws[index];
+        stateChanges += (draw.pass != boundPass) ? 1 : 0;
+        stateChanges += (static_cast<int>(draw.mesh) != boundMesh) ? 1 : 0;
+        stateChanges += (static_cast<int>(draw.texture) != boundTexture) ? 1 : 0;
+        boundPass = draw.pass;
+        boundMesh = static_cast<int>(draw.mesh);
+        boundTexture = static_cast<int>(draw.texture);
+    }
+    return stateChanges;
+}
+
+// Either path sorts by key, keeping packets of equal keys in submission order
+static void TestSortMatchesStableSort()
+{
+    for (size_t size : QUEUE_SIZES)
+    {
+        std::mt19937 random(static_cast<uint32_t>(size));
+        RenderQueue queue;
+        std::vector<DrawPacket> expected;
+        for (size_t i = 0; i < size; i++)
+        {
+            // Few distinct keys, so that some are equal, with differences
+            // in every byte
+            uint64_t key = static_cast<uint64_t>(random() % 16) << ((random() % 8) * 8);
+            queue.Submit(key, static_cast<uint32_t>(i));
+            DrawPacket packet = { key, static_cast<uint32_t>(i) };
+            expected.push_back(packet);
+        }
+        std::stable_sort(expected.begin(), expected.end(),
+            [](const DrawPacket &a, const DrawPacket &b) { return a.sortKey < b.sortKey; });
+
+        queue.Sort();
+        CHECK(queue.Size() == size);
+        CHECK(queue.GetStats().packetCount == size);
+        bool same = true;
+        for (size_t i = 0; i < size; i++)
+        {
+            same = same && queue[i].sortKey == expected[i].sortKey && queue[i].drawIndex == expected[i].drawIndex;
+        }
+        CHECK(same);
+    }
+
+    // Keys differing only in their top byte, which the radix sort must not
+    // skip, and a queue sorted again after more submissions
+    RenderQueue queue;
+    for (uint32_t i = 0; i < 80; i++)
+    {
+        queue.Submit(static_cast<uint64_t>(80 - i) << 56, i);
+    }
+    queue.Sort();
+    for (uint32_t i = 0; i < 80; i++)
+    {
+        CHECK(queue[i].drawIndex == 79 - i);
+    }
+    queue.Submit(0, 80);
+    queue.Sort();
+    CHECK(queue[0].drawIndex == 80);
+
+    queue.Clear();
+    CHECK(queue.Size() == 0);
+    CHECK(queue.GetStats().packetCount == 0);
+}
+
+static void TestKeyOrdering()
+{
+    // Passes first, whatever the rest
+    uint64_t opaque = RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 3, 255, 4095, 255, 1.0f);
+    uint64_t translucent = RenderQueue::MakeSortKey(RENDER_PASS_TRANSLUCENT, 0, 0, 0, 0, 0.0f);
+    uint64_t overlay = RenderQueue::MakeSortKey(RENDER_PASS_OVERLAY, 0, 0, 0, 0, 0.0f);
+    CHECK(opaque < translucent && translucent < overlay);
+    CHECK(RenderQueue::GetPass(opaque) == RENDER_PASS_OPAQUE);
+    CHECK(RenderQueue::GetPass(translucent) == RENDER_PASS_TRANSLUCENT);
+    CHECK(RenderQueue::GetPass(overlay) == RENDER_PASS_OVERLAY);
+
+    // Opaque: grouped by state, then front to back within a state
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 1, 2, 0.2f) < RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 1, 2, 0.8f));
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 1, 2, 0.9f) < RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 1, 3, 0.1f));
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 1, 9, 0.9f) < RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 2, 0, 0.1f));
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 1, 0, 0, 0.9f) < RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 1, 0, 0, 0, 0.1f));
+
+    // Translucent: back to front, whatever the state
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_TRANSLUCENT, 1, 0, 7, 7, 0.8f) < RenderQueue::MakeSortKey(RENDER_PASS_TRANSLUCENT, 1, 0, 0, 0, 0.2f));
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_TRANSLUCENT, 1, 0, 0, 0, 0.5f) < RenderQueue::MakeSortKey(RENDER_PASS_TRANSLUCENT, 1, 0, 1, 0, 0.5f));
+
+    // Depths out of [0, 1] are clamped
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 0, 0, -1.0f) == RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 0, 0, 0.0f));
+    CHECK(RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 0, 0, 2.0f) == RenderQueue::MakeSortKey(RENDER_PASS_OPAQUE, 0, 0, 0, 0, 1.0f));
+
+    // A sorted scene executes in that order on both sides of the threshold
+    for (size_t size : QUEUE_SIZES)
+    {
+        std::vector<TestDraw> draws;
+        MakeDraws(size, 4, 3, 11, draws);
+        RenderQueue queue;
+        for (size_t i = 0; i < size; i++)
+        {
+            queue.Submit(GetSortKey(draws[i]), static_cast<uint32_t>(i));
+        }
+        queue.Sort();
+
+        for (size_t i = 1; i < size; i++)
+        {
+            const TestDraw &previous = draws[queue[i - 1].drawIndex];
+            const TestDraw &draw = draws[queue[i].drawIndex];
+            CHECK(previous.pass <= draw.pass);
+            if (previous.pass != draw.pass)
+            {
+                continue;
+            }
+            if (draw.pass == RENDER_PASS_TRANSLUCENT)
+            {
+                CHECK(previous.depth >= draw.depth);
+            }
+            else if (previous.texture == draw.texture && previous.mesh == draw.mesh)
+            {
+                CHECK(previous.depth <= draw.depth);
+            }
+            else
+            {
+                CHECK(previous.texture < draw.texture || (previous.texture == draw.texture && previous.mesh < draw.mesh));
+            }
+        }
+    }
+}
+
+// Sorting the opaque draws by state binds each texture once and each mesh
+// at most once per texture
+static void TestStateChanges()
+{
+    const uint32_t textures = 4;
+    const uint32_t meshes = 3;
+    const size_t sizes[] = { 24, 200 };
+    for (size_t size : sizes)
+    {
+        std::vector<TestDraw> draws;
+        MakeDraws(size, textures, meshes, 5, draws);
+
+        std::vector<uint32_t> submitted;
+        RenderQueue queue;
+        for (size_t i = 0; i < size; i++)
+        {
+            submitted.push_back(static_cast<uint32_t>(i));
+            queue.Submit(GetSortKey(draws[i]), static_cast<uint32_t>(i));
+        }
+        queue.Sort();
+
+        std::vector<uint32_t> sorted;
+        std::vector<TestDraw> opaqueDraws;
+        for (const auto &packet : queue)
+        {
+            sorted.push_back(packet.drawIndex);
+            if (RenderQueue::GetPass(packet.sortKey) == RENDER_PASS_OPAQUE)
+            {
+                opaqueDraws.push_back(draws[packet.drawIndex]);
+            }
+        }
+
+        uint32_t submittedChanges = CountStateChanges(draws, submitted);
+        uint32_t sortedChanges = CountStateChanges(draws, sorted);
+        printf("  %u draws: %u state changes in submission order, %u sorted\n",
+            static_cast<uint32_t>(size), submittedChanges, sortedChanges);
+        CHECK(sortedChanges < submittedChanges);
+
+        std::vector<uint32_t> opaqueOrder;
+        for (uint32_t i = 0; i < opaqueDraws.size(); i++)
+        {
+            opaqueOrder.push_back(i);
+        }
+        CHECK(CountStateChanges(opaqueDraws, opaqueOrder) <= 1 + textures + textures * meshes);
+    }
+}
+
+int main()
+{
+    SampleTests::RunTest("sort matches a stable sort", TestSortMatchesStableSort);
+    SampleTests::RunTest("key ordering", TestKeyOrdering);
+    SampleTests::RunTest("state changes", TestStateChanges);
+    return SampleTests::Result();
+}
@@ -0,0 +1,307 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "Reprojection.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace SampleCommon;
+
+// A camera of about 60 degrees, looking down +z, in the row-major layout
+// Reprojection reads: rows x, y and w of clip space
+static const float PROJECTION[16] = {
+    1.7f, 0.0f, 0.05f, 0.0f,
+    0.0f, 2.2f, -0.03f, 0.0f,
+    0.0f, 0.0f, 1.0f, -10.0f,
+    0.0f, 0.0f, 1.0f, 0.0f
+};
+
+// Target plane points, in millimeters
+static const float PLANE_POINTS[][2] = {
+    { 0.0f, 0.0f }, { 50.0f, 30.0f }, { -80.0f, 60.0f }, { 70.0f, -90.0f }, { -40.0f, -20.0f }
+};
+
+// pose = [R | t] with R = exp(rotation) by Rodrigues' formula
+static void MakePose(const double rotation[3], const double translation[3], float pose[12])
+{
+    double theta = sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2]);
+    double axis[3] = { 1.0, 0.0, 0.0 };
+    if (theta > 0.0)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            axis[i] = rotation[i] / theta;
+        }
+    }
+    double c = cos(theta);
+    double s = sin(theta);
+    double k[9] = {
+        0.0, -axis[2], axis[1],
+        axis[2], 0.0, -axis[0],
+        -axis[1], axis[0], 0.0
+    };
+    for (int r = 0; r < 3; r++)
+    {
+        for (int col = 0; col < 3; col++)
+        {
+            double kk = k[r * 3] * k[col] + k[r * 3 + 1] * k[3 + col] + k[r * 3 + 2] * k[6 + col];
+            pose[r * 4 + col] = static_cast<float>(((r == col) ? 1.0 : 0.0) + s * k[r * 3 + col] + (1.0 - c) * kk);
+        }
+        pose[r * 4 + 3] = static_cast<float>(translation[r]);
+    }
+}
+
+// Projects a camera space point to normalized device coordinates
+static bool ProjectCameraPoint(const double point[3], float &x, float &y)
+{
+    double clip[4];
+    for (int r = 0; r < 4; r++)
+    {
+        clip[r] = PROJECTION[r * 4] * point[0] + PROJECTION[r * 4 + 1] * point[1] + PROJECTION[r * 4 + 2] * point[2] + PROJECTION[r * 4 + 3];
+    }
+    if (clip[3] <= 0.0)
+    {
+        return false;
+    }
+    x = static_cast<float>(clip[0] / clip[3]);
+    y = static_cast<float>(clip[1] / clip[3]);
+    return true;
+}
+
+static void TransformByPose(const float pose[12], const double point[3], double result[3])
+{
+    for (int r = 0; r < 3; r++)
+    {
+        result[r] = pose[r * 4] * point[0] + pose[r * 4 + 1] * point[1] + pose[r * 4 + 2] * point[2] + pose[r * 4 + 3];
+    }
+}
+
+// The homographies are defined up to scale, and normalized for their
+// largest entry to be one
+static void CheckHomographiesEqual(const float a[9], const double b[9])
+{
+    double scale = 0.0;
+    for (int i = 0; i < 9; i++)
+    {
+        scale = (std::max)(scale, std::fabs(b[i]));
+    }
+    for (int i = 0; i < 9; i++)
+    {
+        CHECK_NEAR(a[i], b[i] / scale, 1e-4);
+    }
+}
+
+static void TestIdenticalPoses()
+{
+    const double rotation[3] = { 0.2, -0.3, 0.1 };
+    const double translation[3] = { 20.0, -10.0, 350.0 };
+    float pose[12];
+    MakePose(rotation, translation, pose);
+
+    float identity[9];
+    Reprojection::Identity(identity);
+
+    float homography[9];
+    CHECK(Reprojection::ComputePlanarHomography(PROJECTION, pose, pose, homography));
+    for (int i = 0; i < 9; i++)
+    {
+        CHECK_NEAR(homography[i], identity[i], 1e-5);
+    }
+    CHECK(Reprojection::ComputeRotationalHomography(PROJECTION, pose, pose, homography));
+    for (int i = 0; i < 9; i++)
+    {
+        CHECK_NEAR(homography[i], identity[i], 1e-5);
+    }
+}
+
+// A point of the target plane, where it is displayed, maps to where it was
+// rendered
+static void TestPlanarHomography()
+{
+    const double renderedRotation[3] = { 0.3, -0.2, 0.05 };
+    const double renderedTranslation[3] = { 30.0, -20.0, 400.0 };
+    const double displayedRotation[3] = { 0.34, -0.15, 0.08 };
+    const double displayedTranslation[3] = { 42.0, -12.0, 385.0 };
+    float rendered[12], displayed[12];
+    MakePose(renderedRotation, renderedTranslation, rendered);
+    MakePose(displayedRotation, displayedTranslation, displayed);
+
+    float homography[9];
+    CHECK(Reprojection::ComputePlanarHomography(PROJECTION, rendered, displayed, homography));
+    for (const auto &planePoint : PLANE_POINTS)
+    {
+        const double point[3] = { planePoint[0], planePoint[1], 0.0 };
+        double renderedCamera[3], displayedCamera[3];
+        TransformByPose(rendered, point, renderedCamera);
+        TransformByPose(displayed, point, displayedCamera);
+
+        float renderedX, renderedY, displayedX, displayedY, x, y;
+        CHECK(ProjectCameraPoint(renderedCamera, renderedX, renderedY));
+        CHECK(ProjectCameraPoint(displayedCamera, displayedX, displayedY));
+        CHECK(Reprojection::TransformPoint(homography, displayedX, displayedY, x, y));
+        CHECK_NEAR(x, renderedX, 1e-4f);
+        CHECK_NEAR(y, renderedY, 1e-4f);
+    }
+
+    // Edge on: the target plane goes through the camera
+    const double edgeOnRotation[3] = { 1.5707963, 0.0, 0.0 };
+    const double edgeOnTranslation[3] = { 0.0, 0.0, 300.0 };
+    float edgeOn[12];
+    MakePose(edgeOnRotation, edgeOnTranslation, edgeOn);
+    CHECK(!Reprojection::ComputePlanarHomography(PROJECTION, rendered, edgeOn, homography));
+    CHECK(!Reprojection::ComputePlanarHomography(PROJECTION, edgeOn, displayed, homography));
+}
+
+// Between poses differing by a rotation of the camera, the homography is
+// K Rr Rd^T K^-1, and maps points at any depth
+static void TestPureRotation()
+{
+    const double renderedRotation[3] = { 0.1, 0.4, -0.2 };
+    const double translation[3] = { -15.0, 25.0, 300.0 };
+    float rendered[12];
+    MakePose(renderedRotation, translation, rendered);
+
+    // displayed = [C | 0] * rendered, for a camera rotation C
+    const double cameraRotation[3] = { -0.03, 0.05, 0.02 };
+    const double none[3] = { 0.0, 0.0, 0.0 };
+    float camera[12], displayed[12];
+    MakePose(cameraRotation, none, camera);
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            double value = 0.0;
+            for (int k = 0; k < 3; k++)
+            {
+                value += static_cast<double>(camera[r * 4 + k]) * rendered[k * 4 + c];
+            }
+            displayed[r * 4 + c] = static_cast<float>(value);
+        }
+    }
+
+    float homography[9];
+    CHECK(Reprojection::ComputeRotationalHomography(PROJECTION, rendered, displayed, homography));
+
+    // K, the projection's rows x, y and w without the translation column
+    const double k[9] = {
+        PROJECTION[0], PROJECTION[1], PROJECTION[2],
+        PROJECTION[4], PROJECTION[5], PROJECTION[6],
+        PROJECTION[12], PROJECTION[13], PROJECTION[14]
+    };
+    float kFloat[9], kInverseFloat[9];
+    for (int i = 0; i < 9; i++)
+    {
+        kFloat[i] = static_cast<float>(k[i]);
+    }
+    CHECK(Reprojection::Invert(kFloat, kInverseFloat));
+
+    double expected[9];
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            // (K Rr Rd^T K^-1)[r][c]
+            double value = 0.0;
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    double rotation = 0.0;
+                    for (int n = 0; n < 3; n++)
+                    {
+                        rotation += static_cast<double>(rendered[i * 4 + n]) * displayed[j * 4 + n];
+                    }
+                    value += k[r * 3 + i] * rotation * kInverseFloat[j * 3 + c];
+                }
+            }
+            expected[r * 3 + c] = value;
+        }
+    }
+    CheckHomographiesEqual(homography, expected);
+
+    // Points near and far, on the plane or not
+    const double points[][3] = { { 0.0, 0.0, 0.0 }, { 40.0, -30.0, 100.0 }, { -500.0, 200.0, 5000.0 } };
+    for (const auto &point : points)
+    {
+        double renderedCamera[3], displayedCamera[3];
+        TransformByPose(rendered, point, renderedCamera);
+        TransformByPose(displayed, point, displayedCamera);
+
+        float renderedX, renderedY, displayedX, displayedY, x, y;
+        CHECK(ProjectCameraPoint(renderedCamera, renderedX, renderedY));
+        CHECK(ProjectCameraPoint(displayedCamera, displayedX, displayedY));
+        CHECK(Reprojection::TransformPoint(homography, displayedX, displayedY, x, y));
+        CHECK_NEAR(x, renderedX, 1e-4f);
+        CHECK_NEAR(y, renderedY, 1e-4f);
+    }
+}
+
+static void TestDegenerateInput()
+{
+    float result[9];
+    const float zero[9] = { 0.0f };
+    CHECK(!Reprojection::Invert(zero, result));
+
+    // The third row is the sum of the first two
+    const float singular[9] = { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 5.0f, 7.0f, 9.0f };
+    CHECK(!Reprojection::Invert(singular, result));
+
+    // The same at a small scale, as in scene units of meters, where the
+    // determinant is tiny either way
+    float scaled[9];
+    for (int i = 0; i < 9; i++)
+    {
+        scaled[i] = singular[i] / 1024.0f;
+    }
+    CHECK(!Reprojection::Invert(scaled, result));
+
+    const float regular[9] = { 2.0f, 0.0f, 1.0f, 1.0f, 3.0f, 0.0f, 0.0f, 1.0f, 4.0f };
+    CHECK(Reprojection::Invert(regular, result));
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            float value = regular[r * 3] * result[c] + regular[r * 3 + 1] * result[3 + c] + regular[r * 3 + 2] * result[6 + c];
+            CHECK_NEAR(value, (r == c) ? 1.0f : 0.0f, 1e-5f);
+        }
+    }
+    for (int i = 0; i < 9; i++)
+    {
+        scaled[i] = regular[i] / 1024.0f;
+    }
+    CHECK(Reprojection::Invert(scaled, result));
+
+    // A projection that can't be inverted has no rotational homography
+    float pose[12];
+    const double rotation[3] = { 0.0, 0.0, 0.0 };
+    const double translation[3] = { 0.0, 0.0, 300.0 };
+    MakePose(rotation, translation, pose);
+    float flat[16] = { 0.0f };
+    float homography[9];
+    CHECK(!Reprojection::ComputeRotationalHomography(flat, pose, pose, homography));
+
+    // Points mapping to infinity or behind the camera
+    float x = 0.0f;
+    float y = 0.0f;
+    const float toInfinity[9] = { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    CHECK(!Reprojection::TransformPoint(toInfinity, 0.0f, 0.5f, x, y));
+    const float behind[9] = { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, -1.0f };
+    CHECK(!Reprojection::TransformPoint(behind, 0.3f, 0.5f, x, y));
+    CHECK(Reprojection::TransformPoint(toInfinity, 2.0f, 0.5f, x, y));
+    CHECK_NEAR(x, 1.0f, 1e-6f);
+    CHECK_NEAR(y, 0.25f, 1e-6f);
+}
+
+int main()
+{
+    SampleTests::RunTest("identical poses", TestIdenticalPoses);
+    SampleTests::RunTest("planar homography", TestPlanarHomography);
+    SampleTests::RunTest("pure rotation", TestPureRotation);
+    SampleTests::RunTest("degenerate input", TestDegenerateInput);
+    return SampleTests::Result();
+}
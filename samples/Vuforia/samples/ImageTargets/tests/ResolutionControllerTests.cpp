@@ -0,0 +1,147 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "ResolutionController.h"
+
+#include <cmath>
+
+using namespace SampleCommon;
+
+// A pass whose time goes with the pixels drawn, fullMilliseconds at scale 1
+static double PassMilliseconds(double fullMilliseconds, float scale)
+{
+    return fullMilliseconds * scale * scale;
+}
+
+// Replays a load on the controller for a number of passes; returns the
+// number of the pass at which the scale first changed, or -1
+static int Run(ResolutionController &controller, double fullMilliseconds, int passes)
+{
+    int firstChange = -1;
+    for (int pass = 0; pass < passes; pass++)
+    {
+        float before = controller.GetScale();
+        controller.Update(PassMilliseconds(fullMilliseconds, before));
+        if (firstChange < 0 && controller.GetScale() != before)
+        {
+            firstChange = pass;
+        }
+    }
+    return firstChange;
+}
+
+static void TestStepDownUnderOverrun()
+{
+    ResolutionControllerSettings settings = ResolutionController::GetDefaultSettings();
+    ResolutionController controller(settings);
+
+    // Twice the budget at full resolution
+    int firstChange = Run(controller, 2.0 * settings.targetMilliseconds, 300);
+    float scale = controller.GetScale();
+    double milliseconds = PassMilliseconds(2.0 * settings.targetMilliseconds, scale);
+    printf("  settled at %.2f, %.2f ms, first change after %d passes\n", scale, milliseconds, firstChange + 1);
+
+    CHECK(firstChange >= 0 && firstChange < 20);
+    CHECK(scale < 1.0f);
+    CHECK(scale >= settings.minScale);
+    CHECK(milliseconds <= settings.targetMilliseconds * (1.0 + settings.deadband) + 0.5);
+
+    // Each change is a whole step
+    float steps = scale / settings.scaleStep;
+    CHECK_NEAR(steps, std::floor(steps + 0.5f), 1e-3f);
+
+    // Settled, it doesn't flicker
+    uint32_t changes = controller.GetStats().scaleChanges;
+    Run(controller, 2.0 * settings.targetMilliseconds, 100);
+    CHECK(controller.GetStats().scaleChanges == changes);
+}
+
+static void TestSingleSlowPass()
+{
+    ResolutionControllerSettings settings = ResolutionController::GetDefaultSettings();
+    ResolutionController controller(settings);
+
+    for (int pass = 0; pass < 100; pass++)
+    {
+        // Every tenth pass takes four times as long
+        double milliseconds = (pass % 10 == 5) ? 4.0 * settings.targetMilliseconds : settings.targetMilliseconds;
+        controller.Update(milliseconds);
+    }
+
+    CHECK(controller.GetScale() == 1.0f);
+    CHECK(controller.GetStats().scaleChanges == 0);
+}
+
+static void TestDeadband()
+{
+    ResolutionControllerSettings settings = ResolutionController::GetDefaultSettings();
+
+    // Just inside the deadband, over the budget
+    ResolutionController over(settings);
+    Run(over, settings.targetMilliseconds * (1.0 + 0.9 * settings.deadband), 200);
+    CHECK(over.GetScale() == 1.0f);
+    CHECK(over.GetStats().lastError == 0.0);
+
+    // And under it, after stepping down
+    ResolutionController under(settings);
+    Run(under, 2.0 * settings.targetMilliseconds, 300);
+    uint32_t changes = under.GetStats().scaleChanges;
+    float scale = under.GetScale();
+    double milliseconds = settings.targetMilliseconds * (1.0 - 0.9 * settings.deadband);
+    for (int pass = 0; pass < 200; pass++)
+    {
+        under.Update(milliseconds);
+    }
+    CHECK(under.GetScale() == scale);
+    CHECK(under.GetStats().scaleChanges == changes);
+}
+
+static void TestClampWithoutWindup()
+{
+    ResolutionControllerSettings settings = ResolutionController::GetDefaultSettings();
+    ResolutionController controller(settings);
+
+    // Far over the budget even at the lowest scale, for a long time
+    Run(controller, 20.0 * settings.targetMilliseconds, 500);
+    CHECK(controller.GetScale() == settings.minScale);
+
+    // Once the load is gone, the scale goes up without first unwinding
+    int firstChange = Run(controller, 0.5 * settings.targetMilliseconds, 50);
+    printf("  up from the lowest scale after %d passes\n", firstChange + 1);
+    CHECK(firstChange >= 0 && firstChange < 10);
+
+    // Likewise at the highest scale, far under the budget for a long time
+    controller.Reset();
+    Run(controller, 0.1 * settings.targetMilliseconds, 500);
+    CHECK(controller.GetScale() == settings.maxScale);
+    firstChange = Run(controller, 2.0 * settings.targetMilliseconds, 50);
+    printf("  down from the highest scale after %d passes\n", firstChange + 1);
+    CHECK(firstChange >= 0 && firstChange < 10);
+}
+
+static void TestRecovery()
+{
+    ResolutionControllerSettings settings = ResolutionController::GetDefaultSettings();
+    ResolutionController controller(settings);
+
+    Run(controller, 3.0 * settings.targetMilliseconds, 300);
+    CHECK(controller.GetScale() < 1.0f);
+
+    // The load that made it step down is gone
+    Run(controller, 0.6 * settings.targetMilliseconds, 300);
+    CHECK(controller.GetScale() == 1.0f);
+}
+
+int main()
+{
+    SampleTests::RunTest("step down under a sustained overrun", TestStepDownUnderOverrun);
+    SampleTests::RunTest("single slow pass", TestSingleSlowPass);
+    SampleTests::RunTest("deadband", TestDeadband);
+    SampleTests::RunTest("clamp without windup", TestClampWithoutWindup);
+    SampleTests::RunTest("recovery", TestRecovery);
+    return SampleTests::Result();
+}
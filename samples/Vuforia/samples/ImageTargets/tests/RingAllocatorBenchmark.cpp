@@ -0,0 +1,55 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "RingAllocator.h"
+
+#include <cstdlib>
+
+using namespace SampleCommon;
+
+// Throughput of the ring bookkeeping with the ImageTargets settings: a
+// 1 MB ring of 256 byte constant slices, frames retired 2 frames late
+int main(int argc, char **argv)
+{
+    const int frames = (argc > 1) ? atoi(argv[1]) : 200000;
+    const int drawsPerFrame[] = { 4, 64, 1024 };
+
+    for (int draws : drawsPerFrame)
+    {
+        RingAllocator ring(1024 * 1024, 256);
+        uint32_t offset;
+        bool wrapped;
+        uint64_t checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 1; frame <= frames; frame++)
+        {
+            for (int draw = 0; draw < draws; draw++)
+            {
+                if (ring.Allocate(256, offset, wrapped))
+                {
+                    checksum += offset;
+                }
+            }
+            ring.EndFrame(frame);
+            if (frame > 2)
+            {
+                ring.Retire(frame - 2);
+            }
+        }
+        double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+
+        const RingAllocatorStats &stats = ring.GetStats();
+        printf("%4d draws/frame: %.1f ns/allocation, %.0f M allocations/s, %llu wraps, %llu failed (checksum %llu)\n",
+            draws, milliseconds * 1e6 / (static_cast<double>(frames) * draws),
+            frames * static_cast<double>(draws) / milliseconds / 1e3,
+            static_cast<unsigned long long>(stats.wraps),
+            static_cast<unsigned long long>(stats.failedAllocations),
+            static_cast<unsigned long long>(checksum));
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "RingAllocator.h"
+
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+using namespace SampleCommon;
+
+static void TestAlignment()
+{
+    RingAllocator ring(1024, 256);
+    uint32_t offset = 1;
+    bool wrapped = true;
+
+    CHECK(ring.Allocate(1, offset, wrapped));
+    CHECK(offset == 0 && !wrapped);
+    CHECK(ring.Allocate(257, offset, wrapped));
+    CHECK(offset == 256);
+    CHECK(ring.GetUsedBytes() == 768);
+    CHECK(ring.GetStats().allocatedBytes == 768);
+}
+
+static void TestFullAndInvalid()
+{
+    RingAllocator ring(1024, 256);
+    uint32_t offset;
+    bool wrapped;
+
+    for (int i = 0; i < 4; i++)
+    {
+        CHECK(ring.Allocate(256, offset, wrapped));
+    }
+    CHECK(!ring.Allocate(1, offset, wrapped));
+    CHECK(!ring.Allocate(0, offset, wrapped));
+    CHECK(ring.GetStats().failedAllocations == 2);
+
+    RingAllocator small(1024, 16);
+    CHECK(!small.Allocate(1025, offset, wrapped));
+}
+
+static void TestFenceRetire()
+{
+    RingAllocator ring(1024, 1);
+    uint32_t offset;
+    bool wrapped;
+
+    CHECK(ring.Allocate(1024, offset, wrapped));
+    ring.EndFrame(1);
+    CHECK(!ring.Allocate(1, offset, wrapped));
+
+    // Not reclaimed before its fence
+    ring.Retire(0);
+    CHECK(!ring.Allocate(1, offset, wrapped));
+
+    // Once nothing is in flight the ring restarts at 0 without wrapping
+    ring.Retire(1);
+    CHECK(ring.GetUsedBytes() == 0);
+    CHECK(ring.Allocate(100, offset, wrapped));
+    CHECK(offset == 0 && !wrapped);
+    CHECK(ring.GetStats().wraps == 0);
+}
+
+static void TestWrap()
+{
+    RingAllocator ring(1024, 1);
+    uint32_t offset;
+    bool wrapped;
+
+    CHECK(ring.Allocate(600, offset, wrapped));
+    ring.EndFrame(1);
+    CHECK(ring.Allocate(300, offset, wrapped));
+    CHECK(offset == 600);
+    ring.EndFrame(2);
+    ring.Retire(1);
+
+    // 124 bytes are left at the end, the allocation restarts at 0 and the
+    // padding is charged to its frame
+    CHECK(ring.Allocate(200, offset, wrapped));
+    CHECK(offset == 0 && wrapped);
+    CHECK(ring.GetUsedBytes() == 300 + 124 + 200);
+    CHECK(ring.GetStats().wraps == 1);
+
+    // Doesn't reach into the frame still in flight at [600, 900)
+    CHECK(ring.Allocate(400, offset, wrapped));
+    CHECK(offset == 200);
+    CHECK(!ring.Allocate(1, offset, wrapped));
+    ring.EndFrame(3);
+
+    ring.Retire(2);
+    CHECK(ring.GetUsedBytes() == 124 + 200 + 400);
+    ring.Retire(3);
+    CHECK(ring.GetUsedBytes() == 0);
+}
+
+static void TestEmptyFrame()
+{
+    RingAllocator ring(1024, 1);
+    uint32_t offset;
+    bool wrapped;
+
+    // A frame without allocations holds nothing back
+    ring.EndFrame(1);
+    CHECK(ring.Allocate(1024, offset, wrapped));
+    ring.EndFrame(2);
+    ring.Retire(2);
+    CHECK(ring.GetUsedBytes() == 0);
+}
+
+// Random frames retired a few frames late: no allocation may overlap one
+// of a frame still in flight, and all memory comes back
+static void TestReuseUnderLoad()
+{
+    const uint32_t capacity = 64 * 1024;
+    const int framesInFlight = 3;
+    RingAllocator ring(capacity, 256);
+
+    struct Range { uint32_t begin; uint32_t end; uint64_t fence; };
+    std::deque<Range> live;
+    srand(1);
+
+    uint64_t fence = 0;
+    for (int frame = 0; frame < 5000; frame++)
+    {
+        fence++;
+        int count = rand() % 40;
+        for (int i = 0; i < count; i++)
+        {
+            uint32_t size = 1 + rand() % 2000;
+            uint32_t offset;
+            bool wrapped;
+            if (!ring.Allocate(size, offset, wrapped))
+            {
+                continue;
+            }
+
+            CHECK(offset % 256 == 0);
+            uint32_t end = offset + (size + 255) / 256 * 256;
+            CHECK(end <= capacity);
+            for (const Range &range : live)
+            {
+                CHECK(end <= range.begin || offset >= range.end);
+            }
+            Range range = { offset, end, fence };
+            live.push_back(range);
+        }
+        ring.EndFrame(fence);
+
+        if (fence > framesInFlight)
+        {
+            uint64_t completed = fence - framesInFlight;
+            ring.Retire(completed);
+            while (!live.empty() && live.front().fence <= completed)
+            {
+                live.pop_front();
+            }
+        }
+    }
+
+    ring.Retire(fence);
+    CHECK(ring.GetUsedBytes() == 0);
+    CHECK(ring.GetStats().wraps > 0);
+}
+
+static void TestReset()
+{
+    RingAllocator ring(1024, 1);
+    uint32_t offset;
+    bool wrapped;
+
+    CHECK(ring.Allocate(1000, offset, wrapped));
+    ring.EndFrame(1);
+    ring.Reset();
+    CHECK(ring.GetUsedBytes() == 0);
+    CHECK(ring.Allocate(1024, offset, wrapped));
+    CHECK(offset == 0);
+}
+
+int main()
+{
+    SampleTests::RunTest("RingAllocator alignment", TestAlignment);
+    SampleTests::RunTest("RingAllocator full and invalid sizes", TestFullAndInvalid);
+    SampleTests::RunTest("RingAllocator fence retire", TestFenceRetire);
+    SampleTests::RunTest("RingAllocator wrap", TestWrap);
+    SampleTests::RunTest("RingAllocator empty frame", TestEmptyFrame);
+    SampleTests::RunTest("RingAllocator reuse under load", TestReuseUnderLoad);
+    SampleTests::RunTest("RingAllocator reset", TestReset);
+    return SampleTests::Result();
+}
@@ -0,0 +1,78 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "SampleMath.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace SampleCommon;
+
+typedef void (*MultiplyFunction)(const float a[16], const float b[16], float result[16]);
+
+// Like a frame of the pose batch: a product per augmentation, into an array
+static const int BATCH_SIZE = 256;
+
+static double NanosecondsPerCall(MultiplyFunction multiply, const std::vector<float> &a,
+    const std::vector<float> &b, int calls, float &checksum)
+{
+    std::vector<float> results(BATCH_SIZE * 16);
+    int batches = (std::max)(1, calls / BATCH_SIZE);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int batch = 0; batch < batches; batch++)
+    {
+        for (int i = 0; i < BATCH_SIZE; i++)
+        {
+            multiply(&a[i * 16], &b[i * 16], &results[i * 16]);
+        }
+        checksum += results[batch % (BATCH_SIZE * 16)];
+    }
+    double milliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+    return milliseconds * 1e6 / (static_cast<double>(batches) * BATCH_SIZE);
+}
+
+// Time of the SIMD backend against the scalar references, per matrix
+// product, as spent building a model-view-projection per augmentation
+int main(int argc, char **argv)
+{
+    const int calls = (argc > 1) ? atoi(argv[1]) : 10000000;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> a(BATCH_SIZE * 16);
+    std::vector<float> b(BATCH_SIZE * 16);
+    for (int i = 0; i < BATCH_SIZE * 16; i++)
+    {
+        a[i] = distribution(random);
+        b[i] = distribution(random);
+    }
+
+    // MultiplyMatrix34 only reads the first 12 elements
+    const struct
+    {
+        const char *name;
+        MultiplyFunction simd;
+        MultiplyFunction scalar;
+    } products[] = {
+        { "Multiply", SampleMath::Multiply, SampleMath::MultiplyScalar },
+        { "MultiplyMatrix34", SampleMath::MultiplyMatrix34, SampleMath::MultiplyMatrix34Scalar },
+    };
+
+    float checksum = 0.0f;
+    for (const auto &product : products)
+    {
+        double simd = NanosecondsPerCall(product.simd, a, b, calls, checksum);
+        double scalar = NanosecondsPerCall(product.scalar, a, b, calls, checksum);
+        printf("%-16s %s %.2f ns, scalar %.2f ns, %.2fx\n",
+            product.name, SampleMath::GetBackendName(), simd, scalar, scalar / simd);
+    }
+    printf("(checksum %g)\n", checksum);
+    return 0;
+}
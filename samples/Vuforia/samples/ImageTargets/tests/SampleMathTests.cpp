@@ -0,0 +1,175 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "SampleMath.h"
+
+#include <cstring>
+#include <random>
+
+using namespace SampleCommon;
+
+// The SIMD backends sum the same products in another order
+static const float TOLERANCE = 1e-5f;
+static const int RANDOM_MATRICES = 10000;
+
+static void RandomMatrix(std::mt19937 &random, float *matrix, int count)
+{
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (int i = 0; i < count; i++)
+    {
+        matrix[i] = distribution(random);
+    }
+}
+
+static bool Near(const float a[16], const float b[16])
+{
+    for (int i = 0; i < 16; i++)
+    {
+        if (std::fabs(a[i] - b[i]) > TOLERANCE)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void TestMultiplyMatchesScalar()
+{
+    std::mt19937 random(1);
+    int mismatches = 0;
+    for (int i = 0; i < RANDOM_MATRICES; i++)
+    {
+        float a[16], b[16], result[16], expected[16];
+        RandomMatrix(random, a, 16);
+        RandomMatrix(random, b, 16);
+
+        SampleMath::Multiply(a, b, result);
+        SampleMath::MultiplyScalar(a, b, expected);
+        mismatches += Near(result, expected) ? 0 : 1;
+    }
+    CHECK(mismatches == 0);
+}
+
+static void TestMultiplyScalarReference()
+{
+    // Row-major, applied to column vectors: the translation of a is applied after b
+    const float a[16] = {
+        1, 0, 0, 5,
+        0, 1, 0, 6,
+        0, 0, 1, 7,
+        0, 0, 0, 1 };
+    const float b[16] = {
+        2, 0, 0, 0,
+        0, 3, 0, 0,
+        0, 0, 4, 0,
+        0, 0, 0, 1 };
+    const float expected[16] = {
+        2, 0, 0, 5,
+        0, 3, 0, 6,
+        0, 0, 4, 7,
+        0, 0, 0, 1 };
+
+    float result[16];
+    SampleMath::MultiplyScalar(a, b, result);
+    CHECK(memcmp(result, expected, sizeof(expected)) == 0);
+    SampleMath::Multiply(a, b, result);
+    CHECK(Near(result, expected));
+}
+
+static void TestMultiplyAliasing()
+{
+    std::mt19937 random(2);
+    float a[16], b[16], expected[16], aliased[16];
+    RandomMatrix(random, a, 16);
+    RandomMatrix(random, b, 16);
+    SampleMath::MultiplyScalar(a, b, expected);
+
+    memcpy(aliased, a, sizeof(a));
+    SampleMath::Multiply(aliased, b, aliased);
+    CHECK(Near(aliased, expected));
+
+    memcpy(aliased, b, sizeof(b));
+    SampleMath::Multiply(a, aliased, aliased);
+    CHECK(Near(aliased, expected));
+}
+
+static void TestMultiplyMatrix34MatchesScalar()
+{
+    std::mt19937 random(3);
+    int mismatches = 0;
+    int extendedMismatches = 0;
+    for (int i = 0; i < RANDOM_MATRICES; i++)
+    {
+        float pose[12], b[16], result[16], expected[16];
+        RandomMatrix(random, pose, 12);
+        RandomMatrix(random, b, 16);
+
+        SampleMath::MultiplyMatrix34(pose, b, result);
+        SampleMath::MultiplyMatrix34Scalar(pose, b, expected);
+        mismatches += Near(result, expected) ? 0 : 1;
+
+        // The same as extending the pose first
+        float pose44[16], extended[16];
+        SampleMath::FromMatrix34(pose, pose44);
+        SampleMath::MultiplyScalar(pose44, b, extended);
+        extendedMismatches += Near(result, extended) ? 0 : 1;
+    }
+    CHECK(mismatches == 0);
+    CHECK(extendedMismatches == 0);
+}
+
+static void TestMultiplyMatrix34Aliasing()
+{
+    std::mt19937 random(4);
+    float pose[12], b[16], expected[16];
+    RandomMatrix(random, pose, 12);
+    RandomMatrix(random, b, 16);
+    SampleMath::MultiplyMatrix34Scalar(pose, b, expected);
+
+    SampleMath::MultiplyMatrix34(pose, b, b);
+    CHECK(Near(b, expected));
+}
+
+static void TestConversions()
+{
+    float matrix[16];
+    for (int i = 0; i < 16; i++)
+    {
+        matrix[i] = static_cast<float>(i);
+    }
+
+    float transposed[16];
+    SampleMath::Transpose(matrix, transposed);
+    for (int row = 0; row < 4; row++)
+    {
+        for (int column = 0; column < 4; column++)
+        {
+            CHECK(transposed[row * 4 + column] == matrix[column * 4 + row]);
+        }
+    }
+
+    // A column-major matrix is the transpose of the row-major one
+    float converted[16];
+    SampleMath::FromGLMatrix(matrix, converted);
+    CHECK(memcmp(converted, transposed, sizeof(converted)) == 0);
+
+    SampleMath::FromMatrix34(matrix, converted);
+    CHECK(memcmp(converted, matrix, 12 * sizeof(float)) == 0);
+    CHECK(converted[12] == 0 && converted[13] == 0 && converted[14] == 0 && converted[15] == 1);
+}
+
+int main()
+{
+    printf("SampleMath backend: %s\n", SampleMath::GetBackendName());
+    SampleTests::RunTest("SampleMath Multiply matches the scalar reference", TestMultiplyMatchesScalar);
+    SampleTests::RunTest("SampleMath Multiply order", TestMultiplyScalarReference);
+    SampleTests::RunTest("SampleMath Multiply aliasing", TestMultiplyAliasing);
+    SampleTests::RunTest("SampleMath MultiplyMatrix34 matches the scalar reference", TestMultiplyMatrix34MatchesScalar);
+    SampleTests::RunTest("SampleMath MultiplyMatrix34 aliasing", TestMultiplyMatrix34Aliasing);
+    SampleTests::RunTest("SampleMath conversions", TestConversions);
+    return SampleTests::Result();
+}
@@ -0,0 +1,314 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "SessionLifecycle.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+using namespace SampleCommon;
+
+static const uint32_t INITIALIZE_MILLISECONDS = 30;
+static const uint32_t CAMERA_START_MILLISECONDS = 20;
+static const uint32_t CAMERA_STOP_MILLISECONDS = 5;
+static const uint32_t IDLE_TIMEOUT_MILLISECONDS = 5000;
+static const int STORM_EVENTS = 50;
+
+// Stands in for the SDK: takes about as long as a camera does, relative to
+// each other, and logs the calls it gets
+class MockSessionHandler : public SessionHandler
+{
+public:
+    MockSessionHandler() :
+        failInitialize(false),
+        failCameraStart(false),
+        m_cameraStarts(0),
+        m_cameraStops(0)
+    {
+    }
+
+    virtual bool InitializeSession()
+    {
+        Sleep(INITIALIZE_MILLISECONDS);
+        Log("initialize");
+        return !failInitialize;
+    }
+
+    virtual bool StartCamera(int direction)
+    {
+        Sleep(CAMERA_START_MILLISECONDS);
+        m_cameraStarts++;
+        Log("start" + std::to_string(direction));
+        return !failCameraStart;
+    }
+
+    virtual bool StopCamera()
+    {
+        Sleep(CAMERA_STOP_MILLISECONDS);
+        m_cameraStops++;
+        Log("stop");
+        return true;
+    }
+
+    virtual void PauseSession() { Log("pause"); }
+    virtual void ResumeSession() { Log("resume"); }
+
+    virtual bool DeinitializeSession()
+    {
+        Log("deinitialize");
+        return true;
+    }
+
+    virtual void OnSessionStateChanged(SessionState, SessionState state)
+    {
+        Log(std::string("->") + SessionLifecycle::GetStateName(state));
+    }
+
+    // The calls logged since the last time, space separated
+    std::string TakeLog()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::string log;
+        log.swap(m_log);
+        return log;
+    }
+
+    int GetCameraStarts() const { return m_cameraStarts; }
+    int GetCameraStops() const { return m_cameraStops; }
+
+    std::atomic<bool> failInitialize;
+    std::atomic<bool> failCameraStart;
+
+private:
+    static void Sleep(uint32_t milliseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    }
+
+    void Log(const std::string &entry)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_log.empty())
+        {
+            m_log += " ";
+        }
+        m_log += entry;
+    }
+
+    std::mutex m_mutex;
+    std::string m_log;
+    std::atomic<int> m_cameraStarts;
+    std::atomic<int> m_cameraStops;
+};
+
+static void StartSession(SessionLifecycle &lifecycle, MockSessionHandler &handler)
+{
+    lifecycle.Initialize();
+    lifecycle.Start(0);
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(lifecycle.GetState() == SESSION_RUNNING);
+    handler.TakeLog();
+}
+
+static void TestStartAndStop()
+{
+    MockSessionHandler handler;
+    SessionLifecycle lifecycle(&handler, 0);
+
+    lifecycle.Initialize();
+    lifecycle.Start(0);
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(handler.TakeLog() == "->initializing initialize ->ready start0 ->running");
+    CHECK(lifecycle.GetState() == SESSION_RUNNING);
+
+    lifecycle.Deinitialize();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(handler.TakeLog() == "stop deinitialize ->uninitialized");
+    CHECK(lifecycle.GetState() == SESSION_UNINITIALIZED);
+
+    // Posting never waits for a transition
+    auto start = std::chrono::steady_clock::now();
+    lifecycle.Initialize();
+    lifecycle.Start(0);
+    double postMilliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+    CHECK(postMilliseconds < INITIALIZE_MILLISECONDS);
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+}
+
+// The pause and resume latencies of the app, each transition on its own
+static void TestTransitionLatency()
+{
+    MockSessionHandler handler;
+    SessionLifecycle lifecycle(&handler, 0);
+    StartSession(lifecycle, handler);
+
+    for (int i = 0; i < 5; i++)
+    {
+        lifecycle.Pause();
+        CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+        CHECK(lifecycle.GetState() == SESSION_PAUSED);
+        lifecycle.Resume();
+        CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+        CHECK(lifecycle.GetState() == SESSION_RUNNING);
+    }
+
+    SessionLifecycleStats stats = lifecycle.GetStats();
+    const SessionTransitionTiming &pause = stats.transitions[SESSION_COMMAND_PAUSE];
+    const SessionTransitionTiming &resume = stats.transitions[SESSION_COMMAND_RESUME];
+    printf("  pause: mean %.1f ms, max %.1f ms; resume: mean %.1f ms, max %.1f ms\n",
+        pause.meanMilliseconds, pause.maxMilliseconds, resume.meanMilliseconds, resume.maxMilliseconds);
+
+    CHECK(pause.count == 5);
+    CHECK(resume.count == 5);
+    CHECK(pause.meanMilliseconds >= CAMERA_STOP_MILLISECONDS);
+    CHECK(resume.meanMilliseconds >= CAMERA_START_MILLISECONDS);
+    CHECK(resume.maxMilliseconds >= resume.meanMilliseconds);
+    CHECK(stats.commandsCoalesced == 0);
+    CHECK(stats.commandsFailed == 0);
+}
+
+// A burst of pause and resume events costs at most one transition
+static void TestPauseResumeStorm()
+{
+    MockSessionHandler handler;
+    SessionLifecycle lifecycle(&handler, 0);
+    StartSession(lifecycle, handler);
+    int startsBefore = handler.GetCameraStarts();
+
+    // Cancels out entirely
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < STORM_EVENTS; i++)
+    {
+        lifecycle.Pause();
+        lifecycle.Resume();
+    }
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    double stormMilliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+
+    // The first pause may already be running when the rest is posted, and
+    // is then undone by the last resume
+    CHECK(lifecycle.GetState() == SESSION_RUNNING);
+    CHECK(handler.GetCameraStarts() - startsBefore <= 1);
+    CHECK(lifecycle.GetStats().commandsCoalesced >= 2 * STORM_EVENTS - 2);
+    CHECK(stormMilliseconds < 4 * (CAMERA_START_MILLISECONDS + CAMERA_STOP_MILLISECONDS));
+
+    // Ends paused
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < STORM_EVENTS; i++)
+    {
+        lifecycle.Pause();
+        lifecycle.Resume();
+    }
+    lifecycle.Pause();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    stormMilliseconds = SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+    printf("  %d pause and resume events, then a pause: %.1f ms\n", 2 * STORM_EVENTS + 1, stormMilliseconds);
+
+    CHECK(lifecycle.GetState() == SESSION_PAUSED);
+    CHECK(handler.GetCameraStarts() - startsBefore <= 2);
+    CHECK(stormMilliseconds < 4 * (CAMERA_START_MILLISECONDS + CAMERA_STOP_MILLISECONDS));
+}
+
+static void TestStormDuringInitialization()
+{
+    MockSessionHandler handler;
+    SessionLifecycle lifecycle(&handler, 0);
+
+    lifecycle.Initialize();
+    lifecycle.Start(0);
+    for (int i = 0; i < STORM_EVENTS; i++)
+    {
+        lifecycle.Pause();
+        lifecycle.Resume();
+    }
+    lifecycle.Pause();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+
+    CHECK(lifecycle.GetState() == SESSION_PAUSED);
+    CHECK(handler.GetCameraStarts() <= 1);
+    CHECK(handler.GetCameraStops() == handler.GetCameraStarts());
+
+    // A camera switched while paused starts in the new direction on resume
+    handler.TakeLog();
+    lifecycle.Start(1);
+    lifecycle.Resume();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(handler.TakeLog() == "resume start1 ->running");
+    CHECK(lifecycle.GetCameraDirection() == 1);
+}
+
+static void TestFailedResume()
+{
+    MockSessionHandler handler;
+    SessionLifecycle lifecycle(&handler, 0);
+    StartSession(lifecycle, handler);
+
+    lifecycle.Pause();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    handler.TakeLog();
+
+    // The camera doesn't start again: the session is resumed without it
+    handler.failCameraStart = true;
+    lifecycle.Resume();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(handler.TakeLog() == "resume start0 ->ready");
+    CHECK(lifecycle.GetState() == SESSION_READY);
+
+    SessionLifecycleStats stats = lifecycle.GetStats();
+    const SessionTransitionTiming &resume = stats.transitions[SESSION_COMMAND_RESUME];
+    printf("  failed resume: %.1f ms\n", resume.lastMilliseconds);
+    CHECK(stats.commandsFailed == 1);
+    CHECK(resume.count == 1);
+    CHECK(resume.lastMilliseconds >= CAMERA_START_MILLISECONDS);
+
+    // The commands queued behind it are projected again from READY
+    lifecycle.Resume();
+    lifecycle.Stop();
+    lifecycle.Pause();
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(lifecycle.GetState() == SESSION_PAUSED);
+    CHECK(handler.TakeLog() == "pause ->paused");
+
+    // Starting the camera again recovers
+    handler.failCameraStart = false;
+    lifecycle.Resume();
+    lifecycle.Start(0);
+    CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+    CHECK(lifecycle.GetState() == SESSION_RUNNING);
+}
+
+static void TestFailedInitialization()
+{
+    MockSessionHandler handler;
+    handler.failInitialize = true;
+    {
+        SessionLifecycle lifecycle(&handler, 0);
+        lifecycle.Initialize();
+        lifecycle.Start(0);
+        lifecycle.Pause();
+        CHECK(lifecycle.WaitForIdle(IDLE_TIMEOUT_MILLISECONDS));
+        CHECK(lifecycle.GetState() == SESSION_FAILED);
+        CHECK(handler.TakeLog() == "->initializing initialize ->failed");
+        CHECK(handler.GetCameraStarts() == 0);
+
+        // Only deinitializing leaves it; the destructor finishes it
+        lifecycle.Deinitialize();
+    }
+    CHECK(handler.TakeLog() == "deinitialize ->uninitialized");
+}
+
+int main()
+{
+    SampleTests::RunTest("start and stop", TestStartAndStop);
+    SampleTests::RunTest("transition latency", TestTransitionLatency);
+    SampleTests::RunTest("pause and resume storm", TestPauseResumeStorm);
+    SampleTests::RunTest("storm during initialization", TestStormDuringInitialization);
+    SampleTests::RunTest("failed resume", TestFailedResume);
+    SampleTests::RunTest("failed initialization", TestFailedInitialization);
+    return SampleTests::Result();
+}
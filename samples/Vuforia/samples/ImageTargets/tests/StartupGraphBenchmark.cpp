@@ -0,0 +1,182 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "StartupGraph.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace SampleCommon;
+
+// Mocked costs of the startup work, in milliseconds
+static const int SDK_INIT_STEPS = 10;
+static const int SDK_INIT_STEP = 60;
+static const int TRACKER_INIT = 50;
+static const int DATASET_PREFETCH = 150;
+static const int DATASET_LOAD_COLD = 250;
+static const int DATASET_LOAD_PREFETCHED = 100;
+static const int RENDERER_ASSETS = 400;
+static const int SURFACE = 100;
+static const int CAMERA_START = 300;
+
+static const uint32_t STAGE_TIMEOUT_MILLISECONDS = 10000;
+static const int RUNS = 5;
+
+struct ColdStart
+{
+    double cameraMilliseconds;      // until the camera runs
+    double trackingMilliseconds;    // until the dataset is loaded as well
+};
+
+static void Work(int milliseconds)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+static bool InitializeSdk()
+{
+    for (int i = 0; i < SDK_INIT_STEPS; i++)
+    {
+        Work(SDK_INIT_STEP);
+    }
+    return true;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return SampleTests::Milliseconds(start, std::chrono::steady_clock::now());
+}
+
+// The renderer and the window are set up on threads of their own either way
+static void StartUiStages(const std::shared_ptr<StartupTracker> &tracker, std::thread &renderer, std::thread &surface)
+{
+    renderer = std::thread([tracker]()
+    {
+        tracker->Begin(STARTUP_STAGE_RENDERER_ASSETS);
+        Work(RENDERER_ASSETS);
+        tracker->End(STARTUP_STAGE_RENDERER_ASSETS);
+    });
+    surface = std::thread([tracker]()
+    {
+        Work(SURFACE);
+        tracker->End(STARTUP_STAGE_SURFACE);
+    });
+}
+
+// One stage after another, the camera started once the dataset is loaded
+static ColdStart RunSequential()
+{
+    auto tracker = std::make_shared<StartupTracker>();
+    auto start = std::chrono::steady_clock::now();
+    std::thread renderer;
+    std::thread surface;
+    StartUiStages(tracker, renderer, surface);
+
+    tracker->Begin(STARTUP_STAGE_SDK_INIT);
+    InitializeSdk();
+    tracker->End(STARTUP_STAGE_SDK_INIT);
+    tracker->Begin(STARTUP_STAGE_TRACKER_INIT);
+    Work(TRACKER_INIT);
+    tracker->End(STARTUP_STAGE_TRACKER_INIT);
+    tracker->Begin(STARTUP_STAGE_DATASET_LOAD);
+    Work(DATASET_LOAD_COLD);
+    tracker->End(STARTUP_STAGE_DATASET_LOAD);
+
+    tracker->WaitFor(
+        StartupStageBit(STARTUP_STAGE_RENDERER_ASSETS) | StartupStageBit(STARTUP_STAGE_SURFACE),
+        STAGE_TIMEOUT_MILLISECONDS);
+    Work(CAMERA_START);
+
+    ColdStart result;
+    result.cameraMilliseconds = MillisecondsSince(start);
+    result.trackingMilliseconds = result.cameraMilliseconds;
+    renderer.join();
+    surface.join();
+    return result;
+}
+
+// The stages of the graph, the camera started once its own dependencies are done
+static ColdStart RunGraph()
+{
+    auto tracker = std::make_shared<StartupTracker>();
+    auto start = std::chrono::steady_clock::now();
+    std::thread renderer;
+    std::thread surface;
+    StartUiStages(tracker, renderer, surface);
+
+    std::atomic<bool> prefetched(false);
+    ColdStart result;
+    {
+        StartupGraph graph(tracker, STAGE_TIMEOUT_MILLISECONDS);
+        graph.Add(STARTUP_STAGE_SDK_INIT, InitializeSdk);
+        graph.Add(STARTUP_STAGE_DATASET_PREFETCH, [&prefetched]()
+        {
+            Work(DATASET_PREFETCH);
+            prefetched = true;
+            return true;
+        });
+        graph.Add(STARTUP_STAGE_TRACKER_INIT, []()
+        {
+            Work(TRACKER_INIT);
+            return true;
+        });
+        graph.Add(STARTUP_STAGE_DATASET_LOAD, [&prefetched]()
+        {
+            Work(prefetched ? DATASET_LOAD_PREFETCHED : DATASET_LOAD_COLD);
+            return true;
+        });
+        graph.Start();
+
+        tracker->WaitFor(StartupTracker::GetDependencies(STARTUP_STAGE_CAMERA_START), STAGE_TIMEOUT_MILLISECONDS);
+        Work(CAMERA_START);
+        result.cameraMilliseconds = MillisecondsSince(start);
+
+        graph.WaitFor(StartupStageBit(STARTUP_STAGE_DATASET_LOAD));
+        result.trackingMilliseconds = MillisecondsSince(start);
+    }
+    renderer.join();
+    surface.join();
+    return result;
+}
+
+int main()
+{
+    ColdStart sequential = { 0.0, 0.0 };
+    ColdStart graph = { 0.0, 0.0 };
+    for (int run = 0; run < RUNS; run++)
+    {
+        ColdStart result = RunSequential();
+        sequential.cameraMilliseconds += result.cameraMilliseconds / RUNS;
+        sequential.trackingMilliseconds += result.trackingMilliseconds / RUNS;
+
+        result = RunGraph();
+        graph.cameraMilliseconds += result.cameraMilliseconds / RUNS;
+        graph.trackingMilliseconds += result.trackingMilliseconds / RUNS;
+    }
+
+    printf("cold start, mean of %d runs:\n", RUNS);
+    printf("  sequential: camera %.0f ms, dataset %.0f ms\n",
+        sequential.cameraMilliseconds, sequential.trackingMilliseconds);
+    printf("  graph:      camera %.0f ms, dataset %.0f ms\n",
+        graph.cameraMilliseconds, graph.trackingMilliseconds);
+
+    // A failure fails the stages depending on it at once, without their timeout
+    auto tracker = std::make_shared<StartupTracker>();
+    StartupGraph failing(tracker, STAGE_TIMEOUT_MILLISECONDS);
+    failing.Add(STARTUP_STAGE_SDK_INIT, []() { return false; });
+    failing.Add(STARTUP_STAGE_TRACKER_INIT, []() { return true; });
+    failing.Add(STARTUP_STAGE_DATASET_LOAD, []() { return true; });
+    auto start = std::chrono::steady_clock::now();
+    failing.Start();
+    bool loaded = failing.WaitFor(StartupStageBit(STARTUP_STAGE_DATASET_LOAD));
+    failing.Join();
+    printf("  failed SDK initialization: dataset %s, failed mask 0x%x, after %.1f ms\n",
+        loaded ? "loaded" : "failed", failing.GetFailedMask(), MillisecondsSince(start));
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "StereoViews.h"
+
+using namespace SampleCommon;
+
+static const float TOLERANCE = 1e-5f;
+
+// Side by side eyes of a 1280x720 headset display
+static const ViewportRect LEFT_EYE = { 0.0f, 0.0f, 640.0f, 720.0f };
+static const ViewportRect RIGHT_EYE = { 640.0f, 0.0f, 640.0f, 720.0f };
+
+static bool RectsEqual(const ViewportRect &a, const ViewportRect &b)
+{
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+// Where a clip space point of the shared viewport lands, in pixels
+static void ClipToPixels(const ViewportRect &viewport, float x, float y, float &pixelX, float &pixelY)
+{
+    pixelX = viewport.x + 0.5f * (x + 1.0f) * viewport.width;
+    pixelY = viewport.y + 0.5f * (1.0f - y) * viewport.height;
+}
+
+static void TestUnionViewport()
+{
+    const ViewportRect sideBySide[] = { LEFT_EYE, RIGHT_EYE };
+    const ViewportRect expected = { 0.0f, 0.0f, 1280.0f, 720.0f };
+    CHECK(RectsEqual(StereoUtil::ComputeUnionViewport(sideBySide, 2), expected));
+
+    // Eyes apart from each other and from the origin, in either order
+    const ViewportRect apart[] = { { 700.0f, 40.0f, 500.0f, 600.0f }, { 100.0f, 60.0f, 500.0f, 640.0f } };
+    const ViewportRect apartUnion = { 100.0f, 40.0f, 1100.0f, 660.0f };
+    CHECK(RectsEqual(StereoUtil::ComputeUnionViewport(apart, 2), apartUnion));
+
+    CHECK(RectsEqual(StereoUtil::ComputeUnionViewport(apart, 1), apart[0]));
+    const ViewportRect empty = { 0.0f, 0.0f, 0.0f, 0.0f };
+    CHECK(RectsEqual(StereoUtil::ComputeUnionViewport(apart, 0), empty));
+}
+
+static void TestEyeTransform()
+{
+    const ViewportRect sideBySide[] = { LEFT_EYE, RIGHT_EYE };
+    ViewportRect unionViewport = StereoUtil::ComputeUnionViewport(sideBySide, 2);
+
+    StereoEyeTransform left = StereoUtil::ComputeEyeTransform(LEFT_EYE, unionViewport);
+    CHECK_NEAR(left.scaleX, 0.5f, TOLERANCE);
+    CHECK_NEAR(left.scaleY, 1.0f, TOLERANCE);
+    CHECK_NEAR(left.offsetX, -0.5f, TOLERANCE);
+    CHECK_NEAR(left.offsetY, 0.0f, TOLERANCE);
+    CHECK_NEAR(left.bounds[0], -1.0f, TOLERANCE);
+    CHECK_NEAR(left.bounds[1], 0.0f, TOLERANCE);
+
+    StereoEyeTransform right = StereoUtil::ComputeEyeTransform(RIGHT_EYE, unionViewport);
+    CHECK_NEAR(right.offsetX, 0.5f, TOLERANCE);
+    CHECK_NEAR(right.bounds[0], 0.0f, TOLERANCE);
+    CHECK_NEAR(right.bounds[1], 1.0f, TOLERANCE);
+
+    // The corners of an eye's clip space land on the corners of its
+    // viewport, wherever it is in the shared one
+    const ViewportRect eyes[] = { { 700.0f, 40.0f, 500.0f, 600.0f }, { 100.0f, 60.0f, 500.0f, 640.0f } };
+    unionViewport = StereoUtil::ComputeUnionViewport(eyes, 2);
+    for (const auto &eye : eyes)
+    {
+        StereoEyeTransform transform = StereoUtil::ComputeEyeTransform(eye, unionViewport);
+        float pixelX, pixelY;
+        ClipToPixels(unionViewport, transform.bounds[0], transform.bounds[3], pixelX, pixelY);
+        CHECK_NEAR(pixelX, eye.x, 1e-3f);
+        CHECK_NEAR(pixelY, eye.y, 1e-3f);
+        ClipToPixels(unionViewport, transform.bounds[1], transform.bounds[2], pixelX, pixelY);
+        CHECK_NEAR(pixelX, eye.x + eye.width, 1e-3f);
+        CHECK_NEAR(pixelY, eye.y + eye.height, 1e-3f);
+    }
+
+    // An empty shared viewport leaves the view untouched
+    const ViewportRect empty = { 0.0f, 0.0f, 0.0f, 0.0f };
+    StereoEyeTransform identity = StereoUtil::ComputeEyeTransform(LEFT_EYE, empty);
+    StereoEyeTransform expected = StereoUtil::IdentityEyeTransform();
+    CHECK(identity.scaleX == expected.scaleX && identity.scaleY == expected.scaleY);
+    CHECK(identity.offsetX == expected.offsetX && identity.offsetY == expected.offsetY);
+}
+
+static void TestApplyEyeTransform()
+{
+    const float projection[16] = {
+        1.7f, 0.0f, 0.05f, 0.2f,
+        0.0f, 2.2f, -0.03f, 0.1f,
+        0.0f, 0.0f, 1.004f, -20.04f,
+        0.0f, 0.0f, 1.0f, 0.0f
+    };
+    const ViewportRect sideBySide[] = { LEFT_EYE, RIGHT_EYE };
+    ViewportRect unionViewport = StereoUtil::ComputeUnionViewport(sideBySide, 2);
+    StereoEyeTransform transform = StereoUtil::ComputeEyeTransform(RIGHT_EYE, unionViewport);
+
+    float result[16];
+    StereoUtil::ApplyEyeTransform(transform, projection, result);
+
+    // x' = scaleX * x + offsetX * w, likewise for y; z and w are kept
+    const float point[4] = { 30.0f, -20.0f, 400.0f, 1.0f };
+    float clip[4], transformed[4];
+    for (int r = 0; r < 4; r++)
+    {
+        clip[r] = 0.0f;
+        transformed[r] = 0.0f;
+        for (int c = 0; c < 4; c++)
+        {
+            clip[r] += projection[r * 4 + c] * point[c];
+            transformed[r] += result[r * 4 + c] * point[c];
+        }
+    }
+    CHECK_NEAR(transformed[0], transform.scaleX * clip[0] + transform.offsetX * clip[3], 1e-3f);
+    CHECK_NEAR(transformed[1], transform.scaleY * clip[1] + transform.offsetY * clip[3], 1e-3f);
+    CHECK(transformed[2] == clip[2]);
+    CHECK(transformed[3] == clip[3]);
+
+    // The identity leaves the projection as it is
+    StereoUtil::ApplyEyeTransform(StereoUtil::IdentityEyeTransform(), projection, result);
+    for (int i = 0; i < 16; i++)
+    {
+        CHECK(result[i] == projection[i]);
+    }
+}
+
+static void TestDrawCounts()
+{
+    // Monocular
+    StereoRenderingStats stats = StereoUtil::ComputeDrawCounts(12, 1, false);
+    CHECK(stats.eyeCount == 1 && stats.drawCalls == 12 && stats.twoPassDrawCalls == 12);
+
+    // Instanced stereo draws every augmentation once
+    stats = StereoUtil::ComputeDrawCounts(12, 2, true);
+    CHECK(stats.eyeCount == 2 && stats.drawCalls == 12 && stats.twoPassDrawCalls == 24);
+
+    // The feature level 9 fallback draws it once per eye
+    stats = StereoUtil::ComputeDrawCounts(12, 2, false);
+    CHECK(stats.eyeCount == 2 && stats.drawCalls == 24 && stats.twoPassDrawCalls == 24);
+
+    stats = StereoUtil::ComputeDrawCounts(0, 2, false);
+    CHECK(stats.drawCalls == 0 && stats.twoPassDrawCalls == 0);
+}
+
+int main()
+{
+    SampleTests::RunTest("union viewport", TestUnionViewport);
+    SampleTests::RunTest("eye transform", TestEyeTransform);
+    SampleTests::RunTest("apply eye transform", TestApplyEyeTransform);
+    SampleTests::RunTest("draw counts", TestDrawCounts);
+    return SampleTests::Result();
+}
@@ -0,0 +1,51 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+namespace SampleTests
+{
+    inline int& FailureCount()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void ReportFailure(const char *file, int line, const char *expression)
+    {
+        printf("%s(%d): CHECK(%s) failed\n", file, line, expression);
+        FailureCount()++;
+    }
+
+    // Runs a test, printing its name and whether its checks held
+    inline void RunTest(const char *name, const std::function<void()> &test)
+    {
+        int failures = FailureCount();
+        test();
+        printf("%s %s\n", (FailureCount() == failures) ? "[ ok ]" : "[FAIL]", name);
+    }
+
+    // Exit code of a test program
+    inline int Result()
+    {
+        return (FailureCount() == 0) ? 0 : 1;
+    }
+
+    inline double Milliseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+} // namespace SampleTests
+
+#define CHECK(condition) \
+    do { if (!(condition)) { SampleTests::ReportFailure(__FILE__, __LINE__, #condition); } } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(std::fabs((a) - (b)) <= (tolerance))
@@ -0,0 +1,208 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "TestUtil.h"
+#include "UpdateBus.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace SampleCommon;
+
+// Counts the allocations of the threads that ask for it
+static std::atomic<long> s_allocations(0);
+static thread_local bool t_countAllocations = false;
+
+void* operator new(size_t size)
+{
+    if (t_countAllocations)
+    {
+        s_allocations++;
+    }
+    void *memory = malloc(size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+// Kept out of line: GCC takes an inlined free() of what operator new
+// returned for a mismatched pair
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+TEST_NOINLINE void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+TEST_NOINLINE void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+struct TestUpdate
+{
+    int64_t frame;
+};
+
+static void TestPriorityOrder()
+{
+    UpdateBus<TestUpdate> bus;
+    std::vector<int> order;
+    bus.Subscribe("low", 0, 1.0, [&order](const TestUpdate&) { order.push_back(4); });
+    bus.Subscribe("high", 200, 1.0, [&order](const TestUpdate&) { order.push_back(1); });
+    bus.Subscribe("middle", 100, 1.0, [&order](const TestUpdate&) { order.push_back(2); });
+    bus.Subscribe("middle, added later", 100, 1.0, [&order](const TestUpdate&) { order.push_back(3); });
+
+    TestUpdate update = { 0 };
+    bus.Dispatch(update);
+    CHECK((order == std::vector<int>{ 1, 2, 3, 4 }));
+
+    std::vector<UpdateSubscriberStats> stats;
+    bus.GetStats(stats);
+    CHECK(stats.size() == 4);
+    CHECK(stats[0].name == "high");
+    CHECK(stats[0].calls == 1);
+}
+
+static void TestDispatchDoesNotAllocate()
+{
+    UpdateBus<TestUpdate> bus;
+    int64_t sum = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        bus.Subscribe("subscriber", i, 1.0, [&sum](const TestUpdate &update) { sum += update.frame; });
+    }
+
+    t_countAllocations = true;
+    long before = s_allocations;
+    for (int64_t frame = 1; frame <= 1000; frame++)
+    {
+        TestUpdate update = { frame };
+        bus.Dispatch(update);
+    }
+    long allocations = s_allocations - before;
+    t_countAllocations = false;
+
+    CHECK(allocations == 0);
+    CHECK(sum == 4 * 1000 * 1001 / 2);
+}
+
+static void TestOverruns()
+{
+    UpdateBus<TestUpdate> bus;
+    bus.Subscribe("slow", 0, 0.5, [](const TestUpdate &update)
+    {
+        if (update.frame % 2 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+
+    for (int64_t frame = 0; frame < 10; frame++)
+    {
+        TestUpdate update = { frame };
+        bus.Dispatch(update);
+    }
+
+    std::vector<UpdateSubscriberStats> stats;
+    bus.GetStats(stats);
+    CHECK(bus.GetOverrunCount() == 5);
+    CHECK(stats[0].overruns == 5);
+    CHECK(stats[0].maxMilliseconds >= 2.0);
+}
+
+// Unsubscribe() returns only once a call of the handler already under
+// way has returned
+static void TestUnsubscribeWaitsForHandler()
+{
+    UpdateBus<TestUpdate> bus;
+    std::atomic<bool> entered(false);
+    std::atomic<bool> returned(false);
+    std::atomic<int> calls(0);
+    uint32_t id = bus.Subscribe("slow", 0, 100.0, [&](const TestUpdate&)
+    {
+        calls++;
+        entered = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        returned = true;
+    });
+
+    std::thread dispatcher([&bus]()
+    {
+        TestUpdate update = { 0 };
+        bus.Dispatch(update);
+    });
+    while (!entered)
+    {
+        std::this_thread::yield();
+    }
+
+    bus.Unsubscribe(id);
+    CHECK(returned);
+    dispatcher.join();
+
+    TestUpdate update = { 1 };
+    bus.Dispatch(update);
+    CHECK(calls == 1);
+
+    // Unknown ids are ignored
+    bus.Unsubscribe(id);
+}
+
+static void TestChurnWhileDispatching()
+{
+    UpdateBus<TestUpdate> bus;
+    bus.Subscribe("resident", 2, 1.0, [](const TestUpdate&) {});
+
+    std::atomic<bool> running(true);
+    std::atomic<int> calls(0);
+    std::thread dispatcher([&]()
+    {
+        TestUpdate update = { 0 };
+        while (running)
+        {
+            bus.Dispatch(update);
+            std::this_thread::yield();
+        }
+    });
+
+    for (int i = 0; i < 2000; i++)
+    {
+        uint32_t id = bus.Subscribe("churn", i % 5, 1.0, [&calls](const TestUpdate&) { calls++; });
+        bus.Unsubscribe(id);
+    }
+
+    // None of the removed handlers is called any more
+    int after = calls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    CHECK(calls == after);
+
+    running = false;
+    dispatcher.join();
+
+    std::vector<UpdateSubscriberStats> stats;
+    bus.GetStats(stats);
+    CHECK(stats.size() == 1);
+}
+
+int main()
+{
+    SampleTests::RunTest("priority order", TestPriorityOrder);
+    SampleTests::RunTest("dispatch does not allocate", TestDispatchDoesNotAllocate);
+    SampleTests::RunTest("overruns", TestOverruns);
+    SampleTests::RunTest("unsubscribe waits for handler", TestUnsubscribeWaitsForHandler);
+    SampleTests::RunTest("churn while dispatching", TestChurnWhileDispatching);
+    return SampleTests::Result();
+}
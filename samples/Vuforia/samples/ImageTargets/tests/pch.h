@@ -0,0 +1,10 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+// The portable SampleCommon sources include the app's precompiled header,
+// which pulls in the Windows headers; the tests need none of it.
@@ -0,0 +1,142 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#include "pch.h"
+
+#include "FrameRateGovernor.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace SampleCommon;
+
+FrameRateGovernor::FrameRateGovernor(const FrameRateGovernorSettings &settings) :
+    m_settings(settings),
+    m_framesWithoutTracking(0),
+    m_framesSinceRender(0),
+    m_wasTracking(false),
+    m_nextOverrun(0),
+    m_overrunCount(0),
+    m_timedFrames(0),
+    m_recoveredFrames(0)
+{
+    m_settings.windowFrames = (std::max)(m_settings.windowFrames, 1u);
+    m_settings.idleRenderInterval = (std::max)(m_settings.idleRenderInterval, 1u);
+    m_maxQualityLevel = m_settings.allowVideoModeChange ? QUALITY_FAST_CAMERA : QUALITY_HALF_RATE;
+    m_overruns.resize(m_settings.windowFrames, false);
+
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_decision.render = true;
+    m_decision.idle = false;
+    SetQualityLevel(QUALITY_FULL);
+    UpdateDecision();
+}
+
+FrameRateGovernorSettings FrameRateGovernor::GetDefaultSettings()
+{
+    FrameRateGovernorSettings settings;
+    settings.frameBudgetMilliseconds = 1000.0 / 30.0;
+    settings.windowFrames = 30;
+    settings.overrunFrames = 10;
+    settings.recoveryFrames = 90;
+    settings.recoveryHeadroom = 0.6;
+    settings.idleFrames = 15;
+    settings.idleRenderInterval = 3;
+    settings.allowVideoModeChange = true;
+    return settings;
+}
+
+const FrameRateDecision& FrameRateGovernor::Update(bool tracking, double frameMilliseconds)
+{
+    // Idle frames are cheap and say little about the cost of tracked ones
+    if (frameMilliseconds >= 0.0 && !m_decision.idle)
+    {
+        AddFrameTime(frameMilliseconds);
+    }
+
+    m_framesWithoutTracking = tracking ? 0 : (std::min)(m_framesWithoutTracking + 1, m_settings.idleFrames);
+
+    bool idle = (m_framesWithoutTracking >= m_settings.idleFrames);
+    if (idle && !m_decision.idle)
+    {
+        m_stats.idlePeriods++;
+    }
+    m_decision.idle = idle;
+    UpdateDecision();
+
+    // A target that was just found is shown at once, whatever the render interval
+    bool detected = tracking && !m_wasTracking;
+    m_wasTracking = tracking;
+
+    m_decision.render = detected || (m_framesSinceRender + 1 >= m_decision.renderInterval);
+    if (m_decision.render)
+    {
+        m_framesSinceRender = 0;
+    }
+    else
+    {
+        m_framesSinceRender++;
+        m_stats.framesSkipped++;
+    }
+    return m_decision;
+}
+
+void FrameRateGovernor::AddFrameTime(double frameMilliseconds)
+{
+    bool overrun = frameMilliseconds > m_settings.frameBudgetMilliseconds;
+    if (m_overruns[m_nextOverrun])
+    {
+        m_overrunCount--;
+    }
+    m_overruns[m_nextOverrun] = overrun;
+    m_overrunCount += overrun ? 1 : 0;
+    m_nextOverrun = (m_nextOverrun + 1) % m_settings.windowFrames;
+    m_timedFrames = (std::min)(m_timedFrames + 1, m_settings.windowFrames);
+
+    bool fast = frameMilliseconds < m_settings.frameBudgetMilliseconds * m_settings.recoveryHeadroom;
+    m_recoveredFrames = fast ? m_recoveredFrames + 1 : 0;
+
+    // Each step needs a full window of frames at the new level before the next one
+    QualityLevel level = m_decision.qualityLevel;
+    if (m_timedFrames == m_settings.windowFrames &&
+        m_overrunCount >= m_settings.overrunFrames &&
+        level < m_maxQualityLevel)
+    {
+        SetQualityLevel(static_cast<QualityLevel>(level + 1));
+        m_stats.qualityStepsDown++;
+    }
+    else if (m_recoveredFrames >= m_settings.recoveryFrames && level > QUALITY_FULL)
+    {
+        SetQualityLevel(static_cast<QualityLevel>(level - 1));
+        m_stats.qualityStepsUp++;
+    }
+}
+
+void FrameRateGovernor::SetQualityLevel(QualityLevel level)
+{
+    m_decision.qualityLevel = level;
+
+    std::fill(m_overruns.begin(), m_overruns.end(), false);
+    m_nextOverrun = 0;
+    m_overrunCount = 0;
+    m_timedFrames = 0;
+    m_recoveredFrames = 0;
+}
+
+void FrameRateGovernor::UpdateDecision()
+{
+    QualityLevel level = m_decision.qualityLevel;
+
+    uint32_t renderInterval = (level >= QUALITY_HALF_RATE) ? 2 : 1;
+    if (m_decision.idle)
+    {
+        renderInterval = (std::max)(renderInterval, m_settings.idleRenderInterval);
+    }
+
+    m_decision.renderInterval = renderInterval;
+    m_decision.textureMipBias = (level >= QUALITY_REDUCED_TEXTURES) ? 1.0f : 0.0f;
+    m_decision.fastVideoMode = (level >= QUALITY_FAST_CAMERA);
+}
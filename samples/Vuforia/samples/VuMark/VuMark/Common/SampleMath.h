@@ -0,0 +1,53 @@
+/*===============================================================================
+Copyright (c) 2016 PTC Inc. All Rights Reserved.
+
+Vuforia is a trademark of PTC Inc., registered in the United States and other
+countries.
+===============================================================================*/
+#pragma once
+
+#include <cstddef>
+
+// Picks the SIMD backend of SampleMath: SSE2 on x86 and x64, NEON on ARM,
+// and the scalar reference implementation elsewhere
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define SAMPLE_MATH_SSE2 1
+#elif defined(_M_ARM) || defined(_M_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SAMPLE_MATH_NEON 1
+#endif
+
+namespace SampleCommon
+{
+    // Matrix helpers working directly on float arrays.
+    //
+    // Matrices are 4x4, stored row-major and applied to column vectors
+    // (p' = M * p), the layout the samples keep in XMFLOAT4X4 and send to
+    // the shaders. Vuforia's 3x4 matrices (Matrix34F) are row-major as well,
+    // so they convert without going through a column-major Matrix44F.
+    // No alignment is required.
+    namespace SampleMath
+    {
+        // Extends a row-major 3x4 matrix, such as a pose, with a (0, 0, 0, 1) row
+        void FromMatrix34(const float matrix34[12], float result[16]);
+
+        // Converts a column-major (OpenGL) 4x4 matrix
+        void FromGLMatrix(const float glMatrix[16], float result[16]);
+
+        void Transpose(const float matrix[16], float result[16]);
+
+        // result = a * b. result may alias a or b.
+        void Multiply(const float a[16], const float b[16], float result[16]);
+
+        // result = matrix34 * b, where matrix34 is a row-major 3x4 matrix with
+        // an implicit (0, 0, 0, 1) row: the model-view of a pose and a model
+        // matrix without converting the pose first. result may alias b.
+        void MultiplyMatrix34(const float matrix34[12], const float b[16], float result[16]);
+
+        // Reference implementations the SIMD backends are checked against
+        void MultiplyScalar(const float a[16], const float b[16], float result[16]);
+        void MultiplyMatrix34Scalar(const float matrix34[12], const float b[16], float result[16]);
+
+        // Name of the backend in use: "SSE2", "NEON" or "scalar"
+        const char* GetBackendName();
+    }
+} // namespace SampleCommon
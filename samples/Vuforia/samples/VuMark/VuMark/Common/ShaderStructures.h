@@ -11,19 +11,28 @@ countries.
 
 namespace SampleCommon
 {
-    // Constant buffer used to send MVP matrices to the vertex shader.
-    struct ModelViewProjectionConstantBuffer
+    // Constant buffer used to send projection matrices to the vertex shader.
+    struct ProjectionConstantBuffer
     {
-        DirectX::XMFLOAT4X4 model;
-        DirectX::XMFLOAT4X4 view;
         DirectX::XMFLOAT4X4 projection;
-        DirectX::XMFLOAT4 colorMask;
     };
 
-    // Constant buffer used to send projection matrices to the vertex shader.
-    struct ProjectionConstantBuffer
+    // Constant buffer used to send the projection matrices of both eyes to the
+    // vertex shader, which selects one per instance. eyeBounds holds the clip
+    // space rectangle of each eye as (left, right, bottom, top); monocular
+    // rendering uses the same projection for both and the whole clip space.
+    struct StereoProjectionConstantBuffer
     {
-        DirectX::XMFLOAT4X4 projection;
+        DirectX::XMFLOAT4X4 projection[2];
+        DirectX::XMFLOAT4 eyeBounds[2];
+    };
+
+    // Constant buffer used to send the per-draw data to the vertex shader,
+    // with the model matrix already multiplied into the model-view matrix.
+    struct ModelViewColorConstantBuffer
+    {
+        DirectX::XMFLOAT4X4 modelView;
+        DirectX::XMFLOAT4 colorMask;
     };
 
     // Used to send per-vertex data to the vertex shader.
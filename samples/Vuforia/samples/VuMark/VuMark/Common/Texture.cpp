@@ -17,7 +17,7 @@ namespace SampleCommon
     Texture::Texture(const std::shared_ptr<DX::DeviceResources>& deviceResources) :
         m_deviceResources(deviceResources), 
         m_texture(nullptr), m_initialized(false),
-        m_imageWidth(0), m_imageHeight(0), m_rowPitch(0), m_imageSize(0)
+        m_imageWidth(0), m_imageHeight(0), m_rowPitch(0), m_imageSize(0), m_mipBias(0.0f)
     {
     }
 
@@ -133,6 +133,25 @@ namespace SampleCommon
                 );
         }
 
+        CreateSamplerState();
+    }
+
+    void Texture::SetMipBias(float mipBias)
+    {
+        if (mipBias == m_mipBias)
+        {
+            return;
+        }
+
+        m_mipBias = mipBias;
+        if (m_deviceResources != nullptr && m_samplerState != nullptr)
+        {
+            CreateSamplerState();
+        }
+    }
+
+    void Texture::CreateSamplerState()
+    {
         // Create a texture sampler state description.
         D3D11_SAMPLER_DESC samplerDesc;
         ZeroMemory(&samplerDesc, sizeof(D3D11_SAMPLER_DESC));
@@ -140,7 +159,7 @@ namespace SampleCommon
         samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
         samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
         samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-        samplerDesc.MipLODBias = 0.0f;
+        samplerDesc.MipLODBias = m_mipBias;
         samplerDesc.MaxAnisotropy = 1;
         samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
         samplerDesc.BorderColor[0] = 0;
@@ -152,7 +171,7 @@ namespace SampleCommon
 
         DX::ThrowIfFailed(
             m_deviceResources->GetD3DDevice()->CreateSamplerState(
-                &samplerDesc, m_samplerState.GetAddressOf())
+                &samplerDesc, m_samplerState.ReleaseAndGetAddressOf())
             );
     }
 
@@ -23,12 +23,19 @@ namespace SampleCommon
         void Init();
         void ReleaseResources();
 
+        // Biases the mip level the texture is sampled from; positive values
+        // sample smaller mips, which costs less bandwidth
+        void SetMipBias(float mipBias);
+        float GetMipBias() const { return m_mipBias; }
+
         bool IsInitialized() const { return m_initialized; }
         Microsoft::WRL::ComPtr<ID3D11SamplerState> & GetD3DSamplerState() { return m_samplerState; }
         Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> & GetD3DTextureView() { return m_textureView; }
         Microsoft::WRL::ComPtr<ID3D11Texture2D> & GetD3DTexture() { return m_texture; }
 
     private:
+        void CreateSamplerState();
+
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources> m_deviceResources;
 
@@ -45,5 +52,6 @@ namespace SampleCommon
         size_t m_imageSize;
         std::unique_ptr<uint8_t[]> m_imageBytes;
         bool m_initialized;
+        float m_mipBias;
     };
 } // SampleCommon
\ No newline at end of file
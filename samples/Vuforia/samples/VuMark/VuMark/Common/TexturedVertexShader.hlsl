@@ -1,8 +1,16 @@
-cbuffer ModelViewProjectionConstantBuffer : register(b0)
+// Draws a single eye, without instancing or clip distances, so that it runs
+// on feature level 9 devices. The constant buffers are laid out like those
+// of TexturedStereoVertexShader; only the first projection is used.
+cbuffer StereoProjectionConstantBuffer : register(b0)
 {
-    matrix model;
-    matrix view;
-    matrix projection;
+    matrix projection[2];
+    float4 eyeBounds[2];
+};
+
+// Updated once per draw
+cbuffer ModelViewColorConstantBuffer : register(b1)
+{
+    matrix modelView;
     float4 colorMask;
 };
 
@@ -25,9 +33,8 @@ PixelShaderInput main(VertexShaderInput input)
     float4 pos = float4(input.pos, 1.0f);
 
     // Transform the vertex position into projected space.
-    pos = mul(pos, model);
-    pos = mul(pos, view);
-    pos = mul(pos, projection);
+    pos = mul(pos, modelView);
+    pos = mul(pos, projection[0]);
     output.pos = pos;
     output.texcoord = input.texcoord;
     output.color = colorMask;
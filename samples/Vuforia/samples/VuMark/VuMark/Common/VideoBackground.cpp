@@ -12,6 +12,7 @@ countries.
 #include <memory>
 #include "DirectXHelper.h"
 #include "RenderUtil.h"
+#include "SampleMath.h"
 #include "SampleUtil.h"
 
 #include <Vuforia\CameraDevice.h>
@@ -268,13 +269,9 @@ void VideoBackground::Render(
     Vuforia::Matrix34F vbProjection = renderPrimitives->getVideoBackgroundProjectionMatrix(
         viewId, Vuforia::COORDINATE_SYSTEM_CAMERA);
 
-    // Convert the matrix to 4x4 format
-    Vuforia::Matrix44F vbProjection44F = Vuforia::Tool::convert2GLMatrix(vbProjection);
-
     // Convert the matrix to XMFLOAT4X4 format
     XMFLOAT4X4 vbProjectionDX;
-    memcpy(vbProjectionDX.m, vbProjection44F.data, sizeof(float) * 16);
-    XMStoreFloat4x4(&vbProjectionDX, XMMatrixTranspose(XMLoadFloat4x4(&vbProjectionDX)));
+    SampleMath::FromMatrix34(vbProjection.data, &vbProjectionDX.m[0][0]);
 
     // Convert the XMFLOAT4X4 to XMMATRIX
     auto vbProjectionMatrix = XMLoadFloat4x4(&vbProjectionDX);
@@ -7,19 +7,40 @@ countries.
 #include "pch.h"
 #include "VuMarkMain.h"
 #include "Common\DirectXHelper.h"
+#include "Common\SampleUtil.h"
 #include <Vuforia\Vuforia_UWP.h>
 
+#include <chrono>
+#include <cstdio>
+
 using namespace VuMark;
 using namespace Windows::Foundation;
 using namespace Windows::System::Threading;
 using namespace Concurrency;
 
+// The render loop wakes this often to check whether it should stop
+static const uint32_t IDLE_WAIT_MILLISECONDS = 100;
+
+// The frame stats are logged at most this often
+static const std::chrono::seconds FRAME_STATS_LOG_INTERVAL(5);
+
+static SampleCommon::FrameRateGovernorSettings GetFrameRateGovernorSettings()
+{
+    // The session has no camera video mode to switch to
+    SampleCommon::FrameRateGovernorSettings settings = SampleCommon::FrameRateGovernor::GetDefaultSettings();
+    settings.allowVideoModeChange = false;
+    return settings;
+}
+
 // Loads and initializes application assets when the application is loaded.
 VuMarkMain::VuMarkMain(
     const std::shared_ptr<DX::DeviceResources>& deviceResources,
     const std::shared_ptr<AppSession>& appSession) :
     m_deviceResources(deviceResources),
-    m_appSession(appSession)
+    m_appSession(appSession),
+    m_frameRateGovernor(GetFrameRateGovernorSettings()),
+    m_renderedFrameMilliseconds(-1.0),
+    m_framesRendered(0)
 {
     // Register to be notified if the Device is lost or recreated
     m_deviceResources->RegisterDeviceNotify(this);
@@ -27,10 +48,9 @@ VuMarkMain::VuMarkMain(
     // Init the Image Targets scene renderer
     m_vuMarkRenderer = std::unique_ptr<VuMarkRenderer>(new VuMarkRenderer(m_deviceResources));
 
-    // We set the desired frame rate here
-    float fps = 30;
-    m_timer.SetFixedTimeStep(true);
-    m_timer.SetTargetElapsedSeconds(1.0 / fps);
+    // The render loop runs once per camera frame the frame rate governor
+    // lets through, so the timer follows it
+    m_timer.SetFixedTimeStep(false);
 }
 
 VuMarkMain::~VuMarkMain()
@@ -72,20 +92,41 @@ void VuMarkMain::StartRenderLoop()
     // Create a task that will be run on a background thread.
     auto workItemHandler = ref new WorkItemHandler([this](IAsyncAction ^ action)
     {
-        // Calculate the updated frame and render once per vertical blanking interval.
+        // Render once per camera frame let through by PrepareFrame, rather than
+        // once per vertical blank: redrawing the same frame only burns power.
         while (action->Status == AsyncStatus::Started)
         {
+            SampleCommon::FrameWakeReason wakeReason = m_frameScheduler.WaitForFrame(IDLE_WAIT_MILLISECONDS);
+            if (wakeReason == SampleCommon::FRAME_WAKE_TIMEOUT || action->Status != AsyncStatus::Started)
+            {
+                continue;
+            }
+
             // We provide a dispatcher to the renderer so that it can run 
             // certain UI-related tasks on the UI thread
             m_vuMarkRenderer->SetUIDispatcher(
                 Windows::ApplicationModel::Core::CoreApplication::MainView->CoreWindow->Dispatcher
             );
 
-            critical_section::scoped_lock lock(m_criticalSection);
-            Update();
-            if (Render())
             {
-                m_deviceResources->Present();
+                critical_section::scoped_lock lock(m_criticalSection);
+                auto start = std::chrono::high_resolution_clock::now();
+                Update();
+                if (Render())
+                {
+                    m_deviceResources->Present();
+                    auto end = std::chrono::high_resolution_clock::now();
+                    double frameMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+                    m_renderedFrameMilliseconds = frameMilliseconds;
+                    m_frameScheduler.FrameRendered(wakeReason == SampleCommon::FRAME_WAKE_NEW_FRAME);
+
+                    m_framesRendered++;
+                    if (end - m_frameStatsLogTime >= FRAME_STATS_LOG_INTERVAL)
+                    {
+                        LogFrameStats(frameMilliseconds);
+                        m_frameStatsLogTime = end;
+                    }
+                }
             }
 
             // We release the dispatcher as we don't need to hold it any more
@@ -100,6 +141,33 @@ void VuMarkMain::StartRenderLoop()
 void VuMarkMain::StopRenderLoop()
 {
     m_renderLoopWorker->Cancel();
+    m_frameScheduler.Wake();
+}
+
+// Render thread: frames rendered so far, and the cost of the last one
+void VuMarkMain::LogFrameStats(double frameMilliseconds)
+{
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer),
+        "%u frames rendered. Last frame: %.2f ms including present, %u bytes of constant data uploaded",
+        m_framesRendered,
+        frameMilliseconds,
+        m_vuMarkRenderer->GetConstantBufferBytesPerFrame());
+    SampleCommon::SampleUtil::Log("VuMarkMain", SampleCommon::SampleUtil::ToPlatformString(buffer));
+}
+
+void VuMarkMain::PrepareFrame(const Vuforia::State &state)
+{
+    bool tracking = state.getNumTrackableResults() > 0;
+    const SampleCommon::FrameRateDecision &decision =
+        m_frameRateGovernor.Update(tracking, m_renderedFrameMilliseconds.exchange(-1.0));
+
+    m_vuMarkRenderer->SetTextureMipBias(decision.textureMipBias);
+
+    if (decision.render)
+    {
+        m_frameScheduler.NotifyFrame();
+    }
 }
 
 // Updates the application state once per frame.
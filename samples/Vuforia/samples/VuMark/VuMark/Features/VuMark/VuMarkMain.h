@@ -8,9 +8,15 @@ countries.
 
 #include "Common\StepTimer.h"
 #include "Common\DeviceResources.h"
+#include "Common\FrameRateGovernor.h"
+#include "Common\FrameScheduler.h"
 #include "Features\VuMark\VuMarkRenderer.h"
 #include "SampleApplication\AppSession.h"
 
+#include <Vuforia\State.h>
+
+#include <atomic>
+#include <chrono>
 
 // Renders Direct2D and 3D content on the screen.
 namespace VuMark
@@ -25,6 +31,10 @@ namespace VuMark
         void CreateWindowSizeDependentResources();
         void StartRenderLoop();
         void StopRenderLoop();
+
+        // Called on the tracking thread for each new camera frame; decides
+        // whether the render loop draws it
+        void PrepareFrame(const Vuforia::State &state);
         Concurrency::critical_section& GetCriticalSection() { return m_criticalSection; }
 
         // IDeviceNotify
@@ -39,6 +49,7 @@ namespace VuMark
         void ProcessInput();
         void Update();
         bool Render();
+        void LogFrameStats(double frameMilliseconds);
 
         // Cached pointer to device resources.
         std::shared_ptr<DX::DeviceResources> m_deviceResources;
@@ -54,5 +65,18 @@ namespace VuMark
 
         // Rendering loop timer.
         SampleCommon::StepTimer m_timer;
+
+        // Wakes the render loop when a camera frame is to be drawn
+        SampleCommon::FrameScheduler m_frameScheduler;
+
+        // Lowers the frame rate while nothing is tracked, and the quality while
+        // frames overrun. Used by the tracking thread, which the render thread
+        // tells the time of each frame it renders.
+        SampleCommon::FrameRateGovernor m_frameRateGovernor;
+        std::atomic<double> m_renderedFrameMilliseconds;
+
+        // Render thread only: frames rendered, and when they were last logged
+        uint32_t m_framesRendered;
+        std::chrono::high_resolution_clock::time_point m_frameStatsLogTime;
     };
 }
\ No newline at end of file
@@ -36,6 +36,7 @@ using namespace Windows::Storage::Streams;
 using namespace Windows::UI::Xaml::Media::Imaging;
 
 static const float VUMARK_SCALE = 1.06f;
+static const float RETICLE_FOV_Y = 45.0f * XM_PI / 180.0f;
 
 #define VUMARK_ID_MAX_LENGTH 100
 
@@ -110,8 +111,14 @@ VuMarkRenderer::VuMarkRenderer(const std::shared_ptr<DX::DeviceResources>& devic
     m_vuforiaInitialized(false),
     m_vuforiaStarted(false),
     m_extTracking(false),
+    m_textureMipBias(0.0f),
     m_currentTime(0),
-    m_uiDispatcher(nullptr)
+    m_uiDispatcher(nullptr),
+    m_reticleProjectionValid(false),
+    m_eyeCount(1),
+    m_passCount(1),
+    m_constantBufferBytes(0),
+    m_constantBufferBytesPerFrame(0)
 {
     CreateDeviceDependentResources();
     CreateWindowSizeDependentResources();
@@ -148,17 +155,6 @@ void VuMarkRenderer::UpdateRenderingPrimitives()
         new Vuforia::RenderingPrimitives(Vuforia::Device::getInstance().getRenderingPrimitives())
         );
 
-    // Calculate the DX Projection matrix
-    auto projectionMatrix = Vuforia::Tool::convertPerspectiveProjection2GLMatrix(
-        m_renderingPrimitives->getProjectionMatrix(Vuforia::VIEW_SINGULAR, Vuforia::COORDINATE_SYSTEM_CAMERA),
-        m_near, m_far);
-
-    XMFLOAT4X4 dxProjection;
-    memcpy(dxProjection.m, projectionMatrix.data, sizeof(float) * 16);
-    XMStoreFloat4x4(&dxProjection, XMMatrixTranspose(XMLoadFloat4x4(&dxProjection)));
-    
-    m_projection = dxProjection;
-
     m_videoBackground->ResetForNewRenderingPrimitives();
 }
 
@@ -183,10 +179,19 @@ void VuMarkRenderer::Render()
     Vuforia::Renderer &vuforiaRenderer = Vuforia::Renderer::getInstance();
     Vuforia::State state = vuforiaRenderer.begin(&dxRenderData);
 
+    m_constantBufferBytes = 0;
+
+    // Textures recreated after a device loss start unbiased, so this is checked every frame
+    float mipBias = m_textureMipBias;
+    m_augmentationTexture->SetMipBias(mipBias);
+    m_reticleTexture->SetMipBias(mipBias);
+
     RenderScene(vuforiaRenderer, state);
 
     RenderReticle();
 
+    m_constantBufferBytesPerFrame = m_constantBufferBytes;
+
     Vuforia::Renderer::getInstance().end();
 }
 
@@ -200,11 +205,10 @@ void VuMarkRenderer::RenderReticle()
 
     Size outputSize = m_deviceResources->GetOutputSize();
     float aspectRatio = outputSize.Width / outputSize.Height;
-    float fovAngleY = 45.0f * XM_PI / 180.0f;
 
     // This sample makes use of a right-handed coordinate system using row-major matrices.
     XMMATRIX perspectiveMatrix = XMMatrixPerspectiveFovRH(
-        fovAngleY,
+        RETICLE_FOV_Y,
         aspectRatio,
         m_near,
         m_far
@@ -213,36 +217,35 @@ void VuMarkRenderer::RenderReticle()
     XMFLOAT4X4 orientation = m_deviceResources->GetOrientationTransform3D();
     XMMATRIX orientationMatrix = XMLoadFloat4x4(&orientation);
 
-    XMStoreFloat4x4(
-        &m_constantBufferData.projection,
-        XMMatrixTranspose(perspectiveMatrix * orientationMatrix)
-    );
-
-    // We place the reticle at the near clipping plane
-    float reticleDistance = 1.1f * m_near;
-    static const XMVECTORF32 eye = { 0.0f, 0.0f, reticleDistance, 0.0f };
-    static const XMVECTORF32 at = { 0.0f, 0.0f, 0.0f, 0.0f };
-    static const XMVECTORF32 up = { 0.0f, 1.0f, 0.0f, 0.0f };
+    XMFLOAT4X4 reticleProjection;
+    XMStoreFloat4x4(&reticleProjection, XMMatrixTranspose(perspectiveMatrix * orientationMatrix));
 
-    XMStoreFloat4x4(&m_constantBufferData.view, XMMatrixTranspose(XMMatrixLookAtRH(eye, at, up)));
-
-    float reticleScale = reticleDistance * tan(fovAngleY/2);
-    auto reticleScaleMatrix = XMMatrixScaling(reticleScale, reticleScale, reticleScale);
-    XMStoreFloat4x4(&m_constantBufferData.model, XMMatrixTranspose(reticleScaleMatrix));
+    // Only upload the projection when the window size or orientation changed
+    if (!m_reticleProjectionValid || memcmp(&reticleProjection, &m_reticleProjection, sizeof(reticleProjection)) != 0)
+    {
+        m_reticleProjection = reticleProjection;
+        m_reticleProjectionValid = true;
 
-    // Set the color mask
-    m_constantBufferData.colorMask = { 1.0F, 1.0F, 1.0F, 1.0F };
+        // The reticle is drawn once, over the whole screen
+        SampleCommon::StereoEyeTransform identity = SampleCommon::StereoUtil::IdentityEyeTransform();
+        SampleCommon::StereoProjectionConstantBuffer reticleConstantBufferData;
+        for (uint32_t eye = 0; eye < SampleCommon::MAX_STEREO_EYES; eye++)
+        {
+            reticleConstantBufferData.projection[eye] = m_reticleProjection;
+            reticleConstantBufferData.eyeBounds[eye] = XMFLOAT4(identity.bounds);
+        }
 
-    // Prepare the constant buffer to send it to the graphics device.
-    context->UpdateSubresource1(
-        m_constantBuffer.Get(),
-        0,
-        NULL,
-        &m_constantBufferData,
-        0,
-        0,
-        0
-    );
+        context->UpdateSubresource1(
+            m_reticleFrameConstantBuffer.Get(),
+            0,
+            NULL,
+            &reticleConstantBufferData,
+            0,
+            0,
+            0
+        );
+        m_constantBufferBytes += sizeof(reticleConstantBufferData);
+    }
 
     // Each vertex is one instance of the TexturedVertex struct.
     UINT stride = sizeof(SampleCommon::TexturedVertex);
@@ -268,11 +271,15 @@ void VuMarkRenderer::RenderReticle()
     // Attach our vertex shader.
     context->VSSetShader(m_vertexShader.Get(), nullptr, 0);
 
-    // Send the constant buffer to the graphics device.
+    // Send the constant buffers to the graphics device.
+    ID3D11Buffer *const constantBuffers[2] = {
+        m_reticleFrameConstantBuffer.Get(),
+        m_reticleInstanceConstantBuffer.Get()
+    };
     context->VSSetConstantBuffers1(
         0,
-        1,
-        m_constantBuffer.GetAddressOf(),
+        2,
+        constantBuffers,
         nullptr,
         nullptr
     );
@@ -287,163 +294,253 @@ void VuMarkRenderer::RenderReticle()
     context->DrawIndexed(m_quadMesh->GetIndexCount(), 0, 0);
 }
 
+void VuMarkRenderer::GetProjectionMatrix(Vuforia::VIEW viewId, XMFLOAT4X4 &projection)
+{
+    auto projection44F = Vuforia::Tool::convertPerspectiveProjection2GLMatrix(
+        m_renderingPrimitives->getProjectionMatrix(viewId, Vuforia::COORDINATE_SYSTEM_CAMERA),
+        m_near, m_far);
+
+    XMFLOAT4X4 projectionDX;
+    SampleCommon::SampleMath::FromGLMatrix(projection44F.data, &projectionDX.m[0][0]);
+
+    // Apply the appropriate eye adjustment to the raw projection matrix
+    XMFLOAT4X4 eyeAdjustmentDX;
+    SampleCommon::SampleMath::FromMatrix34(
+        m_renderingPrimitives->getEyeDisplayAdjustmentMatrix(viewId).data, &eyeAdjustmentDX.m[0][0]);
+
+    SampleCommon::SampleMath::Multiply(&projectionDX.m[0][0], &eyeAdjustmentDX.m[0][0], &projection.m[0][0]);
+}
+
 void VuMarkRenderer::RenderScene(Vuforia::Renderer &renderer, Vuforia::State &state)
 {
     Concurrency::critical_section::scoped_lock lock(m_renderingPrimitivesLock);
 
+    // Video see-through eyewear renders a view per eye, other devices a single view
     Vuforia::ViewList &viewList = m_renderingPrimitives->getRenderingViews();
-    if (!viewList.contains(Vuforia::VIEW::VIEW_SINGULAR))
+    bool stereo = viewList.contains(Vuforia::VIEW::VIEW_LEFTEYE) && viewList.contains(Vuforia::VIEW::VIEW_RIGHTEYE);
+    if (!stereo && !viewList.contains(Vuforia::VIEW::VIEW_SINGULAR))
     {
-        SampleCommon::SampleUtil::Log("VuMarksRenderer", "Monocular view not found.");
+        SampleCommon::SampleUtil::Log("VuMarksRenderer", "Monocular or stereo views not found.");
         return;
     }
 
     auto context = m_deviceResources->GetD3DDeviceContext();
 
-    XMMATRIX xmProjection = XMLoadFloat4x4(&m_projection);
+    // Feature level 9 devices have neither instance ids nor clip distances,
+    // and draw each eye in a pass of its own instead
+    bool instanced = stereo && (m_stereoVertexShader != nullptr);
+    m_eyeCount = instanced ? 2 : 1;
+    m_passCount = (stereo && !instanced) ? 2 : 1;
 
-    bool gotVuMark = false;
+    // Projection and viewport of each eye, the left eye first
+    XMFLOAT4X4 eyeProjections[SampleCommon::MAX_STEREO_EYES];
+    SampleCommon::ViewportRect eyeViewports[SampleCommon::MAX_STEREO_EYES];
 
     for (size_t v = 0; v < viewList.getNumViews(); v++)
     {
         Vuforia::VIEW viewId = viewList.getView(static_cast<int>(v));
 
-        // Apply the appropriate eye adjustment to the raw projection matrix, and assign to the global variable
-        Vuforia::Matrix44F eyeAdjustment44F = Vuforia::Tool::convert2GLMatrix(
-            m_renderingPrimitives->getEyeDisplayAdjustmentMatrix(viewId));
+        // Other views, such as the post-process view, are not used by this sample
+        int eye = -1;
+        if (stereo)
+        {
+            eye = (viewId == Vuforia::VIEW::VIEW_LEFTEYE) ? 0 : (viewId == Vuforia::VIEW::VIEW_RIGHTEYE) ? 1 : -1;
+        }
+        else if (viewId == Vuforia::VIEW::VIEW_SINGULAR)
+        {
+            eye = 0;
+        }
 
-        // Convert the matrix to XMFLOAT4X4 format
-        XMFLOAT4X4 eyeAdjustmentDX;
-        memcpy(eyeAdjustmentDX.m, eyeAdjustment44F.data, sizeof(float) * 16);
-        XMStoreFloat4x4(&eyeAdjustmentDX, XMMatrixTranspose(XMLoadFloat4x4(&eyeAdjustmentDX)));
-        XMMATRIX eyeAdjustmentMatrix = XMLoadFloat4x4(&eyeAdjustmentDX);
+        if (eye < 0)
+        {
+            continue;
+        }
 
-        // Compute final adjusted projection matrix
-        XMMATRIX projectionMatrix = xmProjection * eyeAdjustmentMatrix;
+        if (stereo)
+        {
+            // The video background is drawn separately for each eye, into its own viewport
+            Vuforia::Vec4I viewport = m_renderingPrimitives->getViewport(viewId);
+            SampleCommon::ViewportRect eyeViewport = {
+                static_cast<float>(viewport.data[0]),
+                static_cast<float>(viewport.data[1]),
+                static_cast<float>(viewport.data[2]),
+                static_cast<float>(viewport.data[3])
+            };
+            eyeViewports[eye] = eyeViewport;
+
+            CD3D11_VIEWPORT d3dViewport(eyeViewport.x, eyeViewport.y, eyeViewport.width, eyeViewport.height);
+            context->RSSetViewports(1, &d3dViewport);
+        }
+
+        // Render the camera video background
+        m_videoBackground->Render(renderer, m_renderingPrimitives.get(), viewId);
+
+        GetProjectionMatrix(viewId, eyeProjections[eye]);
+    }
+
+    // VuMarks are drawn once for all eyes: each draw has an instance per eye,
+    // which the vertex shader moves into the eye's part of a viewport spanning all eyes
+    SampleCommon::ViewportRect unionViewport = { 0.0f, 0.0f, 0.0f, 0.0f };
+    if (instanced)
+    {
+        unionViewport = SampleCommon::StereoUtil::ComputeUnionViewport(eyeViewports, m_eyeCount);
 
-        if (viewId == Vuforia::VIEW::VIEW_SINGULAR)
+        CD3D11_VIEWPORT d3dViewport(unionViewport.x, unionViewport.y, unionViewport.width, unionViewport.height);
+        context->RSSetViewports(1, &d3dViewport);
+    }
+
+    // The projections are shared by all VuMarks, so they are uploaded once per pass
+    for (uint32_t pass = 0; pass < m_passCount; pass++)
+    {
+        if (m_passCount > 1)
         {
-            // Render the camera video background
-            m_videoBackground->Render(renderer, m_renderingPrimitives.get(), viewId);
+            m_passViewports[pass] = eyeViewports[pass];
+        }
+
+        SampleCommon::StereoProjectionConstantBuffer frameConstantBufferData;
+        for (uint32_t eye = 0; eye < SampleCommon::MAX_STEREO_EYES; eye++)
+        {
+            // A single eye draw has a single instance, the second slot only mirrors the first
+            uint32_t sourceEye = pass + ((eye < m_eyeCount) ? eye : 0);
+            SampleCommon::StereoEyeTransform transform = instanced ?
+                SampleCommon::StereoUtil::ComputeEyeTransform(eyeViewports[sourceEye], unionViewport) :
+                SampleCommon::StereoUtil::IdentityEyeTransform();
+
+            SampleCommon::StereoUtil::ApplyEyeTransform(
+                transform, &eyeProjections[sourceEye].m[0][0], &frameConstantBufferData.projection[eye].m[0][0]);
+            frameConstantBufferData.eyeBounds[eye] = XMFLOAT4(transform.bounds);
+        }
 
-            // Set state for augmentation rendering
-            if (renderer.getVideoBackgroundConfig().mReflection == Vuforia::VIDEO_BACKGROUND_REFLECTION_ON)
-                context->RSSetState(m_augmentationRasterStateCullFront.Get()); //Front camera
-            else
-                context->RSSetState(m_augmentationRasterState.Get()); //Back camera
+        context->UpdateSubresource1(
+            m_frameConstantBuffers[pass].Get(),
+            0,
+            NULL,
+            &frameConstantBufferData,
+            0,
+            0,
+            0
+            );
+        m_constantBufferBytes += sizeof(frameConstantBufferData);
+    }
 
-            context->OMSetDepthStencilState(m_augmentationDepthStencilState.Get(), 1);
-            context->OMSetBlendState(m_augmentationBlendState.Get(), NULL, 0xffffffff);
+    // Set state for augmentation rendering
+    if (renderer.getVideoBackgroundConfig().mReflection == Vuforia::VIDEO_BACKGROUND_REFLECTION_ON)
+        context->RSSetState(m_augmentationRasterStateCullFront.Get()); //Front camera
+    else
+        context->RSSetState(m_augmentationRasterState.Get()); //Back camera
 
-            int indexVuMarkToDisplay = -1;
+    context->OMSetDepthStencilState(m_augmentationDepthStencilState.Get(), 1);
+    context->OMSetBlendState(m_augmentationBlendState.Get(), NULL, 0xffffffff);
 
-            if (state.getNumTrackableResults() > 1) {
-                float minimumDistance = FLT_MAX;
-                const Vuforia::CameraCalibration& camCalib = Vuforia::CameraDevice::getInstance().getCameraCalibration();
-                const Vuforia::Vec2F camSize = camCalib.getSize();
-                const Vuforia::Vec2F camCenter = Vuforia::Vec2F(camSize.data[0] / 2.0f, camSize.data[1] / 2.0f);
+    bool gotVuMark = false;
 
-                for (int tIdx = 0; tIdx < state.getNumTrackableResults(); ++tIdx) {
-                    const Vuforia::TrackableResult* result = state.getTrackableResult(tIdx);
-                    if (result->isOfType(Vuforia::VuMarkTargetResult::getClassType()))
-                    {
-                        Vuforia::Vec3F point = Vuforia::Vec3F(0.0, 0.0, 0.0);
-                        Vuforia::Vec2F projPoint = Vuforia::Tool::projectPoint(
-                            camCalib, result->getPose(), point);
-
-                        float distance = DistanceSquared(projPoint, camCenter);
-                        if (distance < minimumDistance) {
-                            minimumDistance = distance;
-                            indexVuMarkToDisplay = tIdx;
-                        }
-                    }
+    int indexVuMarkToDisplay = -1;
+
+    if (state.getNumTrackableResults() > 1) {
+        float minimumDistance = FLT_MAX;
+        const Vuforia::CameraCalibration& camCalib = Vuforia::CameraDevice::getInstance().getCameraCalibration();
+        const Vuforia::Vec2F camSize = camCalib.getSize();
+        const Vuforia::Vec2F camCenter = Vuforia::Vec2F(camSize.data[0] / 2.0f, camSize.data[1] / 2.0f);
+
+        for (int tIdx = 0; tIdx < state.getNumTrackableResults(); ++tIdx) {
+            const Vuforia::TrackableResult* result = state.getTrackableResult(tIdx);
+            if (result->isOfType(Vuforia::VuMarkTargetResult::getClassType()))
+            {
+                Vuforia::Vec3F point = Vuforia::Vec3F(0.0, 0.0, 0.0);
+                Vuforia::Vec2F projPoint = Vuforia::Tool::projectPoint(
+                    camCalib, result->getPose(), point);
+
+                float distance = DistanceSquared(projPoint, camCenter);
+                if (distance < minimumDistance) {
+                    minimumDistance = distance;
+                    indexVuMarkToDisplay = tIdx;
                 }
             }
+        }
+    }
 
-            std::string currVuMarkId;
-            SampleCommon::SampleUtil::ToStdString(m_vuMarkView->GetCurrentVuMarkId(), currVuMarkId);
+    std::string currVuMarkId;
+    SampleCommon::SampleUtil::ToStdString(m_vuMarkView->GetCurrentVuMarkId(), currVuMarkId);
 
-            for (int tIdx = 0; tIdx < state.getNumTrackableResults(); tIdx++)
-            {
-                // Get the trackable:
-                const Vuforia::TrackableResult *result = state.getTrackableResult(tIdx);
-                const Vuforia::Trackable &trackable = result->getTrackable();
-                const char* trackableName = trackable.getName();
+    for (int tIdx = 0; tIdx < state.getNumTrackableResults(); tIdx++)
+    {
+        // Get the trackable:
+        const Vuforia::TrackableResult *result = state.getTrackableResult(tIdx);
+        const Vuforia::Trackable &trackable = result->getTrackable();
+        const char* trackableName = trackable.getName();
 
-                if (result->isOfType(Vuforia::VuMarkTargetResult::getClassType()))
-                {
-                    gotVuMark = true;
+        if (result->isOfType(Vuforia::VuMarkTargetResult::getClassType()))
+        {
+            gotVuMark = true;
 
-                    const Vuforia::VuMarkTargetResult* vmResult = (const Vuforia::VuMarkTargetResult*)result;
-                    const Vuforia::VuMarkTarget &vmTarget = vmResult->getTrackable();
+            const Vuforia::VuMarkTargetResult* vmResult = (const Vuforia::VuMarkTargetResult*)result;
+            const Vuforia::VuMarkTarget &vmTarget = vmResult->getTrackable();
 
-                    // This boolean teels if the current VuMark is the 'main' one,
-                    // i.e either the closest one to the camera center or the only one
-                    bool isMainVumark = (indexVuMarkToDisplay < 0) || (indexVuMarkToDisplay == tIdx);
+            // This boolean teels if the current VuMark is the 'main' one,
+            // i.e either the closest one to the camera center or the only one
+            bool isMainVumark = (indexVuMarkToDisplay < 0) || (indexVuMarkToDisplay == tIdx);
 
-                    const Vuforia::VuMarkTemplate& vmTemplate = vmTarget.getTemplate();
-                    const Vuforia::InstanceId & vmId = vmTarget.getInstanceId();
-                    const Vuforia::Image & vmImage = vmTarget.getInstanceImage();
+            const Vuforia::VuMarkTemplate& vmTemplate = vmTarget.getTemplate();
+            const Vuforia::InstanceId & vmId = vmTarget.getInstanceId();
+            const Vuforia::Image & vmImage = vmTarget.getInstanceImage();
 
-                    if (isMainVumark)
-                    {
-                        char vmId_cstr[VUMARK_ID_MAX_LENGTH + 1];
-                        ConvertInstanceIdToString(vmId, vmId_cstr);
+            if (isMainVumark)
+            {
+                char vmId_cstr[VUMARK_ID_MAX_LENGTH + 1];
+                ConvertInstanceIdToString(vmId, vmId_cstr);
 
-                        char vmType_cstr[16];
-                        GetInstanceType(vmId, vmType_cstr);
+                char vmType_cstr[16];
+                GetInstanceType(vmId, vmType_cstr);
 
-                        // if the vumark has changed, we hide the card
-                        // and reset the animation
-                        if (strcmp(vmId_cstr, currVuMarkId.c_str()) != 0)
-                        {
-                            BlinkVumark(true);
-
-                            // Hide the VuMark Card
-                            if (m_uiDispatcher != nullptr)
-                            {
-                                m_uiDispatcher->RunAsync(
-                                    Windows::UI::Core::CoreDispatcherPriority::Normal,
-                                    ref new Windows::UI::Core::DispatchedHandler([this]()
-                                {
-                                    m_vuMarkView->HideVuMarkCard();
-                                }));
-                            }
-                        }
-
-                        Platform::String^ vmIdStr = SampleCommon::SampleUtil::ToPlatformString(vmId_cstr);
-                        Platform::String^ vmTypeStr = SampleCommon::SampleUtil::ToPlatformString(vmType_cstr);
-
-                        // build Bitmap from Vuforia::Image and pass it here
-                        int vmImgWid = vmImage.getWidth();
-                        int vmImgHgt = vmImage.getHeight();
-                        m_vuMarkView->UpdateVuMarkInstance(
-                            vmIdStr, vmTypeStr, vmImgWid, vmImgHgt,
-                            (byte*)vmImage.getPixels()
-                        );
-                    }
+                // if the vumark has changed, we hide the card
+                // and reset the animation
+                if (strcmp(vmId_cstr, currVuMarkId.c_str()) != 0)
+                {
+                    BlinkVumark(true);
 
-                    // Set up the modelview matrix
-                    auto poseGL = Vuforia::Tool::convertPose2GLMatrix(result->getPose());
-                    XMFLOAT4X4 poseDX;
-                    memcpy(poseDX.m, poseGL.data, sizeof(float) * 16);
-                    XMStoreFloat4x4(&poseDX, XMMatrixTranspose(XMLoadFloat4x4(&poseDX)));
-                    XMMATRIX xmPose = XMLoadFloat4x4(&poseDX);
-
-                    float opacity = isMainVumark ? BlinkVumark(false) : 1.0f;
-                    float vmOrigX = -vmTemplate.getOrigin().data[0];
-                    float vmOrigY = -vmTemplate.getOrigin().data[1];
-                    float vmWidth = vmTarget.getSize().data[0];
-                    float vmHeight = vmTarget.getSize().data[1];
-                    if (!m_augmentationTexture->IsInitialized()) {
-                        m_augmentationTexture->Init();
+                    // Hide the VuMark Card
+                    if (m_uiDispatcher != nullptr)
+                    {
+                        m_uiDispatcher->RunAsync(
+                            Windows::UI::Core::CoreDispatcherPriority::Normal,
+                            ref new Windows::UI::Core::DispatchedHandler([this]()
+                        {
+                            m_vuMarkView->HideVuMarkCard();
+                        }));
                     }
-                    RenderVuMark(vmOrigX, vmOrigY, vmWidth, vmHeight, xmPose, xmProjection, m_augmentationTexture, opacity);
                 }
+
+                Platform::String^ vmIdStr = SampleCommon::SampleUtil::ToPlatformString(vmId_cstr);
+                Platform::String^ vmTypeStr = SampleCommon::SampleUtil::ToPlatformString(vmType_cstr);
+
+                // build Bitmap from Vuforia::Image and pass it here
+                int vmImgWid = vmImage.getWidth();
+                int vmImgHgt = vmImage.getHeight();
+                m_vuMarkView->UpdateVuMarkInstance(
+                    vmIdStr, vmTypeStr, vmImgWid, vmImgHgt,
+                    (byte*)vmImage.getPixels()
+                );
+            }
+
+            float opacity = isMainVumark ? BlinkVumark(false) : 1.0f;
+            float vmOrigX = -vmTemplate.getOrigin().data[0];
+            float vmOrigY = -vmTemplate.getOrigin().data[1];
+            float vmWidth = vmTarget.getSize().data[0];
+            float vmHeight = vmTarget.getSize().data[1];
+            if (!m_augmentationTexture->IsInitialized()) {
+                m_augmentationTexture->Init();
             }
+            RenderVuMark(vmOrigX, vmOrigY, vmWidth, vmHeight, result->getPose(), m_augmentationTexture, opacity);
         }
     }
 
+    if (stereo)
+    {
+        // The reticle is drawn over the whole screen
+        auto viewport = m_deviceResources->GetScreenViewport();
+        context->RSSetViewports(1, &viewport);
+    }
+
     if (gotVuMark)
     {
         if (m_uiDispatcher != nullptr) 
@@ -472,41 +569,39 @@ void VuMarkRenderer::RenderVuMark(
     float vuMarkOriginY,
     float vuMarkWidth,
     float vuMarkHeight,
-    const DirectX::XMMATRIX &poseMatrix,
-    const DirectX::XMMATRIX &projectionMatrix,
+    const Vuforia::Matrix34F &pose,
     const std::shared_ptr<SampleCommon::Texture> texture,
     float opacity
     )
 {
     auto context = m_deviceResources->GetD3DDeviceContext();
 
-    ZeroMemory(&m_constantBufferData, sizeof(SampleCommon::ModelViewProjectionConstantBuffer));
+    SampleCommon::ModelViewColorConstantBuffer constantBufferData;
 
     // Set the model matrix (the 'model' part of the 'model-view' matrix)
     auto translate = XMMatrixTranslation(-vuMarkOriginX, -vuMarkOriginY, 0.0f);
     auto scale = XMMatrixScaling(vuMarkWidth*VUMARK_SCALE, vuMarkHeight*VUMARK_SCALE, 1.0f);
     auto modelMatrix = XMMatrixTranspose(translate) * XMMatrixTranspose(scale);
-    XMStoreFloat4x4(&m_constantBufferData.model, modelMatrix);
 
-    // Set the pose matrix (the 'view' part of the 'model-view' matrix)
-    XMStoreFloat4x4(&m_constantBufferData.view, poseMatrix);
-
-    // Set the projection matrix
-    XMStoreFloat4x4(&m_constantBufferData.projection, projectionMatrix);
+    // Combine it with the pose matrix (the 'view' part of the 'model-view' matrix)
+    XMFLOAT4X4 modelDX;
+    XMStoreFloat4x4(&modelDX, modelMatrix);
+    SampleCommon::SampleMath::MultiplyMatrix34(pose.data, &modelDX.m[0][0], &constantBufferData.modelView.m[0][0]);
 
     // Set the color mask
-    m_constantBufferData.colorMask = {1.0F, 1.0F, 1.0F, opacity};
+    constantBufferData.colorMask = {1.0F, 1.0F, 1.0F, opacity};
 
     // Prepare the constant buffer to send it to the graphics device.
     context->UpdateSubresource1(
-        m_constantBuffer.Get(),
+        m_instanceConstantBuffer.Get(),
         0,
         NULL,
-        &m_constantBufferData,
+        &constantBufferData,
         0,
         0,
         0
         );
+    m_constantBufferBytes += sizeof(constantBufferData);
 
     // Each vertex is one instance of the TexturedVertex struct.
     UINT stride = sizeof(SampleCommon::TexturedVertex);
@@ -529,17 +624,8 @@ void VuMarkRenderer::RenderVuMark(
 
     context->IASetInputLayout(m_inputLayout.Get());
 
-    // Attach our vertex shader.
-    context->VSSetShader(m_vertexShader.Get(), nullptr, 0);
-
-    // Send the constant buffer to the graphics device.
-    context->VSSetConstantBuffers1(
-        0,
-        1,
-        m_constantBuffer.GetAddressOf(),
-        nullptr,
-        nullptr
-        );
+    // Attach our vertex shader; a single eye needs neither instancing nor clip distances
+    context->VSSetShader((m_eyeCount > 1) ? m_stereoVertexShader.Get() : m_vertexShader.Get(), nullptr, 0);
 
     // Attach our pixel shader.
     context->PSSetShader(m_pixelShader.Get(), nullptr, 0);
@@ -547,8 +633,38 @@ void VuMarkRenderer::RenderVuMark(
     context->PSSetSamplers(0, 1, texture->GetD3DSamplerState().GetAddressOf());
     context->PSSetShaderResources(0, 1, texture->GetD3DTextureView().GetAddressOf());
 
-    // Draw the objects.
-    context->DrawIndexed(m_quadMesh->GetIndexCount(), 0, 0);
+    for (uint32_t pass = 0; pass < m_passCount; pass++)
+    {
+        if (m_passCount > 1)
+        {
+            const SampleCommon::ViewportRect &viewport = m_passViewports[pass];
+            CD3D11_VIEWPORT d3dViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+            context->RSSetViewports(1, &d3dViewport);
+        }
+
+        // Send the per-view and per-draw constant buffers to the graphics device.
+        ID3D11Buffer *const constantBuffers[2] = {
+            m_frameConstantBuffers[pass].Get(),
+            m_instanceConstantBuffer.Get()
+        };
+        context->VSSetConstantBuffers1(
+            0,
+            2,
+            constantBuffers,
+            nullptr,
+            nullptr
+            );
+
+        // Draw the objects, with one instance per eye when drawing several
+        if (m_eyeCount > 1)
+        {
+            context->DrawIndexedInstanced(m_quadMesh->GetIndexCount(), m_eyeCount, 0, 0, 0);
+        }
+        else
+        {
+            context->DrawIndexed(m_quadMesh->GetIndexCount(), 0, 0);
+        }
+    }
 }
 
 float VuMarkRenderer::BlinkVumark(bool reset)
@@ -612,6 +728,23 @@ void VuMarkRenderer::CreateDeviceDependentResources()
             );
     });
 
+    // The instanced stereo shader takes feature level 10_0; below it, stereo
+    // views are drawn a pass per eye with the single eye shader above
+    auto createStereoVSTask = Concurrency::create_task([]() {});
+    if (m_deviceResources->GetDeviceFeatureLevel() >= D3D_FEATURE_LEVEL_10_0)
+    {
+        createStereoVSTask = DX::ReadDataAsync(L"TexturedStereoVertexShader.cso").then([this](const std::vector<byte>& fileData) {
+            DX::ThrowIfFailed(
+                m_deviceResources->GetD3DDevice()->CreateVertexShader(
+                    &fileData[0],
+                    fileData.size(),
+                    nullptr,
+                    &m_stereoVertexShader
+                    )
+                );
+        });
+    }
+
     auto createVideoBgVSTask = loadVideoBgVSTask.then([this](const std::vector<byte>& fileData) {
         m_videoBackground->InitVertexShader(&fileData[0], fileData.size());
     });
@@ -627,14 +760,40 @@ void VuMarkRenderer::CreateDeviceDependentResources()
                 )
             );
 
-        CD3D11_BUFFER_DESC constantBufferDesc(sizeof(SampleCommon::ModelViewProjectionConstantBuffer) , D3D11_BIND_CONSTANT_BUFFER);
-        DX::ThrowIfFailed(
-            m_deviceResources->GetD3DDevice()->CreateBuffer(
-                &constantBufferDesc,
-                nullptr,
-                &m_constantBuffer
-                )
-            );
+        auto device = m_deviceResources->GetD3DDevice();
+
+        CD3D11_BUFFER_DESC frameConstantBufferDesc(sizeof(SampleCommon::StereoProjectionConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
+        for (auto &frameConstantBuffer : m_frameConstantBuffers)
+        {
+            DX::ThrowIfFailed(device->CreateBuffer(&frameConstantBufferDesc, nullptr, &frameConstantBuffer));
+        }
+        DX::ThrowIfFailed(device->CreateBuffer(&frameConstantBufferDesc, nullptr, &m_reticleFrameConstantBuffer));
+        m_reticleProjectionValid = false;
+
+        CD3D11_BUFFER_DESC instanceConstantBufferDesc(sizeof(SampleCommon::ModelViewColorConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
+        DX::ThrowIfFailed(device->CreateBuffer(&instanceConstantBufferDesc, nullptr, &m_instanceConstantBuffer));
+
+        // We place the reticle at the near clipping plane, its model-view never changes
+        float reticleDistance = 1.1f * m_near;
+        const XMVECTORF32 eye = { 0.0f, 0.0f, reticleDistance, 0.0f };
+        const XMVECTORF32 at = { 0.0f, 0.0f, 0.0f, 0.0f };
+        const XMVECTORF32 up = { 0.0f, 1.0f, 0.0f, 0.0f };
+
+        float reticleScale = reticleDistance * tan(RETICLE_FOV_Y / 2);
+        auto reticleScaleMatrix = XMMatrixScaling(reticleScale, reticleScale, reticleScale);
+
+        SampleCommon::ModelViewColorConstantBuffer reticleData;
+        XMStoreFloat4x4(
+            &reticleData.modelView,
+            XMMatrixTranspose(XMMatrixLookAtRH(eye, at, up)) * XMMatrixTranspose(reticleScaleMatrix));
+        reticleData.colorMask = { 1.0F, 1.0F, 1.0F, 1.0F };
+
+        D3D11_SUBRESOURCE_DATA reticleInitData = { &reticleData, 0, 0 };
+        CD3D11_BUFFER_DESC reticleConstantBufferDesc(
+            sizeof(SampleCommon::ModelViewColorConstantBuffer),
+            D3D11_BIND_CONSTANT_BUFFER,
+            D3D11_USAGE_IMMUTABLE);
+        DX::ThrowIfFailed(device->CreateBuffer(&reticleConstantBufferDesc, &reticleInitData, &m_reticleInstanceConstantBuffer));
     });
 
     // After the pixel shader file is loaded, create the shader and constant buffer.
@@ -643,7 +802,7 @@ void VuMarkRenderer::CreateDeviceDependentResources()
     });
 
     // Once both shaders are loaded, create the mesh.
-    auto createAugmentationModelsTask = (createPSTask && createVSTask).then([this] () {
+    auto createAugmentationModelsTask = (createPSTask && createVSTask && createStereoVSTask).then([this] () {
         m_quadMesh = std::shared_ptr<SampleCommon::QuadMesh>(new SampleCommon::QuadMesh(m_deviceResources));
         m_quadMesh->InitMesh();
     });
@@ -743,9 +902,16 @@ void VuMarkRenderer::ReleaseDeviceDependentResources()
     m_videoBackground.reset();
 
     m_vertexShader.Reset();
+    m_stereoVertexShader.Reset();
     m_inputLayout.Reset();
     m_pixelShader.Reset();
-    m_constantBuffer.Reset();
+    for (auto &frameConstantBuffer : m_frameConstantBuffers)
+    {
+        frameConstantBuffer.Reset();
+    }
+    m_instanceConstantBuffer.Reset();
+    m_reticleFrameConstantBuffer.Reset();
+    m_reticleInstanceConstantBuffer.Reset();
 
     m_quadMesh->ReleaseResources();
     m_augmentationTexture->ReleaseResources();
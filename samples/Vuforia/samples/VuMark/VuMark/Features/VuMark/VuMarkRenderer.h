@@ -12,6 +12,8 @@ countries.
 #include "..\..\Common\StepTimer.h"
 #include "..\..\Common\Texture.h"
 #include "..\..\Common\QuadMesh.h"
+#include "..\..\Common\StereoViews.h"
+#include "..\..\Common\SampleMath.h"
 #include "..\..\Common\VideoBackground.h"
 
 #include <Vuforia\Matrices.h>
@@ -42,13 +44,21 @@ namespace VuMark
         void SetVuforiaInitialized(bool initialized) { m_vuforiaInitialized = initialized; }
         void SetVuforiaStarted(bool started);
         void SetExtendedTracking(bool enabled) { m_extTracking = enabled; }
+        void SetTextureMipBias(float mipBias) { m_textureMipBias = mipBias; }
 
         void UpdateRenderingPrimitives();
         
         void SetUIDispatcher(Windows::UI::Core::CoreDispatcher^ dispatcher) { m_uiDispatcher = dispatcher; }
 
+        // Bytes of augmentation constant data uploaded during the last frame
+        uint32_t GetConstantBufferBytesPerFrame() const { return m_constantBufferBytesPerFrame; }
+
     private:
         void RenderScene(Vuforia::Renderer &renderer, Vuforia::State &state);
+
+        // Eye adjusted projection matrix of a view
+        void GetProjectionMatrix(Vuforia::VIEW viewId, DirectX::XMFLOAT4X4 &projection);
+
         void RenderReticle();
 
         void RenderVuMark(
@@ -56,8 +66,7 @@ namespace VuMark
             float vuMarkOriginY,
             float vuMarkWidth,
             float vuMarkHeight,
-            const DirectX::XMMATRIX &poseMatrix,
-            const DirectX::XMMATRIX &projectionMatrix,
+            const Vuforia::Matrix34F &pose,
             const std::shared_ptr<SampleCommon::Texture> texture,
             float opacity);
 
@@ -90,25 +99,39 @@ namespace VuMark
        // Direct3D resources for mesh geometry.
         Microsoft::WRL::ComPtr<ID3D11InputLayout>    m_inputLayout;
         Microsoft::WRL::ComPtr<ID3D11VertexShader>    m_vertexShader;
+        Microsoft::WRL::ComPtr<ID3D11VertexShader>    m_stereoVertexShader; // null below feature level 10_0
         Microsoft::WRL::ComPtr<ID3D11PixelShader>    m_pixelShader;
-        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_constantBuffer;
+        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_frameConstantBuffers[SampleCommon::MAX_STEREO_EYES]; // one per pass
+        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_instanceConstantBuffer;
+
+        // The reticle has its own buffers: its model-view never changes and its
+        // projection only changes with the window size and orientation
+        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_reticleFrameConstantBuffer;
+        Microsoft::WRL::ComPtr<ID3D11Buffer>        m_reticleInstanceConstantBuffer;
+        DirectX::XMFLOAT4X4 m_reticleProjection;
+        bool m_reticleProjectionValid;
 
         // Quad mesh and texture
         std::shared_ptr<SampleCommon::QuadMesh> m_quadMesh;
         std::shared_ptr<SampleCommon::Texture> m_augmentationTexture;
         std::shared_ptr<SampleCommon::Texture> m_reticleTexture;
 
-        // System resources for model-view projection.
-        SampleCommon::ModelViewProjectionConstantBuffer    m_constantBufferData;
+        // Constant data uploaded in the current and in the last frame
+        uint32_t m_constantBufferBytes;
+        uint32_t m_constantBufferBytesPerFrame;
 
-        // Projection matrix
-        DirectX::XMFLOAT4X4 m_projection;
+        // Eyes drawn by each VuMark draw of the current frame, one instance each.
+        // Without instanced stereo, each eye is drawn in a pass of its own.
+        uint32_t m_eyeCount;
+        uint32_t m_passCount;
+        SampleCommon::ViewportRect m_passViewports[SampleCommon::MAX_STEREO_EYES];
 
         // Variables used with the rendering loop.
         std::atomic<bool> m_rendererInitialized;
         std::atomic<bool> m_vuforiaInitialized;
         std::atomic<bool> m_vuforiaStarted;
         std::atomic<bool> m_extTracking;
+        std::atomic<float> m_textureMipBias;
 
         // Near and Far clipping planes
         const float m_near = .02f;
@@ -395,7 +395,7 @@ void VuMarkView::OnARStarted()
 // This callback is called every cycle
 void VuMarkView::OnVuforiaUpdate(VuforiaState^ vuforiaState)
 {
-    //Vuforia::State* state = vuforiaState->m_nativeState;
+    m_main->PrepareFrame(*vuforiaState->m_nativeState);
 }
 
 // Window event handlers.